@@ -0,0 +1,18 @@
+%% ----------------- Exact Discretization -----------------
+function [Phi, G0, G1, Gc] = discretize_foh(A, B, h)
+    % Exact discretization of x' = A*x + B*w over a step h, for an input w
+    % linear between the samples (first-order hold),
+    %   x_k+1 = Phi*x_k + G0*w_k + G1*w_k+1,
+    % and for an input held over the step (zero-order hold), Gc*w_k.
+    % Input w(t) = w_k + (w_k+1 - w_k) * tau / h as additional states
+    n = size(A, 1);
+    M = [A, B, zeros(n, 1);
+         zeros(1, n + 1), 1;
+         zeros(1, n + 2)];
+    E = expm(M * h);
+
+    Phi = E(1:n, 1:n);
+    Gc = E(1:n, n+1);          % Zero-order hold
+    G1 = E(1:n, n+2) / h;      % Ramp over the step
+    G0 = Gc - G1;
+end
@@ -0,0 +1,10 @@
+%% ----------------- PID Augmented State-Space Model -----------------
+function [A_pid, B_pid] = pid_augment(A, B)
+    % Appends the integral and previous error states used by pid_control;
+    % the states are x(end-1) (integral term) and x(end) (previous error).
+    n = size(A, 1);
+    A_pid = [A, zeros(n, 2);
+             zeros(1, n), 1, 0;         % Integral term
+             zeros(1, n-1), 1, 0, 0];   % Previous error
+    B_pid = [B; 0; 0];
+end
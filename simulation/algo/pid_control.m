@@ -0,0 +1,15 @@
+%% ----------------- PID Control Law -----------------
+function u = pid_control(error, integral, Kp, Ki, Kd)
+    % Saturated PID output; all arguments may be arrays of equal size (or
+    % scalars), e.g. one column per gain set in run_batch_control.
+    % The former anti-windup correction of the local integral never reached
+    % the output or the integrator state, so only the saturation remains.
+    u_max = 100;  % Upper limit of control output
+    u_min = -100; % Lower limit of control output
+
+    % Compute PID terms
+    u = Kp .* error + Ki .* integral + Kd .* (error - integral);
+
+    % Apply saturation limits
+    u = min(max(u, u_min), u_max);
+end
@@ -0,0 +1,56 @@
+%% ----------------- Exact Discretization Simulation -----------------
+function [t, y] = simulate_discrete(A, B, T, u, x0, control)
+    % Simulates x' = A*x + B*(u(t) + c(x)) at the sample times T.
+    % The road input u is linear between samples (first-order hold), which
+    % equals interp1(T, u, t, 'linear'), so without feedback the result is
+    % exact. The optional feedback c = control(x) is held over substeps of at
+    % most max_substep (zero-order hold), with the road interpolated inside
+    % the step; a hold over a whole sample step (e.g. 0.1 s) would distort
+    % the nonlinear controllers. Discretization matrices are computed once
+    % per distinct step.
+    if nargin < 6
+        control = [];
+    end
+
+    max_substep = 1e-3;  % Longest hold of the feedback [s]
+
+    t = T(:);
+    u = u(:);
+    n = size(A, 1);
+    N = numel(t);
+
+    if numel(u) ~= N
+        error('simulate_discrete:input', 'Road input must have one value per time sample.');
+    end
+
+    y = zeros(N, n);
+    x = x0(:);
+    y(1, :) = x';
+
+    h_last = NaN;
+    for k = 1:N-1
+        h = t(k+1) - t(k);
+
+        % Steps of a uniform grid differ by rounding only
+        if ~(abs(h - h_last) <= 1e-9 * abs(h))
+            if isempty(control)
+                m = 1;
+            else
+                m = ceil(h / max_substep - 1e-9);
+            end
+            [Phi, G0, G1, Gc] = discretize_foh(A, B, h / m);
+            h_last = h;
+        end
+
+        if isempty(control)
+            x = Phi * x + G0 * u(k) + G1 * u(k+1);
+        else
+            % Road sampled linearly at the substeps
+            w = u(k) + (u(k+1) - u(k)) * (0:m) / m;
+            for j = 1:m
+                x = Phi * x + G0 * w(j) + G1 * w(j+1) + Gc * control(x);
+            end
+        end
+        y(k+1, :) = x';
+    end
+end
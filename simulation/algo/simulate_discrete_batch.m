@@ -0,0 +1,80 @@
+%% ----------------- Batched Exact Discretization Simulation -----------------
+function [t, Y] = simulate_discrete_batch(A, B, T, u, X0, control)
+    % Simulates G variants of x' = A*x + B*(u(t) + c(x)) in lockstep on the
+    % same road input, as simulate_discrete does for a single one.
+    %   A        n x n x G system matrices of the variants, or n x n shared
+    %   X0       n x G initial states, or n x 1 shared
+    %   control  optional @(X) returning the 1 x G feedback for the n x G
+    %            states of all variants, held over substeps of at most
+    %            max_substep as in simulate_discrete
+    % The states of all variants form one n x G array, so each step is one
+    % update over all variants. Y is numel(T) x n x G.
+    if nargin < 6
+        control = [];
+    end
+
+    max_substep = 1e-3;  % Longest hold of the feedback [s], as in simulate_discrete
+
+    t = T(:);
+    u = u(:);
+    n = size(A, 1);
+    N = numel(t);
+    G = max(size(A, 3), size(X0, 2));
+
+    if numel(u) ~= N
+        error('simulate_discrete_batch:input', 'Road input must have one value per time sample.');
+    end
+
+    X = repmat(X0, 1, G / size(X0, 2));
+    Y = zeros(N, n, G);
+    Y(1, :, :) = reshape(X, 1, n, G);
+
+    shared = size(A, 3) == 1;
+    h_last = NaN;
+    for k = 1:N-1
+        h = t(k+1) - t(k);
+
+        % Steps of a uniform grid differ by rounding only
+        if ~(abs(h - h_last) <= 1e-9 * abs(h))
+            if isempty(control)
+                m = 1;
+            else
+                m = ceil(h / max_substep - 1e-9);
+            end
+            [Phi, G0, G1, Gc] = discretize_batch(A, B, h / m);
+            h_last = h;
+        end
+
+        % Road sampled linearly at the substeps
+        w = u(k) + (u(k+1) - u(k)) * (0:m) / m;
+        for j = 1:m
+            if isempty(control)
+                C = 0;
+            else
+                C = control(X);
+            end
+
+            % One road sample drives all variants
+            if shared
+                X = Phi * X + (G0 * w(j) + G1 * w(j+1)) + Gc .* C;
+            else
+                X = reshape(sum(Phi .* reshape(X, 1, n, G), 2), n, G) + G0 * w(j) + G1 * w(j+1) + Gc .* C;
+            end
+        end
+        Y(k+1, :, :) = reshape(X, 1, n, G);
+    end
+end
+
+%% ----------------- Discretization -----------------
+function [Phi, G0, G1, Gc] = discretize_batch(A, B, h)
+    % Shared systems keep n x 1 input matrices, variants get n x G ones
+    n = size(A, 1);
+    G = size(A, 3);
+    Phi = zeros(n, n, G);
+    G0 = zeros(n, G);
+    G1 = zeros(n, G);
+    Gc = zeros(n, G);
+    for g = 1:G
+        [Phi(:, :, g), G0(:, g), G1(:, g), Gc(:, g)] = discretize_foh(A(:, :, g), B, h);
+    end
+end
@@ -0,0 +1,11 @@
+%% ----------------- Sliding Mode Control Law -----------------
+function u = smc_control(sigma, K_s, epsilon)
+    % Saturated sliding mode control output; all arguments may be arrays of
+    % equal size (or scalars), e.g. one column per gain set in run_batch_control.
+    % Smooth saturation for sliding mode control
+    sat = @(x) x ./ (1 + abs(x));
+    u = -K_s .* sat(sigma ./ epsilon);
+
+    % Apply control saturation
+    u = max(min(u, 100), -100);
+end
@@ -0,0 +1,82 @@
+function [t, Y] = run_batch_control(controller, A, B, T, u, x0, gain_sets, varargin)
+    % Simulates one controller with several gain sets in lockstep on the same
+    % road (see simulate_discrete_batch). gain_sets is a cell array holding
+    % the gains of each variant as passed to run_<controller>_control; Y is
+    % numel(T) x states x numel(gain_sets), NaN for variants that failed.
+    %
+    %   [t, Y] = run_batch_control(controller, A, B, T, u, x0, gain_sets, 'OutputDir', dir)
+    %
+    % With OutputDir the results and the throughput are saved to batch.mat,
+    % next to the results of a sweep (see run_sweep).
+    p = inputParser;
+    addParameter(p, 'OutputDir', '');
+    parse(p, varargin{:});
+    out_dir = p.Results.OutputDir;
+
+    G = numel(gain_sets);
+    t_start = tic;
+    failed = false(1, G);
+
+    switch controller
+        case {'LQR', 'Hinf'}
+            % Closed-loop system of each variant
+            A_cl = repmat(A, 1, 1, G);
+            for g = 1:G
+                Q = gain_sets{g}{1};
+                R = gain_sets{g}{2};
+                try
+                    if strcmp(controller, 'LQR')
+                        K = lqr(A, B, Q, R);
+                    else
+                        P = care(A, B, Q, R);
+                        K = R \ (B' * P);
+                    end
+                    A_cl(:, :, g) = A - B * K;
+                catch ME
+                    warning(ME.identifier, '%s failed for gain set %d: %s', controller, g, ME.message);
+                    failed(g) = true;
+                end
+            end
+            [t, Y] = simulate_discrete_batch(A_cl, B, T, u, x0);
+
+        case 'PID'
+            % System augmented by the integral and previous error states, as in run_pid_control
+            [A_pid, B_pid] = pid_augment(A, B);
+            Kp = cellfun(@(g) g{1}, gain_sets);
+            Ki = cellfun(@(g) g{2}, gain_sets);
+            Kd = cellfun(@(g) g{3}, gain_sets);
+            control = @(X) pid_control(X(end-1, :), X(end, :), Kp, Ki, Kd);
+            [t, Y] = simulate_discrete_batch(A_pid, B_pid, T, u, repmat([x0; 0; 0], 1, G), control);
+
+        case 'SMC'
+            % Sliding surface on the displacement state, as in run_smc_control
+            K_s = cellfun(@(g) g{1}, gain_sets);
+            epsilon = cellfun(@(g) g{2}, gain_sets);
+            control = @(X) smc_control(X(1, :), K_s, epsilon);
+            [t, Y] = simulate_discrete_batch(A, B, T, u, repmat(x0, 1, G), control);
+
+        otherwise
+            error('run_batch_control:controller', 'Unknown controller: %s', controller);
+    end
+
+    % Check for NaNs or Infs in output
+    invalid = failed | reshape(any(any(~isfinite(Y), 1), 2), 1, []);
+    if any(invalid & ~failed)
+        warning('%s control solution contains NaNs or Infs for %d gain set(s). Marking output as invalid.', ...
+            controller, nnz(invalid & ~failed));
+    end
+    Y(:, :, invalid) = NaN;
+
+    elapsed = toc(t_start);
+    fprintf('Batch: %d %s simulations in %.2f s (%.1f simulations/s)\n', ...
+        G, controller, elapsed, G / max(elapsed, eps));
+
+    if ~isempty(out_dir)
+        if ~exist(out_dir, 'dir')
+            mkdir(out_dir);
+        end
+        batch = struct('controller', controller, 'no_simulations', G, 'elapsed', elapsed, ...
+            'simulations_per_s', G / max(elapsed, eps));
+        save(fullfile(out_dir, 'batch.mat'), 'batch', 'gain_sets', 't', 'Y');
+    end
+end
@@ -15,13 +15,10 @@ function [t, y] = run_hinf_control(A, B, T, u, x0, gains)
         return;
     end
 
-    % Define closed-loop system dynamics
-    dynamics = @(t, x) (A - B * K_hinf) * x + B * interp1(T, u, t, 'linear', 'extrap');
-
     % Solve the system
     try
-        % Solve ODE with H-Infinity feedback
-        [t, y] = ode15s(dynamics, T, x0);
+        % Closed-loop system with H-Infinity feedback, discretized exactly
+        [t, y] = simulate_discrete(A - B * K_hinf, B, T, u, x0);
 
         % Check for NaNs or Infs in output
         if any(isnan(y(:))) || any(isinf(y(:)))
@@ -29,7 +26,7 @@ function [t, y] = run_hinf_control(A, B, T, u, x0, gains)
             y = NaN(size(y));
         end
     catch ME
-        warning(ME.identifier, 'ODE solver failed during H-Inf simulation: %s', ME.message);
+        warning(ME.identifier, 'Simulation failed during H-Inf control: %s', ME.message);
         t = T;
         y = NaN(numel(T), size(A,1));
     end
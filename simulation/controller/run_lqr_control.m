@@ -18,12 +18,10 @@ function [t, y] = run_lqr_control(A, B, T, u, x0, gains)
         error('Interpolation returned NaN values!');
     end
 
-    % System dynamics with LQR feedback
-    dynamics = @(t, x) A * x + B * (-K * x + interp1(T, u_interp, t, 'linear', 'extrap'));
-
     % Solve the system
     try
-        [t, y] = ode15s(dynamics, T, x0);
+        % Closed-loop system with LQR feedback, discretized exactly
+        [t, y] = simulate_discrete(A - B * K, B, T, u_interp, x0);
 
         % Check for NaNs or Infs in output
         if any(isnan(y(:))) || any(isinf(y(:)))
@@ -31,7 +29,7 @@ function [t, y] = run_lqr_control(A, B, T, u, x0, gains)
             y = NaN(size(y));
         end
     catch ME
-        warning(ME.identifier, 'ODE solver failed during LQR simulation: %s', ME.message);
+        warning(ME.identifier, 'Simulation failed during LQR control: %s', ME.message);
         t = T;
         y = NaN(numel(T), size(A,1));
     end
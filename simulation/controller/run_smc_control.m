@@ -14,20 +14,7 @@ function [t, y] = run_smc_control(A, B, T, u, x0, gains)
         error('Interpolation returned NaN values!');
     end
 
-    % Define closed-loop system dynamics
-    dynamics = @(t, x) A * x + B * (...
-        smc_control(C_smc * x(:), K_s, epsilon) + ...
-        interp1(T, u, t, 'linear', 'extrap'));
-
-    % Solve using ODE15s
-    [t, y] = ode15s(dynamics, T, x0_smc);
-end
-
-function u = smc_control(sigma, K_s, epsilon)
-    % Smooth saturation for sliding mode control
-    sat = @(x) x ./ (1 + abs(x));
-    u = -K_s * sat(sigma / epsilon);
-
-    % Apply control saturation
-    u = max(min(u, 100), -100);
+    % Solve the system with sliding mode control
+    control = @(x) smc_control(C_smc * x(:), K_s, epsilon);
+    [t, y] = simulate_discrete(A, B, T, u, x0_smc, control);
 end
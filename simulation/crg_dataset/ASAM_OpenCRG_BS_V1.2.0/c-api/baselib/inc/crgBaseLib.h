@@ -64,6 +64,7 @@
 #define dCrgCpOptionCheckTol            17       /* [double],  expected abs. tolerance                                                    [m] */
 #define dCrgCpOptionWarnCurvLocal		18		 /* [integer], local curvature test															  */
 #define dCrgCpOptionWarnCurvGlobal		19		 /* [integer], global curvature test														  */
+#define dCrgCpOptionRealTimeSteps       20       /* [integer], real-time mode: max. number of search steps per x/y query, 0 = off        [-] */
 
 
 /**
@@ -88,6 +89,13 @@
 #define dCrgCurvLateral              0   /* compute curvature based on lateral position (v)  */     /* default */
 #define dCrgCurvRefLine              1   /* keep curvature value on reference line           */
 
+/**
+* Status flags of real-time queries (see dCrgCpOptionRealTimeSteps and crgContactPointGetRealTimeStatus())
+*/
+#define dCrgRtStatusOk             0x00   /* query performed with full accuracy                                  */
+#define dCrgRtStatusCoarseScan     0x01   /* history miss; start interval taken from a two-level reference line scan */
+#define dCrgRtStatusStepLimit      0x02   /* search stopped at step limit; accuracy of u/v may be reduced          */
+
 /**
 * CRG modifiers for modification of data sets 
 * ATTENTION: IDs MUST NOT overlap with option IDs (see dCrgCpOptionxxx)
@@ -136,7 +144,84 @@
 #define dCrgOrientFwd               0   /* forward orientation                */
 #define dCrgOrientRev               1   /* reverse orientation                */
 
+/**
+* performance counters: number of latency histogram bins, bin i holds
+* queries with a duration in the range [2^i, 2^(i+1)) ns
+*/
+#define dCrgPerfStatNoBins         32
+
+/**
+* output formats for crgPerfStatDump()
+*/
+#define dCrgPerfStatFormatJSON      0
+#define dCrgPerfStatFormatCSV       1
+
+/**
+* data formats of files written by crgWriterOpen()
+*/
+#define dCrgWriterFormatKRBI        0   /* binary, single precision           */      /* default of crg_write.m */
+#define dCrgWriterFormatKDBI        1   /* binary, double precision           */
+#define dCrgWriterFormatKRBZ        2   /* binary, single precision, compressed */
+
+/**
+* co-ordinates of the points of a path (see CrgPathStruct)
+*/
+#define dCrgPathTypeUV              0   /* path given in u/v co-ordinates     */
+#define dCrgPathTypeXY              1   /* path given in x/y co-ordinates     */
+
 /* ====== TYPE DEFINITIONS ====== */
+/**
+* runtime performance counters; these are always collected per thread, the
+* values returned by crgPerfStatGet() are accumulated over all threads
+*/
+typedef struct
+{
+    unsigned long noEvaluv2z;                          /* number of z evaluations                            [-] */
+    unsigned long noBorderU;                           /* z evaluations outside the core area in u           [-] */
+    unsigned long noBorderV;                           /* z evaluations outside the core area in v           [-] */
+    unsigned long noLoopV;                             /* iterations of the v interval search                [-] */
+    unsigned long noEvalxy2uv;                         /* number of x/y -> u/v conversions                   [-] */
+    unsigned long noHistIter;                          /* iterations through the history                     [-] */
+    unsigned long noHistCloseHits;                     /* history hits within close distance                 [-] */
+    unsigned long noHistFarHits;                       /* history hits within far distance                   [-] */
+    unsigned long noHistNoHits;                        /* history misses, i.e. fallback scans                [-] */
+    unsigned long noScanPts;                           /* reference line points tested in fallback scans     [-] */
+    unsigned long noLoop1;                             /* iterations of the upward interval search           [-] */
+    unsigned long noLoop2;                             /* iterations of the downward interval search         [-] */
+    unsigned long latencyEvaluv2z[dCrgPerfStatNoBins];  /* sampled latency histogram of u/v -> z queries      [-] */
+    unsigned long latencyEvalxy2uv[dCrgPerfStatNoBins]; /* sampled latency histogram of x/y -> u/v queries    [-] */
+} CrgPerfStatStruct;
+
+/**
+* roughness of a wheel track according to ISO 8608, see crgDataSetCalcRoughness()
+*/
+typedef struct
+{
+    double gdN0;                                       /* displacement PSD at n0 = 0.1 cycles/m, waviness 2  [m^3] */
+    double waviness;                                   /* waviness of a free fit, 0 if less than two octaves  [-] */
+    double nMin;                                       /* lowest spatial frequency of the fit         [cycles/m] */
+    double nMax;                                       /* highest spatial frequency of the fit        [cycles/m] */
+    int    isoClass;                                   /* road class, 0 = A ... 7 = H                         [-] */
+    int    noWindows;                                  /* number of averaged windows                          [-] */
+} CrgRoughnessStruct;
+
+/**
+* path driven at a given speed schedule for sampling the road excitation with
+* crgEvalPathSample(); the speed is interpolated linearly between the entries
+* of the schedule and kept constant before the first and after the last entry
+*/
+typedef struct
+{
+    int           type;                                /* co-ordinates of the path points        [dCrgPathTypeXXX] */
+    int           noPts;                               /* number of path points, min. 2                        [-] */
+    const double* a;                                   /* u or x co-ordinates of the path points               [m] */
+    const double* b;                                   /* v or y co-ordinates of the path points               [m] */
+    int           noSpeeds;                            /* number of entries of the speed schedule, min. 1      [-] */
+    const double* speedTime;                           /* times of the speed schedule, ascending; time of the  [s] */
+                                                       /* first sample is 0.0                                      */
+    const double* speed;                               /* speed at the times of the schedule, not negative   [m/s] */
+    double        sampleRate;                          /* sample rate of the excitation                       [Hz] */
+} CrgPathStruct;
 
 /* ====== METHODS in crgMgr.c ====== */
     /** 
@@ -201,6 +286,17 @@
     */
     extern int crgDataSetGetUtilityDataClosedTrack( const int dataSetId, int *uIsClosed, double *uCloseMin, double *uCloseMax );
 
+    /**
+    * enable or disable pre-computed interpolation coefficients of the grid cells; when enabled,
+    * z evaluations in the grid need a single interpolation instead of separate interpolations
+    * of z data, reference line elevation and banking, at the cost of 32 bytes per grid cell;
+    * results may differ from the standard evaluation by floating point rounding
+    * @param dataSetId    identifier of the applicable dataset
+    * @param enable       1 to compute and use the coefficients, 0 to release them
+    * @return 1 upon success, otherwise 0
+    */
+    extern int crgDataSetCellCoefsEnable( int dataSetId, int enable );
+
     /**
     * set/add an integer value modifier to be applied to the data set
     * CRG data using the indicated data point
@@ -342,7 +438,8 @@
     
 /* ====== METHODS in crgLoader.c ====== */
     /**
-    * check CRG data for consistency and accuracy
+    * check CRG data for consistency and accuracy; the result is kept in the
+    * data set and re-used until its options, modifiers or data change
     * @param  dataSetId    identifier of the applicable dataset
     * @return true         if crgData is valid
     */
@@ -355,6 +452,23 @@
     */
     extern int crgLoaderReadFile( const char* filename );
     
+    /**
+    * re-read the file of a data set after it has been modified; the data set keeps
+    * its identifier and all contact points referring to it stay valid (their
+    * history is cleared). Nothing is read if time stamp and size of the file are
+    * unchanged, and nothing is rebuilt if its contents are the same. Header
+    * changes which do not affect the data layout (e.g. comments, options,
+    * modifiers) and modified ranges of the data section are detected by
+    * checksums; from the second reload on, only the modified u ranges are decoded
+    * again while the decoded data of the previous reload is kept in memory.
+    * If the header is unchanged, options and modifiers set by the application are
+    * kept; modifiers which had been applied to the data set are applied again.
+    * Include files are not tracked, so data sets using them are always re-read.
+    * @param dataSetId  identifier of the data set read by crgLoaderReadFile()
+    * @return 1 if successful (the data set is unchanged on failure), otherwise 0
+    */
+    extern int crgDataSetReload( int dataSetId );
+    
 /* ====== METHODS in crgContactPoint.c ====== */
     /**
     * create a new contact point working on the indicated data set
@@ -458,6 +572,18 @@
     * @return 1 if successful, otherwise 0
     */
     extern int crgContactPointSetHistory( int cpId, int histSize );
+    
+    /**
+    * get the real-time status of a contact point (see dCrgCpOptionRealTimeSteps); with
+    * real-time mode active, x/y queries perform a bounded amount of work and do neither
+    * allocate memory nor print messages, at the expense of accuracy in rare cases
+    * @param  cpId         index of the contact point
+    * @param  status       pointer to status of the latest x/y query (dCrgRtStatusXXX)
+    * @param  noDegraded   pointer to number of queries stopped at the step limit since the
+    *                      contact point's creation (may be NULL)
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgContactPointGetRealTimeStatus( int cpId, int* status, unsigned long* noDegraded );
         
 /* ====== METHODS in crgEvalxy2uv.c ====== */
     /**
@@ -529,6 +655,152 @@
     */
     extern int crgEvalxy2pk( int cpId, double x, double y, double* phi, double* curv );
       
+/* ====== METHODS in crgEvalGrid.c ====== */
+    /**
+    * compute the z values of a regular u/v grid using bilinear interpolation;
+    * the default options of the data set apply (see crgDataSetOptionSetDefault()),
+    * positions which cannot be evaluated result in NaN
+    * @param dataSetId  identifier of the applicable dataset
+    * @param u0         u co-ordinate of the first column
+    * @param du         increment in u direction
+    * @param nu         number of columns
+    * @param v0         v co-ordinate of the first row
+    * @param dv         increment in v direction
+    * @param nv         number of rows
+    * @param out        resulting z values, nv rows of nu values each;
+    *                   out[j * nu + i] holds z( u0 + i * du, v0 + j * dv )
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgEvalGridUV( int dataSetId, double u0, double du, int nu, double v0, double dv, int nv, float* out );
+
+    /**
+    * define the max. number of threads sharing the rows of a grid in
+    * crgEvalGridUV(); small grids are evaluated by fewer threads
+    * @param noThreads  max. number of threads, 0 = number of processors (default)
+    * @return 1 if successful, 0 if not available (library built without
+    *         dCrgEnableThreads, only 1 is accepted then)
+    */
+    extern int crgEvalGridSetMaxThreads( int noThreads );
+
+/* ====== METHODS in crgEvalPath.c ====== */
+    /**
+    * get the number of samples taken by crgEvalPathSample() until the end of
+    * the path is reached
+    * @param path       pointer to the path description
+    * @param noSamples  pointer to the resulting number of samples
+    * @return 1 if successful, 0 if the path is invalid or its end is never reached
+    */
+    extern int crgEvalPathGetNoSamples( const CrgPathStruct* path, int* noSamples );
+
+    /**
+    * sample the z values of one or more wheel tracks along a path in the time
+    * domain; each track is offset laterally from the path (positive to the left)
+    * and evaluated by its own contact point, whose options and history apply;
+    * positions which cannot be evaluated result in NaN
+    * @param path        pointer to the path description
+    * @param noTracks    number of wheel tracks
+    * @param cpId        contact point of each track
+    * @param offset      lateral offset of each track from the path
+    * @param maxSamples  max. number of samples per track
+    * @param z           resulting z values, noTracks blocks of maxSamples values;
+    *                    z[j * maxSamples + k] holds track j at time k / sampleRate
+    * @param noSamples   pointer to the resulting number of samples per track; less than
+    *                    maxSamples if the end of the path has been reached before
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgEvalPathSample( const CrgPathStruct* path, int noTracks, const int* cpId, const double* offset,
+                                  int maxSamples, double* z, int* noSamples );
+
+/* ====== METHODS in crgRoughness.c ====== */
+    /**
+    * classify the roughness of a wheel track according to ISO 8608: the
+    * displacement PSD is estimated along u by Welch's method (Hann windows
+    * overlapping by one half, linear trend removed) and the level Gd(n0) at
+    * n0 = 0.1 cycles/m is fitted for waviness 2 in octave bands; the memory
+    * needed depends on the window length only
+    * @param dataSetId     identifier of the applicable dataset
+    * @param v             lateral position of the wheel track
+    * @param windowLength  min. length of the windows, rounded up to a power of 2
+    *                      of samples; 0.0 = 100 m (default)
+    * @param roughness     pointer to the resulting classification
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgDataSetCalcRoughness( int dataSetId, double v, double windowLength, CrgRoughnessStruct* roughness );
+
+/* ====== METHODS in crgPerfStat.c ====== */
+    /**
+    * get the performance counters accumulated over all threads
+    * @param perfStat   pointer to the structure receiving the counters
+    */
+    extern void crgPerfStatGet( CrgPerfStatStruct* perfStat );
+
+    /**
+    * reset the performance counters of all threads; counts of queries running
+    * concurrently in other threads may get lost
+    */
+    extern void crgPerfStatReset( void );
+
+    /**
+    * set the interval for sampling query latencies
+    * @param interval   time every n-th query, 0 turns sampling off (default)
+    */
+    extern void crgPerfStatSetSampling( int interval );
+
+    /**
+    * print the accumulated performance counters
+    */
+    extern void crgPerfStatPrint( void );
+
+    /**
+    * write the accumulated performance counters to a file
+    * @param filename   name of the target file, NULL for stdout
+    * @param format     output format [dCrgPerfStatFormatJSON, dCrgPerfStatFormatCSV]
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgPerfStatDump( const char* filename, int format );
+
+/* ====== METHODS in crgWriter.c ====== */
+    /**
+    * open a CRG file for writing its data record by record with a bounded amount
+    * of memory; the file describes a straight reference line starting at u = 0
+    * with equidistant long sections, and the end of the reference line is
+    * written when the file is closed
+    * @param filename     name of the file to be written
+    * @param format       data format [dCrgWriterFormatKRBI, dCrgWriterFormatKDBI, dCrgWriterFormatKRBZ]
+    * @param uInc         increment of the reference line
+    * @param vRight       v position of the rightmost (first) long section
+    * @param vInc         increment between the long sections
+    * @param noSections   number of long sections, i.e. values per record
+    * @return identifier of the writer if successful, otherwise 0
+    */
+    extern int crgWriterOpen( const char* filename, int format, double uInc, double vRight, double vInc, int noSections );
+    
+    /**
+    * add text to the comment block of the file; lines are truncated to 72
+    * characters and must not start with '$'
+    * @param writerId     identifier of the writer
+    * @param text         comment text, may consist of several lines
+    * @return 1 if successful, 0 if failed or if a record has been written already
+    */
+    extern int crgWriterAddComment( int writerId, const char* text );
+    
+    /**
+    * append a record, i.e. the z values of all long sections at the next u position;
+    * NaNs mark missing values
+    * @param writerId     identifier of the writer
+    * @param z            z values from the rightmost to the leftmost long section
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgWriterAppendRecord( int writerId, const double* z );
+    
+    /**
+    * complete and close the file; a file which could not be completed or which
+    * has less than 2 records is removed
+    * @param writerId     identifier of the writer
+    * @return 1 if the file has been written successfully, otherwise 0
+    */
+    extern int crgWriterClose( int writerId );
+
 /* ====== METHODS in crgPortability.c ====== */
     /**
     * print a message with a defined criticality level
@@ -590,5 +862,20 @@
     * @param func   pointer to the user-defined method accepting message level and text
     */
     extern void crgMsgSetCallback( int ( *func ) ( int level, char* message ) );
-    
+
+    /**
+    * start asynchronous message output: messages are queued in lock-free
+    * per-thread ring buffers and written (or passed to the message callback)
+    * by a background thread; messages are dropped if a thread's queue is full
+    * @return 1 if successful, 0 if not available (library built without
+    *         dCrgEnableMsgQueue) or if the output thread could not be started
+    */
+    extern int crgMsgQueueStart( void );
+
+    /**
+    * stop asynchronous message output after all queued messages have been
+    * written; subsequent messages are printed synchronously again
+    */
+    extern void crgMsgQueueStop( void );
+
 #endif /* _CRG_BASELIB_H */
@@ -0,0 +1,603 @@
+/* ===================================================
+ *  header-only C++17 interface on top of the
+ *  OpenCRG base library
+ * ---------------------------------------------------
+ *
+ * ASAM OpenCRG C API
+ *
+ * OpenCRG version:           1.2.0
+ *
+ * package:               baselib
+ * file name:             crgBaseLib.hpp
+ * author:                ASAM e.V.
+ *
+ *
+ * C by ASAM e.V., 2020
+ * Any use is limited to the scope described in the license terms.
+ * The license terms can be viewed at www.asam.net/license
+ *
+ * More Information on ASAM OpenCRG can be found here:
+ * https://www.asam.net/standards/detail/opencrg/
+ *
+ */
+#ifndef _CRG_BASELIB_HPP
+#define _CRG_BASELIB_HPP
+
+/* ====== INCLUSIONS ====== */
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>     /* must not be included with C linkage */
+#endif
+
+extern "C" {
+#include "crgBaseLib.h"
+#include "crgBaseLibPrivate.h"
+}
+
+namespace crg
+{
+
+/* ====== TYPE DEFINITIONS ====== */
+/**
+* non-owning view of a contiguous sequence (stand-in for std::span, which is C++20)
+*/
+template < typename T >
+class Span
+{
+public:
+    constexpr Span() noexcept : mData( nullptr ), mSize( 0 ) {}
+    constexpr Span( T* data, std::size_t size ) noexcept : mData( data ), mSize( size ) {}
+
+    template < typename U, typename A >
+    Span( std::vector< U, A >& vec ) noexcept : mData( vec.data() ), mSize( vec.size() ) {}
+
+    template < typename U, typename A >
+    Span( const std::vector< U, A >& vec ) noexcept : mData( vec.data() ), mSize( vec.size() ) {}
+
+    template < std::size_t N >
+    constexpr Span( T ( &arr )[N] ) noexcept : mData( arr ), mSize( N ) {}
+
+    constexpr T*          data() const noexcept { return mData; }
+    constexpr std::size_t size() const noexcept { return mSize; }
+    constexpr T& operator[]( std::size_t i ) const noexcept { return mData[i]; }
+
+private:
+    T*          mData;
+    std::size_t mSize;
+};
+
+/**
+* a CRG data set; owns the data set id and releases the data set on destruction
+*/
+class Road
+{
+public:
+    /**
+    * load a CRG file
+    * @param filename   full filename of the CRG input file including path
+    * @param prepare    if true, check the data and apply its modifiers (as done by the demo programs)
+    * @throw std::runtime_error if the file cannot be loaded or fails the check
+    */
+    explicit Road( const std::string& filename, bool prepare = true )
+        : mId( crgLoaderReadFile( filename.c_str() ) )
+    {
+        if ( mId <= 0 )
+            throw std::runtime_error( "crg::Road: could not load <" + filename + ">" );
+
+        if ( !prepare )
+            return;
+
+        if ( !crgCheck( mId ) )
+        {
+            crgDataSetRelease( mId );
+            throw std::runtime_error( "crg::Road: could not validate <" + filename + ">" );
+        }
+
+        crgDataSetModifiersApply( mId );
+    }
+
+    ~Road() { if ( mId > 0 ) crgDataSetRelease( mId ); }
+
+    Road( const Road& ) = delete;
+    Road& operator=( const Road& ) = delete;
+
+    Road( Road&& other ) noexcept : mId( std::exchange( other.mId, 0 ) ) {}
+
+    Road& operator=( Road&& other ) noexcept
+    {
+        if ( this != &other )
+        {
+            if ( mId > 0 )
+                crgDataSetRelease( mId );
+
+            mId = std::exchange( other.mId, 0 );
+        }
+        return *this;
+    }
+
+    int id() const noexcept { return mId; }
+
+    bool check() const noexcept { return crgCheck( mId ) != 0; }
+
+    void applyModifiers() const noexcept { crgDataSetModifiersApply( mId ); }
+
+    std::pair< double, double > uRange() const noexcept
+    {
+        std::pair< double, double > range( 0.0, 0.0 );
+        crgDataSetGetURange( mId, &range.first, &range.second );
+        return range;
+    }
+
+    std::pair< double, double > vRange() const noexcept
+    {
+        std::pair< double, double > range( 0.0, 0.0 );
+        crgDataSetGetVRange( mId, &range.first, &range.second );
+        return range;
+    }
+
+    CrgDataStruct* data() const noexcept { return crgDataSetAccess( mId ); }
+
+private:
+    int mId;
+};
+
+/**
+* a contact point on a road; owns the contact point id and deletes the contact point on destruction;
+* the road must outlive its contact points
+*/
+class ContactPoint
+{
+public:
+    /**
+    * @throw std::runtime_error if the contact point cannot be created
+    */
+    explicit ContactPoint( const Road& road )
+        : mId( crgContactPointCreate( road.id() ) )
+    {
+        if ( mId < 0 )
+            throw std::runtime_error( "crg::ContactPoint: could not create contact point" );
+
+        mCp = crgContactPointGetFromId( mId );
+    }
+
+    ~ContactPoint() { if ( mId >= 0 ) crgContactPointDelete( mId ); }
+
+    ContactPoint( const ContactPoint& ) = delete;
+    ContactPoint& operator=( const ContactPoint& ) = delete;
+
+    ContactPoint( ContactPoint&& other ) noexcept
+        : mId( std::exchange( other.mId, -1 ) ), mCp( std::exchange( other.mCp, nullptr ) ) {}
+
+    ContactPoint& operator=( ContactPoint&& other ) noexcept
+    {
+        if ( this != &other )
+        {
+            if ( mId >= 0 )
+                crgContactPointDelete( mId );
+
+            mId = std::exchange( other.mId, -1 );
+            mCp = std::exchange( other.mCp, nullptr );
+        }
+        return *this;
+    }
+
+    int id() const noexcept { return mId; }
+
+    CrgContactPointStruct* ptr() const noexcept { return mCp; }
+
+    bool setOption( unsigned int optionId, int value ) noexcept    { return crgContactPointOptionSetInt( mId, optionId, value ) != 0; }
+    bool setOption( unsigned int optionId, double value ) noexcept { return crgContactPointOptionSetDouble( mId, optionId, value ) != 0; }
+    bool setHistory( int histSize ) noexcept                       { return crgContactPointSetHistory( mId, histSize ) != 0; }
+
+    bool uv2z( double u, double v, double& z ) const noexcept             { return crgEvaluv2zPtr( mCp, u, v, &z ) != 0; }
+    bool xy2uv( double x, double y, double& u, double& v ) const noexcept { return crgEvalxy2uvPtr( mCp, x, y, &u, &v ) != 0; }
+    bool uv2xy( double u, double v, double& x, double& y ) const noexcept { return crgEvaluv2xy( mId, u, v, &x, &y ) != 0; }
+    bool xy2z( double x, double y, double& z ) const noexcept             { return crgEvalxy2z( mId, x, y, &z ) != 0; }
+
+    /**
+    * evaluate z for a batch of u/v positions
+    * @return number of successful evaluations; evaluation stops at the end of the shortest span
+    */
+    std::size_t uv2z( Span< const double > u, Span< const double > v, Span< double > z ) const noexcept
+    {
+        std::size_t n     = std::min( u.size(), std::min( v.size(), z.size() ) );
+        std::size_t noOk  = 0;
+
+        for ( std::size_t i = 0; i < n; i++ )
+            noOk += crgEvaluv2zPtr( mCp, u[i], v[i], &z[i] ) != 0;
+
+        return noOk;
+    }
+
+    /**
+    * transform a batch of x/y positions into u/v positions; successive positions should be
+    * close to each other, so that the history of the contact point is used efficiently
+    * @return number of successful evaluations
+    */
+    std::size_t xy2uv( Span< const double > x, Span< const double > y, Span< double > u, Span< double > v ) const noexcept
+    {
+        std::size_t n     = std::min( std::min( x.size(), y.size() ), std::min( u.size(), v.size() ) );
+        std::size_t noOk  = 0;
+
+        for ( std::size_t i = 0; i < n; i++ )
+            noOk += crgEvalxy2uvPtr( mCp, x[i], y[i], &u[i], &v[i] ) != 0;
+
+        return noOk;
+    }
+
+private:
+    int                    mId;
+    CrgContactPointStruct* mCp;
+};
+
+/**
+* z evaluation with the option branches of crgDataEvaluv2z() resolved at compile time;
+* the option values (border offsets, smoothing zones) are taken from the contact point
+* when the evaluator is constructed, later changes of the options are not seen;
+* precomputed cell coefficients (crgDataSetCellCoefsEnable()) are used as by the C
+* implementation; data sets with closed reference line or variably spaced v axis are
+* handed to the generic C implementation; performance counters are not updated
+* @tparam BorderU   border mode in u direction [dCrgBorderModeXXX]
+* @tparam BorderV   border mode in v direction [dCrgBorderModeXXX]
+* @tparam HasBank   true if the data set has banking
+* @tparam Smooth    true if a smoothing zone at begin and/or end is defined
+*/
+template < int BorderU, int BorderV, bool HasBank, bool Smooth >
+class Evaluator
+{
+    static_assert( BorderU >= dCrgBorderModeNone && BorderU <= dCrgBorderModeReflect, "invalid border mode in u direction" );
+    static_assert( BorderV >= dCrgBorderModeNone && BorderV <= dCrgBorderModeReflect, "invalid border mode in v direction" );
+
+public:
+    /**
+    * @throw std::invalid_argument if the options of the contact point or the data set
+    *                              do not match the template parameters
+    */
+    explicit Evaluator( const ContactPoint& cp )
+        : mData( cp.ptr()->crgData ), mOptions( &( cp.ptr()->options ) )
+    {
+        if ( !compatible( cp ) )
+            throw std::invalid_argument( "crg::Evaluator: template parameters do not match options of contact point" );
+
+        const unsigned int flags = mOptions->flags;
+
+        mOffsetU     = ( flags & dCrgOptFlagBorderOffsetU ) ? mOptions->entry[dCrgCpOptionBorderOffsetU].dValue : 0.0;
+        mOffsetV     = ( flags & dCrgOptFlagBorderOffsetV ) ? mOptions->entry[dCrgCpOptionBorderOffsetV].dValue : 0.0;
+        mSmoothBegin = ( flags & dCrgOptFlagSmoothUBegin )  ? mOptions->entry[dCrgCpOptionSmoothUBegin].dValue  : -1.0;
+        mSmoothEnd   = ( flags & dCrgOptFlagSmoothUEnd )    ? mOptions->entry[dCrgCpOptionSmoothUEnd].dValue    : -1.0;
+        mGeneric     = mData->util.uIsClosed || !( mData->admin.defMask & dCrgDataDefVIndex );
+    }
+
+    /**
+    * check whether the options of a contact point and its data set match the template parameters
+    */
+    static bool compatible( const ContactPoint& cp ) noexcept
+    {
+        const CrgContactPointStruct* ptr   = cp.ptr();
+        const unsigned int           flags = ptr->options.flags;
+        const int borderU = ( flags & dCrgOptFlagBorderModeU ) ? ptr->options.entry[dCrgCpOptionBorderModeU].iValue : dCrgBorderModeNone;
+        const int borderV = ( flags & dCrgOptFlagBorderModeV ) ? ptr->options.entry[dCrgCpOptionBorderModeV].iValue : dCrgBorderModeExKeep;
+        const bool smooth = ( flags & ( dCrgOptFlagSmoothUBegin | dCrgOptFlagSmoothUEnd ) ) != 0;
+
+        return borderU == BorderU && borderV == BorderV && smooth == Smooth && ( ptr->crgData->util.hasBank != 0 ) == HasBank;
+    }
+
+    /**
+    * evaluate z at a u/v position
+    * @return true if successful, false if the position is outside the data and border mode is none
+    */
+    bool uv2z( double u, double v, double& z ) const noexcept
+    {
+        if ( mGeneric )
+            return crgDataEvaluv2z( mData, mOptions, u, v, &z ) != 0;
+
+        const CrgDataStruct* d = mData;
+        const double uFirst = d->channelU.info.first;
+        const double uLast  = d->channelU.info.last;
+        const double uInc   = d->channelU.info.inc;
+        const double vFirst = d->channelV.info.first;
+        const double vLast  = d->channelV.info.last;
+        const double vInc   = d->channelV.info.inc;
+
+        std::size_t indexU = 0;
+        std::size_t indexV = 0;
+        bool   calcIndexU     = true;
+        bool   calcIndexV     = true;
+        bool   inCoreAreaU    = true;
+        bool   inCoreAreaV    = true;
+        bool   calcValue      = true;
+        bool   calcBank       = true;
+        int    calcSmoothBase = 0;
+        bool   calcSmooth     = false;
+        bool   cellDone       = false;
+        double fracU          = ( u - uFirst ) / uInc;
+        double fracV          = 0.0;
+        double zOffset        = 0.0;
+        double smoothScale    = 1.0;
+        double smoothBase     = 0.0;
+
+        z = 0.0;
+
+        /* --- u direction --- */
+        if ( ( u < uFirst ) || ( u > uLast ) )
+        {
+            inCoreAreaU = false;
+
+            if constexpr ( BorderU == dCrgBorderModeNone )
+                return false;
+            else if constexpr ( BorderU == dCrgBorderModeExKeep )
+            {
+                if ( fracU < 0.0 )
+                {
+                    fracU          = 0.0;
+                    calcIndexU     = false;
+                    calcSmoothBase = 1;
+                }
+                else
+                    calcSmoothBase = 2;
+            }
+            else if constexpr ( BorderU == dCrgBorderModeExZero )
+            {
+                calcValue      = false;
+                calcBank       = false;
+                calcSmoothBase = ( fracU < 0.0 ) ? 1 : 2;
+            }
+            else if constexpr ( BorderU == dCrgBorderModeRepeat )
+            {
+                double maxFrac = ( uLast - uFirst ) / uInc;
+
+                fracU = std::fmod( ( u - uFirst ) / uInc, maxFrac );
+
+                if ( fracU < 0.0 )
+                    fracU += maxFrac;
+
+                inCoreAreaU = true;
+                u = uFirst + fracU * uInc;
+            }
+            else
+            {
+                double uSize   = uLast - uFirst;
+                double maxFrac = uSize / uInc;
+                int    repSeq  = ( int ) ( ( u - uFirst ) / uSize );
+
+                fracU  = std::fabs( fracU );
+                fracU -= std::abs( repSeq ) * maxFrac;
+
+                if ( std::abs( repSeq ) % 2 )
+                    fracU = maxFrac - fracU;
+
+                inCoreAreaU = true;
+                u = uFirst + fracU * uInc;
+            }
+
+            zOffset += mOffsetU;
+        }
+
+        if ( calcIndexU )
+        {
+            if ( fracU < 0.0 )
+                fracU = 0.0;
+
+            indexU = ( std::size_t ) fracU;
+
+            if ( indexU >= d->channelU.info.size - 1 )
+            {
+                indexU = d->channelU.info.size - 2;
+                fracU  = 1.0;
+            }
+            else
+                fracU -= indexU;
+        }
+
+        /* --- v direction (constantly spaced) --- */
+        fracV = ( v - vFirst ) / vInc;
+
+        if ( ( v < vFirst ) || ( v > vLast ) )
+        {
+            inCoreAreaV = false;
+
+            if constexpr ( BorderV == dCrgBorderModeNone )
+                return false;
+            else if constexpr ( BorderV == dCrgBorderModeExKeep )
+            {
+                if ( fracV < 0.0 )
+                {
+                    fracV      = 0.0;
+                    calcIndexV = false;
+                }
+            }
+            else if constexpr ( BorderV == dCrgBorderModeExZero )
+                calcValue = false;
+            else if constexpr ( BorderV == dCrgBorderModeRepeat )
+            {
+                double maxFrac = ( vLast - vFirst ) / vInc;
+
+                fracV = std::fmod( ( v - vFirst ) / vInc, maxFrac );
+
+                if ( fracV < 0.0 )
+                    fracV += maxFrac;
+
+                inCoreAreaV = true;
+                v = vFirst + fracV * vInc;
+            }
+            else
+            {
+                double vSize   = vLast - vFirst;
+                double maxFrac = vSize / vInc;
+                int    repSeq  = ( int ) ( ( v - vFirst ) / vSize );
+
+                fracV  = std::fabs( fracV );
+                fracV -= std::abs( repSeq ) * maxFrac;
+
+                if ( std::abs( repSeq ) % 2 )
+                    fracV = maxFrac - fracV;
+
+                inCoreAreaV = true;
+                v = vFirst + fracV * vInc;
+            }
+
+            zOffset += mOffsetV;
+        }
+
+        if ( calcIndexV )
+        {
+            if ( fracV < 0.0 )
+                fracV = 0.0;
+
+            indexV = ( std::size_t ) fracV;
+
+            if ( indexV >= d->channelV.info.size - 1 )
+            {
+                indexV = d->channelV.info.size - 2;
+                fracV  = 1.0;
+            }
+            else
+                fracV -= indexV;
+        }
+
+        /* --- precomputed cell coefficients, incl. reference line z and banking (see crgDataEvaluv2z()) --- */
+        if ( calcValue && d->cellCoefs.coef && ( !HasBank || BorderV == dCrgBorderModeExKeep || ( v >= vFirst && v <= vLast ) ) )
+        {
+            const double* c = d->cellCoefs.coef + 4 * ( indexV * d->cellCoefs.noCellsU + indexU );
+
+            z         = c[0] + fracU * c[1] + fracV * ( c[2] + fracU * c[3] );
+            cellDone  = true;
+            calcValue = false;
+        }
+
+        /* --- bilinear interpolation --- */
+        if ( calcValue )
+        {
+            const float* zLo = d->channelZ[indexV].data   + indexU;
+            const float* zHi = d->channelZ[indexV+1].data + indexU;
+            double z00 = zLo[0];
+            double z10 = zLo[1] - z00;
+            double z01 = zHi[0];
+            double z11 = zHi[1] - ( z10 + z01 );
+
+            z01 -= z00;
+
+            z  = ( z11 * fracV + z10 ) * fracU + z01 * fracV + z00;
+            z += d->channelZ[indexV].info.mean;
+        }
+
+        /* --- smoothing zones --- */
+        if constexpr ( Smooth )
+        {
+            if ( inCoreAreaU || calcSmoothBase )
+            {
+                if ( mSmoothBegin >= 0.0 && ( u - uFirst ) <= mSmoothBegin )
+                {
+                    smoothScale    = ( u < uFirst ) ? 0.0 : ( u - uFirst ) / mSmoothBegin;
+                    calcSmoothBase = 1;
+                    calcSmooth     = true;
+                }
+
+                if ( mSmoothEnd >= 0.0 && ( uLast - u ) <= mSmoothEnd )
+                {
+                    smoothScale    = ( u > uLast ) ? 0.0 : ( uLast - u ) / mSmoothEnd;
+                    calcSmoothBase = 2;
+                    calcSmooth     = true;
+                }
+            }
+
+            if ( calcSmoothBase == 1 )
+                smoothBase += d->channelRefZ.info.valid ? d->channelRefZ.data[0] : d->channelRefZ.info.first;
+            else if ( calcSmoothBase == 2 )
+                smoothBase += d->channelRefZ.info.valid ? d->channelRefZ.data[d->channelRefZ.info.size-1] : d->channelRefZ.info.last;
+        }
+
+        if ( fracU < 0.0 )
+            fracU = 0.0;
+        else if ( fracU > 1.0 )
+            fracU = 1.0;
+
+        /* --- reference line z and banking --- */
+        if ( cellDone )
+            ;   /* --- already contained in cell coefficients --- */
+        else if ( d->channelRefZ.info.valid )
+            z += d->channelRefZ.data[indexU] + fracU * ( d->channelRefZ.data[indexU+1] - d->channelRefZ.data[indexU] );
+        else
+            z += d->channelRefZ.info.first;
+
+        if constexpr ( HasBank )
+        {
+            if ( calcBank && !cellDone )
+            {
+                double bank;
+
+                if ( d->channelBank.info.valid )
+                    bank = d->channelBank.data[indexU] + fracU * ( d->channelBank.data[indexU+1] - d->channelBank.data[indexU] );
+                else
+                    bank = d->channelBank.info.first;
+
+                if ( v < vFirst )
+                    v = vFirst;
+                else if ( v > vLast )
+                    v = vLast;
+
+                z += bank * v;
+            }
+        }
+
+        /* --- border offsets --- */
+        if ( !inCoreAreaU )
+        {
+            if constexpr ( BorderU == dCrgBorderModeExZero )
+                z = zOffset;
+            else if constexpr ( BorderU == dCrgBorderModeExKeep )
+                z += zOffset;
+        }
+        else if ( !inCoreAreaV )
+        {
+            if constexpr ( BorderV == dCrgBorderModeExZero )
+                z = zOffset;
+            else if constexpr ( BorderV == dCrgBorderModeExKeep )
+                z += zOffset;
+        }
+
+        if constexpr ( Smooth )
+        {
+            if ( calcSmooth )
+                z = smoothBase + ( z - smoothBase ) * smoothScale;
+        }
+
+        return true;
+    }
+
+    /**
+    * evaluate z for a batch of u/v positions
+    * @return number of successful evaluations; evaluation stops at the end of the shortest span
+    */
+    std::size_t uv2z( Span< const double > u, Span< const double > v, Span< double > z ) const noexcept
+    {
+        std::size_t n    = std::min( u.size(), std::min( v.size(), z.size() ) );
+        std::size_t noOk = 0;
+
+        for ( std::size_t i = 0; i < n; i++ )
+            noOk += uv2z( u[i], v[i], z[i] );
+
+        return noOk;
+    }
+
+private:
+    CrgDataStruct*    mData;
+    CrgOptionsStruct* mOptions;
+    double            mOffsetU;
+    double            mOffsetV;
+    double            mSmoothBegin;   /* length of smoothing zone at begin, < 0 if not defined [m] */
+    double            mSmoothEnd;     /* length of smoothing zone at end, < 0 if not defined   [m] */
+    bool              mGeneric;       /* use crgDataEvaluv2z() for this data set                  */
+};
+
+} /* namespace crg */
+
+#endif /* _CRG_BASELIB_HPP */
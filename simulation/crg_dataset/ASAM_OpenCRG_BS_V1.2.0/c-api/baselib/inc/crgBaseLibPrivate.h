@@ -28,29 +28,144 @@
 /* include the public part */
 #include "crgBaseLib.h"
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 /* ====== DEFINITIONS ====== */
 
 /**
-* enable CRG statistics calculations?
+* enable asynchronous message output? Messages are then queued in per-thread
+* ring buffers and written by a background thread (requires POSIX threads,
+* link with -lpthread)
+*/
+/* #define dCrgEnableMsgQueue */
+
+/**
+* enable multi-threaded evaluation of grids? The rows of a grid and the
+* blocks of a compressed data section are then shared by several threads,
+* see crgEvalGridUV() (requires POSIX threads, link with -lpthread)
+*/
+/* #define dCrgEnableThreads */
+
+/**
+* highest message level compiled into the library; messages issued via
+* dCrgMsgInfo() and dCrgMsgDebug() above this level are removed by the
+* pre-processor
+*/
+#ifndef dCrgMsgCompileLevel
+#define dCrgMsgCompileLevel  dCrgMsgLevelDebug
+#endif
+
+/**
+* message queue: number of entries per thread and max. length of a queued message
+*/
+#define dCrgMsgQueueSize     256
+#define dCrgMsgQueueTextLen  256
+
+/**
+* thread-local storage for per-thread data (performance counters); compilers
+* without support share the data between all threads
+*/
+#if defined(__GNUC__)
+#define dCrgThreadLocal  __thread
+#elif defined(_MSC_VER)
+#define dCrgThreadLocal  __declspec(thread)
+#else
+#define dCrgThreadLocal
+#endif
+
+/**
+* atomic operations on data which may be shared between threads
+*/
+#if defined(__GNUC__)
+#define dCrgAtomicIncrement( ptr )              __sync_add_and_fetch( ( ptr ), 1 )
+#define dCrgAtomicCas( ptr, oldVal, newVal )    __sync_bool_compare_and_swap( ( ptr ), ( oldVal ), ( newVal ) )
+#define dCrgAtomicCasPtr( ptr, oldVal, newVal ) __sync_bool_compare_and_swap( ( ptr ), ( oldVal ), ( newVal ) )
+#define dCrgMemBarrier()                        __sync_synchronize()
+#elif defined(_MSC_VER)
+#define dCrgAtomicIncrement( ptr )              _InterlockedIncrement( ( ptr ) )
+#define dCrgAtomicCas( ptr, oldVal, newVal )    ( _InterlockedCompareExchange( ( ptr ), ( newVal ), ( oldVal ) ) == ( oldVal ) )
+#define dCrgAtomicCasPtr( ptr, oldVal, newVal ) ( _InterlockedCompareExchangePointer( ( void* volatile* ) ( ptr ), ( newVal ), ( oldVal ) ) == ( oldVal ) )
+#define dCrgMemBarrier()                        _ReadWriteBarrier()
+#else
+#define dCrgAtomicIncrement( ptr )              ( ++( *( ptr ) ) )
+#define dCrgAtomicCas( ptr, oldVal, newVal )    ( ( *( ptr ) = ( newVal ) ), 1 )
+#define dCrgAtomicCasPtr( ptr, oldVal, newVal ) ( ( *( ptr ) = ( newVal ) ), 1 )
+#define dCrgMemBarrier()
+#endif
+
+/**
+* rate limitation of repeated warnings: number of messages printed without
+* restriction, afterwards only every n-th message is printed
 */
-/* #define dCrgEnableStats */
+#define dCrgMsgRateBurst        10
+#define dCrgMsgRateInterval   1000
 
 /**
 * CRG history, default size
 */
 #define dCrgHistoryStdSize  50
 
+/**
+* CRG history, default search criteria (see dCrgCpOptionRefLineClose, dCrgCpOptionRefLineFar)
+*/
+#define dCrgHistoryStdClose  0.3
+#define dCrgHistoryStdFar    2.2
+
 /**
 * CRG v index table, default size
 */
 #define dCrgVTableStdSize  200
 
+/**
+* compressed data sections (data format KRBZ): size of the trailer, target
+* size of the decoded records of a block and max. size of an encoded block
+*/
+#define dCrgCompressTrailerSize     16
+#define dCrgCompressBlockSize    65536
+#define dCrgCompressBlockBound( noRecords, noChannels )  ( ( noChannels ) * ( 1 + 5 * ( noRecords ) ) )
+
 /**
 * CRG options data type
 */
 #define dCrgOptionDataTypeInt       0
 #define dCrgOptionDataTypeDouble    1
 
+/**
+* CRG options, pre-computed flags of the options evaluated during each query
+* (see CrgOptionsStruct.flags)
+*/
+#define dCrgOptFlagBorderModeU      0x0001   /* border mode u is set                                    */
+#define dCrgOptFlagBorderModeV      0x0002   /* border mode v is set                                    */
+#define dCrgOptFlagBorderOffsetU    0x0004   /* offset at u border is set                               */
+#define dCrgOptFlagBorderOffsetV    0x0008   /* offset at v border is set                               */
+#define dCrgOptFlagSmoothUBegin     0x0010   /* smoothing zone at begin is set                          */
+#define dCrgOptFlagSmoothUEnd       0x0020   /* smoothing zone at end is set                            */
+#define dCrgOptFlagCloseTrack       0x0040   /* refline continuation mode is dCrgRefLineCloseTrack      */
+#define dCrgOptFlagCurvLateral      0x0080   /* curvature mode is dCrgCurvLateral                       */
+#define dCrgOptFlagRealTime         0x0100   /* real-time mode with step limit > 0 is set               */
+
+/**
+* cached result of data set validation (see crgCheck())
+*/
+#define dCrgCheckStateNone          0        /* data set has not been checked or has changed since  */
+#define dCrgCheckStatePassed        1        /* last check succeeded                                */
+#define dCrgCheckStateFailed        2        /* last check failed                                   */
+
+/**
+* size of a cache line; contact points and their histories are aligned to
+* cache lines so that contact points used by different threads don't share any
+*/
+#define dCrgCacheLineSize  64
+
+/**
+* number of u samples processed as one tile when sweeping across all v channels
+* of the z data (e.g. NaN handling); each v channel contributes one contiguous
+* block of the tile, which should fit into the first level cache
+*/
+#define dCrgGridTileSize  256
+
 /**
 * maximum tolerated relative error
 */
@@ -75,6 +190,38 @@
 #define dCrgDataDefZEnd               0x0040
 #define dCrgDataDefZStart             0x0080
 
+/**
+* conditional message output for hot code paths; arguments are the complete
+* argument list of crgMsgPrint() in parentheses (ANSI C knows no variadic
+* macros), e.g. dCrgMsgDebug( ( dCrgMsgLevelDebug, "value = %d\n", i ) );
+* the level is checked before any argument is evaluated or formatted
+*/
+#define dCrgMsgIfActive( level, args )  ( ( ( level ) <= mCrgMsgLevel ) ? crgMsgPrint args : ( void ) 0 )
+
+#if dCrgMsgCompileLevel >= dCrgMsgLevelInfo
+#define dCrgMsgInfo( args )   dCrgMsgIfActive( dCrgMsgLevelInfo, args )
+#else
+#define dCrgMsgInfo( args )   ( ( void ) 0 )
+#endif
+
+#if dCrgMsgCompileLevel >= dCrgMsgLevelDebug
+#define dCrgMsgDebug( args )  dCrgMsgIfActive( dCrgMsgLevelDebug, args )
+#else
+#define dCrgMsgDebug( args )  ( ( void ) 0 )
+#endif
+
+/**
+* NaN test for float values inside the loops over grid data; unlike crgIsNanf()
+* this is a plain float compare which the compiler may vectorize
+* NOTE: don't compile with options breaking IEEE compliance (e.g. -ffast-math)
+*/
+#define dCrgIsNanf( val )  ( ( val ) != ( val ) )
+
+/**
+* access to the performance counters of the calling thread
+*/
+#define dCrgPerfStatLocal()  ( mCrgPerfStatLocal ? mCrgPerfStatLocal : crgPerfStatRegister() )
+
 /* ====== TYPE DEFINITIONS ====== */
 /** 
 * this structure stores administrative information about a single CRG file
@@ -90,6 +237,10 @@ typedef struct
     int     defMask;      /* mask of defined data in header section         [-] */
     size_t  recordSize;   /* size of a single data record                [byte] */
     int     sectionType;  /* temporarily used while reading file            [-] */
+    int     checkState;   /* cached result of crgCheck()    [dCrgCheckStateXXX] */
+    unsigned int checkRevOptions;   /* revision of options at last check    [-] */
+    unsigned int checkRevModifiers; /* revision of modifiers at last check  [-] */
+    int     modifiersApplied;       /* modifiers have been applied to the data  [0/1] */
 } CrgAdminStruct;
 
 /** 
@@ -156,21 +307,6 @@ typedef struct
     size_t index;   /* index of the inertial position in x/y data channels    [-] */
 } CrgHistoryEntryStruct;
 
-/** 
-* structure for statistics about history use etc.
-*/
-typedef struct
-{
-    short        active;            /* is history statistics active?          [0/1] */
-    unsigned int noTotalQueries;    /* total number of queries to history       [-] */
-    unsigned int noCloseHits;       /* total hits in close distance             [-] */
-    unsigned int noFarHits;         /* total hits in far distance               [-] */
-    unsigned int noNoHits;          /* total tests without hit                  [-] */
-    unsigned int noIter;            /* total number of iterations in history    [-] */
-    unsigned int noCallsLoop1;      /* total number of calls to loop 1          [-] */
-    unsigned int noCallsLoop2;      /* total number of calls to loop 2          [-] */
-} CrgHistoryStatStruct;
-
 /** 
 * structure for information about query history for faster access
 */
@@ -182,21 +318,19 @@ typedef struct
     double closeDist;               /* square of a distance considered 'close' to a point in history [m2] */
     double farDist;                 /* square of a distance considered 'far' to a point in history   [m2] */
     CrgHistoryEntryStruct* entry;   /* entries of the history, dynamically allocated                  [-] */
-    CrgHistoryStatStruct   stat;    /* statistics information about history use                       [-] */
 } CrgHistoryStruct;
 
 /** 
-* structure for performance measurement data
+* per-thread performance counters, registered in a global list for accumulation;
+* the counters of terminated threads are added to the totals and their blocks
+* are re-used (see crgPerfStat.c)
 */
-typedef struct
+typedef struct CrgPerfStatThreadStruct
 {
-    short        active;            /* is performance statistics active?          [0/1] */
-    unsigned int noTotalQueries;    /* total number of queries to history           [-] */
-    unsigned int noCallsLoopV1;     /* total number of calls to a given loop        [-] */
-    unsigned int maxCallsLoopV1;    /* maximum number of calls to a given loop      [-] */
-    unsigned int noCallsBorderU;    /* total number of calls to borderU mode        [-] */
-    unsigned int noCallsBorderV;    /* total number of calls to borderV mode        [-] */
-} CrgPerformanceStruct;
+    CrgPerfStatStruct               counters;    /* the actual counters                                  [-] */
+    unsigned long                   sampleCtr;   /* queries since the last latency sample                [-] */
+    struct CrgPerfStatThreadStruct* next;        /* next entry in list of all threads' counters          [-] */
+} CrgPerfStatThreadStruct;
 
 /**
 * a structure holding settings for one option
@@ -211,13 +345,29 @@ typedef struct
     int           valid;                /* validity of the option                                         [-] */
 } CrgOptionEntryStruct;
 
+/**
+* an immutable snapshot of option entries which is shared by several option lists;
+* a list sharing the block copies the entries before modifying them
+*/
+typedef struct
+{
+    int          refCount;              /* number of references to the block                              [-] */
+    unsigned int noEntries;             /* number of option entries                                       [-] */
+    unsigned int flags;                 /* flags of the source list                       [dCrgOptFlagXXX] */
+    unsigned int revision;              /* revision of the source list                                    [-] */
+    CrgOptionEntryStruct* entry;        /* list of option entries                                         [-] */
+} CrgOptionBlockStruct;
+
 /**
 * a structure holding all option settings for data evaluation etc.
 */
 typedef struct
 {
     unsigned int noEntries;             /* number of available options (size of option entry list)        [-] */
+    unsigned int flags;                 /* flags of the options used during queries       [dCrgOptFlagXXX] */
+    unsigned int revision;              /* incremented with each change of the list                       [-] */
     CrgOptionEntryStruct* entry;        /* list of option entries                                         [-] */
+    CrgOptionBlockStruct* shared;       /* block the entries belong to; NULL if the list owns the entries  [-] */
 } CrgOptionsStruct;
 
 /**
@@ -233,6 +383,19 @@ typedef struct
     size_t refIdx[dCrgVTableStdSize];   /* the index table itself                                             [-] */
 } CrgIndexTable;
 
+/**
+* bilinear coefficients of all grid cells, with the mean value of the z channel, the
+* reference line elevation and the banking folded in; within cell ( i, j ) the elevation is
+* z = c[0] + fracU * c[1] + fracV * ( c[2] + fracU * c[3] )
+*/
+typedef struct
+{
+    double* coef;                       /* 4 coefficients per cell, u index running fastest, aligned   [m] */
+    size_t  noCellsU;                   /* number of cells in u direction                               [-] */
+    size_t  noCellsV;                   /* number of cells in v direction                               [-] */
+    int     enabled;                    /* keep coefficients up to date when the data set changes     [0/1] */
+} CrgCellCoefStruct;
+
 /**
 * now the complete structure composed of the previous sub-structures
 */
@@ -252,15 +415,20 @@ typedef struct
     CrgOptionsStruct     modifiers;                   /* list of modifiers to be applied on the data set                              [-] */
     CrgOptionsStruct     options;                     /* list of default options for new contact points                               [-] */
     CrgUtilityStruct     util;                        /* utility information, also used for increased performance                     [-] */
-    CrgPerformanceStruct perfStat;                    /* data for performance statistics                                              [-] */
     CrgIndexTable        indexTableV;                 /* an index table for faster access to v indices in irregularly spaced v grids  [-] */
+    CrgCellCoefStruct    cellCoefs;                   /* optional pre-computed interpolation coefficients of the grid cells           [-] */
+    CrgOptionBlockStruct* cpOptions;                  /* snapshot of the options, shared by new contact points                        [-] */
+    struct CrgReloadStruct* reload;                   /* file checksums and decoded data for crgDataSetReload(), owned by the loader  [-] */
 } CrgDataStruct;
 
 /**
-* a structure holding contact point information (and providing additional memory for queries)
+* a structure holding contact point information (and providing additional memory for queries);
+* members written or read by each query come first, the structure is allocated aligned to a
+* cache line and padded to a multiple of it (see crgPortCallocAligned())
 */
 typedef struct
 {
+    /* --- hot: written / read by every query --- */
     double x;                          /* inertial x position                                             [m] */
     double y;                          /* inertial y position                                             [m] */
     double u;                          /* local u position                                                [m] */
@@ -269,12 +437,17 @@ typedef struct
     double phi;                        /* heading at the given position                                 [rad] */
     double curv;                       /* curvature at the given position                               [1/m] */  
     CrgDataStruct*        crgData;     /* pointer to the CRG data on which contact point is working           */
+    CrgHistoryStruct      history;     /* history for successive queries                                  [-] */
+    CrgOptionsStruct      options;     /* list of options to be applied when using the contact point      [-] */
+    int           rtStatus;            /* real-time status of the latest x/y query         [dCrgRtStatusXXX] */
+    unsigned long rtNoDegraded;        /* number of real-time queries with reduced accuracy               [-] */
+    
+    /* --- cold: rarely or never used during queries --- */
     int useLocalHistory;               /* use local history of contact point instead of global one      [0/1] */
     CrgHistoryEntryStruct histEntry;   /* information about the previous query                                */
-    CrgOptionsStruct      options;     /* list of options to be applied when using the contact point      [-] */
-    CrgHistoryStruct      history;     /* history for successive queries                                  [-] */
     double smoothBaseBeg;              /* base value for smoothing at the begin of the data set           [m] */
     double smoothBaseEnd;              /* base value for smoothing at the end of the data set             [m] */
+    void*  poolNext;                   /* next unused contact point in the pool                               */
 } CrgContactPointStruct;
 
 /**
@@ -294,6 +467,9 @@ typedef union
 
 /* ====== GLOBAL VARIABLES ====== */
 extern int mCrgBigEndian;             /* endian-ness of machine */
+extern int mCrgMsgLevel;              /* current maximum message level */
+extern int mCrgPerfStatSampling;      /* latency sampling interval, 0 = off */
+extern dCrgThreadLocal CrgPerfStatThreadStruct* mCrgPerfStatLocal;  /* performance counters of the calling thread */
 
 
 /* ====== METHODS in crgLoader.c ====== */
@@ -327,10 +503,54 @@ extern int mCrgBigEndian;             /* endian-ness of machine */
     */
     extern int crgCheckMods( CrgDataStruct* crgData );
 
+    /**
+    * release the information kept by the loader for reloading a data set
+    * @param crgData    pointer to the CRG data set
+    */
+    extern void crgLoaderReleaseReload( CrgDataStruct* crgData );
+
+
+/* ====== METHODS in crgPerfStat.c ====== */
+    /**
+    * create and register the performance counters of the calling thread;
+    * use dCrgPerfStatLocal() for accessing the counters
+    * @return pointer to the counters of the calling thread (fallback: shared counters)
+    */
+    extern CrgPerfStatThreadStruct* crgPerfStatRegister( void );
+    
+    /**
+    * add counters which were collected outside of the registered ones (e.g.
+    * by the worker threads of crgEvalGridUV()) to the counters of a thread
+    * @param perf       counters of the calling thread
+    * @param counters   counters to be added
+    */
+    extern void crgPerfStatAdd( CrgPerfStatThreadStruct* perf, const CrgPerfStatStruct* counters );
+    
+    /**
+    * release the counters of all threads; no other thread may evaluate data
+    * while this is called
+    */
+    extern void crgPerfStatRelease( void );
+    
+    /**
+    * decide whether the current query of the calling thread is to be timed
+    * @param perf   performance counters of the calling thread
+    * @return 1 if the query is a latency sample, otherwise 0
+    */
+    extern int crgPerfStatSampleQuery( CrgPerfStatThreadStruct* perf );
+    
+    /**
+    * add a latency sample to a histogram
+    * @param histogram  histogram with dCrgPerfStatNoBins entries
+    * @param duration   duration of the query                                   [ns]
+    */
+    extern void crgPerfStatAddLatency( unsigned long* histogram, double duration );
 
 /* ====== METHODS in crgStatistics.c ====== */
     /**
-    * calculate some statistics data for a given CRG data set
+    * calculate some statistics data for a given CRG data set; the elevation
+    * statistics (zMin, zMax, zMeanBeg, zMeanEnd) are collected by the loader
+    * while normalizing the z data and are only reported here
     * @param crgData    pointer to data set which is to be analyzed
     */
     extern void crgCalcStatistics( CrgDataStruct *crgData );
@@ -387,6 +607,13 @@ extern int mCrgBigEndian;             /* endian-ness of machine */
     * @param dataSetId    ID of the applicable data set
     */
     void crgDataSetBuildVTable( int dataSetId );
+    
+    /**
+    * (re-)compute the interpolation coefficients of all grid cells of a data set
+    * @param crgData    pointer to the applicable data set
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgDataCalcCellCoefs( CrgDataStruct* crgData );
 
     
 /* ====== METHODS in crgMsg.c ====== */
@@ -450,6 +677,13 @@ extern int mCrgBigEndian;             /* endian-ness of machine */
     */
     extern int crgContactPointPtrSetHistory( CrgContactPointStruct *cp, int histSize );
     
+    /**
+    * allocate the history of a contact point on first use
+    * @param  cp          pointer to the contact point
+    * @return 1 if the history is available, otherwise 0
+    */
+    extern int crgContactPointPtrAllocHistory( CrgContactPointStruct *cp );
+    
     /**
     * set the size and basic parameters of all contact points referring to a
     * given CRG data set
@@ -459,6 +693,13 @@ extern int mCrgBigEndian;             /* endian-ness of machine */
     */
     extern int crgContactPointSetHistoryForDataSet( CrgDataStruct *crgData, int histSize );
 
+    /**
+    * forget the previous queries of all contact points referring to a given
+    * CRG data set, e.g. after its data has been replaced
+    * @param  crgData     pointer to the applicable CRG data set
+    */
+    extern void crgContactPointClearHistoryForDataSet( CrgDataStruct *crgData );
+
     /**
     * pre-load reference line history with data at given u value
     * @param cp         pointer to the contact point which is to be modified
@@ -474,25 +715,27 @@ extern int mCrgBigEndian;             /* endian-ness of machine */
     extern void crgContactPointPreloadHistoryUFrac( CrgContactPointStruct *cp, double uFrac );
     
     /**
-    * activate the performance statistics
+    * deprecated: statistics are no longer kept per contact point, the
+    * counters of all threads are always active; use crgPerfStatReset() and
+    * crgPerfStatGet() instead. Prints a warning and does nothing else.
     * @param  cpId  id of the contact point whose statistics is to be activated
     */
     extern void crgContactPointActivatePerfStat( int cpId );
     
     /**
-    * deactivate the performance statistics
+    * deprecated, see crgContactPointActivatePerfStat()
     * @param  cpId  id of the contact point whose statistics is to be deactivated
     */
     extern void crgContactPointDeActivatePerfStat( int cpId );
     
     /**
-    * reset the performance statistics
+    * deprecated, see crgContactPointActivatePerfStat()
     * @param  cp  pointer to the contact point which is to be modified
     */
     extern void crgContactPointResetPerfStat( CrgContactPointStruct *cp );
     
     /**
-    * print the performance statistics
+    * print the performance statistics (counters of all threads)
     * @param  cpId  id of the contact point whose information is to be printed
     */
     extern void crgContactPointPrintPerfStat( int cpId );
@@ -600,6 +843,13 @@ extern int mCrgBigEndian;             /* endian-ness of machine */
     * @return 1 if option is available and valid and has the given value, otherwise 0
     */
     extern int crgOptionHasValueInt( CrgOptionsStruct* optionList, unsigned int optionId, int optionValue );
+
+    /**
+    * re-compute the flags of the options which are used during queries;
+    * must be called whenever the entries of an option list have been altered
+    * @param  optionList   pointer to a list holding all applicable options
+    */
+    extern void crgOptionUpdateFlags( CrgOptionsStruct* optionList );
     
     /**
     * set the default options to be applied when using a contact point for data
@@ -629,6 +879,33 @@ extern int mCrgBigEndian;             /* endian-ness of machine */
     */
     extern int crgOptionCreateList( CrgOptionsStruct* optionList );
     
+    /**
+    * release the entries of an option list, i.e. free them or drop the reference
+    * to a shared block
+    * @param  optionList   pointer to the list whose entries shall be released
+    */
+    extern void crgOptionReleaseList( CrgOptionsStruct* optionList );
+    
+    /**
+    * create an immutable snapshot of an option list
+    * @param  src          list whose entries shall be copied
+    * @return pointer to the block (one reference held by the caller) or NULL
+    */
+    extern CrgOptionBlockStruct* crgOptionBlockCreate( CrgOptionsStruct* src );
+    
+    /**
+    * drop a reference to a shared option block, free it with the last reference
+    * @param  block        pointer to the block (may be NULL)
+    */
+    extern void crgOptionBlockRelease( CrgOptionBlockStruct* block );
+    
+    /**
+    * let an option list use the entries of a shared block until it is modified
+    * @param  optionList   pointer to the list which shall share the block
+    * @param  block        pointer to the block
+    */
+    extern void crgOptionShare( CrgOptionsStruct* optionList, CrgOptionBlockStruct* block );
+    
 /* ====== METHODS in crgEvalxy2uv.c ====== */
     /**
     * convert a given (x,y) position into the corresponding (u,v) position
@@ -709,6 +986,54 @@ extern int mCrgBigEndian;             /* endian-ness of machine */
     */
     extern int crgDataEvaluv2pk( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u, double v, double* phi, double* curv );
 
+/* ====== METHODS in crgCompress.c ====== */
+    /**
+    * encode a block of single precision binary records for a compressed data section
+    * @param records      records in big endian byte order
+    * @param noRecords    number of records of the block
+    * @param noChannels   number of values per record
+    * @param tgt          target buffer of at least dCrgCompressBlockBound( noRecords, noChannels ) bytes
+    * @return size of the encoded block, 0 if failed
+    */
+    extern size_t crgCompressEncodeBlock( const unsigned char* records, size_t noRecords, size_t noChannels, unsigned char* tgt );
+
+    /**
+    * encode the index and the trailer which complete a compressed data section
+    * @param blockEnd     offset of the end of each block in the data section
+    * @param noBlocks     number of blocks
+    * @param noRecords    total number of records
+    * @param blockRecords number of records per block
+    * @param tgt          target buffer of at least 4 * noBlocks + dCrgCompressTrailerSize bytes
+    * @return size of the index and the trailer
+    */
+    extern size_t crgCompressEncodeIndex( const size_t* blockEnd, size_t noBlocks, size_t noRecords, size_t blockRecords, unsigned char* tgt );
+
+    /**
+    * check the index of a compressed data section and get its number of records
+    * @param data         the compressed data section
+    * @param size         size of the data section
+    * @param noRecords    pointer to the resulting number of records
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgCompressGetNoRecords( const char* data, size_t size, size_t* noRecords );
+
+    /**
+    * decode a compressed data section into single precision binary records;
+    * the blocks are decoded in parallel if dCrgEnableThreads is defined
+    * @param data         the compressed data section
+    * @param size         size of the data section
+    * @param noChannels   number of values per record
+    * @param records      target buffer for the records in big endian byte order
+    * @return 1 if successful, otherwise 0
+    */
+    extern int crgCompressDecode( const char* data, size_t size, size_t noChannels, unsigned char* records );
+
+/* ====== METHODS in crgWriter.c ====== */
+    /**
+    * complete and close all open writers
+    */
+    extern void crgWriterCloseAll( void );
+
 /* ====== METHODS in crgPortability.c ====== */
     /**
     * set the maximum level of messages that will be handled,
@@ -738,6 +1063,35 @@ extern int mCrgBigEndian;             /* endian-ness of machine */
     * @return 0 if message of the given level may be printed
     */
     extern int crgPortMsgIsPrintable( int level );
+    
+    /**
+    * rate limitation for messages which may be issued at high frequency
+    * (e.g. warnings within evaluation methods); the first dCrgMsgRateBurst
+    * messages pass, afterwards only every dCrgMsgRateInterval-th message
+    * @param counter  pointer to the call-site specific message counter
+    * @return 1 if the message shall be printed, otherwise 0
+    */
+    extern int crgPortMsgRateLimit( volatile long* counter );
+    
+    /**
+    * get the value of a monotonic high resolution clock
+    * @return current time                                                      [ns]
+    */
+    extern double crgPortGetTime( void );
+    
+    /**
+    * allocate zero-initialized memory starting at a cache line boundary and
+    * covering a multiple of cache lines (see dCrgCacheLineSize)
+    * @param size  number of bytes to allocate
+    * @return pointer to the memory or NULL; release with crgPortFreeAligned()
+    */
+    extern void* crgPortCallocAligned( size_t size );
+    
+    /**
+    * release memory allocated by crgPortCallocAligned()
+    * @param ptr  pointer to the memory, may be NULL
+    */
+    extern void crgPortFreeAligned( void* ptr );
 
 
 #endif /* _CRG_BASELIB_PRIVATE_H */
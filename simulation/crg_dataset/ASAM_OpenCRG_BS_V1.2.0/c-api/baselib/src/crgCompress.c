@@ -0,0 +1,657 @@
+/* ===================================================
+ *  encoding and decoding of compressed data sections
+ *  (data format KRBZ)
+ * ---------------------------------------------------
+ *
+ * ASAM OpenCRG C API
+ *
+ * OpenCRG version:           1.2.0
+ *
+ * package:               baselib
+ * file name:             crgCompress.c
+ * author:                ASAM e.V.
+ *
+ *
+ * C by ASAM e.V., 2020
+ * Any use is limited to the scope described in the license terms.
+ * The license terms can be viewed at www.asam.net/license
+ *
+ * More Information on ASAM OpenCRG can be found here:
+ * https://www.asam.net/standards/detail/opencrg/
+ *
+ * layout of a compressed data section, all words are 32 bit big endian:
+ *
+ *   block 0 ... block n-1    independent blocks of records
+ *   index                    n words: offset of the end of each block
+ *   trailer                  number of records, records per block, n, "CRGZ"
+ *
+ * a block holds the channels one after the other; each channel starts with
+ * a byte selecting the predictor of its values, followed by the residuals
+ * of the values' bit patterns: zigzag coded as variable length integers of
+ * 7 bits per byte, a zero residual being followed by the number of zero
+ * residuals repeating it
+ */
+/* ====== INCLUSIONS ====== */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L  /* POSIX threads and sysconf() */
+#endif
+#include "crgBaseLibPrivate.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef dCrgEnableThreads
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#if defined(dCrgEnableThreads) && !defined(__GNUC__) && !defined(_MSC_VER)
+#error "dCrgEnableThreads requires atomic operations which are not available for this compiler"
+#endif
+
+/* ====== DEFINITIONS ====== */
+#define dCrgCompressMagic      0x4352475aUL   /* "CRGZ"                                        */
+#define dCrgCompressMask       0xffffffffUL   /* values are 32 bit words                       */
+#define dCrgCompressMaxThreads           64   /* upper limit of threads decoding a data section */
+#define dCrgCompressMinBlocks             4   /* min. number of blocks per thread               */
+
+#define dCrgCompressPredNone              0   /* value itself                                   */
+#define dCrgCompressPredPrev              1   /* previous value of the channel                  */
+#define dCrgCompressPredLinear            2   /* linear extrapolation of the channel            */
+#define dCrgCompressPredLateral           3   /* previous value plus change of previous channel */
+
+/* ====== TYPE DEFINITIONS ====== */
+/**
+* decoding of a data section shared by all threads
+*/
+typedef struct
+{
+    const unsigned char* data;          /* the compressed data section                  [-] */
+    const unsigned char* index;         /* index of the blocks                          [-] */
+    size_t               noChannels;    /* number of values per record                  [-] */
+    size_t               noRecords;     /* total number of records                      [-] */
+    size_t               blockRecords;  /* number of records per block                  [-] */
+    size_t               noBlocks;      /* number of blocks                             [-] */
+    unsigned char*       records;       /* resulting records in big endian byte order   [-] */
+    volatile long        nextBlock;     /* number of blocks taken by the threads so far [-] */
+    volatile long        failed;        /* a block could not be decoded                 [-] */
+} CrgCompressJobStruct;
+
+/* ====== LOCAL METHODS ====== */
+/**
+* read a 32 bit word in big endian byte order
+* @param src    location of the word
+* @return the word
+*/
+static unsigned long readWord( const unsigned char* src );
+
+/**
+* write a 32 bit word in big endian byte order
+* @param value  the word
+* @param tgt    target location of the word
+*/
+static void writeWord( unsigned long value, unsigned char* tgt );
+
+/**
+* calculate the zigzag coded residuals of the values of a channel; the bit
+* patterns are predicted modulo 2^32, which is exact whatever the values are
+* @param mode       predictor [dCrgCompressPredNone, ...]
+* @param x          values of the channel
+* @param y          values of the previous channel, may be NULL unless mode is dCrgCompressPredLateral
+* @param noValues   number of values
+* @param res        resulting residuals
+*/
+static void calcResiduals( int mode, const unsigned long* x, const unsigned long* y, size_t noValues, unsigned long* res );
+
+/**
+* restore the values of a channel from their residuals
+* @param mode       predictor [dCrgCompressPredNone, ...]
+* @param y          values of the previous channel, may be NULL unless mode is dCrgCompressPredLateral
+* @param noValues   number of values
+* @param x          residuals, replaced by the values of the channel
+*/
+static void applyResiduals( int mode, const unsigned long* y, size_t noValues, unsigned long* x );
+
+/**
+* encode a variable length integer
+* @param value  value to be encoded
+* @param tgt    target location, NULL if only the size is of interest
+* @return number of bytes of the encoded value
+*/
+static size_t writeVarint( unsigned long value, unsigned char* tgt );
+
+/**
+* decode a variable length integer
+* @param src    pointer to the location of the value, advanced behind the value
+* @param end    end of the data which may be read
+* @param value  pointer to the resulting value
+* @return 1 if successful, 0 if the value exceeds the data or 32 bits
+*/
+static int readVarint( const unsigned char** src, const unsigned char* end, unsigned long* value );
+
+/**
+* encode the residuals of a channel
+* @param mode       predictor of the channel
+* @param res        zigzag coded residuals
+* @param noValues   number of residuals
+* @param tgt        target location, NULL if only the size is of interest
+* @return number of bytes of the encoded channel
+*/
+static size_t encodeChannel( int mode, const unsigned long* res, size_t noValues, unsigned char* tgt );
+
+/**
+* decode the residuals of a channel
+* @param src        pointer to the location of the encoded channel, advanced behind the channel
+* @param end        end of the block
+* @param mode       pointer to the resulting predictor of the channel
+* @param res        resulting residuals, no longer zigzag coded
+* @param noValues   number of residuals
+* @return 1 if successful, 0 if the data is corrupt
+*/
+static int decodeChannel( const unsigned char** src, const unsigned char* end, int* mode, unsigned long* res, size_t noValues );
+
+/**
+* decode a block of records
+* @param job        pointer to the decoding job
+* @param block      index of the block
+* @param x          buffer for the values of a channel, size of a block
+* @param y          buffer for the values of another channel, size of a block
+* @return 1 if successful, 0 if the data is corrupt
+*/
+static int decodeBlock( CrgCompressJobStruct* job, size_t block, unsigned long* x, unsigned long* y );
+
+/**
+* decode blocks until all blocks of the data section have been taken
+* @param arg    pointer to the decoding job
+* @return always NULL
+*/
+static void* decodeWorker( void* arg );
+
+/* ====== IMPLEMENTATION ====== */
+size_t
+crgCompressEncodeBlock( const unsigned char* records, size_t noRecords, size_t noChannels, unsigned char* tgt )
+{
+    unsigned long* x;
+    unsigned long* y;
+    unsigned long* res;
+    unsigned long* tmp;
+    size_t         size = 0;
+    size_t         best = 0;
+    size_t         n;
+    size_t         r;
+    size_t         k;
+    int            mode;
+    int            bestMode = dCrgCompressPredNone;
+
+    x   = ( unsigned long* ) crgCalloc( noRecords, sizeof( unsigned long ) );
+    y   = ( unsigned long* ) crgCalloc( noRecords, sizeof( unsigned long ) );
+    res = ( unsigned long* ) crgCalloc( noRecords, sizeof( unsigned long ) );
+
+    if ( !x || !y || !res )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgCompressEncodeBlock: could not allocate memory for %lu records.\n", ( unsigned long ) noRecords );
+        noChannels = 0;
+    }
+
+    for ( k = 0; k < noChannels; k++ )
+    {
+        for ( r = 0; r < noRecords; r++ )
+            x[r] = readWord( records + 4 * ( r * noChannels + k ) );
+
+        /* --- the predictor is chosen per channel and block, whichever gives the shortest code --- */
+        for ( mode = dCrgCompressPredNone; mode <= ( k ? dCrgCompressPredLateral : dCrgCompressPredLinear ); mode++ )
+        {
+            calcResiduals( mode, x, y, noRecords, res );
+
+            if ( ( n = encodeChannel( mode, res, noRecords, NULL ) ) < best || mode == dCrgCompressPredNone )
+            {
+                best     = n;
+                bestMode = mode;
+            }
+        }
+
+        calcResiduals( bestMode, x, y, noRecords, res );
+
+        size += encodeChannel( bestMode, res, noRecords, tgt + size );
+
+        /* --- the channel becomes the previous one --- */
+        tmp = y;
+        y   = x;
+        x   = tmp;
+    }
+
+    if ( x )
+        crgFree( x );
+
+    if ( y )
+        crgFree( y );
+
+    if ( res )
+        crgFree( res );
+
+    return size;
+}
+
+size_t
+crgCompressEncodeIndex( const size_t* blockEnd, size_t noBlocks, size_t noRecords, size_t blockRecords, unsigned char* tgt )
+{
+    size_t b;
+
+    for ( b = 0; b < noBlocks; b++ )
+        writeWord( blockEnd[b], tgt + 4 * b );
+
+    tgt += 4 * noBlocks;
+
+    writeWord( noRecords,         tgt );
+    writeWord( blockRecords,      tgt + 4 );
+    writeWord( noBlocks,          tgt + 8 );
+    writeWord( dCrgCompressMagic, tgt + 12 );
+
+    return 4 * noBlocks + dCrgCompressTrailerSize;
+}
+
+int
+crgCompressGetNoRecords( const char* data, size_t size, size_t* noRecords )
+{
+    const unsigned char* trailer = ( const unsigned char* ) data + size - dCrgCompressTrailerSize;
+    const unsigned char* index;
+    size_t               blockRecords;
+    size_t               noBlocks;
+    size_t               b;
+
+    *noRecords = 0;
+
+    if ( size < dCrgCompressTrailerSize || readWord( trailer + 12 ) != dCrgCompressMagic )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgCompressGetNoRecords: compressed data section has no valid trailer.\n" );
+        return 0;
+    }
+
+    blockRecords = readWord( trailer + 4 );
+    noBlocks     = readWord( trailer + 8 );
+    index        = trailer - 4 * noBlocks;
+
+    /* --- all blocks but the last one are full, the blocks end in ascending order at the index --- */
+    if ( !blockRecords || ( size - dCrgCompressTrailerSize ) / 4 < noBlocks
+      || ( noBlocks ? ( readWord( trailer ) <= ( noBlocks - 1 ) * blockRecords || readWord( trailer ) > noBlocks * blockRecords ) : readWord( trailer ) != 0 )
+      || ( noBlocks && readWord( index + 4 * ( noBlocks - 1 ) ) != ( size_t ) ( index - ( const unsigned char* ) data ) ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgCompressGetNoRecords: compressed data section has an invalid index.\n" );
+        return 0;
+    }
+
+    for ( b = 1; b < noBlocks; b++ )
+    {
+        if ( readWord( index + 4 * b ) < readWord( index + 4 * ( b - 1 ) ) )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal, "crgCompressGetNoRecords: compressed data section has an invalid index.\n" );
+            return 0;
+        }
+    }
+
+    *noRecords = readWord( trailer );
+
+    return 1;
+}
+
+int
+crgCompressDecode( const char* data, size_t size, size_t noChannels, unsigned char* records )
+{
+    const unsigned char* trailer = ( const unsigned char* ) data + size - dCrgCompressTrailerSize;
+    CrgCompressJobStruct job;
+#ifdef dCrgEnableThreads
+    pthread_t            thread[dCrgCompressMaxThreads];
+    int                  noThreads;
+    int                  noStarted = 0;
+    int                  i;
+#endif
+
+    if ( !crgCompressGetNoRecords( data, size, &job.noRecords ) )
+        return 0;
+
+    job.data         = ( const unsigned char* ) data;
+    job.noChannels   = noChannels;
+    job.blockRecords = readWord( trailer + 4 );
+    job.noBlocks     = readWord( trailer + 8 );
+    job.index        = trailer - 4 * job.noBlocks;
+    job.records      = records;
+    job.nextBlock    = 0;
+    job.failed       = 0;
+
+#ifdef dCrgEnableThreads
+    noThreads = ( int ) sysconf( _SC_NPROCESSORS_ONLN );
+
+    if ( noThreads > ( int ) ( job.noBlocks / dCrgCompressMinBlocks ) )
+        noThreads = ( int ) ( job.noBlocks / dCrgCompressMinBlocks );
+
+    if ( noThreads > dCrgCompressMaxThreads )
+        noThreads = dCrgCompressMaxThreads;
+
+    /* --- the calling thread is one of the workers; blocks not taken by a failed thread are taken by the others --- */
+    for ( i = 1; i < noThreads; i++ )
+    {
+        if ( pthread_create( &( thread[noStarted] ), NULL, decodeWorker, &job ) )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "crgCompressDecode: could not start thread, using %d threads only.\n", noStarted + 1 );
+            break;
+        }
+
+        noStarted++;
+    }
+
+    decodeWorker( &job );
+
+    for ( i = 0; i < noStarted; i++ )
+        pthread_join( thread[i], NULL );
+#else
+    decodeWorker( &job );
+#endif
+
+    if ( job.failed )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgCompressDecode: compressed data section is corrupt.\n" );
+        return 0;
+    }
+
+    return 1;
+}
+
+static unsigned long
+readWord( const unsigned char* src )
+{
+    return ( ( unsigned long ) src[0] << 24 ) | ( ( unsigned long ) src[1] << 16 )
+         | ( ( unsigned long ) src[2] << 8 ) | ( unsigned long ) src[3];
+}
+
+static void
+writeWord( unsigned long value, unsigned char* tgt )
+{
+    tgt[0] = ( unsigned char ) ( ( value >> 24 ) & 0xff );
+    tgt[1] = ( unsigned char ) ( ( value >> 16 ) & 0xff );
+    tgt[2] = ( unsigned char ) ( ( value >> 8 ) & 0xff );
+    tgt[3] = ( unsigned char ) ( value & 0xff );
+}
+
+static void
+calcResiduals( int mode, const unsigned long* x, const unsigned long* y, size_t noValues, unsigned long* res )
+{
+    unsigned long d;
+    size_t        r;
+
+    if ( !noValues )
+        return;
+
+    res[0] = ( mode == dCrgCompressPredLateral ) ? x[0] - y[0] : x[0];
+
+    for ( r = 1; r < noValues; r++ )
+    {
+        switch ( mode )
+        {
+            case dCrgCompressPredPrev:
+                res[r] = x[r] - x[r-1];
+                break;
+
+            case dCrgCompressPredLinear:
+                res[r] = ( r > 1 ) ? x[r] - 2 * x[r-1] + x[r-2] : x[r] - x[r-1];
+                break;
+
+            case dCrgCompressPredLateral:
+                res[r] = x[r] - x[r-1] - y[r] + y[r-1];
+                break;
+
+            default:
+                res[r] = x[r];
+                break;
+        }
+    }
+
+    /* --- zigzag coding: small residuals of either sign give small codes --- */
+    for ( r = 0; r < noValues; r++ )
+    {
+        d      = res[r] & dCrgCompressMask;
+        res[r] = ( d & 0x80000000UL ) ? ( ( ~d << 1 ) | 1 ) & dCrgCompressMask : ( d << 1 ) & dCrgCompressMask;
+    }
+}
+
+static void
+applyResiduals( int mode, const unsigned long* y, size_t noValues, unsigned long* x )
+{
+    size_t r;
+
+    if ( !noValues )
+        return;
+
+    /* --- a loop per predictor, each value depends on the previous ones --- */
+    switch ( mode )
+    {
+        case dCrgCompressPredPrev:
+            for ( r = 1; r < noValues; r++ )
+                x[r] = ( x[r] + x[r-1] ) & dCrgCompressMask;
+            break;
+
+        case dCrgCompressPredLinear:
+            if ( noValues > 1 )
+                x[1] = ( x[1] + x[0] ) & dCrgCompressMask;
+
+            for ( r = 2; r < noValues; r++ )
+                x[r] = ( x[r] + 2 * x[r-1] - x[r-2] ) & dCrgCompressMask;
+            break;
+
+        case dCrgCompressPredLateral:
+            x[0] = ( x[0] + y[0] ) & dCrgCompressMask;
+
+            for ( r = 1; r < noValues; r++ )
+                x[r] = ( x[r] + x[r-1] + y[r] - y[r-1] ) & dCrgCompressMask;
+            break;
+
+        default:
+            break;
+    }
+}
+
+static size_t
+writeVarint( unsigned long value, unsigned char* tgt )
+{
+    size_t n = 1;
+
+    while ( value > 0x7f )
+    {
+        if ( tgt )
+            *tgt++ = ( unsigned char ) ( 0x80 | ( value & 0x7f ) );
+
+        value >>= 7;
+        n++;
+    }
+
+    if ( tgt )
+        *tgt = ( unsigned char ) value;
+
+    return n;
+}
+
+static int
+readVarint( const unsigned char** src, const unsigned char* end, unsigned long* value )
+{
+    const unsigned char* srcPtr = *src;
+    unsigned long        result = 0;
+    int                  shift;
+
+    for ( shift = 0; shift < 35; shift += 7 )
+    {
+        if ( srcPtr >= end )
+            return 0;
+
+        result |= ( unsigned long ) ( *srcPtr & 0x7f ) << shift;
+
+        if ( !( *srcPtr++ & 0x80 ) )
+        {
+            *src   = srcPtr;
+            *value = result;
+
+            return result <= dCrgCompressMask;
+        }
+    }
+
+    return 0;
+}
+
+static size_t
+encodeChannel( int mode, const unsigned long* res, size_t noValues, unsigned char* tgt )
+{
+    size_t size = 1;
+    size_t run;
+    size_t r;
+
+    if ( tgt )
+        tgt[0] = ( unsigned char ) mode;
+
+    for ( r = 0; r < noValues; )
+    {
+        size += writeVarint( res[r], tgt ? tgt + size : NULL );
+
+        if ( res[r++] )
+            continue;
+
+        for ( run = 0; r < noValues && !res[r]; r++ )
+            run++;
+
+        size += writeVarint( run, tgt ? tgt + size : NULL );
+    }
+
+    return size;
+}
+
+static int
+decodeChannel( const unsigned char** src, const unsigned char* end, int* mode, unsigned long* res, size_t noValues )
+{
+    const unsigned char* srcPtr = *src;
+    unsigned long        value;
+    unsigned long        run;
+    size_t               r;
+
+    if ( srcPtr >= end )
+        return 0;
+
+    *mode = *srcPtr++;
+
+    for ( r = 0; r < noValues; r++ )
+    {
+        /* --- away from the end of the block the bytes are read without checking it, unrolled --- */
+        if ( end - srcPtr >= 5 )
+        {
+            value = *srcPtr++;
+
+            if ( value & 0x80 )
+            {
+                value = ( value & 0x7f ) | ( ( unsigned long ) *srcPtr << 7 );
+
+                if ( *srcPtr++ & 0x80 )
+                {
+                    value = ( value & 0x3fff ) | ( ( unsigned long ) *srcPtr << 14 );
+
+                    if ( *srcPtr++ & 0x80 )
+                    {
+                        value = ( value & 0x1fffff ) | ( ( unsigned long ) *srcPtr << 21 );
+
+                        if ( *srcPtr++ & 0x80 )
+                        {
+                            /* --- the fifth byte holds the upper 4 bits of 32 --- */
+                            if ( *srcPtr > 0x0f )
+                                return 0;
+
+                            value = ( value & 0xfffffff ) | ( ( unsigned long ) *srcPtr++ << 28 );
+                        }
+                    }
+                }
+            }
+
+            res[r] = value;
+        }
+        else if ( !readVarint( &srcPtr, end, res + r ) )
+            return 0;
+
+        if ( !res[r] )
+        {
+            if ( !readVarint( &srcPtr, end, &run ) || run > noValues - r - 1 )
+                return 0;
+
+            for ( ; run; run-- )
+                res[++r] = 0;
+        }
+        else
+            res[r] = ( ( res[r] >> 1 ) ^ ( 0 - ( res[r] & 1 ) ) ) & dCrgCompressMask;  /* without a branch on the sign */
+    }
+
+    *src = srcPtr;
+
+    return 1;
+}
+
+static int
+decodeBlock( CrgCompressJobStruct* job, size_t block, unsigned long* x, unsigned long* y )
+{
+    const unsigned char* src = job->data + ( block ? readWord( job->index + 4 * ( block - 1 ) ) : 0 );
+    const unsigned char* end = job->data + readWord( job->index + 4 * block );
+    unsigned char*       tgt;
+    unsigned long*       tmp;
+    size_t               noRecords = job->blockRecords;
+    size_t               stride    = 4 * job->noChannels;
+    size_t               r;
+    size_t               k;
+    int                  mode;
+
+    if ( ( block + 1 ) * job->blockRecords > job->noRecords )
+        noRecords = job->noRecords - block * job->blockRecords;
+
+    for ( k = 0; k < job->noChannels; k++ )
+    {
+        if ( !decodeChannel( &src, end, &mode, x, noRecords )
+          || mode > dCrgCompressPredLateral || ( mode == dCrgCompressPredLateral && !k ) )
+            return 0;
+
+        applyResiduals( mode, y, noRecords, x );
+
+        tgt = job->records + block * job->blockRecords * stride + 4 * k;
+
+        for ( r = 0; r < noRecords; r++, tgt += stride )
+            writeWord( x[r], tgt );
+
+        tmp = y;
+        y   = x;
+        x   = tmp;
+    }
+
+    /* --- the block must be used up exactly --- */
+    return src == end;
+}
+
+static void*
+decodeWorker( void* arg )
+{
+    CrgCompressJobStruct* job = ( CrgCompressJobStruct* ) arg;
+    unsigned long*        x;
+    unsigned long*        y;
+    long                  block;
+
+    x = ( unsigned long* ) crgCalloc( job->blockRecords, sizeof( unsigned long ) );
+    y = ( unsigned long* ) crgCalloc( job->blockRecords, sizeof( unsigned long ) );
+
+    if ( !x || !y )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "decodeWorker: could not allocate memory for %lu records.\n", ( unsigned long ) job->blockRecords );
+        job->failed = 1;
+    }
+
+    while ( !job->failed && ( block = dCrgAtomicIncrement( &( job->nextBlock ) ) - 1 ) < ( long ) job->noBlocks )
+    {
+        if ( !decodeBlock( job, ( size_t ) block, x, y ) )
+            job->failed = 1;
+    }
+
+    if ( x )
+        crgFree( x );
+
+    if ( y )
+        crgFree( y );
+
+    return NULL;
+}
@@ -31,65 +31,107 @@
 
 /* ====== LOCAL VARIABLES ====== */
 static CrgContactPointStruct** cpTable = NULL;
-static int cpTableSize = 0;
+static int cpTableSize     = 0;        /* number of table slots in use or freed        */
+static int cpTableCapacity = 0;        /* number of allocated table slots              */
+static int* cpFreeIds      = NULL;     /* stack of freed table slots                   */
+static int cpNoFreeIds     = 0;
+static int cpNoValid       = 0;        /* number of existing contact points            */
+static CrgContactPointStruct* cpPool = NULL;   /* deleted contact points for re-use    */
 
 /* ====== IMPLEMENTATION ====== */
 int 
 crgContactPointCreate( int dataSetId )
 {
-    int i;
     int tgtId = -1;
-    int validIds = 0;
     CrgContactPointStruct* cp      = NULL;
     CrgDataStruct*         crgData = crgDataSetAccess( dataSetId );
+    CrgHistoryEntryStruct* histEntry = NULL;
 
     if ( !crgData )
         return -1;
 
-    cp = ( CrgContactPointStruct* )  crgCalloc( 1, sizeof( CrgContactPointStruct ) );
-
-    /* --- get the maximum ID of existing data sets --- */
-    for ( i = 0; i < cpTableSize; i++ )
+    /* --- extend the table of contact points by doubling its size --- */
+    if ( !cpNoFreeIds && cpTableSize >= cpTableCapacity )
     {
-        /* --- found some free space in list of contact points? --- */
-        if ( !cpTable[i] )
-            tgtId = i;
-        else
-            ++validIds;
+        int newCapacity = cpTableCapacity ? 2 * cpTableCapacity : 16;
+        CrgContactPointStruct** newTable;
+        int* newFreeIds;
+        
+        newTable = ( CrgContactPointStruct** ) crgRealloc( cpTable, newCapacity * sizeof( CrgContactPointStruct* ) );
+        
+        if ( newTable )
+            cpTable = newTable;
+        
+        newFreeIds = ( int* ) crgRealloc( cpFreeIds, newCapacity * sizeof( int ) );
+        
+        if ( newFreeIds )
+            cpFreeIds = newFreeIds;
+        
+        if ( !newTable || !newFreeIds )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal, "crgCreateContactPoint: could not allocate new contact point.\n" );
+            return -1;
+        }
+        
+        cpTableCapacity = newCapacity;
     }
-
-    /* --- any unused ID available or do we need to exend the data management list? --- */
-    if ( tgtId < 0 )
+    
+    /* --- re-use a deleted contact point and its history buffer --- */
+    if ( cpPool )
     {
-        cpTable = ( CrgContactPointStruct** ) crgRealloc( cpTable, ( cpTableSize + 1 ) * sizeof( CrgContactPointStruct* ) );
-        tgtId   = cpTableSize;
-        cpTableSize++;
+        cp        = cpPool;
+        cpPool    = ( CrgContactPointStruct* ) cp->poolNext;
+        histEntry = cp->history.entry;
+        
+        if ( histEntry && cp->history.totalSize != dCrgHistoryStdSize )
+        {
+            crgPortFreeAligned( histEntry );
+            histEntry = NULL;
+        }
+        
+        memset( cp, 0, sizeof( CrgContactPointStruct ) );
     }
-    
-    if ( !cpTable || !cp )
+    /* --- contact points are aligned to cache lines so that threads working on --- */
+    /* --- different contact points don't compete for the same cache lines      --- */
+    else if ( !( cp = ( CrgContactPointStruct* )  crgPortCallocAligned( sizeof( CrgContactPointStruct ) ) ) )
     {
         crgMsgPrint( dCrgMsgLevelFatal, "crgCreateContactPoint: could not allocate new contact point.\n" );
         return -1;
     }
     
-    /* --- allocate space for the history --- */
-    crgContactPointPtrSetHistory( cp, dCrgHistoryStdSize );
+    /* --- any unused ID available or do we need to use a new slot? --- */
+    if ( cpNoFreeIds )
+        tgtId = cpFreeIds[--cpNoFreeIds];
+    else
+        tgtId = cpTableSize++;
+    
+    /* --- the history is allocated on first use --- */
+    cp->history.entry     = histEntry;
+    cp->history.totalSize = dCrgHistoryStdSize;
+    cp->history.entrySize = sizeof( CrgHistoryEntryStruct );
+    cp->history.closeDist = dCrgHistoryStdClose * dCrgHistoryStdClose;  /* internally, square of distance is used */
+    cp->history.farDist   = dCrgHistoryStdFar   * dCrgHistoryStdFar;
 
     /* --- now register contact point in table --- */
     cpTable[tgtId] = cp;
     cp->crgData    = crgData;
+    ++cpNoValid;
     
-    /* --- allocate the memory for the options --- */
-    crgOptionCreateList( &( cp->options ) );
-    
-    /* --- set the default options of the contact point --- */
-    crgContactPointSetDefaultOptions( tgtId );
+    /* --- share the options defined in the data set until the contact point modifies them; --- */
+    /* --- the data set's snapshot is renewed whenever its options have changed           --- */
+    if ( !crgData->cpOptions || crgData->cpOptions->revision != crgData->options.revision )
+    {
+        crgOptionBlockRelease( crgData->cpOptions );
+        crgData->cpOptions = crgOptionBlockCreate( &( crgData->options ) );
+    }
     
-    /* --- get the options defined in the data set --- */
-    crgOptionCopyAll( &( cp->options ), &( crgData->options ) );
+    if ( crgData->cpOptions )
+        crgOptionShare( &( cp->options ), crgData->cpOptions );
+    else
+        crgOptionCopyAll( &( cp->options ), &( crgData->options ) );
     
 #ifdef dCrgEnableDebug2
-    crgMsgPrint( dCrgMsgLevelNotice, "crgContactPointCreate: created contact point %d. Now have %d contact points.\n", tgtId, validIds );
+    crgMsgPrint( dCrgMsgLevelNotice, "crgContactPointCreate: created contact point %d. Now have %d contact points.\n", tgtId, cpNoValid );
 #endif
    
    /* --- return the contact point ID, i.e. its position in the contact point table --- */
@@ -104,14 +146,18 @@ crgContactPointDelete( int cpId )
     if ( !cp )
         return 0;
 
-    /* --- free data associated with the contact point --- */
-    crgContactPointReset( cp );
+    /* --- free the options, keep the history buffer for re-use --- */
+    crgOptionReleaseList( &( cp->options ) );
     
     /* --- mark contact point in cp table as unused --- */
-    cpTable[cpId] = NULL;
+    cpTable[cpId]              = NULL;
+    cpFreeIds[cpNoFreeIds++]   = cpId;
+    --cpNoValid;
     
-    /* --- free the actual contact point data --- */
-    crgFree( cp );
+    /* --- keep the actual contact point data in the pool --- */
+    cp->crgData  = NULL;
+    cp->poolNext = cpPool;
+    cpPool       = cp;
     
 #ifdef dCrgEnableDebug2
     crgMsgPrint( dCrgMsgLevelWarn, "crgContactPointDelete: deleted contact point %d.\n", cpId );
@@ -148,10 +194,26 @@ crgContactPointDeleteAll( int dataSetId )
     /* --- now release any memory held for the contact point management --- */
     if ( dataSetId == -1 )
     {
+        while ( cpPool )
+        {
+            cp     = cpPool;
+            cpPool = ( CrgContactPointStruct* ) cp->poolNext;
+            
+            if ( cp->history.entry )
+                crgPortFreeAligned( cp->history.entry );
+            
+            crgPortFreeAligned( cp );
+        }
+        
         crgFree( cpTable );
-    
-        cpTable     = NULL;
-        cpTableSize = 0;
+        crgFree( cpFreeIds );
+    
+        cpTable         = NULL;
+        cpFreeIds       = NULL;
+        cpTableSize     = 0;
+        cpTableCapacity = 0;
+        cpNoFreeIds     = 0;
+        cpNoValid       = 0;
     }
 }
 
@@ -162,13 +224,13 @@ crgContactPointReset( CrgContactPointStruct* cp )
         return;
     
     if ( cp->history.entry )
-        crgFree( cp->history.entry );
+        crgPortFreeAligned( cp->history.entry );
     
-    if ( cp->options.entry )
-        crgFree( cp->options.entry );
+    crgOptionReleaseList( &( cp->options ) );
     
-    cp->options.entry     = NULL;
-    cp->options.noEntries = 0;
+    cp->history.entry     = NULL;
+    cp->history.totalSize = 0;
+    cp->history.usedSize  = 0;
 
     /* crgMsgPrint( dCrgMsgLevelWarn, "crgContactPointReset: called.\n" );*/
 }
@@ -189,6 +251,26 @@ crgContactPointSetCrgData( CrgContactPointStruct* cp, int dataSetId )
     return 1;
 }
 
+int
+crgContactPointGetRealTimeStatus( int cpId, int* status, unsigned long* noDegraded )
+{
+    CrgContactPointStruct* cp = crgContactPointGetFromId( cpId );
+    
+    if ( !cp )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgContactPointGetRealTimeStatus: invalid contact point id <%d>.\n", cpId );
+        return 0;
+    }
+    
+    if ( status )
+        *status = cp->rtStatus;
+    
+    if ( noDegraded )
+        *noDegraded = cp->rtNoDegraded;
+    
+    return 1;
+}
+
 CrgContactPointStruct* 
 crgContactPointGetFromId( int cpId )
 {
@@ -209,6 +291,13 @@ crgContactPointOptionSetInt( int cpId, unsigned int optionId, int optionValue )
         return 0;
     }
     
+    /* --- real-time queries must not allocate the history or the calling thread's counters --- */
+    if ( optionId == dCrgCpOptionRealTimeSteps )
+    {
+        crgContactPointPtrAllocHistory( cp );
+        dCrgPerfStatLocal();
+    }
+    
     return crgOptionSetInt( &( cp->options ), optionId, optionValue );
 }
 
@@ -329,8 +418,8 @@ crgContactPointSetDefaultOptions( int cpId )
     crgOptionSetDefaultOptions( &( cp->options ) );
     
     /* --- copy history options back to contact point's history buffer --- */
-    crgContactPointOptionSetDouble( cpId, dCrgCpOptionRefLineClose, 0.3 );
-    crgContactPointOptionSetDouble( cpId, dCrgCpOptionRefLineFar,   2.2 );
+    crgContactPointOptionSetDouble( cpId, dCrgCpOptionRefLineClose, dCrgHistoryStdClose );
+    crgContactPointOptionSetDouble( cpId, dCrgCpOptionRefLineFar,   dCrgHistoryStdFar   );
 }
 
 int
@@ -381,7 +470,7 @@ crgContactPointPtrSetHistory( CrgContactPointStruct *cp, int histSize )
     
     /* --- free existing history --- */
     if ( cp->history.entry )
-        crgFree( cp->history.entry );
+        crgPortFreeAligned( cp->history.entry );
     
     cp->history.entry     = NULL;
     cp->history.totalSize = histSize;
@@ -389,7 +478,7 @@ crgContactPointPtrSetHistory( CrgContactPointStruct *cp, int histSize )
     cp->history.entrySize = sizeof( CrgHistoryEntryStruct );
 
     if ( histSize )
-        cp->history.entry = ( CrgHistoryEntryStruct* ) crgCalloc( histSize, sizeof( CrgHistoryEntryStruct ) );
+        cp->history.entry = ( CrgHistoryEntryStruct* ) crgPortCallocAligned( histSize * sizeof( CrgHistoryEntryStruct ) );
     
     if ( !( cp->history.entry ) )
     {
@@ -412,6 +501,24 @@ crgContactPointPtrSetHistory( CrgContactPointStruct *cp, int histSize )
     return 1;
 }
 
+int
+crgContactPointPtrAllocHistory( CrgContactPointStruct *cp )
+{
+    if ( !cp )
+        return 0;
+    
+    if ( cp->history.entry )
+        return 1;
+    
+    if ( cp->history.totalSize <= 0 )
+        return 0;
+    
+    cp->history.usedSize = 0;
+    cp->history.entry    = ( CrgHistoryEntryStruct* ) crgPortCallocAligned( cp->history.totalSize * sizeof( CrgHistoryEntryStruct ) );
+    
+    return cp->history.entry != NULL;
+}
+
 int
 crgContactPointSetHistoryForDataSet( CrgDataStruct *crgData, int histSize )
 {
@@ -433,6 +540,22 @@ crgContactPointSetHistoryForDataSet( CrgDataStruct *crgData, int histSize )
     return result;
 }
 
+void
+crgContactPointClearHistoryForDataSet( CrgDataStruct *crgData )
+{
+    int i;
+
+    if ( !crgData )
+        return;
+
+    /* --- the history refers to indices of the reference line, which may have changed --- */
+    for ( i = 0; i < cpTableSize; i++ )
+    {
+        if ( cpTable[i] && cpTable[i]->crgData == crgData )
+            cpTable[i]->history.usedSize = 0;
+    }
+}
+
 void
 crgContactPointPreloadHistoryU( CrgContactPointStruct *cp, double u )
 {
@@ -449,7 +572,7 @@ crgContactPointPreloadHistoryU( CrgContactPointStruct *cp, double u )
     }
     
     /* --- remember result in history --- */
-    if ( !cp->history.totalSize )
+    if ( !crgContactPointPtrAllocHistory( cp ) )
         return;
     
     /* --- shift previous values --- */
@@ -501,66 +624,22 @@ crgContactPointPreloadHistoryUFrac( CrgContactPointStruct *cp, double uFrac )
 void
 crgContactPointActivatePerfStat( int cpId )
 {
-    CrgContactPointStruct* cp = crgContactPointGetFromId( cpId );
-    
-#ifndef dCrgEnableStats
-    crgMsgPrint( dCrgMsgLevelWarn, "crgContactPointActivatePerfStat: performance statistics have been disabled\n"
-                                   "         Please provide/activate \"#define dCrgEnableStats\" in \"crgBaseLibPrivate.h\"\n" );
-    return;
-#endif
-    
-    if ( !cp )
-    {
-        crgMsgPrint( dCrgMsgLevelWarn, "crgContactPointActivatePerfStat: invalid contact point id <%d>.\n", cpId );
-        return;
-    }
-    
-    /* --- reset old contents first --- */
-    crgContactPointResetPerfStat( cp );
-    
-    cp->history.stat.active = 1;
-    if ( cp->crgData )
-        cp->crgData->perfStat.active = 1;
+    crgMsgPrint( dCrgMsgLevelWarn, "crgContactPointActivatePerfStat: deprecated, statistics are no longer kept per contact point\n"
+                                   "         Please use crgPerfStatReset() and crgPerfStatGet() instead\n" );
 }
 
 void
 crgContactPointDeActivatePerfStat( int cpId )
 {
-    CrgContactPointStruct* cp = crgContactPointGetFromId( cpId );
-    
-#ifndef dCrgEnableStats
-    crgMsgPrint( dCrgMsgLevelWarn, "crgContactPointDeActivatePerfStat: performance statistics have been disabled\n"
-                                   "Please provide/activate \"#define dCrgEnableStats\" in \"crgBaseLibPrivate.h\"\n" );
-    return;
-#endif
-
-    if ( !cp )
-    {
-        crgMsgPrint( dCrgMsgLevelWarn, "crgContactPointDeActivatePerfStat: invalid contact point id <%d>.\n", cpId );
-        return;
-    }
-    
-    cp->history.stat.active = 0;
-    if ( cp->crgData )
-        cp->crgData->perfStat.active = 0;
+    crgMsgPrint( dCrgMsgLevelWarn, "crgContactPointDeActivatePerfStat: deprecated, statistics are no longer kept per contact point\n"
+                                   "         Please use crgPerfStatReset() and crgPerfStatGet() instead\n" );
 }
 
 void
 crgContactPointResetPerfStat( CrgContactPointStruct *cp )
 {
-#ifndef dCrgEnableStats
-    crgMsgPrint( dCrgMsgLevelWarn, "crgContactPointResetPerfStat: performance statistics have been disabled\n"
-                                   "Please provide/activate \"#define dCrgEnableStats\" in \"crgBaseLibPrivate.h\"\n" );
-    return;
-#endif
-
-    if ( !cp )
-        return;
-    
-    memset( &( cp->history.stat ), 0, sizeof( CrgHistoryStatStruct ) );
-    
-    if ( cp->crgData )
-        memset( &( cp->crgData->perfStat ), 0, sizeof( CrgPerformanceStruct ) );
+    crgMsgPrint( dCrgMsgLevelWarn, "crgContactPointResetPerfStat: deprecated, statistics are no longer kept per contact point\n"
+                                   "         Please use crgPerfStatReset() instead\n" );
 }
 
 void
@@ -570,29 +649,11 @@ crgContactPointPrintPerfStat( int cpId )
     
     if ( !cp )
     {
-        crgMsgPrint( dCrgMsgLevelWarn, "crgContactPointOptionRemove: invalid contact point id <%d>.\n", cpId );
+        crgMsgPrint( dCrgMsgLevelWarn, "crgContactPointPrintPerfStat: invalid contact point id <%d>.\n", cpId );
         return;
     }
     
-    crgMsgPrint( dCrgMsgLevelNotice, "Performance statistics for contact point <%d>\n", cpId );
-    crgMsgPrint( dCrgMsgLevelNotice, "    History\n" );
-    crgMsgPrint( dCrgMsgLevelNotice, "        total number of queries:          %d\n", cp->history.stat.noTotalQueries );
-    crgMsgPrint( dCrgMsgLevelNotice, "        total number of close hits:       %d\n", cp->history.stat.noCloseHits    );
-    crgMsgPrint( dCrgMsgLevelNotice, "        total number of far hits:         %d\n", cp->history.stat.noFarHits      );
-    crgMsgPrint( dCrgMsgLevelNotice, "        total number of non-hits:         %d\n", cp->history.stat.noNoHits       );
-    crgMsgPrint( dCrgMsgLevelNotice, "        total number of iterations:       %d\n", cp->history.stat.noIter         );
-    crgMsgPrint( dCrgMsgLevelNotice, "        total number of calls to loop 1:  %d\n", cp->history.stat.noCallsLoop1   );
-    crgMsgPrint( dCrgMsgLevelNotice, "        total number of calls to loop 2:  %d\n", cp->history.stat.noCallsLoop2   );
-    
-    if ( cp->crgData )
-    {
-        crgMsgPrint( dCrgMsgLevelNotice, "    Evaluation\n" );
-        crgMsgPrint( dCrgMsgLevelNotice, "        total number of queries:             %d\n", cp->crgData->perfStat.noTotalQueries     );
-        crgMsgPrint( dCrgMsgLevelNotice, "        total number of calls to loop V1:    %d\n", cp->crgData->perfStat.noCallsLoopV1      );
-        crgMsgPrint( dCrgMsgLevelNotice, "        max. number of calls to loop V1:     %d\n", cp->crgData->perfStat.maxCallsLoopV1     );
-        crgMsgPrint( dCrgMsgLevelNotice, "        total number of calls to border U:   %d\n", cp->crgData->perfStat.noCallsBorderU     );
-        crgMsgPrint( dCrgMsgLevelNotice, "        total number of calls to border V:   %d\n", cp->crgData->perfStat.noCallsBorderV     );
-    }
+    crgPerfStatPrint();
 }
 
 void
@@ -603,7 +664,7 @@ crgContactPointPrintHistory( CrgContactPointStruct *cp, double x, double y )
     if ( !cp )
         return;
     
-    crgMsgPrint( dCrgMsgLevelNotice, "History for contact point %p during query %d\n", ( void* ) ( cp ), cp->history.stat.noTotalQueries );
+    crgMsgPrint( dCrgMsgLevelNotice, "History for contact point %p during query %lu\n", ( void* ) ( cp ), dCrgPerfStatLocal()->counters.noEvalxy2uv );
     
     for ( i = 0; i < cp->history.usedSize; i++ )
     {
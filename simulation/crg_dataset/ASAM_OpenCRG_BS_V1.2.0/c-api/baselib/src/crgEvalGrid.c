@@ -0,0 +1,478 @@
+/* ===================================================
+ *  evaluate elevations on a regular u/v grid
+ * ---------------------------------------------------
+ *
+ * ASAM OpenCRG C API
+ *
+ * OpenCRG version:           1.2.0
+ *
+ * package:               baselib
+ * file name:             crgEvalGrid.c
+ * author:                ASAM e.V.
+ *
+ *
+ * C by ASAM e.V., 2020
+ * Any use is limited to the scope described in the license terms.
+ * The license terms can be viewed at www.asam.net/license
+ *
+ * More Information on ASAM OpenCRG can be found here:
+ * https://www.asam.net/standards/detail/opencrg/
+ *
+ */
+/* ====== INCLUSIONS ====== */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L  /* POSIX threads and sysconf() */
+#endif
+#include "crgBaseLibPrivate.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef dCrgEnableThreads
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#if defined(dCrgEnableThreads) && !defined(__GNUC__) && !defined(_MSC_VER)
+#error "dCrgEnableThreads requires atomic operations which are not available for this compiler"
+#endif
+
+/* ====== DEFINITIONS ====== */
+#define dCrgEvalGridMaxThreads   64       /* upper limit of worker threads per grid                */
+#define dCrgEvalGridMinPoints    16384    /* min. number of grid points per thread                 */
+
+/* ====== TYPE DEFINITIONS ====== */
+/**
+* pre-computed u position of a grid column; valid in the core area only
+*/
+typedef struct
+{
+    double u;           /* u co-ordinate of the column                               [m] */
+    double frac;        /* fraction of the cell in u direction                        [-] */
+    double refZ;        /* elevation of the reference line                            [m] */
+    double bank;        /* banking of the reference line                              [-] */
+    size_t index;       /* index of the cell in u direction                           [-] */
+    int    fast;        /* column may be evaluated without border and smoothing logic [-] */
+} CrgGridColumnStruct;
+
+/**
+* description of a grid evaluation shared by all threads
+*/
+typedef struct
+{
+    CrgDataStruct*       crgData;       /* data set to be evaluated                     [-] */
+    CrgGridColumnStruct* column;        /* pre-computed columns                         [-] */
+    double               v0;            /* v co-ordinate of the first row               [m] */
+    double               dv;            /* increment in v direction                     [m] */
+    int                  nu;            /* number of columns                            [-] */
+    int                  nv;            /* number of rows                               [-] */
+    float*               out;           /* resulting elevations, nv rows of nu values   [m] */
+    volatile long        nextRow;       /* number of rows taken by the threads so far   [-] */
+} CrgGridJobStruct;
+
+#ifdef dCrgEnableThreads
+/**
+* a worker thread of a grid evaluation; its performance counters belong to the
+* job and are added to those of the calling thread after the join, so the
+* short-lived workers never register counters of their own
+*/
+typedef struct
+{
+    pthread_t               thread;     /* the thread                                   [-] */
+    CrgGridJobStruct*       job;        /* grid job shared by all threads               [-] */
+    CrgPerfStatThreadStruct perf;       /* performance counters of the thread           [-] */
+} CrgGridThreadStruct;
+#endif
+
+/* ====== LOCAL VARIABLES ====== */
+#ifdef dCrgEnableThreads
+static int sMaxThreads = 0;     /* max. number of threads per grid, 0 = number of processors */
+#endif
+
+/* ====== LOCAL METHODS ====== */
+/**
+* pre-compute the cell index, fraction, reference line elevation and banking
+* of a grid column
+* @param crgData    pointer to the data set
+* @param options    options to be applied
+* @param u          u co-ordinate of the column
+* @param column     pointer to the resulting column
+*/
+static void gridColumnInit( CrgDataStruct* crgData, CrgOptionsStruct* options, double u, CrgGridColumnStruct* column );
+
+/**
+* find the cell of a grid row in the core area
+* @param crgData    pointer to the data set
+* @param v          v co-ordinate of the row
+* @param index      pointer to the resulting index of the cell in v direction
+* @param frac       pointer to the resulting fraction of the cell in v direction
+* @return 1 if the row is in the core area, otherwise 0
+*/
+static int gridRowFind( CrgDataStruct* crgData, double v, size_t* index, double* frac );
+
+/**
+* evaluate a single row of the grid
+* @param job    pointer to the grid job
+* @param row    index of the row
+*/
+static void gridRowEval( CrgGridJobStruct* job, int row );
+
+/**
+* evaluate rows until all rows of the grid have been taken
+* @param arg    pointer to the grid job
+* @return always NULL
+*/
+static void* gridWorker( void* arg );
+
+#ifdef dCrgEnableThreads
+/**
+* entry point of an additional worker thread
+* @param arg    pointer to the thread description
+* @return always NULL
+*/
+static void* gridThread( void* arg );
+#endif
+
+/* ====== IMPLEMENTATION ====== */
+int
+crgEvalGridUV( int dataSetId, double u0, double du, int nu, double v0, double dv, int nv, float* out )
+{
+    CrgDataStruct*   crgData = crgDataSetAccess( dataSetId );
+    CrgGridJobStruct job;
+    int              i;
+#ifdef dCrgEnableThreads
+    CrgGridThreadStruct* thread = NULL;
+    int                  noThreads;
+    int                  noStarted = 0;
+#endif
+
+    if ( !crgData )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgEvalGridUV: invalid data set id <%d>.\n", dataSetId );
+        return 0;
+    }
+
+    if ( nu < 1 || nv < 1 || !out )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgEvalGridUV: invalid grid of %d x %d points.\n", nu, nv );
+        return 0;
+    }
+
+    if ( !( job.column = ( CrgGridColumnStruct* ) crgCalloc( nu, sizeof( CrgGridColumnStruct ) ) ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgEvalGridUV: could not allocate memory for %d columns.\n", nu );
+        return 0;
+    }
+
+    /* --- the u position is the same in each row, compute it only once --- */
+    for ( i = 0; i < nu; i++ )
+        gridColumnInit( crgData, &( crgData->options ), u0 + i * du, job.column + i );
+
+    job.crgData = crgData;
+    job.v0      = v0;
+    job.dv      = dv;
+    job.nu      = nu;
+    job.nv      = nv;
+    job.out     = out;
+    job.nextRow = 0;
+
+#ifdef dCrgEnableThreads
+    noThreads = sMaxThreads;
+
+    if ( noThreads < 1 )
+        noThreads = ( int ) sysconf( _SC_NPROCESSORS_ONLN );
+
+    if ( noThreads > ( int ) ( ( double ) nu * nv / dCrgEvalGridMinPoints ) )
+        noThreads = ( int ) ( ( double ) nu * nv / dCrgEvalGridMinPoints );
+
+    if ( noThreads > nv )
+        noThreads = nv;
+
+    if ( noThreads > dCrgEvalGridMaxThreads )
+        noThreads = dCrgEvalGridMaxThreads;
+
+    if ( noThreads > 1 && !( thread = ( CrgGridThreadStruct* ) crgCalloc( noThreads - 1, sizeof( CrgGridThreadStruct ) ) ) )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgEvalGridUV: could not allocate memory for threads, using 1 thread only.\n" );
+        noThreads = 1;
+    }
+
+    /* --- the calling thread is one of the workers; rows not taken by a failed thread are taken by the others --- */
+    for ( i = 1; i < noThreads; i++ )
+    {
+        thread[noStarted].job = &job;
+
+        if ( pthread_create( &( thread[noStarted].thread ), NULL, gridThread, thread + noStarted ) )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "crgEvalGridUV: could not start thread, using %d threads only.\n", noStarted + 1 );
+            break;
+        }
+
+        noStarted++;
+    }
+
+    gridWorker( &job );
+
+    for ( i = 0; i < noStarted; i++ )
+    {
+        pthread_join( thread[i].thread, NULL );
+        crgPerfStatAdd( dCrgPerfStatLocal(), &( thread[i].perf.counters ) );
+    }
+
+    if ( thread )
+        crgFree( thread );
+#else
+    gridWorker( &job );
+#endif
+
+    crgFree( job.column );
+
+    return 1;
+}
+
+int
+crgEvalGridSetMaxThreads( int noThreads )
+{
+#ifdef dCrgEnableThreads
+    if ( noThreads < 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgEvalGridSetMaxThreads: invalid number of threads <%d>.\n", noThreads );
+        return 0;
+    }
+
+    sMaxThreads = ( noThreads > dCrgEvalGridMaxThreads ) ? dCrgEvalGridMaxThreads : noThreads;
+
+    return 1;
+#else
+    return noThreads == 1;
+#endif
+}
+
+static void
+gridColumnInit( CrgDataStruct* crgData, CrgOptionsStruct* options, double u, CrgGridColumnStruct* column )
+{
+    double frac;
+
+    column->u    = u;
+    column->fast = 0;
+
+    /* --- closed reference lines, border modes and smoothing are left to the full evaluation --- */
+    if ( crgData->util.uIsClosed || u < crgData->channelU.info.first || u > crgData->channelU.info.last )
+        return;
+
+    if ( ( options->flags & dCrgOptFlagSmoothUBegin )
+      && u - crgData->channelU.info.first <= options->entry[dCrgCpOptionSmoothUBegin].dValue )
+        return;
+
+    if ( ( options->flags & dCrgOptFlagSmoothUEnd )
+      && crgData->channelU.info.last - u <= options->entry[dCrgCpOptionSmoothUEnd].dValue )
+        return;
+
+    /* --- same index computation as in crgDataEvaluv2z() --- */
+    frac = ( u - crgData->channelU.info.first ) / crgData->channelU.info.inc;
+
+    if ( frac < 0.0 )
+        frac = 0.0;
+
+    column->index = ( size_t ) frac;
+
+    if ( column->index >= crgData->channelU.info.size - 1 )
+    {
+        column->index = crgData->channelU.info.size - 2;
+        frac          = 1.0;
+    }
+    else
+        frac -= column->index;
+
+    column->frac = frac;
+
+    if ( crgData->channelRefZ.info.valid )
+        column->refZ = crgData->channelRefZ.data[column->index]
+                     + frac * ( crgData->channelRefZ.data[column->index+1] - crgData->channelRefZ.data[column->index] );
+    else
+        column->refZ = crgData->channelRefZ.info.first;
+
+    column->bank = 0.0;
+
+    if ( crgData->util.hasBank )
+    {
+        if ( crgData->channelBank.info.valid )
+            column->bank = crgData->channelBank.data[column->index]
+                         + frac * ( crgData->channelBank.data[column->index+1] - crgData->channelBank.data[column->index] );
+        else
+            column->bank = crgData->channelBank.info.first;
+    }
+
+    column->fast = 1;
+}
+
+static int
+gridRowFind( CrgDataStruct* crgData, double v, size_t* index, double* frac )
+{
+    size_t index0;
+    size_t indexCtr;
+
+    if ( v < crgData->channelV.info.first || v > crgData->channelV.info.last )
+        return 0;
+
+    /* --- constantly spaced v axis --- */
+    if ( crgData->admin.defMask & dCrgDataDefVIndex )
+    {
+        *frac  = ( v - crgData->channelV.info.first ) / crgData->channelV.info.inc;
+
+        if ( *frac < 0.0 )
+            *frac = 0.0;
+
+        *index = ( size_t ) *frac;
+
+        if ( *index >= crgData->channelV.info.size - 1 )
+        {
+            *index = crgData->channelV.info.size - 2;
+            *frac  = 1.0;
+        }
+        else
+            *frac -= *index;
+
+        return 1;
+    }
+
+    /* --- variably spaced v axis: one interval search per row --- */
+    *index = 0;
+    index0 = crgData->channelV.info.size - 1;
+
+    while ( 1 )
+    {
+        indexCtr = ( index0 + *index ) / 2;
+
+        if ( indexCtr <= *index )
+            break;
+
+        if ( v < crgData->channelV.data[indexCtr] )
+            index0 = indexCtr;
+        else
+            *index = indexCtr;
+    }
+
+    *frac = ( v - crgData->channelV.data[*index] ) / ( crgData->channelV.data[*index+1] - crgData->channelV.data[*index] );
+
+    if ( *frac > 1.0 )
+        *frac = 1.0;
+    else if ( *frac < 0.0 )
+        *frac = 0.0;
+
+    return 1;
+}
+
+static void
+gridRowEval( CrgGridJobStruct* job, int row )
+{
+    CrgDataStruct*       crgData = job->crgData;
+    CrgGridColumnStruct* column  = job->column;
+    float*               out     = job->out + ( size_t ) row * job->nu;
+    const float*         zRow0;
+    const float*         zRow1;
+    const double*        coef    = NULL;
+    double               v       = job->v0 + row * job->dv;
+    double               fracV   = 0.0;
+    double               mean;
+    double               fracU;
+    double               z00;
+    double               z01;
+    double               z10;
+    double               z11;
+    double               z;
+    size_t               indexV  = 0;
+    size_t               indexU;
+    int                  inCore;
+    int                  i;
+
+    dCrgPerfStatLocal()->counters.noEvaluv2z += job->nu;
+
+    inCore = gridRowFind( crgData, v, &indexV, &fracV );
+
+    /* --- rows outside the core area are left to the full evaluation --- */
+    if ( !inCore )
+    {
+        for ( i = 0; i < job->nu; i++ )
+        {
+            if ( crgDataEvaluv2z( crgData, &( crgData->options ), column[i].u, v, &z ) )
+                out[i] = ( float ) z;
+            else
+                crgSetNanf( out + i );
+        }
+
+        return;
+    }
+
+    zRow0 = crgData->channelZ[indexV].data;
+    zRow1 = crgData->channelZ[indexV+1].data;
+    mean  = crgData->channelZ[indexV].info.mean;
+
+    if ( crgData->cellCoefs.coef )
+        coef = crgData->cellCoefs.coef + 4 * indexV * crgData->cellCoefs.noCellsU;
+
+    /* --- walk along the row; the expressions match crgDataEvaluv2z() for identical results --- */
+    for ( i = 0; i < job->nu; i++ )
+    {
+        if ( !column[i].fast )
+        {
+            if ( crgDataEvaluv2z( crgData, &( crgData->options ), column[i].u, v, &z ) )
+                out[i] = ( float ) z;
+            else
+                crgSetNanf( out + i );
+
+            continue;
+        }
+
+        indexU = column[i].index;
+        fracU  = column[i].frac;
+
+        if ( coef )
+        {
+            const double* c = coef + 4 * indexU;
+
+            out[i] = ( float ) ( c[0] + fracU * c[1] + fracV * ( c[2] + fracU * c[3] ) );
+            continue;
+        }
+
+        z00  = zRow0[indexU];
+        z10  = zRow0[indexU+1] - z00;
+        z01  = zRow1[indexU];
+        z11  = zRow1[indexU+1] - ( z10 + z01 );
+        z01 -= z00;
+
+        z  = ( z11 * fracV + z10 ) * fracU + z01 * fracV + z00;
+        z += mean;
+        z += column[i].refZ;
+
+        if ( crgData->util.hasBank )
+            z += column[i].bank * v;
+
+        out[i] = ( float ) z;
+    }
+}
+
+static void*
+gridWorker( void* arg )
+{
+    CrgGridJobStruct* job = ( CrgGridJobStruct* ) arg;
+    long              row;
+
+    while ( ( row = dCrgAtomicIncrement( &( job->nextRow ) ) - 1 ) < job->nv )
+        gridRowEval( job, ( int ) row );
+
+    return NULL;
+}
+
+#ifdef dCrgEnableThreads
+static void*
+gridThread( void* arg )
+{
+    CrgGridThreadStruct* thread = ( CrgGridThreadStruct* ) arg;
+
+    /* --- dCrgPerfStatLocal() of this thread now refers to the counters in the job --- */
+    mCrgPerfStatLocal = &( thread->perf );
+
+    return gridWorker( thread->job );
+}
+#endif
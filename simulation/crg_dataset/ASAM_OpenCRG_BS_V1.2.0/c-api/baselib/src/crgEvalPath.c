@@ -0,0 +1,308 @@
+/* ===================================================
+ *  sample the road excitation along a path
+ * ---------------------------------------------------
+ *
+ * ASAM OpenCRG C API
+ *
+ * OpenCRG version:           1.2.0
+ *
+ * package:               baselib
+ * file name:             crgEvalPath.c
+ * author:                ASAM e.V.
+ *
+ *
+ * C by ASAM e.V., 2020
+ * Any use is limited to the scope described in the license terms.
+ * The license terms can be viewed at www.asam.net/license
+ *
+ * More Information on ASAM OpenCRG can be found here:
+ * https://www.asam.net/standards/detail/opencrg/
+ *
+ */
+/* ====== INCLUSIONS ====== */
+#include "crgBaseLibPrivate.h"
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ====== DEFINITIONS ====== */
+#define dCrgPathEndTolerance  1.0e-9   /* tolerance for positions beyond the end of the path [m] */
+
+/* ====== TYPE DEFINITIONS ====== */
+/**
+* state of a drive along a path; time and position only increase, so both
+* the speed schedule and the path points are walked incrementally
+*/
+typedef struct
+{
+    const CrgPathStruct* path;
+    double time;        /* time of the last position                                  [s] */
+    double speed;       /* speed at the last position                               [m/s] */
+    double s;           /* distance travelled along the path                          [m] */
+    int    iSpeed;      /* index of the next entry of the speed schedule after time   [-] */
+    int    iPt;         /* index of the current path segment                          [-] */
+    double sSeg;        /* distance at the start of the current segment               [m] */
+    double segLen;      /* length of the current segment                              [m] */
+    double length;      /* total length of the path                                   [m] */
+} CrgPathDriveStruct;
+
+/* ====== LOCAL METHODS ====== */
+/**
+* check a path description and start a drive along it
+* @param path   pointer to the path description
+* @param drive  pointer to the drive to be initialized
+* @param caller name of the calling method for messages
+* @return 1 if the path is valid, otherwise 0
+*/
+static int pathDriveInit( const CrgPathStruct* path, CrgPathDriveStruct* drive, const char* caller );
+
+/**
+* advance a drive to a later time
+* @param drive  pointer to the drive
+* @param time   new time, not before the time of the last position
+*/
+static void pathDriveAdvance( CrgPathDriveStruct* drive, double time );
+
+/**
+* get the speed of a drive at a time between the last entry of the speed
+* schedule before and the next entry
+* @param drive  pointer to the drive
+* @param time   time of interest
+* @return speed at the given time
+*/
+static double pathDriveSpeed( CrgPathDriveStruct* drive, double time );
+
+/**
+* get the length of a segment of the path
+* @param path   pointer to the path description
+* @param iPt    index of the segment
+* @return length of the segment
+*/
+static double pathSegLength( const CrgPathStruct* path, int iPt );
+
+/* ====== IMPLEMENTATION ====== */
+int
+crgEvalPathGetNoSamples( const CrgPathStruct* path, int* noSamples )
+{
+    CrgPathDriveStruct drive;
+    int                k;
+
+    *noSamples = 0;
+
+    if ( !pathDriveInit( path, &drive, "crgEvalPathGetNoSamples" ) )
+        return 0;
+
+    for ( k = 0; k < INT_MAX; k++ )
+    {
+        pathDriveAdvance( &drive, k / path->sampleRate );
+
+        if ( drive.s > drive.length + dCrgPathEndTolerance )
+            break;
+
+        /* --- standing still after the end of the speed schedule --- */
+        if ( drive.iSpeed >= path->noSpeeds && drive.speed <= 0.0 )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "crgEvalPathGetNoSamples: end of path is never reached.\n" );
+            return 0;
+        }
+    }
+
+    *noSamples = k;
+
+    return 1;
+}
+
+int
+crgEvalPathSample( const CrgPathStruct* path, int noTracks, const int* cpId, const double* offset,
+                   int maxSamples, double* z, int* noSamples )
+{
+    CrgPathDriveStruct      drive;
+    CrgContactPointStruct** cp;
+    double                  frac;
+    double                  dirA = 1.0;
+    double                  dirB = 0.0;
+    double                  posA;
+    double                  posB;
+    double                  u;
+    double                  v;
+    int                     k;
+    int                     j;
+    int                     ok;
+
+    *noSamples = 0;
+
+    if ( !pathDriveInit( path, &drive, "crgEvalPathSample" ) )
+        return 0;
+
+    if ( noTracks < 1 || !cpId || !offset || maxSamples < 0 || !z )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgEvalPathSample: invalid wheel tracks or output buffer.\n" );
+        return 0;
+    }
+
+    if ( !( cp = ( CrgContactPointStruct** ) crgCalloc( noTracks, sizeof( CrgContactPointStruct* ) ) ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgEvalPathSample: could not allocate memory for %d tracks.\n", noTracks );
+        return 0;
+    }
+
+    for ( j = 0; j < noTracks; j++ )
+    {
+        if ( !( cp[j] = crgContactPointGetFromId( cpId[j] ) ) )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "crgEvalPathSample: invalid contact point id <%d>.\n", cpId[j] );
+            crgFree( cp );
+            return 0;
+        }
+    }
+
+    for ( k = 0; k < maxSamples; k++ )
+    {
+        pathDriveAdvance( &drive, k / path->sampleRate );
+
+        if ( drive.s > drive.length + dCrgPathEndTolerance )
+            break;
+
+        /* --- move on to the segment holding the position; zero length segments are skipped --- */
+        while ( drive.iPt < path->noPts - 2 && ( drive.segLen <= 0.0 || drive.s > drive.sSeg + drive.segLen ) )
+        {
+            drive.sSeg  += drive.segLen;
+            drive.segLen = pathSegLength( path, ++drive.iPt );
+        }
+
+        if ( drive.segLen > 0.0 )
+        {
+            frac = ( drive.s - drive.sSeg ) / drive.segLen;
+
+            if ( frac > 1.0 )
+                frac = 1.0;
+
+            dirA = ( path->a[drive.iPt+1] - path->a[drive.iPt] ) / drive.segLen;
+            dirB = ( path->b[drive.iPt+1] - path->b[drive.iPt] ) / drive.segLen;
+        }
+        else
+            frac = 0.0;
+
+        posA = path->a[drive.iPt] + frac * ( path->a[drive.iPt+1] - path->a[drive.iPt] );
+        posB = path->b[drive.iPt] + frac * ( path->b[drive.iPt+1] - path->b[drive.iPt] );
+
+        /* --- wheel tracks are offset to the left of the driving direction --- */
+        for ( j = 0; j < noTracks; j++ )
+        {
+            u = posA - dirB * offset[j];
+            v = posB + dirA * offset[j];
+
+            if ( path->type == dCrgPathTypeXY )
+                ok = crgEvalxy2uvPtr( cp[j], u, v, &u, &v ) && crgEvaluv2zPtr( cp[j], u, v, z + ( size_t ) j * maxSamples + k );
+            else
+                ok = crgEvaluv2zPtr( cp[j], u, v, z + ( size_t ) j * maxSamples + k );
+
+            if ( !ok )
+                crgSetNan( z + ( size_t ) j * maxSamples + k );
+        }
+    }
+
+    crgFree( cp );
+
+    *noSamples = k;
+
+    return 1;
+}
+
+static int
+pathDriveInit( const CrgPathStruct* path, CrgPathDriveStruct* drive, const char* caller )
+{
+    int i;
+
+    memset( drive, 0, sizeof( CrgPathDriveStruct ) );
+
+    if ( !path || ( path->type != dCrgPathTypeUV && path->type != dCrgPathTypeXY )
+      || path->noPts < 2 || !path->a || !path->b )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "%s: invalid path points.\n", caller );
+        return 0;
+    }
+
+    if ( path->noSpeeds < 1 || !path->speedTime || !path->speed || !( path->sampleRate > 0.0 ) )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "%s: invalid speed schedule or sample rate.\n", caller );
+        return 0;
+    }
+
+    for ( i = 0; i < path->noSpeeds; i++ )
+    {
+        if ( !( path->speed[i] >= 0.0 ) || ( i > 0 && !( path->speedTime[i] >= path->speedTime[i-1] ) ) )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "%s: invalid entry %d of speed schedule.\n", caller, i );
+            return 0;
+        }
+    }
+
+    for ( i = 0; i < path->noPts - 1; i++ )
+        drive->length += pathSegLength( path, i );
+
+    if ( !( drive->length > 0.0 ) )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "%s: path has no length.\n", caller );
+        return 0;
+    }
+
+    drive->path   = path;
+    drive->segLen = pathSegLength( path, 0 );
+
+    /* --- entries of the schedule up to the start are not integrated --- */
+    while ( drive->iSpeed < path->noSpeeds && path->speedTime[drive->iSpeed] <= 0.0 )
+        drive->iSpeed++;
+
+    drive->speed = pathDriveSpeed( drive, 0.0 );
+
+    return 1;
+}
+
+static void
+pathDriveAdvance( CrgPathDriveStruct* drive, double time )
+{
+    const CrgPathStruct* path = drive->path;
+    double               speed;
+
+    /* --- the speed is linear between the entries of the schedule, so each interval is integrated exactly --- */
+    while ( drive->iSpeed < path->noSpeeds && path->speedTime[drive->iSpeed] <= time )
+    {
+        drive->s    += 0.5 * ( path->speedTime[drive->iSpeed] - drive->time ) * ( drive->speed + path->speed[drive->iSpeed] );
+        drive->time  = path->speedTime[drive->iSpeed];
+        drive->speed = path->speed[drive->iSpeed];
+        drive->iSpeed++;
+    }
+
+    speed = pathDriveSpeed( drive, time );
+
+    drive->s    += 0.5 * ( time - drive->time ) * ( drive->speed + speed );
+    drive->time  = time;
+    drive->speed = speed;
+}
+
+static double
+pathDriveSpeed( CrgPathDriveStruct* drive, double time )
+{
+    const CrgPathStruct* path = drive->path;
+    int                  i    = drive->iSpeed;
+
+    if ( i == 0 )
+        return path->speed[0];
+
+    if ( i == path->noSpeeds )
+        return path->speed[i-1];
+
+    return path->speed[i-1] + ( path->speed[i] - path->speed[i-1] ) * ( time - path->speedTime[i-1] ) / ( path->speedTime[i] - path->speedTime[i-1] );
+}
+
+static double
+pathSegLength( const CrgPathStruct* path, int iPt )
+{
+    double da = path->a[iPt+1] - path->a[iPt];
+    double db = path->b[iPt+1] - path->b[iPt];
+
+    return sqrt( da * da + db * db );
+}
@@ -141,7 +141,7 @@ crgDataEvaluv2pk( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u
         *curv = ( dx0 * dy1 - dy0 * dx1 ) * hd;
         
         /* now take v into account if the corresponding option is set */
-        if ( crgOptionHasValueInt( optionList, dCrgCpOptionCurvMode, dCrgCurvLateral ) &&
+        if ( optionList && ( optionList->flags & dCrgOptFlagCurvLateral ) &&
              fabs( *curv ) > 1.0e-10 )
         {
             double radius = 1.0 / ( *curv ) - v;
@@ -29,6 +29,10 @@
 /* ====== TYPE DEFINITIONS ====== */
 
 /* ====== LOCAL METHODS ====== */
+/**
+* convert x/y into u/v co-ordinates, see crgEvalxy2uvPtr()
+*/
+static int evalxy2uv( CrgContactPointStruct *cp, double x, double y, double* u, double* v );
 
 /* ====== IMPLEMENTATION ====== */
 
@@ -45,6 +49,30 @@ crgEvalxy2uv( int cpId, double x, double y, double* u, double* v )
 
 int 
 crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, double* v )
+{
+    CrgPerfStatThreadStruct* perf;
+    double startTime;
+    int    retVal;
+    
+    if ( !cp )
+        return 0;
+    
+    /* --- take a latency sample? --- */
+    perf = dCrgPerfStatLocal();
+    
+    if ( !crgPerfStatSampleQuery( perf ) )
+        return evalxy2uv( cp, x, y, u, v );
+    
+    startTime = crgPortGetTime();
+    retVal    = evalxy2uv( cp, x, y, u, v );
+    
+    crgPerfStatAddLatency( perf->counters.latencyEvalxy2uv, crgPortGetTime() - startTime );
+    
+    return retVal;
+}
+
+static int 
+evalxy2uv( CrgContactPointStruct *cp, double x, double y, double* u, double* v )
 {
     size_t indexMin = 0;
     int useHist  =  0;
@@ -79,10 +107,20 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
     size_t i;
     int j;
     size_t lastIdx;
+    size_t stride   = 10;      /* step width of global reference line scan        */
+    int    rtSteps  = 0;       /* step limit in real-time mode, 0 = no limit      */
+    int    noSteps;
+    int    rtStatus = dCrgRtStatusOk;
+    int    closeHit = 0;
+    size_t seedIdx  = 0;       /* real-time mode: candidate index from history    */
+    int    hasSeed  = 0;
+    CrgPerfStatStruct* perfStat;
     
     if ( !cp )
         return 0;
     
+    perfStat = &( dCrgPerfStatLocal()->counters );
+    
     /* --- remember the input and compute the fallback solution --- */
     cp->x = x;
     cp->y = y;
@@ -97,6 +135,9 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
         return 1;
     else if ( !( crgData->channelX.info.valid ) )
         return 1;
+    
+    if ( cp->options.flags & dCrgOptFlagRealTime )
+        rtSteps = cp->options.entry[dCrgCpOptionRealTimeSteps].iValue;
 
     /* --- check for the information in the history  --- */
     /* --- look for search start interval in history --- */
@@ -107,10 +148,7 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
         double dx;
         double dy;
         
-#ifdef dCrgEnableStats
-        if ( cp->history.stat.active )
-            cp->history.stat.noIter++;
-#endif
+        perfStat->noHistIter++;
 
         dx = cp->x - cp->history.entry[j].x;
         dy = cp->y - cp->history.entry[j].y;
@@ -121,12 +159,10 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
         if ( dist2 <  cp->history.closeDist )
         {
             useHist  = 1;
+            closeHit = 1;
             indexMin = cp->history.entry[j].index;
             
-#ifdef dCrgEnableStats
-            if ( cp->history.stat.active )
-                cp->history.stat.noCloseHits++;
-#endif
+            perfStat->noHistCloseHits++;
             break;
         } 
         /* --- second choice: find closest point in history which is not too far away (still fairly fast) --- */
@@ -138,10 +174,7 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
                 indexMin = cp->history.entry[j].index;
                 useHist  = 1;
                 
-#ifdef dCrgEnableStats
-                if ( cp->history.stat.active )
-                    cp->history.stat.noFarHits++;
-#endif
+                perfStat->noHistFarHits++;
                 
                 /* --- code runs faster if using first fairly good point instead of waiting for point within closeDist --- */
                 /* --- therefore: stop search and go ahead immediately                                                 --- */
@@ -150,12 +183,39 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
         }
     }
     
+    /* --- real-time mode: a far hit may be many steps away from the target interval; --- */
+    /* --- so treat it like a miss but keep its index as candidate for the scan       --- */
+    if ( rtSteps )
+    {
+        if ( useHist && !closeHit )
+        {
+            useHist = 0;
+            seedIdx = indexMin;
+            hasSeed = 1;
+        }
+        else if ( cp->history.usedSize > 0 )
+        {
+            seedIdx = cp->history.entry[0].index;
+            hasSeed = 1;
+        }
+        
+        if ( seedIdx >= crgData->channelX.info.size )
+            hasSeed = 0;
+    }
+    
     /* --- did not find close enough point in history               --- */
     /* --- third choice: find globally closest reference line point --- */
     if ( !useHist )
     {
         i = 0;
         
+        /* --- real-time mode: scan at most rtSteps points --- */
+        if ( rtSteps && ( size_t ) rtSteps * stride < crgData->channelX.info.size )
+        {
+            stride    = ( crgData->channelX.info.size + rtSteps - 1 ) / rtSteps;
+            rtStatus |= dCrgRtStatusCoarseScan;
+        }
+        
         while ( i < crgData->channelX.info.size )
         {
             double dx = cp->x - crgData->channelX.data[i];
@@ -163,6 +223,8 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
             
             double dist2 = dx * dx + dy * dy;
             
+            perfStat->noScanPts++;
+            
             if ( ( dist2 < dist2Min ) || !i )
             {
                 indexMin = i;
@@ -172,30 +234,63 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
             /* --- make sure last point of a closed reference line is tested --- */
             if ( crgData->util.uIsClosed )
             {
-                if ( i < crgData->channelX.info.size - 10 )
-                    i += 10;
+                if ( i < crgData->channelX.info.size - stride )
+                    i += stride;
                 else if ( i < crgData->channelX.info.size - 1 )
                     i = crgData->channelX.info.size - 1;
                 else
                     break;
             }
-            else if ( i < crgData->channelX.info.size - 10 )
-                i += 10;
+            else if ( i < crgData->channelX.info.size - stride )
+                i += stride;
             else if ( i < crgData->channelX.info.size - 1 )
                 i = crgData->channelX.info.size - 1;
             else
                 break;
         }
-#ifdef dCrgEnableStats
-        if ( cp->history.stat.active )
-            cp->history.stat.noNoHits++;
-#endif
+        
+        /* --- real-time mode: refine the coarse result by a second scan with the same budget --- */
+        if ( rtStatus & dCrgRtStatusCoarseScan )
+        {
+            lastIdx = indexMin + stride;
+            
+            if ( lastIdx > crgData->channelX.info.size - 1 )
+                lastIdx = crgData->channelX.info.size - 1;
+            
+            i      = indexMin > stride ? indexMin - stride : 0;
+            stride = ( 2 * stride + rtSteps - 1 ) / rtSteps;
+            
+            for ( ; i <= lastIdx; i += stride )
+            {
+                double dx = cp->x - crgData->channelX.data[i];
+                double dy = cp->y - crgData->channelY.data[i];
+                
+                double dist2 = dx * dx + dy * dy;
+                
+                perfStat->noScanPts++;
+                
+                if ( dist2 < dist2Min )
+                {
+                    indexMin = i;
+                    dist2Min = dist2;
+                }
+            }
+        }
+        
+        /* --- real-time mode: the history's candidate may be closer than any point of the scan --- */
+        if ( hasSeed )
+        {
+            double dx = cp->x - crgData->channelX.data[seedIdx];
+            double dy = cp->y - crgData->channelY.data[seedIdx];
+            
+            if ( dx * dx + dy * dy < dist2Min )
+                indexMin = seedIdx;
+        }
+        
+        perfStat->noHistNoHits++;
     }
     
-#ifdef dCrgEnableStats
-    if ( cp->history.stat.active )
-        cp->history.stat.noTotalQueries++;
-#endif
+    perfStat->noEvalxy2uv++;
 
 /* -- found the start? --- */
     if ( indexMin < 1 )
@@ -210,6 +305,7 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
      *  P :               (X , Y ) (current input from subroutine call)
      */
      t_dProd = 0.0;
+     noSteps = 0;
 
      for(;;)
      {
@@ -234,13 +330,17 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
         *   to make hd negative
         */
         
-#ifdef dCrgEnableStats
-        if ( cp->history.stat.active )
-            cp->history.stat.noCallsLoop1++;
-#endif
+        perfStat->noLoop1++;
 
         if ( dProd > 0.0 )
         {
+             /* --- real-time mode: bounded number of steps --- */
+             if ( rtSteps && ++noSteps > rtSteps )
+             {
+                 rtStatus |= dCrgRtStatusStepLimit;
+                 break;
+             }
+             
              if ( indexMin < ( crgData->channelX.info.size - 1 ) )
                  indexMin++;
              else if(crgData->util.uIsClosed)
@@ -267,6 +367,8 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
     *  so let's correct that
     */    
     
+    noSteps = 0;
+    
     for(;;)
     {
         size_t indexM2 = 0;
@@ -301,13 +403,17 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
         *   to make hd positive
         */
         
-#ifdef dCrgEnableStats
-        if ( cp->history.stat.active )
-            cp->history.stat.noCallsLoop2++;
-#endif
+        perfStat->noLoop2++;
 
         if ( dProd < 0.0 )
         {
+            /* --- real-time mode: bounded number of steps --- */
+            if ( rtSteps && ++noSteps > rtSteps )
+            {
+                rtStatus |= dCrgRtStatusStepLimit;
+                break;
+            }
+            
             if ( indexMin > 1 )
                 indexMin--;
             else if (crgData->util.uIsClosed)
@@ -424,10 +530,10 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
     }
 
     /* --- remember result in history --- */
-    if ( cp->history.totalSize > 1 )
+    if ( cp->history.totalSize > 1 && ( cp->history.entry || crgContactPointPtrAllocHistory( cp ) ) )
     {
         /* --- avoid registering twice for the same index --- */
-        if ( cp->history.entry[0].index != indexP1 )
+        if ( !cp->history.usedSize || cp->history.entry[0].index != indexP1 )
         {
             memmove( &( cp->history.entry[1] ), cp->history.entry, ( cp->history.totalSize - 1 ) * cp->history.entrySize );
             
@@ -440,6 +546,15 @@ crgEvalxy2uvPtr( CrgContactPointStruct *cp, double x, double y, double* u, doubl
         cp->history.entry[0].index = indexP1;
     }
     
+    /* --- report degraded accuracy in real-time mode --- */
+    if ( rtSteps )
+    {
+        cp->rtStatus = rtStatus;
+        
+        if ( rtStatus & dCrgRtStatusStepLimit )
+            cp->rtNoDegraded++;
+    }
+    
     *u = cp->u;
     *v = cp->v;
     
@@ -457,7 +572,7 @@ crgEvalu2uvalid( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double* u
     
     if ( *u < crgData->util.uCloseMin || *u > crgData->util.uCloseMax )
     {
-        if ( crgOptionHasValueInt( optionList, dCrgCpOptionRefLineContinue, dCrgRefLineCloseTrack ) )
+        if ( optionList->flags & dCrgOptFlagCloseTrack )
         {                
             /* --- clip incoming u value to the correct range --- */
             *u = fmod( *u - crgData->util.uCloseMin, crgData->util.uCloseMax - crgData->util.uCloseMin );
@@ -48,16 +48,29 @@ crgEvaluv2z( int cpId, double u, double v, double* z )
 int crgEvaluv2zPtr( CrgContactPointStruct *cp, double u, double v, double* z )
 {
     int retVal = 0;
+    CrgPerfStatThreadStruct* perf;
+    double startTime = 0.0;
+    int    sample;
     
     if ( !cp )
         return 0;
     
+    /* --- take a latency sample? --- */
+    perf   = dCrgPerfStatLocal();
+    sample = crgPerfStatSampleQuery( perf );
+    
+    if ( sample )
+        startTime = crgPortGetTime();
+    
     /* --- compute the fallback solution --- */
     cp->u = u;
     cp->v = v;
     
     retVal = crgDataEvaluv2z( cp->crgData, &( cp->options ), cp->u, cp->v, &( cp->z ) );
     
+    if ( sample )
+        crgPerfStatAddLatency( perf->counters.latencyEvaluv2z, crgPortGetTime() - startTime );
+    
     /* --- transfer the result --- */
     *z = cp->z;
     
@@ -85,12 +98,15 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
     double z11;
     double bank;
     double zOffset        = 0.0;
+    int    cellDone       = 0;     /* value computed from cell coefficients, incl. reference line z and banking */
     double smoothScale    = 1.0;   /* scale from smoothing option        */
     double smoothZone     = 0.0;   /* length of smoothing zone           */
     double smoothBase     = 0.0;   /* base value against which to smooth */
 
     int borderModeU       = dCrgBorderModeNone;
     int borderModeV       = dCrgBorderModeExKeep;
+    
+    CrgPerfStatStruct* perfStat = &( dCrgPerfStatLocal()->counters );
 
     /* --- compute the fallback solution --- */
     *z = 0.0;
@@ -98,11 +114,7 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
     if ( !crgData )
         return 0;
     
-    /* --- doing performance measurements? --- */
-#ifdef dCrgEnableStats
-    if ( crgData->perfStat.active )
-        crgData->perfStat.noTotalQueries++;
-#endif
+    perfStat->noEvaluv2z++;
     
     /* --- incoming u value might have to be clipped to correct range --- */
     /* --- if a closed reference line is to be used                   --- */
@@ -117,10 +129,7 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
     if ( ( u < crgData->channelU.info.first ) || ( u > crgData->channelU.info.last ) )
     {
         
-#ifdef dCrgEnableStats
-        if ( crgData->perfStat.active )
-            crgData->perfStat.noCallsBorderU++;
-#endif
+        perfStat->noBorderU++;
         
         /* --- leaving the core area --- */
         inCoreAreaU = 0;
@@ -128,7 +137,7 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
         if ( !optionList )
             return 0;
             
-        if ( optionList->entry[dCrgCpOptionBorderModeU].valid )
+        if ( optionList->flags & dCrgOptFlagBorderModeU )
             borderModeU = optionList->entry[dCrgCpOptionBorderModeU].iValue;
         
         if ( borderModeU == dCrgBorderModeNone )
@@ -196,8 +205,8 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
         }
         
         /* --- any offset option valid? --- */
-        if ( optionList  )
-            zOffset += optionList->entry[dCrgCpOptionBorderOffsetU].valid ? optionList->entry[dCrgCpOptionBorderOffsetU].dValue : 0.0;
+        if ( optionList && ( optionList->flags & dCrgOptFlagBorderOffsetU ) )
+            zOffset += optionList->entry[dCrgCpOptionBorderOffsetU].dValue;
     }
     
     /* --- calculate / correct the u index? --- */
@@ -236,7 +245,7 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
             if ( !optionList )
                 return 0;
             
-            if ( optionList->entry[dCrgCpOptionBorderModeV].valid )
+            if ( optionList->flags & dCrgOptFlagBorderModeV )
                 borderModeV = optionList->entry[dCrgCpOptionBorderModeV].iValue;
         
             if ( borderModeV == dCrgBorderModeNone )
@@ -298,8 +307,8 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
             }
             
             /* --- any offset option valid? --- */
-            if ( optionList )
-                zOffset += optionList->entry[dCrgCpOptionBorderOffsetV].valid ? optionList->entry[dCrgCpOptionBorderOffsetV].dValue : 0.0;
+            if ( optionList && ( optionList->flags & dCrgOptFlagBorderOffsetV ) )
+                zOffset += optionList->entry[dCrgCpOptionBorderOffsetV].dValue;
         }
         
         /* --- calculate / correct the v index? --- */
@@ -337,10 +346,7 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
 
             borderModeV = dCrgBorderModeExKeep;
         
-#ifdef dCrgEnableStats
-            if ( crgData->perfStat.active )
-                crgData->perfStat.noCallsBorderV++;
-#endif
+            perfStat->noBorderV++;
  
             /* --- compensate for numeric inaccuracies at the original borders --- */
             if ( fabs( vPos - crgData->channelV.info.first ) < dMaxBorderError )
@@ -352,7 +358,7 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
                 if ( !optionList )
                     return 0;
 
-                if ( ( optionList->entry[dCrgCpOptionBorderModeV].valid ) )
+                if ( optionList->flags & dCrgOptFlagBorderModeV )
                     borderModeV = optionList->entry[dCrgCpOptionBorderModeV].iValue;
                 
                 if ( borderModeV == dCrgBorderModeNone )
@@ -420,8 +426,8 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
             }
             
             /* --- any offset option valid? --- */
-            if ( optionList )
-                zOffset += optionList->entry[dCrgCpOptionBorderOffsetV].valid ? optionList->entry[dCrgCpOptionBorderOffsetV].dValue : 0.0;
+            if ( optionList && ( optionList->flags & dCrgOptFlagBorderOffsetV ) )
+                zOffset += optionList->entry[dCrgCpOptionBorderOffsetV].dValue;
         }
 
         if ( calcIndex )
@@ -463,10 +469,7 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
             
             while ( 1 )
             {
-#ifdef dCrgEnableStats
-                if ( crgData->perfStat.active )
-                    crgData->perfStat.noCallsLoopV1++;
-#endif
+                perfStat->noLoopV++;
                 
                 indexCtr = ( index0 + indexV ) / 2;
                 
@@ -488,6 +491,21 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
         }
     }
     
+    /* --- pre-computed cell coefficients: z data, reference line z and banking in one step;  --- */
+    /* --- not applicable if v of the banking term differs from the one of the interpolation, --- */
+    /* --- i.e. for banked data sets evaluated in a repeated or reflected v border area       --- */
+    if ( calcValue && crgData->cellCoefs.coef 
+      && ( !crgData->util.hasBank || borderModeV == dCrgBorderModeExKeep 
+        || ( v >= crgData->channelV.info.first && v <= crgData->channelV.info.last ) ) )
+    {
+        const double* c = crgData->cellCoefs.coef + 4 * ( indexV * crgData->cellCoefs.noCellsU + indexU );
+        
+        *z = c[0] + fracU * c[1] + fracV * ( c[2] + fracU * c[3] );
+        
+        cellDone  = 1;
+        calcValue = 0;
+    }
+    
     if ( calcValue )
     {
         /* evaluate z(u, v) by bilinear interpolation */
@@ -506,13 +524,13 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
     /* --- is a transition (smooth) option set? --- */
     if ( optionList )
         {
-            if ( optionList->entry[dCrgCpOptionSmoothUBegin].valid || optionList->entry[dCrgCpOptionSmoothUEnd].valid )
+            if ( optionList->flags & ( dCrgOptFlagSmoothUBegin | dCrgOptFlagSmoothUEnd ) )
                 {
 
                     if ( inCoreAreaU || calcSmoothBase )
                         {
                             /* NOTE: smoothZone cannot be 0.0; this is checked when setting the option */
-                            if ( optionList->entry[dCrgCpOptionSmoothUBegin].valid )
+                            if ( optionList->flags & dCrgOptFlagSmoothUBegin )
                                 {
                                     smoothZone = optionList->entry[dCrgCpOptionSmoothUBegin].dValue;
                         
@@ -526,7 +544,7 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
                                             calcSmooth     = 1;
                                         }
                                 }
-                            if ( optionList->entry[dCrgCpOptionSmoothUEnd].valid )
+                            if ( optionList->flags & dCrgOptFlagSmoothUEnd )
                                 {
                                     smoothZone = optionList->entry[dCrgCpOptionSmoothUEnd].dValue;
                         
@@ -571,13 +589,15 @@ crgDataEvaluv2z( CrgDataStruct *crgData, CrgOptionsStruct* optionList, double u,
 
     /* --- add slope, banking, offsets and smoothing --- */
     /* add z displacement from reference line z data */
-    if ( crgData->channelRefZ.info.valid )
+    if ( cellDone )
+        ;   /* --- already contained in cell coefficients --- */
+    else if ( crgData->channelRefZ.info.valid )
        *z += crgData->channelRefZ.data[indexU] + fracU * ( crgData->channelRefZ.data[indexU+1] - crgData->channelRefZ.data[indexU] );
     else
         *z += crgData->channelRefZ.info.first;
 
     /* add z displacement from banking */
-    if ( crgData->util.hasBank && calcBank )
+    if ( crgData->util.hasBank && calcBank && !cellDone )
     {
         if ( crgData->channelBank.info.valid )
             bank = crgData->channelBank.data[indexU] + fracU * ( crgData->channelBank.data[indexU+1] - crgData->channelBank.data[indexU] );
@@ -622,22 +642,33 @@ crgEvalxy2z( int cpId, double x, double y, double* z )
     double u;
     double v;
     CrgContactPointStruct* cp = NULL;
+    static volatile long   sNaNWarnCount = 0;
     
-#ifdef dCrgEnableDebug2
-    if ( crgIsNan( &x ) || crgIsNan( &y ) || x !=x || y !=y )
-    {
-        crgMsgPrint( dCrgMsgLevelWarn, "crgEvalxy2z: got NaN for x and/or y position. Refusing evaluation.\n" );
+    if ( !( cp = crgContactPointGetFromId( cpId ) ) )
         return 0;
-    }
-    else
+    
+    /* --- NaN positions may arrive at every step of a simulation, so the warning is rate limited --- */
+    if ( x != x || y != y )
     {
-        crgMsgPrint( dCrgMsgLevelNotice, "crgEvalxy2z: cpId = %d, x = %.6f, y = %.6f\n", cpId, x, y );
-    }
+        /* --- no I/O in real-time mode --- */
+        if ( !( cp->options.flags & dCrgOptFlagRealTime ) && crgPortMsgRateLimit( &sNaNWarnCount ) )
+        {
+#ifdef dCrgEnableDebug2
+            crgMsgPrint( dCrgMsgLevelWarn, "crgEvalxy2z: got NaN for x and/or y position. Refusing evaluation.\n" );
+#else
+            crgMsgPrint( dCrgMsgLevelWarn, "crgEvalxy2z: got NaN for x and/or y position.\n" );
 #endif
-
-    if ( !( cp = crgContactPointGetFromId( cpId ) ) )
+        }
+#ifdef dCrgEnableDebug2
         return 0;
+#endif
+    }
     
+#ifdef dCrgEnableDebug2
+    if ( !( cp->options.flags & dCrgOptFlagRealTime ) )
+        dCrgMsgIfActive( dCrgMsgLevelNotice, ( dCrgMsgLevelNotice, "crgEvalxy2z: cpId = %d, x = %.6f, y = %.6f\n", cpId, x, y ) );
+#endif
+
     if ( !crgEvalxy2uvPtr( cp, x, y, &u, &v ) )
         return 0;
     
@@ -29,10 +29,16 @@
 #include <fcntl.h>
 #include <ctype.h>
 #include <math.h>
+#include <time.h>
 
 /* ====== DEFINITIONS ====== */
 #define dCrgLoaderMaxTagLen           128
 #define dCrgLoaderBufferLen          1024
+#define dCrgLoaderTagHashSize         256   /* must be a power of 2 and exceed the total number of tags */
+#define dCrgLoaderTagHashSeed  2166136261UL   /* FNV-1a offset basis */
+#define dCrgLoaderReloadBlockRecs      64   /* records per checksum block of the data section */
+#define dCrgLoaderSumPrime     16777619UL   /* FNV-1a prime */
+#define dCrgLoaderTileSize          16384   /* size of the tile of decoded binary records [byte] */
 
 #define dOpcodeNone                     0
 #define dOpcodeRefLineStartU            1
@@ -72,6 +78,7 @@
 #define dDataFormatPrecisionDouble 0x0008
 #define dDataFormatASCII           0x0010
 #define dDataFormatBinary          0x0020
+#define dDataFormatCompressed      0x0040
 
 #ifdef _WIN64
 #    define stat _stat64
@@ -89,6 +96,34 @@ typedef struct
     int  opcode;
 } CrgReaderCallbackStruct;
 
+typedef struct
+{
+    CrgReaderCallbackStruct* table;   /* callback table the tag belongs to                         */
+    CrgReaderCallbackStruct* entry;   /* first entry of the table matching a line starting with tag */
+    const char*              tag;     /* the tag itself                                             */
+    unsigned long            hash;    /* hash value of the lower case tag                           */
+    size_t                   len;     /* length of the tag                                          */
+} CrgReaderTagHashStruct;
+
+typedef struct CrgReloadStruct
+{
+    char*          filename;          /* name of the file the data set has been read from            */
+    time_t         mtime;             /* time of last modification when the file was read            */
+    time_t         readTime;          /* time when the file was read                                 */
+    size_t         fileSize;          /* size of the file when it was read                    [byte] */
+    int            hasIncludes;       /* file refers to include files, which are not tracked  [0/1] */
+    int            isCompressed;      /* data section is compressed, blocks are tracked decoded [0/1] */
+    size_t         hdrSize;           /* size of everything in front of the data section      [byte] */
+    unsigned long  hdrSum;            /* checksum of everything in front of the data section         */
+    unsigned long  layoutSum;         /* checksum of the data layout defined by the header           */
+    size_t         noRecords;         /* number of records in the data section                       */
+    size_t         noBlocks;          /* number of checksum blocks, 0 if the data is not tracked     */
+    size_t*        blockOffset;       /* offset of each block in the data section, plus end   [byte] */
+    unsigned long* blockSum;          /* checksum of each block                                      */
+    size_t         noDecoded;         /* number of blocks decoded while reading                      */
+    CrgDataStruct* image;             /* decoded, not yet prepared data; kept once a data set is reloaded */
+} CrgReloadStruct;
+
 /* ====== LOCAL METHODS ====== */
 /**
 * initialize a data structure
@@ -132,6 +167,31 @@ static int terminateReader( CrgDataStruct* crgData, int retCode );
 */
 static int  ( *scanTagsForCallback( const char* buffer, CrgReaderCallbackStruct* cbs, int* opcode ) ) ();
 
+/**
+* hash a single (lower case) character into an existing hash value
+* @param hash    hash value of the preceding characters
+* @param c       character which is to be added
+* @return the updated hash value
+*/
+static unsigned long tagHashAddChar( unsigned long hash, char c );
+
+/**
+* insert all tags of a callback table into the tag hash table
+* @param cbs     pointer to the callback table
+* @return 1 if successful, 0 if the hash table is full
+*/
+static int tagHashInsertTable( CrgReaderCallbackStruct* cbs );
+
+/**
+* look up a tag of given length in the tag hash table
+* @param cbs     pointer to the callback table the tag must belong to
+* @param hash    hash value of the tag
+* @param tag     pointer to the (not terminated) tag
+* @param len     length of the tag
+* @return pointer to the matching callback entry or NULL if not found
+*/
+static CrgReaderCallbackStruct* tagHashLookup( CrgReaderCallbackStruct* cbs, unsigned long hash, const char* tag, size_t len );
+
 /**
 * check whether the first tag contained in the buffer is and "end-of-section" tag
 * @param buffer     the ASCII buffer which is to be evaluated
@@ -311,6 +371,43 @@ static int allocateChannels( CrgDataStruct* crgData );
 */
 static void readData( CrgDataStruct* crgData );
 
+/**
+* read binary CRG data block by block: the records of a block are decoded into
+* a tile of float values at once, which is then transposed into the z channels
+* @param  crgData     pointer to the CRG data set which is to be altered
+*/
+static void readDataBinary( CrgDataStruct* crgData );
+
+/**
+* decode the values of a block of binary records; NaNs are replaced by the
+* value set by crgSetNanf()
+* @param  crgData     pointer to the CRG data set
+* @param  recPtr      pointer to the first record of the block
+* @param  noRecords   number of records in the block
+* @param  tile        target of the values, noRecords x noChannels
+*/
+static void decodeBlock( CrgDataStruct* crgData, const char* recPtr, size_t noRecords, CrgNanUnionFloat* tile );
+
+/**
+* copy the channel data of the decoded record into the channels
+* @param  crgData     pointer to the CRG data set which is to be altered
+* @param  nRec        index of the record
+*/
+static void storeRecord( CrgDataStruct* crgData, size_t nRec );
+
+/**
+* copy the reference line data of the decoded record into the channels
+* @param  crgData     pointer to the CRG data set which is to be altered
+* @param  nRec        index of the record
+*/
+static void storeRefLineRecord( CrgDataStruct* crgData, size_t nRec );
+
+/**
+* release the data of all channels which are allocated by allocateChannels()
+* @param  crgData     pointer to the CRG data set which is to be altered
+*/
+static void releaseChannelData( CrgDataStruct* crgData );
+
 /**
 * calculate the CRG reference line
 * @param  crgData     pointer to the CRG data set which is to be altered
@@ -330,7 +427,8 @@ static void calcRefLineZ( CrgDataStruct* crgData );
 static void normalizeRefLine( CrgDataStruct* crgData );
 
 /**
-* normalize the CRG z data
+* normalize the CRG z data and collect the elevation statistics (min/max and
+* mean values at begin and end) in the same pass
 * @param  crgData     pointer to the CRG data set which is to be altered
 */
 static void normalizeZ( CrgDataStruct* crgData );
@@ -341,6 +439,14 @@ static void normalizeZ( CrgDataStruct* crgData );
 */
 static void smoothenRefLine( CrgDataStruct* crgData );
 
+/**
+* run the consistency checks of a data set, stopping at the first failure;
+* called by crgCheck() only if no valid result of a previous check is cached
+* @param  crgData     pointer to the CRG data set which is to be checked
+* @return 1 if all checks passed, otherwise 0
+*/
+static int checkDataSet( CrgDataStruct* crgData );
+
 /**
 * read a double value from the data set and perform any necessary endian conversion
 * @param dataPtr pointer where to start reading the number from
@@ -363,6 +469,26 @@ static int readFloat( char* dataPtr, float* tgt );
 */
 static int isLittleEndian( void );
 
+/**
+* get the size of the binary data section without the NaN values padding it
+* to a multiple of 80 bytes; records shorter than 80 bytes which consist of
+* padding only are removed, as in ipl_read.m
+* @param crgData    pointer to the CRG data set
+* @param nBytes     number of bytes in the data section
+* @return number of bytes in the data section without padding records
+*/
+static size_t stripPadding( CrgDataStruct* crgData, size_t nBytes );
+
+/**
+* decode a compressed data section; the file buffer is replaced by one holding
+* the header followed by the decoded single precision binary records, so the
+* data section is read like any binary one afterwards
+* @param crgData    pointer to the CRG data set
+* @param nBytes     number of bytes in the compressed data section
+* @return number of bytes in the decoded data section, 0 if failed
+*/
+static size_t inflateData( CrgDataStruct* crgData, size_t nBytes );
+
 /**
 * check whether the first string begins with the characters of the second, ignoring case;
 * this method was introduced due to incompatibility of strncasecmp with
@@ -395,6 +521,99 @@ static int decodeIncludeFile( CrgDataStruct* crgData, const char* buffer, int co
 */
 static int crgLoaderAddFile( const char* filename, CrgDataStruct** crgData );
 
+/**
+* read a CRG file and prepare its data
+* @param filename   full filename of the CRG input file including path
+* @param crgData    pointer to the resulting data set, set even if reading fails
+* @return 1 if successful, otherwise 0
+*/
+static int loadFile( const char* filename, CrgDataStruct** crgData );
+
+/**
+* update a checksum with a block of data
+* @param sum        checksum of the preceding data
+* @param data       data to be added
+* @param size       number of bytes in data
+* @return the updated checksum
+*/
+static unsigned long reloadChecksum( unsigned long sum, const char* data, size_t size );
+
+/**
+* update a checksum with the information of a channel
+* @param sum        checksum of the preceding data
+* @param info       channel information to be added
+* @return the updated checksum
+*/
+static unsigned long reloadSumInfo( unsigned long sum, const CrgChannelInfoStruct* info );
+
+/**
+* compute the checksum of the data layout defined by the file header
+* @param crgData    pointer to the CRG data set after parsing the header
+* @return the checksum
+*/
+static unsigned long reloadLayoutSum( CrgDataStruct* crgData );
+
+/**
+* compute the checksums of the header and of the blocks of the data section
+* @param crgData    pointer to the CRG data set after parsing the header
+* @param reload     reload information which is to be filled
+* @param nBytes     number of bytes available in the data section
+* @return 1 if successful, otherwise 0
+*/
+static int reloadScanData( CrgDataStruct* crgData, CrgReloadStruct* reload, size_t nBytes );
+
+/**
+* copy a range of records of all channels read from file
+* @param dst        data set receiving the records
+* @param src        data set providing the records
+* @param first      index of the first record
+* @param count      number of records
+*/
+static void reloadCopyRecords( CrgDataStruct* dst, CrgDataStruct* src, size_t first, size_t count );
+
+/**
+* take over the decoded data of the previous read, decoding only the modified blocks
+* @param crgData    pointer to the CRG data set after parsing the header
+* @return 1 if the data has been taken over, 0 if it has to be decoded completely
+*/
+static int reloadReuseData( CrgDataStruct* crgData );
+
+/**
+* keep a copy of the decoded data for the next reload
+* @param crgData    pointer to the CRG data set after reading the data
+* @param reload     reload information which is to hold the copy
+*/
+static void reloadKeepImage( CrgDataStruct* crgData, CrgReloadStruct* reload );
+
+/**
+* release the copy of the decoded data
+* @param image      the copy
+*/
+static void reloadReleaseImage( CrgDataStruct* image );
+
+/**
+* release reload information
+* @param reload     the reload information, may be NULL
+*/
+static void reloadRelease( CrgReloadStruct* reload );
+
+/**
+* read the contents of a file for reloading
+* @param filename   name of the file
+* @param size       expected size of the file
+* @return the contents, allocated with crgCalloc(), or NULL if not successful
+*/
+static char* reloadReadFile( const char* filename, size_t size );
+
+/**
+* check whether the contents of a file match the checksums of its previous read
+* @param reload     reload information of the previous read
+* @param buffer     current contents of the file
+* @param size       current size of the file
+* @return 1 if the contents match, otherwise 0
+*/
+static int reloadIsUnchanged( CrgReloadStruct* reload, const char* buffer, size_t size );
+
 /* ====== LOCAL VARIABLES ====== */
 
 static CrgReaderCallbackStruct	sLoaderCallbacksCommon[] =
@@ -513,6 +732,10 @@ static CrgReaderCallbackStruct	sLoaderCallbacksFile[] =
    { "",   NULL,               -1                 }
 };
 
+/* hash table of the tags of all callback tables above, built by crgLoaderInit() */
+static CrgReaderTagHashStruct sTagHash[dCrgLoaderTagHashSize];
+static size_t                 sTagHashMaxLen = 0;    /* length of the longest tag, 0 if table is not built */
+
 /* ====== GLOBAL VARIABLES ====== */
 int mCrgBigEndian =  0;             /* internal data format is little endian per default */
 
@@ -521,6 +744,11 @@ static int mFileLevel =  0;      /* level at which current file is being read (f
 static int mOptLevel  = -1;      /* level at which current options have been defined              */
 static int mModLevel  = -1;      /* level at which current modifiers have been defined            */
 
+static CrgReloadStruct* sReloadNext       = NULL;   /* reload information collected by the current read      */
+static CrgReloadStruct* sReloadPrev       = NULL;   /* reload information of the data set being reloaded     */
+static char*            sReloadBuffer     = NULL;   /* contents of the primary file read by crgDataSetReload() */
+static size_t           sReloadBufferSize = 0;      /* size of these contents                          [byte] */
+
 /* ====== IMPLEMENTATION ====== */
 static void
 initData( CrgDataStruct* crgData )
@@ -607,6 +835,10 @@ terminateReader( CrgDataStruct *crgData, int retCode )
 static int ( *scanTagsForCallback( const char* buffer, CrgReaderCallbackStruct* cbs, int* opcode ) ) ()
 {
     const char* checkPtr = buffer;
+    CrgReaderCallbackStruct* match = NULL;
+    CrgReaderCallbackStruct* entry;
+    unsigned long hash = dCrgLoaderTagHashSeed;
+    size_t len;
     
     /* --- reset the resulting opcode --- */
     *opcode = dOpcodeNone;
@@ -615,6 +847,26 @@ static int ( *scanTagsForCallback( const char* buffer, CrgReaderCallbackStruct*
     while ( *checkPtr == ' ' )
         checkPtr++;
     
+    /* --- hashed dispatch: look up each prefix of the line up to the longest tag;  --- */
+    /* --- as in the linear scan below, the first matching entry of the table wins --- */
+    if ( sTagHashMaxLen )
+    {
+        for ( len = 1; len <= sTagHashMaxLen && checkPtr[len-1]; len++ )
+        {
+            hash = tagHashAddChar( hash, checkPtr[len-1] );
+            
+            if ( ( entry = tagHashLookup( cbs, hash, checkPtr, len ) ) && ( !match || entry < match ) )
+                match = entry;
+        }
+        
+        if ( !match )
+            return NULL;
+        
+        *opcode = match->opcode;
+        return ( int( * ) () ) ( match->func );
+    }
+    
+    /* --- fallback: linear scan of the table --- */
     while ( cbs )
     {
         /* function defined? */
@@ -633,6 +885,91 @@ static int ( *scanTagsForCallback( const char* buffer, CrgReaderCallbackStruct*
     return NULL;
 }
 
+static unsigned long
+tagHashAddChar( unsigned long hash, char c )
+{
+    /* --- FNV-1a on the lower case character --- */
+    return ( ( hash ^ ( unsigned long ) ( unsigned char ) tolower( c ) ) * 16777619UL ) & 0xffffffffUL;
+}
+
+static int
+tagHashInsertTable( CrgReaderCallbackStruct* cbs )
+{
+    CrgReaderCallbackStruct* entry;
+    CrgReaderCallbackStruct* winner;
+    unsigned long hash;
+    size_t len;
+    size_t i;
+    size_t slot;
+    
+    for ( entry = cbs; entry->func; entry++ )
+    {
+        hash = dCrgLoaderTagHashSeed;
+        len  = strlen( entry->tag );
+        
+        for ( i = 0; i < len; i++ )
+            hash = tagHashAddChar( hash, entry->tag[i] );
+        
+        /* --- same tag defined before? then the earlier entry is the one being used --- */
+        if ( tagHashLookup( cbs, hash, entry->tag, len ) )
+            continue;
+        
+        /* --- a line starting with this tag is matched by the first entry which is a prefix of the tag --- */
+        for ( winner = cbs; winner != entry; winner++ )
+            if ( crgStrBeginsWithStrNoCase( entry->tag, winner->tag ) )
+                break;
+        
+        /* --- find a free slot --- */
+        for ( i = 0, slot = hash & ( dCrgLoaderTagHashSize - 1 ); i < dCrgLoaderTagHashSize; i++, slot = ( slot + 1 ) & ( dCrgLoaderTagHashSize - 1 ) )
+            if ( !sTagHash[slot].table )
+                break;
+        
+        if ( i == dCrgLoaderTagHashSize )
+            return 0;
+        
+        sTagHash[slot].table = cbs;
+        sTagHash[slot].entry = winner;
+        sTagHash[slot].tag   = entry->tag;
+        sTagHash[slot].hash  = hash;
+        sTagHash[slot].len   = len;
+        
+        if ( len > sTagHashMaxLen )
+            sTagHashMaxLen = len;
+    }
+    
+    return 1;
+}
+
+static CrgReaderCallbackStruct*
+tagHashLookup( CrgReaderCallbackStruct* cbs, unsigned long hash, const char* tag, size_t len )
+{
+    CrgReaderTagHashStruct* item;
+    size_t i;
+    size_t j;
+    size_t slot;
+    
+    for ( i = 0, slot = hash & ( dCrgLoaderTagHashSize - 1 ); i < dCrgLoaderTagHashSize; i++, slot = ( slot + 1 ) & ( dCrgLoaderTagHashSize - 1 ) )
+    {
+        item = &( sTagHash[slot] );
+        
+        if ( !item->table )
+            return NULL;
+        
+        if ( item->table != cbs || item->hash != hash || item->len != len )
+            continue;
+        
+        /* --- verify the characters, the hash may collide --- */
+        for ( j = 0; j < len; j++ )
+            if ( tolower( tag[j] ) != tolower( item->tag[j] ) )
+                break;
+        
+        if ( j == len )
+            return item->entry;
+    }
+    
+    return NULL;
+}
+
 static int tagIsEndOfSection( const char* buffer )
 {
     const char* checkPtr = buffer;
@@ -1170,6 +1507,7 @@ decodeDataFormat( CrgDataStruct* crgData, const char* buffer, int code )
     crgData->admin.dataFormat |= strchr( dataFormat, 'L' ) ? dDataFormatLong            : dDataFormatCompact;
     crgData->admin.dataFormat |= strchr( dataFormat, 'D' ) ? dDataFormatPrecisionDouble : dDataFormatPrecisionSingle;
     crgData->admin.dataFormat |= strchr( dataFormat, 'F' ) ? dDataFormatASCII           : dDataFormatBinary;
+    crgData->admin.dataFormat |= strchr( dataFormat, 'Z' ) ? dDataFormatCompressed      : dDataFormatUndefined;
 
     return 1;
 }
@@ -1224,6 +1562,14 @@ checkHeaderConsistency( CrgDataStruct *crgData )
         return 0;
     }
     
+    /* --- compression is defined for compact single precision binary data only --- */
+    if ( ( crgData->admin.dataFormat & dDataFormatCompressed )
+      && ( crgData->admin.dataFormat & ( dDataFormatLong | dDataFormatPrecisionDouble | dDataFormatASCII ) ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgLoader: compressed data must be of format KRBZ\n" );
+        return 0;
+    }
+    
     return 1;
 }
 
@@ -1452,7 +1798,7 @@ parseFileHeader( CrgDataStruct* crgData, char **dataPtr, size_t* nBytesLeft )
                         
                         /* --- the number of bytes to be read may differ from the remaining file size due to alignment issues --- */
                         /* --- therefore, calculate the maximum size which is to be read                                      --- */
-                        if ( crgData->admin.dataFormat & dDataFormatBinary )
+                        if ( ( crgData->admin.dataFormat & dDataFormatBinary ) && !( crgData->admin.dataFormat & dDataFormatCompressed ) )
                         {
                             *nBytesLeft = crgData->admin.recordSize * ( ( size_t ) ( ( crgData->channelU.info.last - crgData->channelU.info.first ) / crgData->channelU.info.inc + 0.5 ) + 1 );
                             
@@ -1872,43 +2218,19 @@ readData( CrgDataStruct* crgData )
 {
     char   *recPtr      = crgData->admin.dataSection;        /* pointer to begin of record */
     size_t srcBytesLeft = crgData->admin.dataSize;
-    size_t i;
     size_t nRec = 0;
     
+    /* --- binary records have a fixed size and may be decoded block by block --- */
+    if ( crgData->admin.dataFormat & dDataFormatBinary )
+    {
+        readDataBinary( crgData );
+        return;
+    }
+    
     /* --- parse through all records --- */
     while ( decodeNextRecord( crgData, &recPtr, &srcBytesLeft ) )
     {
-        /* crgMsgPrint( dCrgMsgLevelNotice, "readData: channelZ at cross section no. %ld\n", nRec ); */
-        for ( i = 0; i < crgData->channelV.info.size; i++ )
-        {
-            if ( crgIsNan( &( crgData->admin.recordBuffer[crgData->channelZ[i].info.index] ) ) )
-                crgSetNanf( &( crgData->channelZ[i].data[nRec] ) );
-            else
-                crgData->channelZ[i].data[nRec] = ( float ) crgData->admin.recordBuffer[crgData->channelZ[i].info.index];
-        }
-        /* crgMsgPrint( dCrgMsgLevelNotice, "readData: channelZ at cross section no. %ld finished.\n", nRec ); */
-        
-        if ( crgData->channelX.info.defined )
-        {
-            crgData->channelX.data[nRec] = crgData->admin.recordBuffer[crgData->channelX.info.index];
-            crgData->channelY.data[nRec] = crgData->admin.recordBuffer[crgData->channelY.info.index];
-        }
-            
-        if ( crgData->channelPhi.info.defined )
-        {
-            if ( !nRec )
-                crgData->channelPhi.data[nRec] = crgData->channelPhi.info.first;
-            else
-                crgData->channelPhi.data[nRec] = crgData->admin.recordBuffer[crgData->channelPhi.info.index];
-            crgMsgPrint( dCrgMsgLevelDebug, "readData: channelPhi.data[%ld] = %.3f\n", nRec, crgData->channelPhi.data[nRec] );
-        }
-            
-        if ( crgData->channelBank.info.defined )
-            crgData->channelBank.data[nRec] = crgData->admin.recordBuffer[crgData->channelBank.info.index];
-            
-        if ( crgData->channelSlope.info.defined )
-            crgData->channelSlope.data[nRec] = crgData->admin.recordBuffer[crgData->channelSlope.info.index];
-            
+        storeRecord( crgData, nRec );
         nRec++;
         
         /*
@@ -1924,136 +2246,389 @@ readData( CrgDataStruct* crgData )
     crgData->admin.fileBuffer = NULL;
 }
 
-void
-crgLoaderHandleNaNs( CrgDataStruct* crgData, int mode, double offset )
+static void
+readDataBinary( CrgDataStruct* crgData )
 {
-    int totalNaN   = 0;
-    size_t minIndexLR = crgData->channelV.info.size;
-    size_t maxIndexRL = 0;
-    size_t i;
-    size_t v;
-    int offsetApplied = 0;
-
+    const char*       recPtr     = crgData->admin.dataSection;
+    size_t            recordSize = crgData->admin.recordSize;
+    size_t            noRecords  = crgData->admin.dataSize / recordSize;
+    size_t            noChannels = crgData->noChannels;
+    size_t            blockSize;
+    size_t            nRec;
+    size_t            n;
+    size_t            i;
+    size_t            r;
+    CrgNanUnionFloat* tile;
+    CrgNanUnionFloat* srcPtr;
+    float*            dstPtr;
+    size_t            refIndex[5];
+    size_t            noRefChannels = 0;
+    double            value;
+    
+    /* --- channels of the reference line which are stored with each record --- */
+    if ( crgData->channelX.info.defined )
+    {
+        refIndex[noRefChannels++] = crgData->channelX.info.index;
+        refIndex[noRefChannels++] = crgData->channelY.info.index;
+    }
     
-    /* --- at least, NaNs need to be counted, so don't exit --- */
-    /* --- even if mode is dCrgGridNaNKeep                  --- */
+    if ( crgData->channelPhi.info.defined )
+        refIndex[noRefChannels++] = crgData->channelPhi.info.index;
+    
+    if ( crgData->channelBank.info.defined )
+        refIndex[noRefChannels++] = crgData->channelBank.info.index;
+    
+    if ( crgData->channelSlope.info.defined )
+        refIndex[noRefChannels++] = crgData->channelSlope.info.index;
+    
+    /* --- the channels have been allocated for the records counted by parseCenterLine() --- */
+    if ( noRecords > crgData->channelU.info.size )
+        noRecords = crgData->channelU.info.size;
+    
+    /* --- blocks of records whose decoded values fit into the first level cache --- */
+    blockSize = dCrgLoaderTileSize / ( noChannels * sizeof( CrgNanUnionFloat ) );
+    blockSize = ( blockSize < 4 ) ? 4 : blockSize;
     
-    for ( i = 0; i < crgData->channelU.info.size; i++ )
+    /* --- fall back to decoding record by record --- */
+    if ( !( tile = ( CrgNanUnionFloat* ) crgCalloc( blockSize * noChannels, sizeof( CrgNanUnionFloat ) ) ) )
+        blockSize = 0;
+    
+    for ( nRec = 0; !blockSize && nRec < noRecords; nRec++, recPtr += recordSize )
+    {
+        decodeRecord( crgData, ( char* ) recPtr, recordSize );
+        storeRecord( crgData, nRec );
+    }
+    
+    for ( nRec = 0; blockSize && nRec < noRecords; nRec += n, recPtr += n * recordSize )
     {
-        size_t nan     = 0;
-        size_t indexLR = 0;
-        size_t indexRL = crgData->channelV.info.size-1;
+        n = ( noRecords - nRec < blockSize ) ? noRecords - nRec : blockSize;
         
-        /* --- right to left --- */
-        for ( v = 1; v < crgData->channelV.info.size; v++ )
+        decodeBlock( crgData, recPtr, n, tile );
+        
+        /* --- transpose the tile, writing a contiguous run per z channel --- */
+        for ( i = 0; i < crgData->channelV.info.size; i++ )
         {
+            srcPtr = tile + crgData->channelZ[i].info.index;
+            dstPtr = crgData->channelZ[i].data + nRec;
             
-            if ( crgIsNanf( &( crgData->channelZ[v].data[i] ) ) )
+            for ( r = 0; r < n; r++, srcPtr += noChannels )
+                dstPtr[r] = srcPtr->fVal;
+        }
+        
+        /* --- the few channels of the reference line need double precision values --- */
+        for ( r = 0; noRefChannels && r < n; r++ )
+        {
+            for ( i = 0; i < noRefChannels; i++ )
             {
-                nan++;
-                
-                switch ( mode )
+                if ( crgData->admin.dataFormat & dDataFormatPrecisionDouble )
                 {
-                    case dCrgGridNaNSetZero:
-                        crgData->channelZ[v].data[i] = ( float ) offset;
-                        break;
-                        
-                    case dCrgGridNaNKeepLast:
-                        /* --- copy data from right neighbor --- */
-                        memcpy( &( crgData->channelZ[v].data[i] ), &( crgData->channelZ[v-1].data[i] ), sizeof( crgData->channelZ[v].data[0] ) );
-                        if ( !crgIsNanf( &( crgData->channelZ[v].data[i] ) ) && !offsetApplied )
-                        {
-                            crgData->channelZ[v].data[i] += ( float ) offset;
-                            offsetApplied = 1;
-                        }
-                        break;
-                        
-                    default:
-                        break;
+                    if ( readDouble( ( char* ) recPtr + r * recordSize + 8 * refIndex[i], &value ) < 0 )
+                        crgSetNan( &value );
                 }
+                else if ( dCrgIsNanf( tile[r * noChannels + refIndex[i]].fVal ) )
+                    crgSetNan( &value );
+                else
+                    value = tile[r * noChannels + refIndex[i]].fVal;
+                
+                crgData->admin.recordBuffer[refIndex[i]] = value;
             }
-            else
-                indexLR = v;
+            
+            storeRefLineRecord( crgData, nRec + r );
         }
+    }
+    
+    if ( tile )
+        crgFree( tile );
+    
+    /* --- ok, file data copy is no longer needed, get rid of it --- */
+    if ( crgData->admin.fileBuffer )
+        free ( crgData->admin.fileBuffer );
+    
+    crgData->admin.fileBuffer = NULL;
+}
 
-        /* --- left to right --- */
-        offsetApplied = 0;
-        for ( v = crgData->channelV.info.size-1; v > 0; v-- )
+static void
+decodeBlock( CrgDataStruct* crgData, const char* recPtr, size_t noRecords, CrgNanUnionFloat* tile )
+{
+    size_t               noValues = crgData->noChannels;
+    size_t               r;
+    size_t               k;
+    unsigned int         bits;
+    const unsigned char* srcPtr;
+    CrgNanUnionDouble    dValue;
+    
+    if ( crgData->admin.dataFormat & dDataFormatPrecisionDouble )
+    {
+        for ( r = 0; r < noRecords; r++, tile += noValues )
         {
-            if ( crgIsNanf( &( crgData->channelZ[v-1].data[i] ) ) && !crgIsNanf( &( crgData->channelZ[v].data[i] ) ) )
+            srcPtr = ( const unsigned char* ) recPtr + r * crgData->admin.recordSize;
+            
+            for ( k = 0; k < noValues; k++, srcPtr += 8 )
             {
-                nan++;
+                readDouble( ( char* ) srcPtr, &( dValue.dVal ) );
                 
-                switch ( mode )
-                {
-                    case dCrgGridNaNSetZero:
-                        crgData->channelZ[v-1].data[i] = ( float ) offset;
-                        break;
-                        
-                    case dCrgGridNaNKeepLast:
-                        /* --- copy data from right neighbor --- */
-                        memcpy( &( crgData->channelZ[v-1].data[i] ), &( crgData->channelZ[v].data[i] ), sizeof( crgData->channelZ[v-1].data[0] ) );
-                        
-                        if ( !crgIsNanf( &( crgData->channelZ[v-1].data[i] ) ) && !offsetApplied )
-                        {
-                            crgData->channelZ[v-1].data[i] += ( float ) offset;
-                            offsetApplied = 1;
-                        }
-                        break;
-                        
-                    default:
-                        break;
-                }
+                if ( dValue.dVal != dValue.dVal )
+                    tile[k].iVal = 0x7fc00000;
+                else
+                    tile[k].fVal = ( float ) dValue.dVal;
             }
-            else
-                indexRL = v-1;
         }
+        return;
+    }
+    
+    /* --- big endian byte order is assembled independently of the machine's byte order, --- */
+    /* --- a loop the compiler may turn into vectorized byte shuffles                     --- */
+    for ( r = 0; r < noRecords; r++, tile += noValues )
+    {
+        srcPtr = ( const unsigned char* ) recPtr + r * crgData->admin.recordSize;
         
-        if ( nan > 0 )
+        for ( k = 0; k < noValues; k++ )
         {
-            crgMsgPrint( dCrgMsgLevelInfo, "crgLoaderHandleNaNs: cross section %ld: NaNs total: %4ld, left: %4ld, right %4ld\n",
-                                             i, nan, crgData->channelV.info.size - indexLR, indexRL );
+            bits = ( ( unsigned int ) srcPtr[4*k] << 24 ) | ( ( unsigned int ) srcPtr[4*k+1] << 16 )
+                 | ( ( unsigned int ) srcPtr[4*k+2] << 8 ) | ( unsigned int ) srcPtr[4*k+3];
+            
+            /* --- any NaN becomes the one set by crgSetNanf() --- */
+            tile[k].iVal = ( int ) ( ( ( bits & 0x7fffffffU ) > 0x7f800000U ) ? 0x7fc00000U : bits );
         }
-        
-        totalNaN += nan;
-        
-        if ( indexRL > maxIndexRL )
-            maxIndexRL = indexRL;
-        
-        if ( indexLR < minIndexLR )
-            minIndexLR = indexLR;
     }
+}
+
+static void
+storeRecord( CrgDataStruct* crgData, size_t nRec )
+{
+    size_t i;
     
-    if ( !totalNaN )
+    /* crgMsgPrint( dCrgMsgLevelNotice, "storeRecord: channelZ at cross section no. %ld\n", nRec ); */
+    for ( i = 0; i < crgData->channelV.info.size; i++ )
     {
-        crgMsgPrint( dCrgMsgLevelNotice, "crgLoaderHandleNaNs: no NaNs found.\n" );
-        return;
+        if ( crgIsNan( &( crgData->admin.recordBuffer[crgData->channelZ[i].info.index] ) ) )
+            crgSetNanf( &( crgData->channelZ[i].data[nRec] ) );
+        else
+            crgData->channelZ[i].data[nRec] = ( float ) crgData->admin.recordBuffer[crgData->channelZ[i].info.index];
     }
     
-    crgMsgPrint( dCrgMsgLevelNotice, "crgLoaderHandleNaNs: Summary of NaN handling information:\n" );
-    crgMsgPrint( dCrgMsgLevelNotice, "                     NaNs in crg data replaced by constant extrapolation.\n" );
-    crgMsgPrint( dCrgMsgLevelNotice, "                     total NaNs in data [-]:        %ld\n", totalNaN );
-    crgMsgPrint( dCrgMsgLevelNotice, "                     max. NaN count from left [-]:  %ld\n", crgData->channelV.info.size - minIndexLR );
-    crgMsgPrint( dCrgMsgLevelNotice, "                     max. NaN count from right [-]: %ld\n", maxIndexRL );
+    storeRefLineRecord( crgData, nRec );
 }
 
 static void
-calcRefLine( CrgDataStruct* crgData )
+storeRefLineRecord( CrgDataStruct* crgData, size_t nRec )
 {
-    double x = crgData->channelX.info.first;
-    double y = crgData->channelY.info.first;
-    double dx;
-    double dy;
-    size_t i = 0u;
-    
-    /* --- calculate x/y only if phi is given --- */
-    if ( !crgData->channelPhi.info.defined )
+    if ( crgData->channelX.info.defined )
     {
-        /* --- we have a straight line --- */
-        for ( i = 0; i < crgData->channelU.info.size; i++ )
-        {
-            crgData->channelX.data[i] = x + i * crgData->channelU.info.inc * cos( crgData->channelPhi.info.first );
-            crgData->channelY.data[i] = y + i * crgData->channelU.info.inc * sin( crgData->channelPhi.info.first );
+        crgData->channelX.data[nRec] = crgData->admin.recordBuffer[crgData->channelX.info.index];
+        crgData->channelY.data[nRec] = crgData->admin.recordBuffer[crgData->channelY.info.index];
+    }
+        
+    if ( crgData->channelPhi.info.defined )
+    {
+        if ( !nRec )
+            crgData->channelPhi.data[nRec] = crgData->channelPhi.info.first;
+        else
+            crgData->channelPhi.data[nRec] = crgData->admin.recordBuffer[crgData->channelPhi.info.index];
+        dCrgMsgDebug( ( dCrgMsgLevelDebug, "storeRecord: channelPhi.data[%ld] = %.3f\n", nRec, crgData->channelPhi.data[nRec] ) );
+    }
+        
+    if ( crgData->channelBank.info.defined )
+        crgData->channelBank.data[nRec] = crgData->admin.recordBuffer[crgData->channelBank.info.index];
+        
+    if ( crgData->channelSlope.info.defined )
+        crgData->channelSlope.data[nRec] = crgData->admin.recordBuffer[crgData->channelSlope.info.index];
+}
+
+static void
+releaseChannelData( CrgDataStruct* crgData )
+{
+    CrgChannelStruct* chan[6];
+    size_t i;
+    
+    for ( i = 0; i < crgData->channelV.info.size; i++ )
+    {
+        if ( crgData->channelZ[i].data )
+            crgFree( crgData->channelZ[i].data );
+        
+        crgData->channelZ[i].data = NULL;
+    }
+    
+    chan[0] = &( crgData->channelX );
+    chan[1] = &( crgData->channelY );
+    chan[2] = &( crgData->channelPhi );
+    chan[3] = &( crgData->channelBank );
+    chan[4] = &( crgData->channelSlope );
+    chan[5] = &( crgData->channelRefZ );
+    
+    for ( i = 0; i < 6; i++ )
+    {
+        if ( chan[i]->data )
+            crgFree( chan[i]->data );
+        
+        chan[i]->data = NULL;
+    }
+}
+
+void
+crgLoaderHandleNaNs( CrgDataStruct* crgData, int mode, double offset )
+{
+    int    totalNaN   = 0;
+    size_t minIndexLR = crgData->channelV.info.size;
+    size_t maxIndexRL = 0;
+    size_t nan[dCrgGridTileSize];
+    size_t indexLR[dCrgGridTileSize];
+    size_t indexRL[dCrgGridTileSize];
+    int    offsetApplied[dCrgGridTileSize];
+    size_t nU = crgData->channelU.info.size;
+    size_t nV = crgData->channelV.info.size;
+    size_t i0;
+    size_t nTile;
+    size_t k;
+    size_t v;
+    double startTime = crgPortGetTime();
+
+    
+    /* --- at least, NaNs need to be counted, so don't exit --- */
+    /* --- even if mode is dCrgGridNaNKeep                  --- */
+    
+    /* --- the grid is processed in tiles of u samples, so that each v channel --- */
+    /* --- is accessed contiguously instead of once per u sample               --- */
+    for ( i0 = 0; i0 < nU; i0 += dCrgGridTileSize )
+    {
+        nTile = ( nU - i0 < dCrgGridTileSize ) ? nU - i0 : dCrgGridTileSize;
+        
+        for ( k = 0; k < nTile; k++ )
+        {
+            nan[k]           = 0;
+            indexLR[k]       = 0;
+            indexRL[k]       = nV-1;
+            offsetApplied[k] = 0;
+        }
+        
+        /* --- right to left --- */
+        for ( v = 1; v < nV; v++ )
+        {
+            float* z  = crgData->channelZ[v].data   + i0;
+            float* zR = crgData->channelZ[v-1].data + i0;
+            
+            for ( k = 0; k < nTile; k++ )
+            {
+                if ( dCrgIsNanf( z[k] ) )
+                {
+                    nan[k]++;
+                    
+                    switch ( mode )
+                    {
+                        case dCrgGridNaNSetZero:
+                            z[k] = ( float ) offset;
+                            break;
+                            
+                        case dCrgGridNaNKeepLast:
+                            /* --- copy data from right neighbor --- */
+                            z[k] = zR[k];
+                            if ( !dCrgIsNanf( z[k] ) && !offsetApplied[k] )
+                            {
+                                z[k] += ( float ) offset;
+                                offsetApplied[k] = 1;
+                            }
+                            break;
+                            
+                        default:
+                            break;
+                    }
+                }
+                else
+                    indexLR[k] = v;
+            }
+        }
+
+        /* --- left to right --- */
+        for ( k = 0; k < nTile; k++ )
+            offsetApplied[k] = 0;
+        
+        for ( v = nV-1; v > 0; v-- )
+        {
+            float* z  = crgData->channelZ[v].data   + i0;
+            float* zL = crgData->channelZ[v-1].data + i0;
+            
+            for ( k = 0; k < nTile; k++ )
+            {
+                if ( dCrgIsNanf( zL[k] ) && !dCrgIsNanf( z[k] ) )
+                {
+                    nan[k]++;
+                    
+                    switch ( mode )
+                    {
+                        case dCrgGridNaNSetZero:
+                            zL[k] = ( float ) offset;
+                            break;
+                            
+                        case dCrgGridNaNKeepLast:
+                            /* --- copy data from right neighbor --- */
+                            zL[k] = z[k];
+                            if ( !offsetApplied[k] )
+                            {
+                                zL[k] += ( float ) offset;
+                                offsetApplied[k] = 1;
+                            }
+                            break;
+                            
+                        default:
+                            break;
+                    }
+                }
+                else
+                    indexRL[k] = v-1;
+            }
+        }
+        
+        for ( k = 0; k < nTile; k++ )
+        {
+            if ( nan[k] > 0 )
+            {
+                crgMsgPrint( dCrgMsgLevelInfo, "crgLoaderHandleNaNs: cross section %ld: NaNs total: %4ld, left: %4ld, right %4ld\n",
+                                                 i0 + k, nan[k], nV - indexLR[k], indexRL[k] );
+            }
+            
+            totalNaN += nan[k];
+            
+            if ( indexRL[k] > maxIndexRL )
+                maxIndexRL = indexRL[k];
+            
+            if ( indexLR[k] < minIndexLR )
+                minIndexLR = indexLR[k];
+        }
+    }
+    
+    dCrgMsgInfo( ( dCrgMsgLevelInfo, "crgLoaderHandleNaNs: grid of %ld x %ld processed in %.3f ms\n",
+                                     nU, nV, 1.0e-6 * ( crgPortGetTime() - startTime ) ) );
+    
+    if ( !totalNaN )
+    {
+        crgMsgPrint( dCrgMsgLevelNotice, "crgLoaderHandleNaNs: no NaNs found.\n" );
+        return;
+    }
+    
+    crgMsgPrint( dCrgMsgLevelNotice, "crgLoaderHandleNaNs: Summary of NaN handling information:\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                     NaNs in crg data replaced by constant extrapolation.\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                     total NaNs in data [-]:        %ld\n", totalNaN );
+    crgMsgPrint( dCrgMsgLevelNotice, "                     max. NaN count from left [-]:  %ld\n", nV - minIndexLR );
+    crgMsgPrint( dCrgMsgLevelNotice, "                     max. NaN count from right [-]: %ld\n", maxIndexRL );
+}
+
+static void
+calcRefLine( CrgDataStruct* crgData )
+{
+    double x = crgData->channelX.info.first;
+    double y = crgData->channelY.info.first;
+    double dx;
+    double dy;
+    size_t i = 0u;
+    
+    /* --- calculate x/y only if phi is given --- */
+    if ( !crgData->channelPhi.info.defined )
+    {
+        /* --- we have a straight line --- */
+        for ( i = 0; i < crgData->channelU.info.size; i++ )
+        {
+            crgData->channelX.data[i] = x + i * crgData->channelU.info.inc * cos( crgData->channelPhi.info.first );
+            crgData->channelY.data[i] = y + i * crgData->channelU.info.inc * sin( crgData->channelPhi.info.first );
             crgData->channelX.info.valid   = 1;
             crgData->channelY.info.valid   = 1;
         }
@@ -2217,7 +2792,7 @@ calcRefLineZ( CrgDataStruct* crgData )
             
             crgData->channelRefZ.data[i+1] = crgData->channelRefZ.data[i] + slope * crgData->channelU.info.inc;
     
-            crgMsgPrint( dCrgMsgLevelDebug, "calcRefLineZ: crgData->channelRefZ.data[%d] = %.5f\n", i, crgData->channelRefZ.data[i] );
+            dCrgMsgDebug( ( dCrgMsgLevelDebug, "calcRefLineZ: crgData->channelRefZ.data[%d] = %.5f\n", i, crgData->channelRefZ.data[i] ) );
         }
         /* --- remember last value --- */
         crgData->channelRefZ.info.last = crgData->channelRefZ.data[crgData->channelRefZ.info.size-1];
@@ -2279,33 +2854,126 @@ normalizeRefLine( CrgDataStruct* crgData )
 static void
 normalizeZ( CrgDataStruct* crgData )
 {
-    double zMean = 0.0;
+    double zMean  = 0.0;
+    double zMeanF = 0.0;
+    double zMeanL = 0.0;
+    double zMin   = 0.0;
+    double zMax   = 0.0;
+    double mean0  = crgData->channelZ[0].info.mean;
+    float  zMinCh;
+    float  zMaxCh;
+    float  zOffset;
+    float* data;
     size_t i, j;
-    size_t nValues = 0;
+    size_t nPtsF  = 0;
+    size_t nPtsL  = 0;
+    int    hasMinMax = 0;
 
     /* make mean elevation at first cross section = 0.0 */
     /* note: prepare may be called multiple times, so take old mean value into account */
-    /* only use values not being NaNs! */
-    for ( i = 0; i < crgData->channelV.info.size; i++ )
-        if ( !crgIsNanf( &( crgData->channelZ[i].data[0] ) ) )
-        {
-            zMean += crgData->channelZ[i].data[0] + crgData->channelZ[i].info.mean;
-            nValues++;
-        }
-    
-    if ( nValues )
-        zMean /= nValues;
-    
     zMean = 0.0; /** @todo: continue here */
 
+    /* --- single pass over each v channel: statistics of the raw values, then normalization --- */
     /* @todo: check size of all channels! */
     for ( i = 0; i < crgData->channelV.info.size; i++ )
     {
-        for ( j = 0; j < crgData->channelZ[i].info.size; j++ )
-            if ( !crgIsNanf( &( crgData->channelZ[i].data[j] ) ) )
-                crgData->channelZ[i].data[j] = crgData->channelZ[i].data[j] + ( float ) ( crgData->channelZ[i].info.mean - zMean );
+        size_t size = crgData->channelZ[i].info.size;
+        
+        data = crgData->channelZ[i].data;
+        
+        if ( !data )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "normalizeZ: v-channel with index %ld has no data!\n", i );
+            crgData->channelZ[i].info.mean = zMean;
+            continue;
+        }
+        
+        /* --- mean elevation at start and end of road --- */
+        if ( !dCrgIsNanf( data[0] ) )
+        {
+            zMeanF += data[0];
+            nPtsF++;
+            
+            if ( size == 0 )
+            {
+                zMeanL = zMeanF;
+                nPtsL++;
+            }
+        }
+        
+        if ( size > 0 && !dCrgIsNanf( data[size-1] ) )
+        {
+            zMeanL += data[size-1];
+            nPtsL++;
+        }
+        
+        /* --- minimum / maximum elevation and normalization; NaNs fail all --- */
+        /* --- compares and stay NaNs when the offset is added               --- */
+        zOffset = ( float ) ( crgData->channelZ[i].info.mean - zMean );
+        
+        for ( j = 0; j < size && dCrgIsNanf( data[j] ); j++ );
+        
+        if ( j < size )
+        {
+            zMinCh = data[j];
+            zMaxCh = data[j];
+            
+            if ( zOffset != 0.0f )
+            {
+                for ( ; j < size; j++ )
+                {
+                    float val = data[j];
+                    
+                    zMinCh  = ( val < zMinCh ) ? val : zMinCh;
+                    zMaxCh  = ( val > zMaxCh ) ? val : zMaxCh;
+                    data[j] = val + zOffset;
+                }
+            }
+            else
+            {
+                for ( ; j < size; j++ )
+                {
+                    zMinCh = ( data[j] < zMinCh ) ? data[j] : zMinCh;
+                    zMaxCh = ( data[j] > zMaxCh ) ? data[j] : zMaxCh;
+                }
+            }
+            
+            if ( !hasMinMax || zMinCh < zMin )
+                zMin = zMinCh;
+            
+            if ( !hasMinMax || zMaxCh > zMax )
+                zMax = zMaxCh;
+            
+            hasMinMax = 1;
+        }
+        
         crgData->channelZ[i].info.mean = zMean;
     }
+    
+    if ( nPtsF )
+        zMeanF /= 1.0 * nPtsF;
+    
+    if ( nPtsL )
+        zMeanL /= 1.0 * nPtsL;
+    
+    /* --- add the mean value which was used for normalizing the data --- */
+    zMeanF += mean0;
+    zMeanL += mean0;
+    
+    /* --- the extreme values start from the mean elevation at start --- */
+    if ( !hasMinMax || zMeanF < zMin )
+        zMin = zMeanF;
+    
+    if ( !hasMinMax || zMeanF > zMax )
+        zMax = zMeanF;
+    
+    zMin += mean0;
+    zMax += mean0;
+    
+    crgData->util.zMeanBeg = zMeanF;
+    crgData->util.zMeanEnd = zMeanL;
+    crgData->util.zMin     = zMin;
+    crgData->util.zMax     = zMax;
 }
 
 static void
@@ -2427,6 +3095,14 @@ smoothenRefLine( CrgDataStruct* crgData )
 void
 crgLoaderPrepareData( CrgDataStruct* crgData )
 {
+    double time0 = crgPortGetTime();
+    double time1;
+    double time2;
+    double time3;
+    
+    /* --- any cached validation result is outdated once the data changes --- */
+    crgData->admin.checkState = dCrgCheckStateNone;
+    
     /* --- first: eliminate NaNs --- */
     /** @note: removed: NaNs should be handled by applying modifiers explicitly! 
     crgLoaderHandleNaNs( crgData, dCrgGridNaNKeepLast, 0.0 );
@@ -2441,6 +3117,14 @@ crgLoaderPrepareData( CrgDataStruct* crgData )
     calcRefLineZ( crgData );
     crgMsgPrint( dCrgMsgLevelDebug, "crgLoaderPrepareData: calcRefLineZ() done.\n" );
 
+    time1 = crgPortGetTime();
+    
+    /* --- normalize z data, collecting the elevation statistics in the same pass --- */
+    normalizeZ( crgData );
+    crgMsgPrint( dCrgMsgLevelDebug, "crgLoaderPrepareData: normalizeZ() done.\n" );
+
+    time2 = crgPortGetTime();
+    
     /* --- calculate statistics --- */
     /* crgPrintElevData( crgData ); */
     crgCalcStatistics( crgData );
@@ -2450,10 +3134,6 @@ crgLoaderPrepareData( CrgDataStruct* crgData )
     normalizeRefLine( crgData );
     crgMsgPrint( dCrgMsgLevelDebug, "crgLoaderPrepareData: normalizeRefLine() done.\n" );
 
-    /* --- normalize z data --- */
-    normalizeZ( crgData );
-    crgMsgPrint( dCrgMsgLevelDebug, "crgLoaderPrepareData: normalizeZ() done.\n" );
-
     /* --- smoothen the reference line --- */
     smoothenRefLine( crgData );
     crgMsgPrint( dCrgMsgLevelDebug, "crgLoaderPrepareData: smoothenRefLine() done.\n" );
@@ -2461,6 +3141,11 @@ crgLoaderPrepareData( CrgDataStruct* crgData )
     /* --- prepare some data for higher performance of evaluations --- */
     crgCalcUtilityData( crgData );
     crgMsgPrint( dCrgMsgLevelDebug, "crgLoaderPrepareData: crgCalcUtilityData() done.\n" );
+    
+    time3 = crgPortGetTime();
+    
+    dCrgMsgInfo( ( dCrgMsgLevelInfo, "crgLoaderPrepareData: timing [ms]: reference line %.3f, z data %.3f, statistics / utility data %.3f\n",
+                                     1.0e-6 * ( time1 - time0 ), 1.0e-6 * ( time2 - time1 ), 1.0e-6 * ( time3 - time2 ) ) );
 }
 
 		int crgLocalCurvature(CrgDataStruct *crgData) {
@@ -2505,6 +3190,7 @@ crgLoaderPrepareData( CrgDataStruct* crgData )
 						crgOptionSetInt(&crgData->options,
 						dCrgCpOptionBorderModeV, optAsInt);
 
+						crgContactPointDelete(cpId);
 						return 0;
 					}
 				}
@@ -2512,6 +3198,7 @@ crgLoaderPrepareData( CrgDataStruct* crgData )
 
 			crgOptionSetInt(&crgData->options, dCrgCpOptionBorderModeV, optAsInt);
 
+			crgContactPointDelete(cpId);
 			return 1;
 		}
 
@@ -2577,7 +3264,7 @@ crgGlobalCurvature(CrgDataStruct* crgData){
 int
 crgCheck( int dataSetId )
 {
-	int optAsInt;
+    int result;
 
     CrgDataStruct *crgData = crgDataSetAccess( dataSetId );
 
@@ -2587,6 +3274,30 @@ crgCheck( int dataSetId )
         return 0;
     }
 
+    /* --- nothing changed since the last check? then re-use its result --- */
+    if ( crgData->admin.checkState != dCrgCheckStateNone
+      && crgData->admin.checkRevOptions   == crgData->options.revision
+      && crgData->admin.checkRevModifiers == crgData->modifiers.revision )
+    {
+        crgMsgPrint( dCrgMsgLevelDebug, "crgCheck: re-using result of previous check.\n" );
+        return crgData->admin.checkState == dCrgCheckStatePassed;
+    }
+
+    result = checkDataSet( crgData );
+
+    /* --- the check itself may complete the modifier settings, so record the revisions afterwards --- */
+    crgData->admin.checkState        = result ? dCrgCheckStatePassed : dCrgCheckStateFailed;
+    crgData->admin.checkRevOptions   = crgData->options.revision;
+    crgData->admin.checkRevModifiers = crgData->modifiers.revision;
+
+    return result;
+}
+
+static int
+checkDataSet( CrgDataStruct* crgData )
+{
+	int optAsInt;
+
     /* @todo: move to one of the following sub check routines */
     /* --- check if closed refline option is valid --- */
     if( crgData->util.uIsClosed && crgOptionHasValueInt( &( crgData->options ), dCrgRefLineCloseTrack, 1 ) )
@@ -2988,45 +3699,171 @@ isLittleEndian( void )
     return ( i == 1 );
 }
 
+static size_t
+stripPadding( CrgDataStruct* crgData, size_t nBytes )
+{
+    size_t recordSize = crgData->admin.recordSize;
+    size_t valueSize  = ( crgData->admin.dataFormat & dDataFormatPrecisionDouble ) ? 8 : 4;
+    size_t noRecords;
+    size_t i;
+    char*  recPtr;
+    double value;
+    float  fValue;
+    
+    if ( !recordSize )
+        return nBytes;
+    
+    noRecords = nBytes / recordSize;
+    
+    /* --- padding is shorter than 80 bytes, so only records starting within --- */
+    /* --- the last 80 bytes may consist of padding                          --- */
+    while ( noRecords && nBytes - ( noRecords - 1 ) * recordSize < 80 )
+    {
+        recPtr = crgData->admin.dataSection + ( noRecords - 1 ) * recordSize;
+        
+        for ( i = 0; i < recordSize; i += valueSize )
+        {
+            if ( valueSize == 8 ? ( readDouble( recPtr + i, &value ) >= 0 ) : ( readFloat( recPtr + i, &fValue ) >= 0 ) )
+                break;
+        }
+        
+        if ( i < recordSize )
+            break;
+        
+        noRecords--;
+    }
+    
+    return noRecords * recordSize;
+}
+
+static size_t
+inflateData( CrgDataStruct* crgData, size_t nBytes )
+{
+    size_t hdrSize = ( size_t ) ( crgData->admin.dataSection - crgData->admin.fileBuffer );
+    size_t noRecords;
+    char*  buffer;
+    
+    if ( !crgCompressGetNoRecords( crgData->admin.dataSection, nBytes, &noRecords ) )
+        return 0;
+    
+    if ( noRecords < 2 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "inflateData: compressed data section holds less than 2 records.\n" );
+        return 0;
+    }
+    
+    if ( !( buffer = ( char* ) crgCalloc( 1, hdrSize + noRecords * crgData->admin.recordSize + 1 ) ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "inflateData: cannot allocate memory for %lu records\n", ( unsigned long ) noRecords );
+        return 0;
+    }
+    
+    memcpy( buffer, crgData->admin.fileBuffer, hdrSize );
+    
+    if ( !crgCompressDecode( crgData->admin.dataSection, nBytes, crgData->noChannels, ( unsigned char* ) buffer + hdrSize ) )
+    {
+        crgFree( buffer );
+        return 0;
+    }
+    
+    crgMsgPrint( dCrgMsgLevelInfo, "inflateData: decoded %lu records from %lu bytes\n", ( unsigned long ) noRecords, ( unsigned long ) nBytes );
+    
+    free( crgData->admin.fileBuffer );
+    
+    crgData->admin.fileBuffer  = buffer;
+    crgData->admin.dataSection = buffer + hdrSize;
+    
+    return noRecords * crgData->admin.recordSize;
+}
+
 int 
 crgLoaderReadFile( const char* filename )
 {
     CrgDataStruct *crgData = NULL;
     
+    if ( !loadFile( filename, &crgData ) )
+        return 0;
+    
+    return crgData->admin.id;
+}
+
+static int 
+loadFile( const char* filename, CrgDataStruct** crgRetData )
+{
+    CrgDataStruct *crgData = NULL;
+    struct stat fileStat;
+    double time0 = crgPortGetTime();
+    double time1;
+    
     /* --- initialize the loader before reading the file --- */
     crgLoaderInit();
     
-    /* --- set file level to base level (reading primary file ) --- */
+    /* --- set file level to base level (reading primary file ), nothing has been defined yet --- */
     mFileLevel = 0;
+    mOptLevel  = -1;
+    mModLevel  = -1;
+    
+    /* --- collect the information for reloading the file; the time stamp is taken before reading --- */
+    sReloadNext = ( CrgReloadStruct* ) crgCalloc( 1, sizeof( CrgReloadStruct ) );
+    
+    if ( sReloadNext && stat( filename, &fileStat ) == 0 )
+    {
+        sReloadNext->mtime    = fileStat.st_mtime;
+        sReloadNext->readTime = time( NULL );
+        sReloadNext->fileSize = ( size_t ) fileStat.st_size;
+    }
     
     if ( !crgLoaderAddFile( filename, &crgData ) )
     {
         crgMsgPrint( dCrgMsgLevelFatal,  "crgLoaderReadFile: error loading <%s>\n", filename );
+        *crgRetData = crgData;
+        reloadRelease( sReloadNext );
+        sReloadNext = NULL;
         terminateReader( crgData, 0 );
         return 0;
     }
     
+    *crgRetData = crgData;
+    
     /* --- data available? --- */
     if ( !crgData->channelV.info.size )
     {
         crgMsgPrint( dCrgMsgLevelDebug, "crgLoaderReadFile: no data available. Terminating reader\n" );
+        reloadRelease( sReloadNext );
+        sReloadNext = NULL;
         return terminateReader( crgData, 0 );
     }
             
+    time1 = crgPortGetTime();
+    
     /* --- prepare the data read from file --- */
     crgMsgPrint( dCrgMsgLevelDebug, "crgLoaderReadFile: preparing data\n" );
     crgLoaderPrepareData( crgData );
     
+    dCrgMsgInfo( ( dCrgMsgLevelInfo, "crgLoaderReadFile: timing [ms]: read and decode %.3f, prepare %.3f\n",
+                                     1.0e-6 * ( time1 - time0 ), 1.0e-6 * ( crgPortGetTime() - time1 ) ) );
+    
     /* --- initialize data-set specific history --- */
     crgDataSetHistory( crgData->admin.id, dCrgHistoryStdSize );
     
+    /* --- hand the reload information over to the data set --- */
+    if ( sReloadNext )
+    {
+        if ( ( sReloadNext->filename = ( char* ) crgCalloc( strlen( filename ) + 1, sizeof( char ) ) ) )
+        {
+            strcpy( sReloadNext->filename, filename );
+            crgData->reload = sReloadNext;
+            sReloadNext     = NULL;
+        }
+    }
+    
+    reloadRelease( sReloadNext );
+    sReloadNext = NULL;
+    
     crgMsgPrint( dCrgMsgLevelNotice, "crgLoaderReadFile: finished reading file <%s>\n", filename );
     
     /* --- clear temporary data and declare success --- */
-    if ( !terminateReader( crgData, 1 ) )
-        return 0;
-    
-    return crgData->admin.id;
+    return terminateReader( crgData, 1 );
 }
 
 static int 
@@ -3038,9 +3875,11 @@ crgLoaderAddFile( const char* filename, CrgDataStruct** crgRetData )
     size_t        nBytesLeft;
 	FILE*         fPtr = NULL;
     CrgDataStruct *crgData = *crgRetData;
+    char*         reloaded = ( mFileLevel == 0 ) ? sReloadBuffer : NULL;
+    double        time0;
    
-    /* --- open the file --- */
-    if ( ( fPtr = fopen( filename, "rb" ) ) == NULL ) 
+    /* --- open the file, unless its contents have been read by crgDataSetReload() --- */
+    if ( !reloaded && ( fPtr = fopen( filename, "rb" ) ) == NULL ) 
     {
         crgMsgPrint( dCrgMsgLevelFatal,  "crgLoaderAddFile: could not open <%s>\n", filename );
         return 0;
@@ -3061,7 +3900,8 @@ crgLoaderAddFile( const char* filename, CrgDataStruct** crgRetData )
         if ( !( crgData = crgDataSetCreate() ) )
         {
             crgMsgPrint( dCrgMsgLevelFatal, "crgLoaderAddFile: could not create data set\n" );
-            fclose(fPtr);
+            if ( fPtr )
+                fclose(fPtr);
             return 0;
         }
         
@@ -3070,25 +3910,39 @@ crgLoaderAddFile( const char* filename, CrgDataStruct** crgRetData )
     }
     
     /* --- memory map the file for faster access --- */
-    stat( filename, &fileStat );
-	crgData->admin.fileBuffer = ( char * ) crgCalloc( 1, fileStat.st_size + 1 );
-    
-    if ( !crgData->admin.fileBuffer )
+    if ( reloaded )
     {
-        crgMsgPrint( dCrgMsgLevelFatal,  "crgLoaderAddFile: cannot allocate memory for file data\n" );
-        fclose(fPtr);
-        return 0;
+        crgData->admin.fileBuffer = reloaded;
+        sReloadBuffer             = NULL;
+    }
+    else
+    {
+        stat( filename, &fileStat );
+	    crgData->admin.fileBuffer = ( char * ) crgCalloc( 1, fileStat.st_size + 1 );
     }
     
-	noBytesRead = fread( crgData->admin.fileBuffer, 1, fileStat.st_size, fPtr );
- 	fclose( fPtr );
-   
-    if ( noBytesRead < ( size_t ) fileStat.st_size )
+    if ( !crgData->admin.fileBuffer )
     {
-        crgMsgPrint( dCrgMsgLevelFatal,  "crgLoaderAddFile: read error: only got %lld of %lld bytes\n", noBytesRead, fileStat.st_size );
+        crgMsgPrint( dCrgMsgLevelFatal,  "crgLoaderAddFile: cannot allocate memory for file data\n" );
+        if ( fPtr )
+            fclose(fPtr);
         return 0;
     }
     
+    if ( reloaded )
+        noBytesRead = sReloadBufferSize;
+    else
+    {
+	    noBytesRead = fread( crgData->admin.fileBuffer, 1, fileStat.st_size, fPtr );
+ 	    fclose( fPtr );
+   
+        if ( noBytesRead < ( size_t ) fileStat.st_size )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal,  "crgLoaderAddFile: read error: only got %lld of %lld bytes\n", noBytesRead, fileStat.st_size );
+            return 0;
+        }
+    }
+    
     /* --- copy basic file parameters for subsequent alteration --- */
     bufPtr     = crgData->admin.fileBuffer;
     nBytesLeft = noBytesRead;
@@ -3120,7 +3974,43 @@ crgLoaderAddFile( const char* filename, CrgDataStruct** crgRetData )
     
     /* --- store the pointer to the data section of the file --- */
     crgData->admin.dataSection = bufPtr;
-    crgData->admin.dataSize    = nBytesLeft;
+    
+    /* --- compressed data is decoded as a whole, the number of records is known then --- */
+    if ( crgData->admin.dataFormat & dDataFormatCompressed )
+    {
+        size_t dataBytes = noBytesRead - ( size_t ) ( bufPtr - crgData->admin.fileBuffer );
+        
+        time0 = crgPortGetTime();
+        
+        if ( !( nBytesLeft = inflateData( crgData, dataBytes ) ) )
+            return 0;
+        
+        dCrgMsgInfo( ( dCrgMsgLevelInfo, "crgLoaderAddFile: timing [ms]: decompressing data %.3f\n", 1.0e-6 * ( crgPortGetTime() - time0 ) ) );
+        
+        bufPtr      = crgData->admin.dataSection;
+        noBytesRead = ( size_t ) ( bufPtr - crgData->admin.fileBuffer ) + nBytesLeft;
+    }
+    /* --- compact binary records may be followed by records of padding only --- */
+    else if ( ( crgData->admin.dataFormat & dDataFormatBinary ) && !( crgData->admin.dataFormat & dDataFormatLong ) )
+    {
+        size_t dataBytes = noBytesRead - ( size_t ) ( bufPtr - crgData->admin.fileBuffer );
+        
+        nBytesLeft = stripPadding( crgData, ( nBytesLeft < dataBytes ) ? nBytesLeft : dataBytes );
+    }
+    
+    crgData->admin.dataSize = nBytesLeft;
+    
+    /* --- data section of the primary file: compute the checksums for reloading; --- */
+    /* --- when reloading, the data decoded previously may be taken over          --- */
+    if ( mFileLevel == 0 && sReloadNext )
+    {
+        size_t dataBytes = noBytesRead - ( size_t ) ( bufPtr - crgData->admin.fileBuffer );
+        
+        reloadScanData( crgData, sReloadNext, ( nBytesLeft < dataBytes ) ? nBytesLeft : dataBytes );
+        
+        if ( sReloadPrev && reloadReuseData( crgData ) )
+            return 1;
+    }
     
     /* --- the header seems to be ok, now let's start reading the actual data  --- */
     crgMsgPrint( dCrgMsgLevelDebug, "crgLoaderAddFile: parsing center line\n" );
@@ -3137,7 +4027,13 @@ crgLoaderAddFile( const char* filename, CrgDataStruct** crgRetData )
     
     /* --- read the actual CRG data --- */
     crgMsgPrint( dCrgMsgLevelDebug, "crgLoaderAddFile: reading actual data\n" );
+    time0 = crgPortGetTime();
     readData( crgData );
+    dCrgMsgInfo( ( dCrgMsgLevelInfo, "crgLoaderAddFile: timing [ms]: decoding data %.3f\n", 1.0e-6 * ( crgPortGetTime() - time0 ) ) );
+    
+    /* --- a data set which is being reloaded keeps its decoded data for the next reload --- */
+    if ( mFileLevel == 0 && sReloadNext && sReloadPrev )
+        reloadKeepImage( crgData, sReloadNext );
 
     /* --- clear temporary data and declare success --- */
     return 1;
@@ -3146,23 +4042,17 @@ crgLoaderAddFile( const char* filename, CrgDataStruct** crgRetData )
 static int 
 crgStrBeginsWithStrNoCase( const char* str1, const char* str2 )
 {
-	char* c1 = ( char* ) str1;
-	char* c2 = ( char* ) str2;
-	unsigned int i;
+	const char* c1 = str1;
+	const char* c2 = str2;
 
 	if ( !str1 || !str2 )
 		return 0;
 
-	if ( strlen( str1 ) < strlen( str2 ) )
-		return 0;
-
-	for ( i = 0; i < strlen( str2 ); i++ )
+	/* --- single pass, the end of str1 never matches a character of str2 --- */
+	for ( ; *c2; c1++, c2++ )
 	{
 		if ( tolower( *c1 ) != tolower( *c2 ) )
 			return 0;
-
-		c1++;
-		c2++;
 	}
 	return 1;
 }
@@ -3171,10 +4061,34 @@ static void
 crgLoaderInit( void )
 {
     static int firstTime = 1;
+    CrgReaderCallbackStruct* tables[6];
+    int i;
     
     /* --- do this only once! --- */
     if ( !firstTime )
         return;
+    
+    firstTime = 0;
+    
+    /* --- build the hash table for the dispatch of header tags --- */
+    tables[0] = sLoaderCallbacksCommon;
+    tables[1] = sLoaderCallbacksRoad;
+    tables[2] = sLoaderCallbacksOpts;
+    tables[3] = sLoaderCallbacksMods;
+    tables[4] = sLoaderCallbacksDataDef;
+    tables[5] = sLoaderCallbacksFile;
+    
+    for ( i = 0; i < 6; i++ )
+    {
+        if ( !tagHashInsertTable( tables[i] ) )
+        {
+            /* --- fall back to scanning the tables --- */
+            crgMsgPrint( dCrgMsgLevelWarn, "crgLoaderInit: tag hash table too small, using linear scan.\n" );
+            memset( sTagHash, 0, sizeof( sTagHash ) );
+            sTagHashMaxLen = 0;
+            return;
+        }
+    }
 }
 
 static int 
@@ -3273,32 +4187,46 @@ decodeIncludeFile( CrgDataStruct* crgData, const char* buffer, int code )
         case dOpcodeIncludeDone:
             {
                 CrgAdminStruct adminBackup;
+                char           includeName[1024];
+                
+                /* take over the filename and reset it for successive (or nested) include files */
+                strcpy( includeName, filename );
+                memset( filename, 0, sizeof( filename ) );
                 
-                crgMsgPrint( dCrgMsgLevelNotice, "--------------------------------------\n", filename );
-                crgMsgPrint( dCrgMsgLevelNotice, "decodeIncludeFile: importing file <%s>\n", filename );
+                crgMsgPrint( dCrgMsgLevelNotice, "--------------------------------------\n" );
+                crgMsgPrint( dCrgMsgLevelNotice, "decodeIncludeFile: importing file <%s>\n", includeName );
                 
                 /* hold a copy of the administration structure */
                 memcpy( &adminBackup, &( crgData->admin ), sizeof( CrgAdminStruct ) );
                 crgData->admin.sectionType = dFileSectionNone;
+                crgData->admin.fileBuffer  = NULL;
+                
+                /* changes of include files are not tracked for reloading */
+                if ( sReloadNext )
+                    sReloadNext->hasIncludes = 1;
                 
                 /* load the include file and set the file level accordingly */
                 mFileLevel++;
                 
-                result = crgLoaderAddFile( filename, &crgData );
+                result = crgLoaderAddFile( includeName, &crgData );
                 
                 mFileLevel--;
                 
-                if ( !result )
-                    return 0;
+                /* release the buffers of the include file */
+                if ( crgData->admin.fileBuffer )
+                    crgFree( crgData->admin.fileBuffer );
+                
+                if ( crgData->admin.recordBuffer != adminBackup.recordBuffer )
+                    clearTmpData( crgData );
                 
                 /* restore the administration structure */
                 memcpy( &( crgData->admin ), &adminBackup, sizeof( CrgAdminStruct ) );
                 
-                crgMsgPrint( dCrgMsgLevelNotice, "--------------------------------------\n", filename );
-                crgMsgPrint( dCrgMsgLevelNotice, "decodeIncludeFile: continuing with previous file\n" );
+                if ( !result )
+                    return 0;
                 
-                /* reset the filename for successive read operations */
-                memset( filename, 0, sizeof( filename ) );
+                crgMsgPrint( dCrgMsgLevelNotice, "--------------------------------------\n" );
+                crgMsgPrint( dCrgMsgLevelNotice, "decodeIncludeFile: continuing with previous file\n" );
                 
                 return 1;
                 
@@ -3322,3 +4250,582 @@ decodeIncludeFile( CrgDataStruct* crgData, const char* buffer, int code )
     return 0;
 }
 
+
+int
+crgDataSetReload( int dataSetId )
+{
+    CrgDataStruct*   crgData = crgDataSetAccess( dataSetId );
+    CrgDataStruct*   newData = NULL;
+    CrgReloadStruct* prev;
+    CrgDataStruct    tmpData;
+    CrgOptionsStruct tmpOpts;
+    struct stat      fileStat;
+    time_t           readTime;
+    char*            buffer;
+    size_t           noDecoded;
+    size_t           noBlocks;
+    int              keepSettings;
+    int              modifiersApplied;
+    int              cellCoefsEnabled;
+    int              result;
+    double           time0 = crgPortGetTime();
+    
+    if ( !crgData )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetReload: invalid data set id <%d>.\n", dataSetId );
+        return 0;
+    }
+    
+    if ( !( prev = crgData->reload ) )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetReload: data set <%d> has not been read from a file.\n", dataSetId );
+        return 0;
+    }
+    
+    if ( stat( prev->filename, &fileStat ) != 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgDataSetReload: could not access <%s>, keeping the previous data.\n", prev->filename );
+        return 0;
+    }
+    
+    /* --- an untouched file needs not be read again; include files are not tracked, though;  --- */
+    /* --- a file modified within the second it was read may have changed without a new time --- */
+    if ( !prev->hasIncludes && prev->mtime < prev->readTime 
+      && fileStat.st_mtime == prev->mtime && ( size_t ) fileStat.st_size == prev->fileSize )
+    {
+        crgMsgPrint( dCrgMsgLevelInfo, "crgDataSetReload: file <%s> is unchanged.\n", prev->filename );
+        return 1;
+    }
+    
+    readTime = time( NULL );
+    
+    if ( !( buffer = reloadReadFile( prev->filename, ( size_t ) fileStat.st_size ) ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgDataSetReload: could not read <%s>, keeping the previous data.\n", prev->filename );
+        return 0;
+    }
+    
+    /* --- the contents may still be the same, e.g. if the file has just been saved again --- */
+    if ( !prev->hasIncludes && reloadIsUnchanged( prev, buffer, ( size_t ) fileStat.st_size ) )
+    {
+        crgFree( buffer );
+        
+        prev->mtime    = fileStat.st_mtime;
+        prev->readTime = readTime;
+        
+        crgMsgPrint( dCrgMsgLevelInfo, "crgDataSetReload: contents of <%s> are unchanged.\n", prev->filename );
+        return 1;
+    }
+    
+    /* --- read the contents into a new data set, taking over the data decoded previously where possible --- */
+    sReloadPrev       = prev;
+    sReloadBuffer     = buffer;
+    sReloadBufferSize = ( size_t ) fileStat.st_size;
+    
+    result = loadFile( prev->filename, &newData );
+    
+    if ( sReloadBuffer )
+        crgFree( sReloadBuffer );
+    
+    sReloadPrev   = NULL;
+    sReloadBuffer = NULL;
+    
+    if ( !result || !newData->reload )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgDataSetReload: could not reload <%s>, keeping the previous data.\n", prev->filename );
+        
+        if ( newData )
+            crgDataSetRelease( newData->admin.id );
+        
+        return 0;
+    }
+    
+    /* --- the contents are those at the time of the status query --- */
+    newData->reload->mtime    = fileStat.st_mtime;
+    newData->reload->readTime = readTime;
+    newData->reload->fileSize = ( size_t ) fileStat.st_size;
+    
+    /* --- an unchanged header keeps the options and modifiers defined by the application --- */
+    keepSettings     = ( newData->reload->hdrSum == prev->hdrSum );
+    modifiersApplied = crgData->admin.modifiersApplied;
+    cellCoefsEnabled = crgData->cellCoefs.enabled;
+    noDecoded        = newData->reload->noDecoded;
+    noBlocks         = newData->reload->noBlocks;
+    
+    /* --- exchange the contents of both data sets: the data set keeps its id and address, so its --- */
+    /* --- contact points remain valid, and the previous contents are released with the new id   --- */
+    tmpData  = *crgData;
+    *crgData = *newData;
+    *newData = tmpData;
+    
+    newData->admin.id = crgData->admin.id;
+    crgData->admin.id = dataSetId;
+    
+    if ( keepSettings )
+    {
+        tmpOpts            = crgData->options;
+        crgData->options   = newData->options;
+        newData->options   = tmpOpts;
+        
+        tmpOpts            = crgData->modifiers;
+        crgData->modifiers = newData->modifiers;
+        newData->modifiers = tmpOpts;
+    }
+    
+    /* --- the option snapshot for new contact points has to be rebuilt from the options in place --- */
+    crgOptionBlockRelease( crgData->cpOptions );
+    crgData->cpOptions = NULL;
+    
+    crgDataSetRelease( newData->admin.id );
+    
+    /* --- the reference line may have changed, so previous queries are no longer valid --- */
+    crgContactPointClearHistoryForDataSet( crgData );
+    
+    /* --- restore the state of the data set as set up by the application --- */
+    crgData->cellCoefs.enabled = cellCoefsEnabled;
+    
+    if ( modifiersApplied )
+        crgDataSetModifiersApply( dataSetId );
+    else if ( cellCoefsEnabled )
+        crgDataCalcCellCoefs( crgData );
+    
+    crgMsgPrint( dCrgMsgLevelNotice, "crgDataSetReload: reloaded <%s> in %.3f ms, decoded %lu of %lu data blocks\n",
+                                     crgData->reload->filename, 1.0e-6 * ( crgPortGetTime() - time0 ),
+                                     ( unsigned long ) noDecoded, ( unsigned long ) noBlocks );
+    
+    return 1;
+}
+
+static char*
+reloadReadFile( const char* filename, size_t size )
+{
+    FILE*  fPtr;
+    char*  buffer;
+    size_t noBytesRead;
+    
+    if ( !( fPtr = fopen( filename, "rb" ) ) )
+        return NULL;
+    
+    if ( !( buffer = ( char* ) crgCalloc( 1, size + 1 ) ) )
+    {
+        fclose( fPtr );
+        return NULL;
+    }
+    
+    noBytesRead = fread( buffer, 1, size, fPtr );
+    fclose( fPtr );
+    
+    if ( noBytesRead < size )
+    {
+        crgFree( buffer );
+        return NULL;
+    }
+    
+    return buffer;
+}
+
+static int
+reloadIsUnchanged( CrgReloadStruct* reload, const char* buffer, size_t size )
+{
+    size_t b;
+    
+    if ( !reload->noBlocks || reload->isCompressed || size != reload->fileSize 
+      || reload->hdrSize + reload->blockOffset[reload->noBlocks] > size
+      || reloadChecksum( dCrgLoaderTagHashSeed, buffer, reload->hdrSize ) != reload->hdrSum )
+        return 0;
+    
+    buffer += reload->hdrSize;
+    
+    for ( b = 0; b < reload->noBlocks; b++ )
+    {
+        if ( reloadChecksum( dCrgLoaderTagHashSeed, buffer + reload->blockOffset[b], 
+                             reload->blockOffset[b+1] - reload->blockOffset[b] ) != reload->blockSum[b] )
+            return 0;
+    }
+    
+    return 1;
+}
+
+void
+crgLoaderReleaseReload( CrgDataStruct* crgData )
+{
+    if ( !crgData )
+        return;
+    
+    reloadRelease( crgData->reload );
+    crgData->reload = NULL;
+}
+
+static unsigned long
+reloadChecksum( unsigned long sum, const char* data, size_t size )
+{
+    unsigned int  word[4];
+    unsigned long lane[4];
+    size_t        i;
+    int           j;
+    
+    /* --- FNV-1a on 32 bit words in four independent lanes, the data section may be large --- */
+    for ( j = 0; j < 4; j++ )
+        lane[j] = sum + j;
+    
+    for ( i = 0; i + sizeof( word ) <= size; i += sizeof( word ) )
+    {
+        memcpy( word, data + i, sizeof( word ) );
+        
+        for ( j = 0; j < 4; j++ )
+            lane[j] = ( ( lane[j] ^ word[j] ) * dCrgLoaderSumPrime ) & 0xffffffffUL;
+    }
+    
+    for ( sum = lane[0], j = 1; j < 4; j++ )
+        sum = ( ( sum ^ lane[j] ) * dCrgLoaderSumPrime ) & 0xffffffffUL;
+    
+    for ( ; i < size; i++ )
+        sum = ( ( sum ^ ( unsigned char ) data[i] ) * dCrgLoaderSumPrime ) & 0xffffffffUL;
+    
+    return sum;
+}
+
+static unsigned long
+reloadSumInfo( unsigned long sum, const CrgChannelInfoStruct* info )
+{
+    CrgChannelInfoStruct tmp;
+    
+    /* --- copy member by member so that padding bytes don't contribute --- */
+    memset( &tmp, 0, sizeof( tmp ) );
+    
+    tmp.valid      = info->valid;
+    tmp.defined    = info->defined;
+    tmp.singlePrec = info->singlePrec;
+    tmp.index      = info->index;
+    tmp.size       = info->size;
+    tmp.first      = info->first;
+    tmp.last       = info->last;
+    tmp.inc        = info->inc;
+    tmp.mean       = info->mean;
+    
+    return reloadChecksum( sum, ( const char* ) &tmp, sizeof( tmp ) );
+}
+
+static unsigned long
+reloadLayoutSum( CrgDataStruct* crgData )
+{
+    unsigned long sum = dCrgLoaderTagHashSeed;
+    size_t        i;
+    
+    sum = reloadChecksum( sum, ( const char* ) &( crgData->noChannels ),         sizeof( crgData->noChannels ) );
+    sum = reloadChecksum( sum, ( const char* ) &( crgData->admin.dataFormat ),   sizeof( crgData->admin.dataFormat ) );
+    sum = reloadChecksum( sum, ( const char* ) &( crgData->admin.defMask ),      sizeof( crgData->admin.defMask ) );
+    sum = reloadChecksum( sum, ( const char* ) &( crgData->admin.recordSize ),   sizeof( crgData->admin.recordSize ) );
+    
+    sum = reloadSumInfo( sum, &( crgData->channelV.info ) );
+    sum = reloadSumInfo( sum, &( crgData->channelX.info ) );
+    sum = reloadSumInfo( sum, &( crgData->channelY.info ) );
+    sum = reloadSumInfo( sum, &( crgData->channelU.info ) );
+    sum = reloadSumInfo( sum, &( crgData->channelPhi.info ) );
+    sum = reloadSumInfo( sum, &( crgData->channelSlope.info ) );
+    sum = reloadSumInfo( sum, &( crgData->channelBank.info ) );
+    sum = reloadSumInfo( sum, &( crgData->channelRefZ.info ) );
+    
+    if ( crgData->channelV.data )
+        sum = reloadChecksum( sum, ( const char* ) crgData->channelV.data, crgData->channelV.info.size * sizeof( double ) );
+    
+    for ( i = 0; crgData->channelZ && i < crgData->channelV.info.size; i++ )
+        sum = reloadSumInfo( sum, &( crgData->channelZ[i].info ) );
+    
+    return sum;
+}
+
+static int
+reloadScanData( CrgDataStruct* crgData, CrgReloadStruct* reload, size_t nBytes )
+{
+    char*  dataPtr   = crgData->admin.dataSection;
+    char*  recPtr    = dataPtr;
+    char*  nextPtr;
+    size_t bytesLeft = nBytes;
+    size_t noRecords = 0;
+    size_t noAlloc   = 0;
+    size_t b;
+    
+    reload->hdrSize   = ( size_t ) ( dataPtr - crgData->admin.fileBuffer );
+    reload->hdrSum    = reloadChecksum( dCrgLoaderTagHashSeed, crgData->admin.fileBuffer, reload->hdrSize );
+    reload->layoutSum = reloadLayoutSum( crgData );
+    
+    /* --- the checksums of compressed data are those of the decoded records --- */
+    reload->isCompressed = ( crgData->admin.dataFormat & dDataFormatCompressed ) != 0;
+    
+    if ( !crgData->admin.recordSize )
+        return 0;
+    
+    /* --- find the start of each block; binary records have a fixed size, --- */
+    /* --- ASCII records may be separated by line breaks of any kind        --- */
+    if ( crgData->admin.dataFormat & dDataFormatBinary )
+    {
+        noRecords = nBytes / crgData->admin.recordSize;
+        noAlloc   = noRecords / dCrgLoaderReloadBlockRecs + 2;
+        
+        if ( !( reload->blockOffset = ( size_t* ) crgCalloc( noAlloc, sizeof( size_t ) ) ) )
+            return 0;
+        
+        for ( b = 0; b * dCrgLoaderReloadBlockRecs < noRecords; b++ )
+            reload->blockOffset[b] = b * dCrgLoaderReloadBlockRecs * crgData->admin.recordSize;
+        
+        recPtr = dataPtr + noRecords * crgData->admin.recordSize;
+    }
+    else
+    {
+        while ( ( nextPtr = getNextRecord( crgData->admin.recordSize, crgData->admin.dataFormat, recPtr, bytesLeft ) ) )
+        {
+            if ( !( noRecords % dCrgLoaderReloadBlockRecs ) )
+            {
+                b = noRecords / dCrgLoaderReloadBlockRecs;
+                
+                /* --- one more entry is required for the end of the last block --- */
+                if ( b + 2 > noAlloc )
+                {
+                    size_t* offsets;
+                    
+                    noAlloc = noAlloc ? 2 * noAlloc : 64;
+                    
+                    if ( !( offsets = ( size_t* ) crgRealloc( reload->blockOffset, noAlloc * sizeof( size_t ) ) ) )
+                        return 0;
+                    
+                    reload->blockOffset = offsets;
+                }
+                
+                reload->blockOffset[b] = ( size_t ) ( recPtr - dataPtr );
+            }
+            
+            bytesLeft -= ( size_t ) ( nextPtr - recPtr );
+            recPtr     = nextPtr;
+            noRecords++;
+        }
+    }
+    
+    if ( !noRecords )
+        return 0;
+    
+    reload->noRecords = noRecords;
+    reload->noBlocks  = ( noRecords + dCrgLoaderReloadBlockRecs - 1 ) / dCrgLoaderReloadBlockRecs;
+    reload->noDecoded = reload->noBlocks;
+    reload->blockOffset[reload->noBlocks] = ( size_t ) ( recPtr - dataPtr );
+    
+    if ( !( reload->blockSum = ( unsigned long* ) crgCalloc( reload->noBlocks, sizeof( unsigned long ) ) ) )
+    {
+        reload->noBlocks = 0;
+        return 0;
+    }
+    
+    for ( b = 0; b < reload->noBlocks; b++ )
+        reload->blockSum[b] = reloadChecksum( dCrgLoaderTagHashSeed, dataPtr + reload->blockOffset[b], 
+                                              reload->blockOffset[b+1] - reload->blockOffset[b] );
+    
+    return 1;
+}
+
+static void
+reloadCopyRecords( CrgDataStruct* dst, CrgDataStruct* src, size_t first, size_t count )
+{
+    CrgChannelStruct* chanDst[5];
+    CrgChannelStruct* chanSrc[5];
+    size_t i;
+    
+    for ( i = 0; i < src->channelV.info.size; i++ )
+        memcpy( dst->channelZ[i].data + first, src->channelZ[i].data + first, count * sizeof( float ) );
+    
+    chanDst[0] = &( dst->channelX );     chanSrc[0] = &( src->channelX );
+    chanDst[1] = &( dst->channelY );     chanSrc[1] = &( src->channelY );
+    chanDst[2] = &( dst->channelPhi );   chanSrc[2] = &( src->channelPhi );
+    chanDst[3] = &( dst->channelBank );  chanSrc[3] = &( src->channelBank );
+    chanDst[4] = &( dst->channelSlope ); chanSrc[4] = &( src->channelSlope );
+    
+    /* --- other channels only hold data read from file if they are defined in the data section --- */
+    for ( i = 0; i < 5; i++ )
+    {
+        if ( chanSrc[i]->info.defined && chanSrc[i]->data && chanDst[i]->data )
+            memcpy( chanDst[i]->data + first, chanSrc[i]->data + first, count * sizeof( double ) );
+    }
+}
+
+static int
+reloadReuseData( CrgDataStruct* crgData )
+{
+    CrgReloadStruct* prev  = sReloadPrev;
+    CrgReloadStruct* next  = sReloadNext;
+    CrgDataStruct*   image = prev->image;
+    char*            recPtr;
+    size_t           srcBytesLeft;
+    size_t           noChanged = 0;
+    size_t           nRec;
+    size_t           nEnd;
+    size_t           b;
+    
+    /* --- data layout and block structure must be unchanged --- */
+    if ( !image || !next->noBlocks || next->layoutSum != prev->layoutSum 
+      || next->noBlocks != prev->noBlocks || next->noRecords != prev->noRecords 
+      || image->channelX.info.size != next->noRecords
+      || memcmp( next->blockOffset, prev->blockOffset, ( next->noBlocks + 1 ) * sizeof( size_t ) ) )
+        return 0;
+    
+    for ( b = 0; b < next->noBlocks; b++ )
+        if ( next->blockSum[b] != prev->blockSum[b] )
+            noChanged++;
+    
+    /* --- explicit u or x/y data define the spacing of the reference line as a whole --- */
+    if ( noChanged && ( crgData->channelU.info.defined || crgData->channelX.info.defined ) )
+        return 0;
+    
+    /* --- the reference line information derived from the data section is unchanged --- */
+    crgData->channelU.info   = image->channelU.info;
+    crgData->channelX.info   = image->channelX.info;
+    crgData->channelY.info   = image->channelY.info;
+    crgData->channelPhi.info = image->channelPhi.info;
+    
+    if ( !allocateChannels( crgData ) )
+    {
+        releaseChannelData( crgData );
+        return 0;
+    }
+    
+    reloadCopyRecords( crgData, image, 0, next->noRecords );
+    
+    /* --- decode the modified blocks only --- */
+    for ( b = 0; b < next->noBlocks; b++ )
+    {
+        if ( next->blockSum[b] == prev->blockSum[b] )
+            continue;
+        
+        recPtr       = crgData->admin.dataSection + next->blockOffset[b];
+        srcBytesLeft = next->blockOffset[next->noBlocks] - next->blockOffset[b];
+        nEnd         = ( b + 1 ) * dCrgLoaderReloadBlockRecs;
+        
+        if ( nEnd > next->noRecords )
+            nEnd = next->noRecords;
+        
+        for ( nRec = b * dCrgLoaderReloadBlockRecs; nRec < nEnd; nRec++ )
+        {
+            if ( !decodeNextRecord( crgData, &recPtr, &srcBytesLeft ) )
+            {
+                releaseChannelData( crgData );
+                return 0;
+            }
+            
+            storeRecord( crgData, nRec );
+        }
+    }
+    
+    /* --- update the decoded data and hand it over to the new reload information --- */
+    for ( b = 0; b < next->noBlocks; b++ )
+    {
+        if ( next->blockSum[b] == prev->blockSum[b] )
+            continue;
+        
+        nEnd = ( b + 1 ) * dCrgLoaderReloadBlockRecs;
+        
+        if ( nEnd > next->noRecords )
+            nEnd = next->noRecords;
+        
+        reloadCopyRecords( image, crgData, b * dCrgLoaderReloadBlockRecs, nEnd - b * dCrgLoaderReloadBlockRecs );
+    }
+    
+    next->image      = image;
+    next->noDecoded  = noChanged;
+    prev->image      = NULL;
+    
+    /* --- file data copy is no longer needed --- */
+    crgFree( crgData->admin.fileBuffer );
+    crgData->admin.fileBuffer = NULL;
+    
+    return 1;
+}
+
+static void
+reloadKeepImage( CrgDataStruct* crgData, CrgReloadStruct* reload )
+{
+    CrgChannelStruct* chanDst[5];
+    CrgChannelStruct* chanSrc[5];
+    CrgDataStruct*    image;
+    size_t            i;
+    int               ok = 1;
+    
+    if ( !( image = ( CrgDataStruct* ) crgCalloc( 1, sizeof( CrgDataStruct ) ) ) )
+        return;
+    
+    image->channelV.info = crgData->channelV.info;
+    image->channelU.info = crgData->channelU.info;
+    
+    if ( !( image->channelZ = ( CrgChannelFStruct* ) crgCalloc( image->channelV.info.size, sizeof( CrgChannelFStruct ) ) ) )
+    {
+        crgFree( image );
+        return;
+    }
+    
+    for ( i = 0; i < image->channelV.info.size; i++ )
+    {
+        image->channelZ[i].info = crgData->channelZ[i].info;
+        
+        if ( !( image->channelZ[i].data = ( float* ) crgCalloc( image->channelZ[i].info.size, sizeof( float ) ) ) )
+            ok = 0;
+    }
+    
+    chanDst[0] = &( image->channelX );     chanSrc[0] = &( crgData->channelX );
+    chanDst[1] = &( image->channelY );     chanSrc[1] = &( crgData->channelY );
+    chanDst[2] = &( image->channelPhi );   chanSrc[2] = &( crgData->channelPhi );
+    chanDst[3] = &( image->channelBank );  chanSrc[3] = &( crgData->channelBank );
+    chanDst[4] = &( image->channelSlope ); chanSrc[4] = &( crgData->channelSlope );
+    
+    for ( i = 0; i < 5; i++ )
+    {
+        chanDst[i]->info = chanSrc[i]->info;
+        
+        if ( chanSrc[i]->info.defined && chanSrc[i]->data )
+        {
+            if ( !( chanDst[i]->data = ( double* ) crgCalloc( chanSrc[i]->info.size, sizeof( double ) ) ) )
+                ok = 0;
+        }
+    }
+    
+    if ( !ok )
+    {
+        crgMsgPrint( dCrgMsgLevelInfo, "reloadKeepImage: not enough memory, next reload will decode all data.\n" );
+        reloadReleaseImage( image );
+        return;
+    }
+    
+    reloadCopyRecords( image, crgData, 0, crgData->channelX.info.size );
+    
+    reload->image = image;
+}
+
+static void
+reloadReleaseImage( CrgDataStruct* image )
+{
+    if ( !image )
+        return;
+    
+    releaseChannelData( image );
+    
+    if ( image->channelZ )
+        crgFree( image->channelZ );
+    
+    crgFree( image );
+}
+
+static void
+reloadRelease( CrgReloadStruct* reload )
+{
+    if ( !reload )
+        return;
+    
+    if ( reload->filename )
+        crgFree( reload->filename );
+    
+    if ( reload->blockOffset )
+        crgFree( reload->blockOffset );
+    
+    if ( reload->blockSum )
+        crgFree( reload->blockSum );
+    
+    reloadReleaseImage( reload->image );
+    
+    crgFree( reload );
+}
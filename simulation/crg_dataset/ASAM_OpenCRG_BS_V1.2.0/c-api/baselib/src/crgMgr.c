@@ -103,12 +103,20 @@ crgDataSetRelease( int dataSet )
     if ( crgData->channelRefZ.data )
         crgFree( crgData->channelRefZ.data );
 
+    if ( crgData->cellCoefs.coef )
+        crgPortFreeAligned( crgData->cellCoefs.coef );
+
     /* --- get rid of modifiers and options --- */
     if ( crgData->modifiers.entry )
         crgFree( crgData->modifiers.entry );
     
     if ( crgData->options.entry )
         crgFree( crgData->options.entry );
+    
+    crgOptionBlockRelease( crgData->cpOptions );
+
+    /* --- get rid of the information for reloading the file --- */
+    crgLoaderReleaseReload( crgData );
 
     /* --- invalidate the data set in the master list --- */
     for ( i = 0; i < (size_t)sNoDataSets; i++ )
@@ -322,6 +330,152 @@ crgDataSetHistory( int dataSetId, int histSize )
     return crgContactPointSetHistoryForDataSet( crgData, histSize );
 }
 
+int
+crgDataSetCellCoefsEnable( int dataSetId, int enable )
+{
+    CrgDataStruct *crgData = crgDataSetAccess( dataSetId );
+    
+    if ( !crgData )
+    {
+        crgMsgPrint( dCrgMsgLevelNotice, "crgDataSetCellCoefsEnable: unknown data set %d\n", dataSetId );
+        return 0;
+    }
+    
+    crgData->cellCoefs.enabled = enable ? 1 : 0;
+    
+    if ( enable )
+        return crgDataCalcCellCoefs( crgData );
+    
+    if ( crgData->cellCoefs.coef )
+        crgPortFreeAligned( crgData->cellCoefs.coef );
+    
+    crgData->cellCoefs.coef     = NULL;
+    crgData->cellCoefs.noCellsU = 0;
+    crgData->cellCoefs.noCellsV = 0;
+    
+    return 1;
+}
+
+int
+crgDataCalcCellCoefs( CrgDataStruct* crgData )
+{
+    size_t  noCellsU;
+    size_t  noCellsV;
+    size_t  i;
+    size_t  j;
+    double* c;
+    double  r0;
+    double  dr;
+    double  b0;
+    double  db;
+    double  v0;
+    double  dv;
+    double  mean;
+    double  z00;
+    double  z10;
+    double  z01;
+    double  z11;
+    
+    if ( !crgData || crgData->channelU.info.size < 2 || crgData->channelV.info.size < 2 )
+        return 0;
+    
+    noCellsU = crgData->channelU.info.size - 1;
+    noCellsV = crgData->channelV.info.size - 1;
+    
+    /* --- (re-)allocate only if the grid size has changed --- */
+    if ( !crgData->cellCoefs.coef || crgData->cellCoefs.noCellsU != noCellsU || crgData->cellCoefs.noCellsV != noCellsV )
+    {
+        if ( crgData->cellCoefs.coef )
+            crgPortFreeAligned( crgData->cellCoefs.coef );
+        
+        crgData->cellCoefs.coef     = NULL;
+        crgData->cellCoefs.noCellsU = 0;
+        crgData->cellCoefs.noCellsV = 0;
+        
+        if ( noCellsV > ( ( size_t ) -1 ) / ( 4 * sizeof( double ) ) / noCellsU )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "crgDataCalcCellCoefs: grid of data set %d is too large.\n", crgData->admin.id );
+            return 0;
+        }
+        
+        if ( !( crgData->cellCoefs.coef = ( double* ) crgPortCallocAligned( noCellsU * noCellsV * 4 * sizeof( double ) ) ) )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "crgDataCalcCellCoefs: cannot allocate %lu bytes for data set %d.\n", 
+                                           ( unsigned long ) ( noCellsU * noCellsV * 4 * sizeof( double ) ), crgData->admin.id );
+            return 0;
+        }
+        
+        crgData->cellCoefs.noCellsU = noCellsU;
+        crgData->cellCoefs.noCellsV = noCellsV;
+    }
+    
+    c = crgData->cellCoefs.coef;
+    
+    for ( j = 0; j < noCellsV; j++ )
+    {
+        const float* zLo = crgData->channelZ[j].data;
+        const float* zHi = crgData->channelZ[j+1].data;
+        
+        mean = crgData->channelZ[j].info.mean;
+        
+        /* --- v at the cell's lower border and width of the cell, as used by the banking term --- */
+        if ( crgData->admin.defMask & dCrgDataDefVIndex )
+        {
+            v0 = crgData->channelV.info.first + j * crgData->channelV.info.inc;
+            dv = crgData->channelV.info.inc;
+        }
+        else
+        {
+            v0 = crgData->channelV.data[j];
+            dv = crgData->channelV.data[j+1] - v0;
+        }
+        
+        for ( i = 0; i < noCellsU; i++, c += 4 )
+        {
+            z00 = zLo[i];
+            z10 = zLo[i+1];
+            z01 = zHi[i];
+            z11 = zHi[i+1];
+            
+            if ( crgData->channelRefZ.info.valid )
+            {
+                r0 = crgData->channelRefZ.data[i];
+                dr = crgData->channelRefZ.data[i+1] - r0;
+            }
+            else
+            {
+                r0 = crgData->channelRefZ.info.first;
+                dr = 0.0;
+            }
+            
+            b0 = 0.0;
+            db = 0.0;
+            
+            if ( crgData->util.hasBank )
+            {
+                if ( crgData->channelBank.info.valid )
+                {
+                    b0 = crgData->channelBank.data[i];
+                    db = crgData->channelBank.data[i+1] - b0;
+                }
+                else
+                    b0 = crgData->channelBank.info.first;
+            }
+            
+            /* --- z + refZ( fracU ) + bank( fracU ) * v( fracV ), expanded in powers of fracU and fracV --- */
+            c[0] = z00 + mean + r0 + b0 * v0;
+            c[1] = ( z10 - z00 ) + dr + db * v0;
+            c[2] = ( z01 - z00 ) + b0 * dv;
+            c[3] = ( z11 - z10 - z01 + z00 ) + db * dv;
+        }
+    }
+    
+    crgMsgPrint( dCrgMsgLevelInfo, "crgDataCalcCellCoefs: computed coefficients of %lu x %lu cells for data set %d.\n", 
+                                   ( unsigned long ) noCellsU, ( unsigned long ) noCellsV, crgData->admin.id );
+    
+    return 1;
+}
+
 int
 crgDataSetGetURange( int dataSetId, double *uMin, double *uMax )
 {
@@ -618,6 +772,14 @@ crgDataSetModifiersApply( int dataSetId )
     
     /* --- transform data to a different location? --- */
     crgDataApplyTransformations( crgData );
+    
+    /* --- data set has changed, so any previous check result is outdated --- */
+    crgData->admin.checkState       = dCrgCheckStateNone;
+    crgData->admin.modifiersApplied = 1;
+    
+    /* --- and pre-computed cell coefficients have to be updated --- */
+    if ( crgData->cellCoefs.enabled )
+        crgDataCalcCellCoefs( crgData );
 }
 
 static void
@@ -715,6 +877,15 @@ crgMemRelease( void )
 
     sDataSetList = NULL;
     sNoDataSets  = 0;
+    
+    /* --- release the contact point management incl. the pool of unused contact points --- */
+    crgContactPointDeleteAll( -1 );
+    
+    /* --- files which are still being written are completed --- */
+    crgWriterCloseAll();
+    
+    /* --- release the performance counters of all threads --- */
+    crgPerfStatRelease();
 }
 
 const char*
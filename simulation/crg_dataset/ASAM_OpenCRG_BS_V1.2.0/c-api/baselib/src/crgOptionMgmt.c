@@ -40,6 +40,13 @@
 */
 static CrgOptionEntryStruct* crgOptionGetEntry( CrgOptionsStruct* optionList, unsigned int optionId, unsigned int optionType );
 
+/**
+* copy the entries of an option list which shares a block before the list is modified
+* @param  optionList pointer to a list holding all applicable options
+* @return 1 if the list owns its entries, otherwise 0
+*/
+static int crgOptionUnshare( CrgOptionsStruct* optionList );
+
 /* ====== IMPLEMENTATION ====== */
 
 const char*
@@ -107,6 +114,10 @@ crgOptionGetName( unsigned int optionId )
             return "expected abs. tolerance";
             break;
 
+        case dCrgCpOptionRealTimeSteps:
+            return "real-time search step limit";
+            break;
+
         case dCrgModScaleZ:
             return "modifier z scale";
             break;
@@ -269,7 +280,24 @@ crgOptionGetType( unsigned int optionId )
 int 
 crgOptionSetInt( CrgOptionsStruct* optionList, unsigned int optionId, int optionValue )
 {
-    CrgOptionEntryStruct* entry = crgOptionGetEntry( optionList, optionId, dCrgOptionDataTypeInt );
+    CrgOptionEntryStruct* entry;
+    
+    /* --- check the validity of the option value --- */
+    switch( optionId )
+    {
+        case dCrgCpOptionRealTimeSteps:
+            if ( optionValue < 0 )
+            {
+                crgMsgPrint( dCrgMsgLevelWarn, "crgOptionSetInt: value for option <%s> must not be negative. Ignoring.\n",
+                                               crgOptionGetName( optionId ) );
+                return 0;
+            }
+            break;
+        default:
+            break;
+    }
+    
+    entry = crgOptionGetEntry( optionList, optionId, dCrgOptionDataTypeInt );
     
     if ( !entry )
     {
@@ -284,6 +312,8 @@ crgOptionSetInt( CrgOptionsStruct* optionList, unsigned int optionId, int option
     entry->dataType = dCrgOptionDataTypeInt;
     entry->valid    = 1;
     
+    crgOptionUpdateFlags( optionList );
+    
     return 1;
 }
 
@@ -323,6 +353,8 @@ crgOptionSetDouble( CrgOptionsStruct* optionList, unsigned int optionId, double
     entry->dataType = dCrgOptionDataTypeDouble;
     entry->valid    = 1;
     
+    crgOptionUpdateFlags( optionList );
+    
     return 1;
 }
 
@@ -364,8 +396,13 @@ crgOptionRemove( CrgOptionsStruct* optionList, unsigned int optionId )
     if ( optionId >= optionList->noEntries )
         return 0;
 
+    if ( !crgOptionUnshare( optionList ) )
+        return 0;
+
     optionList->entry[optionId].valid = 0;
     
+    crgOptionUpdateFlags( optionList );
+    
     return 1;
 }
 
@@ -380,9 +417,15 @@ crgOptionRemoveAll( CrgOptionsStruct* optionList )
         return 0;
     }
     
+    if ( !crgOptionUnshare( optionList ) )
+        return 0;
+    
     for ( i = 0; i < optionList->noEntries; i++ )
         optionList->entry[i].valid = 0;
     
+    optionList->flags = 0;
+    optionList->revision++;
+    
     return 1;
 }
 
@@ -445,6 +488,46 @@ crgOptionHasValueInt( CrgOptionsStruct* optionList, unsigned int optionId, int o
     return optionList->entry[optionId].iValue == optionValue;
 }
 
+void
+crgOptionUpdateFlags( CrgOptionsStruct* optionList )
+{
+    unsigned int flags = 0;
+    
+    if ( !optionList )
+        return;
+    
+    /* --- queries test these flags instead of looking up the option entries --- */
+    if ( crgOptionIsSet( optionList, dCrgCpOptionBorderModeU ) )
+        flags |= dCrgOptFlagBorderModeU;
+    
+    if ( crgOptionIsSet( optionList, dCrgCpOptionBorderModeV ) )
+        flags |= dCrgOptFlagBorderModeV;
+    
+    if ( crgOptionIsSet( optionList, dCrgCpOptionBorderOffsetU ) )
+        flags |= dCrgOptFlagBorderOffsetU;
+    
+    if ( crgOptionIsSet( optionList, dCrgCpOptionBorderOffsetV ) )
+        flags |= dCrgOptFlagBorderOffsetV;
+    
+    if ( crgOptionIsSet( optionList, dCrgCpOptionSmoothUBegin ) )
+        flags |= dCrgOptFlagSmoothUBegin;
+    
+    if ( crgOptionIsSet( optionList, dCrgCpOptionSmoothUEnd ) )
+        flags |= dCrgOptFlagSmoothUEnd;
+    
+    if ( crgOptionHasValueInt( optionList, dCrgCpOptionRefLineContinue, dCrgRefLineCloseTrack ) )
+        flags |= dCrgOptFlagCloseTrack;
+    
+    if ( crgOptionHasValueInt( optionList, dCrgCpOptionCurvMode, dCrgCurvLateral ) )
+        flags |= dCrgOptFlagCurvLateral;
+    
+    if ( crgOptionIsSet( optionList, dCrgCpOptionRealTimeSteps ) && optionList->entry[dCrgCpOptionRealTimeSteps].iValue > 0 )
+        flags |= dCrgOptFlagRealTime;
+    
+    optionList->flags = flags;
+    optionList->revision++;
+}
+
 static CrgOptionEntryStruct* 
 crgOptionGetEntry( CrgOptionsStruct* optionList, unsigned int optionId, unsigned int optionType )
 {
@@ -461,6 +544,10 @@ crgOptionGetEntry( CrgOptionsStruct* optionList, unsigned int optionId, unsigned
         return NULL;
     }
     
+    /* --- entries of a shared block must not be modified --- */
+    if ( !crgOptionUnshare( optionList ) )
+        return NULL;
+    
     /* --- for faster computation, the options are kept in a list with one entry for each --- */
     /* --- possible optionId, so that options can be accessed directly by index           --- */
     if ( optionId < optionList->noEntries )
@@ -532,12 +619,13 @@ crgOptionCopyAll( CrgOptionsStruct* dst, CrgOptionsStruct* src )
     }
 
     /* --- delete default initialisation --- */
-    if( dst->entry )
-        crgFree( dst->entry );
+    crgOptionReleaseList( dst );
     
     /* --- first copy administration data --- */
     memcpy( dst, src, sizeof( CrgOptionsStruct ) );
     
+    dst->shared = NULL;
+    
     /* --- now copy the contents --- */
     dst->entry = ( CrgOptionEntryStruct* ) crgCalloc( src->noEntries, sizeof( CrgOptionEntryStruct ) );
     
@@ -545,6 +633,7 @@ crgOptionCopyAll( CrgOptionsStruct* dst, CrgOptionsStruct* src )
     {
         crgMsgPrint( dCrgMsgLevelWarn, "crgOptionCopyAll: could not allocate space for options. Ignoring request.\n" );
         dst->noEntries = 0;
+        dst->flags     = 0;
         return;
     }
       
@@ -558,10 +647,11 @@ crgOptionCreateList( CrgOptionsStruct* optionList )
     if ( !optionList )
         return 0;
     
-    if ( optionList->entry )
-        crgFree( optionList->entry );
+    crgOptionReleaseList( optionList );
 
+    optionList->revision++;
     optionList->noEntries = 0;
+    optionList->flags     = 0;
     optionList->entry     = ( CrgOptionEntryStruct* ) crgCalloc( dCrgSizeOptList + 1, sizeof( CrgOptionEntryStruct ) );
     
     if ( !optionList->entry )
@@ -572,3 +662,111 @@ crgOptionCreateList( CrgOptionsStruct* optionList )
     return 1;
 }
 
+void
+crgOptionReleaseList( CrgOptionsStruct* optionList )
+{
+    if ( !optionList )
+        return;
+    
+    if ( optionList->shared )
+        crgOptionBlockRelease( optionList->shared );
+    else if ( optionList->entry )
+        crgFree( optionList->entry );
+    
+    optionList->entry     = NULL;
+    optionList->shared    = NULL;
+    optionList->noEntries = 0;
+    optionList->flags     = 0;
+}
+
+CrgOptionBlockStruct*
+crgOptionBlockCreate( CrgOptionsStruct* src )
+{
+    CrgOptionBlockStruct* block;
+    
+    if ( !src )
+        return NULL;
+    
+    if ( !( block = ( CrgOptionBlockStruct* ) crgCalloc( 1, sizeof( CrgOptionBlockStruct ) ) ) )
+        return NULL;
+    
+    if ( src->noEntries )
+    {
+        if ( !( block->entry = ( CrgOptionEntryStruct* ) crgCalloc( src->noEntries, sizeof( CrgOptionEntryStruct ) ) ) )
+        {
+            crgFree( block );
+            return NULL;
+        }
+        
+        memcpy( block->entry, src->entry, src->noEntries * sizeof( CrgOptionEntryStruct ) );
+    }
+    
+    block->refCount  = 1;
+    block->noEntries = src->noEntries;
+    block->flags     = src->flags;
+    block->revision  = src->revision;
+    
+    return block;
+}
+
+void
+crgOptionBlockRelease( CrgOptionBlockStruct* block )
+{
+    if ( !block )
+        return;
+    
+    if ( --block->refCount > 0 )
+        return;
+    
+    if ( block->entry )
+        crgFree( block->entry );
+    
+    crgFree( block );
+}
+
+void
+crgOptionShare( CrgOptionsStruct* optionList, CrgOptionBlockStruct* block )
+{
+    if ( !optionList || !block )
+        return;
+    
+    crgOptionReleaseList( optionList );
+    
+    block->refCount++;
+    
+    optionList->shared    = block;
+    optionList->entry     = block->entry;
+    optionList->noEntries = block->noEntries;
+    optionList->flags     = block->flags;
+    optionList->revision  = block->revision;
+}
+
+static int
+crgOptionUnshare( CrgOptionsStruct* optionList )
+{
+    CrgOptionEntryStruct* entry;
+    
+    if ( !optionList->shared )
+        return 1;
+    
+    /* --- copy on write --- */
+    if ( optionList->noEntries )
+    {
+        if ( !( entry = ( CrgOptionEntryStruct* ) crgCalloc( optionList->noEntries, sizeof( CrgOptionEntryStruct ) ) ) )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "crgOptionUnshare: could not allocate space for options.\n" );
+            return 0;
+        }
+        
+        memcpy( entry, optionList->entry, optionList->noEntries * sizeof( CrgOptionEntryStruct ) );
+    }
+    else
+        entry = NULL;
+    
+    crgOptionBlockRelease( optionList->shared );
+    
+    optionList->shared = NULL;
+    optionList->entry  = entry;
+    
+    return 1;
+}
@@ -0,0 +1,444 @@
+/* ===================================================
+ *  runtime performance counters of the evaluation
+ *  methods, collected per thread
+ * ---------------------------------------------------
+ *
+ * ASAM OpenCRG C API
+ *
+ * OpenCRG version:           1.2.0
+ *
+ * package:               baselib
+ * file name:             crgPerfStat.c
+ * author:                ASAM e.V.
+ *
+ *
+ * C by ASAM e.V., 2020
+ * Any use is limited to the scope described in the license terms.
+ * The license terms can be viewed at www.asam.net/license
+ *
+ * More Information on ASAM OpenCRG can be found here:
+ * https://www.asam.net/standards/detail/opencrg/
+ *
+ */
+/* ====== INCLUSIONS ====== */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L  /* POSIX threads */
+#endif
+#include "crgBaseLibPrivate.h"
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+
+/* ====== DEFINITIONS ====== */
+/**
+* the counters of terminated threads are retired by the destructor of a thread
+* specific key; without dCrgEnableThreads the key is only created if the
+* application is linked with POSIX threads, otherwise (and for compilers
+* without weak symbols) all threads share one set of counters
+*/
+#if defined(dCrgEnableThreads) || ( defined(__GNUC__) && !defined(_WIN32) )
+#define dPerfStatThreadExit
+#endif
+
+/* lock of the lists of counters, held only for list operations */
+#define dPerfStatLock()    while ( !dCrgAtomicCas( &sPerfStatLock, 0, 1 ) )
+#define dPerfStatUnlock()  ( void ) dCrgAtomicCas( &sPerfStatLock, 1, 0 )
+
+#ifdef dPerfStatThreadExit
+#include <pthread.h>
+#ifndef dCrgEnableThreads
+#pragma weak pthread_key_create
+#pragma weak pthread_setspecific
+#endif
+#endif
+
+/* ====== TYPE DEFINITIONS ====== */
+typedef struct
+{
+    const char* name;
+    size_t      offset;
+} CrgPerfStatCounterStruct;
+
+/* ====== LOCAL METHODS ====== */
+static void printHistogram( FILE* fPtr, const char* name, unsigned long* histogram, int format );
+
+/**
+* add a set of counters to another one
+* @param tgt    counters to be increased
+* @param src    counters to be added
+*/
+static void addCounters( CrgPerfStatStruct* tgt, const CrgPerfStatStruct* src );
+
+#ifdef dPerfStatThreadExit
+/**
+* create the key whose destructor retires the counters of terminating threads
+* @return 1 if the key could be created, otherwise 0
+*/
+static int perfStatKeyCreate( void );
+
+/**
+* retire the counters of a terminating thread: add them to the totals of
+* terminated threads and keep the block for re-use by the next new thread
+* @param arg    pointer to the counters of the thread
+*/
+static void perfStatThreadExit( void* arg );
+#endif
+
+/* ====== LOCAL VARIABLES ====== */
+/* fallback counters, shared by all threads whose counters could not be allocated */
+static CrgPerfStatThreadStruct sPerfStatShared;
+
+/* list of the counters of all running threads */
+static CrgPerfStatThreadStruct* volatile sPerfStatList = &sPerfStatShared;
+
+/* accumulated counters of terminated threads */
+static CrgPerfStatStruct sPerfStatRetired;
+
+/* blocks of terminated threads, re-used for new threads */
+static CrgPerfStatThreadStruct* sPerfStatFree = NULL;
+
+static volatile long sPerfStatLock = 0;
+
+/* state of the thread specific key: 0 = not created yet, 1 = valid, -1 = not available */
+static int sPerfStatKeyState = 0;
+
+#ifdef dPerfStatThreadExit
+static pthread_key_t sPerfStatKey;
+#endif
+
+static CrgPerfStatCounterStruct sCounterTable[] = {
+   { "noEvaluv2z",      offsetof( CrgPerfStatStruct, noEvaluv2z      ) },
+   { "noBorderU",       offsetof( CrgPerfStatStruct, noBorderU       ) },
+   { "noBorderV",       offsetof( CrgPerfStatStruct, noBorderV       ) },
+   { "noLoopV",         offsetof( CrgPerfStatStruct, noLoopV         ) },
+   { "noEvalxy2uv",     offsetof( CrgPerfStatStruct, noEvalxy2uv     ) },
+   { "noHistIter",      offsetof( CrgPerfStatStruct, noHistIter      ) },
+   { "noHistCloseHits", offsetof( CrgPerfStatStruct, noHistCloseHits ) },
+   { "noHistFarHits",   offsetof( CrgPerfStatStruct, noHistFarHits   ) },
+   { "noHistNoHits",    offsetof( CrgPerfStatStruct, noHistNoHits    ) },
+   { "noScanPts",       offsetof( CrgPerfStatStruct, noScanPts       ) },
+   { "noLoop1",         offsetof( CrgPerfStatStruct, noLoop1         ) },
+   { "noLoop2",         offsetof( CrgPerfStatStruct, noLoop2         ) },
+   { "",                0                                              }
+};
+
+/* ====== GLOBAL VARIABLES ====== */
+int mCrgPerfStatSampling = 0;
+dCrgThreadLocal CrgPerfStatThreadStruct* mCrgPerfStatLocal = NULL;
+
+/* ====== IMPLEMENTATION ====== */
+CrgPerfStatThreadStruct*
+crgPerfStatRegister( void )
+{
+    CrgPerfStatThreadStruct* perf = NULL;
+
+    if ( mCrgPerfStatLocal )
+        return mCrgPerfStatLocal;
+
+    dPerfStatLock();
+
+#ifdef dPerfStatThreadExit
+    if ( !sPerfStatKeyState )
+        sPerfStatKeyState = perfStatKeyCreate() ? 1 : -1;
+#else
+    sPerfStatKeyState = -1;
+#endif
+
+    /* --- re-use the block of a terminated thread --- */
+    if ( sPerfStatFree )
+    {
+        perf          = sPerfStatFree;
+        sPerfStatFree = perf->next;
+    }
+
+    dPerfStatUnlock();
+
+    /* --- blocks which could never be retired would pile up with every new thread --- */
+    if ( sPerfStatKeyState < 0 ||
+         ( !perf && !( perf = ( CrgPerfStatThreadStruct* ) crgCalloc( 1, sizeof( CrgPerfStatThreadStruct ) ) ) ) )
+    {
+        mCrgPerfStatLocal = &sPerfStatShared;
+        return mCrgPerfStatLocal;
+    }
+
+    dPerfStatLock();
+    perf->next    = sPerfStatList;
+    sPerfStatList = perf;
+    dPerfStatUnlock();
+
+#ifdef dPerfStatThreadExit
+    /* --- the counters are retired when the thread terminates --- */
+    pthread_setspecific( sPerfStatKey, perf );
+#endif
+
+    mCrgPerfStatLocal = perf;
+
+    return perf;
+}
+
+void
+crgPerfStatAdd( CrgPerfStatThreadStruct* perf, const CrgPerfStatStruct* counters )
+{
+    addCounters( &( perf->counters ), counters );
+}
+
+void
+crgPerfStatRelease( void )
+{
+    CrgPerfStatThreadStruct* perf;
+
+    dPerfStatLock();
+
+    while ( ( perf = sPerfStatList ) != &sPerfStatShared )
+    {
+        sPerfStatList = perf->next;
+        crgFree( perf );
+    }
+
+    while ( ( perf = sPerfStatFree ) != NULL )
+    {
+        sPerfStatFree = perf->next;
+        crgFree( perf );
+    }
+
+#ifdef dPerfStatThreadExit
+    if ( sPerfStatKeyState > 0 )
+        pthread_setspecific( sPerfStatKey, NULL );
+#endif
+
+    memset( &( sPerfStatShared.counters ), 0, sizeof( CrgPerfStatStruct ) );
+    memset( &sPerfStatRetired, 0, sizeof( CrgPerfStatStruct ) );
+    sPerfStatShared.sampleCtr = 0;
+
+    dPerfStatUnlock();
+
+    mCrgPerfStatLocal = NULL;
+}
+
+int
+crgPerfStatSampleQuery( CrgPerfStatThreadStruct* perf )
+{
+    if ( mCrgPerfStatSampling <= 0 )
+        return 0;
+
+    if ( ++perf->sampleCtr < ( unsigned long ) mCrgPerfStatSampling )
+        return 0;
+
+    perf->sampleCtr = 0;
+
+    return 1;
+}
+
+void
+crgPerfStatAddLatency( unsigned long* histogram, double duration )
+{
+    int bin = 0;
+
+    while ( duration >= 2.0 && bin < dCrgPerfStatNoBins - 1 )
+    {
+        duration *= 0.5;
+        bin++;
+    }
+
+    histogram[bin]++;
+}
+
+void
+crgPerfStatGet( CrgPerfStatStruct* perfStat )
+{
+    CrgPerfStatThreadStruct* perf;
+
+    if ( !perfStat )
+        return;
+
+    dPerfStatLock();
+
+    *perfStat = sPerfStatRetired;
+
+    for ( perf = sPerfStatList; perf; perf = perf->next )
+        addCounters( perfStat, &( perf->counters ) );
+
+    dPerfStatUnlock();
+}
+
+void
+crgPerfStatReset( void )
+{
+    CrgPerfStatThreadStruct* perf;
+
+    dPerfStatLock();
+
+    memset( &sPerfStatRetired, 0, sizeof( CrgPerfStatStruct ) );
+
+    for ( perf = sPerfStatList; perf; perf = perf->next )
+    {
+        memset( &( perf->counters ), 0, sizeof( CrgPerfStatStruct ) );
+        perf->sampleCtr = 0;
+    }
+
+    dPerfStatUnlock();
+}
+
+void
+crgPerfStatSetSampling( int interval )
+{
+    mCrgPerfStatSampling = ( interval > 0 ) ? interval : 0;
+}
+
+void
+crgPerfStatPrint( void )
+{
+    CrgPerfStatStruct perfStat;
+
+    crgPerfStatGet( &perfStat );
+
+    crgMsgPrint( dCrgMsgLevelNotice, "Performance statistics (all threads)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "    History\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "        total number of queries:          %lu\n", perfStat.noEvalxy2uv     );
+    crgMsgPrint( dCrgMsgLevelNotice, "        total number of close hits:       %lu\n", perfStat.noHistCloseHits );
+    crgMsgPrint( dCrgMsgLevelNotice, "        total number of far hits:         %lu\n", perfStat.noHistFarHits   );
+    crgMsgPrint( dCrgMsgLevelNotice, "        total number of non-hits:         %lu\n", perfStat.noHistNoHits    );
+    crgMsgPrint( dCrgMsgLevelNotice, "        total number of iterations:       %lu\n", perfStat.noHistIter      );
+    crgMsgPrint( dCrgMsgLevelNotice, "        total number of scanned points:   %lu\n", perfStat.noScanPts       );
+    crgMsgPrint( dCrgMsgLevelNotice, "        total number of calls to loop 1:  %lu\n", perfStat.noLoop1         );
+    crgMsgPrint( dCrgMsgLevelNotice, "        total number of calls to loop 2:  %lu\n", perfStat.noLoop2         );
+    crgMsgPrint( dCrgMsgLevelNotice, "    Evaluation\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "        total number of queries:             %lu\n", perfStat.noEvaluv2z );
+    crgMsgPrint( dCrgMsgLevelNotice, "        total number of calls to loop V:     %lu\n", perfStat.noLoopV    );
+    crgMsgPrint( dCrgMsgLevelNotice, "        total number of calls to border U:   %lu\n", perfStat.noBorderU  );
+    crgMsgPrint( dCrgMsgLevelNotice, "        total number of calls to border V:   %lu\n", perfStat.noBorderV  );
+}
+
+int
+crgPerfStatDump( const char* filename, int format )
+{
+    CrgPerfStatStruct perfStat;
+    FILE* fPtr = stdout;
+    int   i;
+
+    if ( format != dCrgPerfStatFormatJSON && format != dCrgPerfStatFormatCSV )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgPerfStatDump: invalid format <%d>.\n", format );
+        return 0;
+    }
+
+    if ( filename && ( fPtr = fopen( filename, "w" ) ) == NULL )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgPerfStatDump: could not open <%s>.\n", filename );
+        return 0;
+    }
+
+    crgPerfStatGet( &perfStat );
+
+    if ( format == dCrgPerfStatFormatJSON )
+        fprintf( fPtr, "{\n" );
+    else
+        fprintf( fPtr, "counter,value\n" );
+
+    for ( i = 0; sCounterTable[i].name[0]; i++ )
+    {
+        unsigned long value = *( unsigned long* ) ( ( char* ) &perfStat + sCounterTable[i].offset );
+
+        if ( format == dCrgPerfStatFormatJSON )
+            fprintf( fPtr, "  \"%s\": %lu,\n", sCounterTable[i].name, value );
+        else
+            fprintf( fPtr, "%s,%lu\n", sCounterTable[i].name, value );
+    }
+
+    printHistogram( fPtr, "latencyEvaluv2z",  perfStat.latencyEvaluv2z,  format );
+
+    if ( format == dCrgPerfStatFormatJSON )
+        fprintf( fPtr, ",\n" );
+
+    printHistogram( fPtr, "latencyEvalxy2uv", perfStat.latencyEvalxy2uv, format );
+
+    if ( format == dCrgPerfStatFormatJSON )
+        fprintf( fPtr, "\n}\n" );
+
+    if ( filename )
+        fclose( fPtr );
+
+    return 1;
+}
+
+static void
+printHistogram( FILE* fPtr, const char* name, unsigned long* histogram, int format )
+{
+    int i;
+
+    if ( format == dCrgPerfStatFormatJSON )
+    {
+        fprintf( fPtr, "  \"%s\": [", name );
+
+        for ( i = 0; i < dCrgPerfStatNoBins; i++ )
+            fprintf( fPtr, "%s%lu", i ? ", " : "", histogram[i] );
+
+        fprintf( fPtr, "]" );
+        return;
+    }
+
+    /* --- CSV: one row per bin, named by the lower bound of the bin in ns --- */
+    for ( i = 0; i < dCrgPerfStatNoBins; i++ )
+        fprintf( fPtr, "%s_%luns,%lu\n", name, 1UL << i, histogram[i] );
+}
+
+static void
+addCounters( CrgPerfStatStruct* tgt, const CrgPerfStatStruct* src )
+{
+    int i;
+
+    for ( i = 0; sCounterTable[i].name[0]; i++ )
+        *( unsigned long* ) ( ( char* ) tgt + sCounterTable[i].offset ) +=
+            *( const unsigned long* ) ( ( const char* ) src + sCounterTable[i].offset );
+
+    for ( i = 0; i < dCrgPerfStatNoBins; i++ )
+    {
+        tgt->latencyEvaluv2z[i]  += src->latencyEvaluv2z[i];
+        tgt->latencyEvalxy2uv[i] += src->latencyEvalxy2uv[i];
+    }
+}
+
+#ifdef dPerfStatThreadExit
+static int
+perfStatKeyCreate( void )
+{
+#ifndef dCrgEnableThreads
+    /* --- application without POSIX threads --- */
+    if ( !pthread_key_create || !pthread_setspecific )
+        return 0;
+#endif
+
+    if ( !pthread_key_create( &sPerfStatKey, perfStatThreadExit ) )
+        return 1;
+
+    crgMsgPrint( dCrgMsgLevelWarn, "crgPerfStatRegister: could not create thread specific key, all threads share one set of counters.\n" );
+    return 0;
+}
+
+static void
+perfStatThreadExit( void* arg )
+{
+    CrgPerfStatThreadStruct*  perf = ( CrgPerfStatThreadStruct* ) arg;
+    CrgPerfStatThreadStruct** link;
+
+    dPerfStatLock();
+
+    /* --- blocks released by crgPerfStatRelease() are not in the list anymore --- */
+    for ( link = ( CrgPerfStatThreadStruct** ) &sPerfStatList; *link; link = &( ( *link )->next ) )
+    {
+        if ( *link != perf )
+            continue;
+
+        *link = perf->next;
+
+        addCounters( &sPerfStatRetired, &( perf->counters ) );
+        memset( perf, 0, sizeof( CrgPerfStatThreadStruct ) );
+
+        perf->next    = sPerfStatFree;
+        sPerfStatFree = perf;
+        break;
+    }
+
+    dPerfStatUnlock();
+}
+#endif
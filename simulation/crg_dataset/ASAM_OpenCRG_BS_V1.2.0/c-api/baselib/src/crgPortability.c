@@ -21,10 +21,23 @@
  *
  */
 /* ====== INCLUSIONS ====== */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L  /* POSIX threads, nanosleep() and clock_gettime() */
+#endif
 #include "crgBaseLibPrivate.h"
 #include <stdarg.h>
 #include <stdio.h>
 
+#include <time.h>
+
+#ifdef dCrgEnableMsgQueue
+#include <pthread.h>
+#endif
+
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+
 /*
 * try to stay compatible with older MSM compilers
 */
@@ -32,9 +45,39 @@
 #define vsnprintf _vsnprintf
 #endif
 
+#if defined(dCrgEnableMsgQueue) && !defined(__GNUC__) && !defined(_MSC_VER)
+#error "dCrgEnableMsgQueue requires atomic operations which are not available for this compiler"
+#endif
+
+/* ====== TYPE DEFINITIONS ====== */
+#ifdef dCrgEnableMsgQueue
+typedef struct
+{
+    int  level;
+    char text[dCrgMsgQueueTextLen];
+} CrgMsgQueueEntryStruct;
+
+/**
+* single-producer / single-consumer ring buffer, one per message issuing thread;
+* head is modified by the owning thread only, tail by the output thread only
+*/
+typedef struct CrgMsgQueueStruct
+{
+    volatile unsigned long    head;               /* index of next entry to be written                */
+    volatile unsigned long    tail;               /* index of next entry to be read                   */
+    volatile unsigned long    noDropped;          /* number of messages dropped due to a full queue   */
+    unsigned long             noDroppedReported;  /* number of dropped messages reported so far       */
+    volatile int              closed;             /* owning thread has terminated                     */
+    struct CrgMsgQueueStruct* next;
+    CrgMsgQueueEntryStruct    entry[dCrgMsgQueueSize];
+} CrgMsgQueueStruct;
+#endif
+
+/* ====== GLOBAL VARIABLES ====== */
+int mCrgMsgLevel = dCrgMsgLevelNotice;
+
 /* ====== LOCAL VARIABLES ====== */
-static int mMsgLevel    = dCrgMsgLevelNotice;
-static int mMaxWarnMsgs = -1;
+static volatile long mMaxWarnMsgs = -1;
 static int mMaxLogMsgs  = -1;
 
 static void* ( *mCallocCallback ) ( size_t nmemb, size_t size ) = NULL;
@@ -42,15 +85,83 @@ static void* ( *mReallocCallback ) ( void* ptr, size_t size ) = NULL;
 static void ( *mFreeCallback ) ( void* ptr ) = NULL;
 static int ( *mMsgCallback ) ( int level, char* message ) = NULL;
 
+#ifdef dCrgEnableMsgQueue
+static CrgMsgQueueStruct* mQueueList      = NULL;
+static pthread_mutex_t    mQueueListMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t      mQueueKey;
+static int                mQueueKeyValid  = 0;
+static pthread_t          mQueueThread;
+static volatile int       mQueueActive    = 0;
+static volatile int       mQueueStop      = 0;
+#endif
+
+/* ====== LOCAL METHODS ====== */
+/**
+* consume one message from the budget defined by crgPortSetMaxWarnMsgs()
+* @return 1 if the message may be printed, otherwise 0
+*/
+static int msgBudgetTake( void );
+
+#ifdef dCrgEnableMsgQueue
+/**
+* write a single message to the console or pass it to the message callback
+* @param level  message level
+* @param text   formatted message text
+*/
+static void msgEmit( int level, char* text );
+
+/**
+* queue a message in the ring buffer of the calling thread
+* @param level  message level
+* @param format format string
+* @param ap     format arguments
+* @return 1 if the message has been handled, 0 if it must be printed directly
+*/
+static int msgQueuePush( int level, const char* format, va_list ap );
+
+/**
+* write all queued messages of all threads
+* @return number of messages written
+*/
+static int msgQueueDrain( void );
+
+/**
+* main loop of the output thread
+*/
+static void* msgQueueThread( void* arg );
+
+/**
+* mark the queue of a terminating thread for release by the output thread
+*/
+static void msgQueueClose( void* queue );
+#endif
+
+/* ====== IMPLEMENTATION ====== */
 void 
 crgMsgPrint( int level, const char *format, ...)
 {
     va_list ap;
     int     ret;
     
-    if ( mMsgLevel < level )
+    if ( mCrgMsgLevel < level )
         return;
     
+#ifdef dCrgEnableMsgQueue
+    /* --- asynchronous output activated? --- */
+    if ( mQueueActive )
+    {
+        if ( !mMsgCallback && !msgBudgetTake() )
+            return;
+        
+        va_start ( ap, format );
+        ret = msgQueuePush( level, format, ap );
+        va_end( ap );
+        
+        if ( ret )
+            return;
+    }
+#endif
+
     /* --- is re-direction activated? --- */
     if ( mMsgCallback )
     {
@@ -72,11 +183,8 @@ crgMsgPrint( int level, const char *format, ...)
     }
 
     /** @todo: this is just a temporary solution and should be completed until 1.0 */
-    if ( !mMaxWarnMsgs )
+    if ( !msgBudgetTake() )
         return;
-    
-    if ( mMaxWarnMsgs > 0 )
-        mMaxWarnMsgs--;
 
     fprintf( stderr, "%7s: ", crgMsgGetLevelName( level ) );
     
@@ -87,12 +195,48 @@ crgMsgPrint( int level, const char *format, ...)
     if ( ret <= 0 )
         fprintf( stderr, "crgMsgPrint: Cannot create message.\n" );
 }
+
+static int
+msgBudgetTake( void )
+{
+    long noMsgs;
+    
+    do
+    {
+        noMsgs = mMaxWarnMsgs;
+        
+        if ( !noMsgs )
+            return 0;
+        
+        if ( noMsgs < 0 )
+            return 1;
+    }
+    while ( !dCrgAtomicCas( &mMaxWarnMsgs, noMsgs, noMsgs - 1 ) );
+    
+    return 1;
+}
+
+int
+crgPortMsgRateLimit( volatile long* counter )
+{
+    long count;
+    
+    if ( !counter )
+        return 1;
+    
+    count = dCrgAtomicIncrement( counter );
+    
+    if ( count <= dCrgMsgRateBurst )
+        return 1;
+    
+    return ( ( count - dCrgMsgRateBurst ) % dCrgMsgRateInterval ) == 0;
+}
     
 void
 crgPortSetMsgLevel( int level )
 {
     if ( level >= dCrgMsgLevelNone && level <= dCrgMsgLevelDebug )
-        mMsgLevel = level;
+        mCrgMsgLevel = level;
 }
     
 void*
@@ -163,3 +307,254 @@ crgMsgSetCallback( int ( *func ) ( int level, char* message ) )
 {
     mMsgCallback = func;
 }
+
+double
+crgPortGetTime( void )
+{
+#if defined(_WIN32)
+    static double nsPerTick = 0.0;
+    LARGE_INTEGER count;
+    
+    if ( nsPerTick == 0.0 )
+    {
+        LARGE_INTEGER freq;
+        
+        QueryPerformanceFrequency( &freq );
+        nsPerTick = 1.0e9 / ( double ) freq.QuadPart;
+    }
+    
+    QueryPerformanceCounter( &count );
+    
+    return ( double ) count.QuadPart * nsPerTick;
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec now;
+    
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    
+    return 1.0e9 * ( double ) now.tv_sec + ( double ) now.tv_nsec;
+#else
+    return 1.0e9 * ( double ) clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+void*
+crgPortCallocAligned( size_t size )
+{
+    char*  base;
+    char*  ptr;
+    size_t noLines = ( size + dCrgCacheLineSize - 1 ) / dCrgCacheLineSize;
+
+    /* --- room for alignment and for the pointer to the original block --- */
+    if ( !( base = ( char* ) crgCalloc( 1, ( noLines + 1 ) * dCrgCacheLineSize + sizeof( void* ) ) ) )
+        return NULL;
+
+    ptr  = base + sizeof( void* );
+    ptr += ( dCrgCacheLineSize - ( size_t ) ptr % dCrgCacheLineSize ) % dCrgCacheLineSize;
+
+    ( ( void** ) ptr )[-1] = base;
+
+    return ptr;
+}
+
+void
+crgPortFreeAligned( void* ptr )
+{
+    if ( ptr )
+        crgFree( ( ( void** ) ptr )[-1] );
+}
+
+int
+crgMsgQueueStart( void )
+{
+#ifndef dCrgEnableMsgQueue
+    crgMsgPrint( dCrgMsgLevelWarn, "crgMsgQueueStart: asynchronous message output has been disabled\n"
+                                   "Please provide/activate \"#define dCrgEnableMsgQueue\" in \"crgBaseLibPrivate.h\"\n" );
+    return 0;
+#else
+    if ( mQueueActive )
+        return 1;
+    
+    if ( !mQueueKeyValid )
+    {
+        if ( pthread_key_create( &mQueueKey, msgQueueClose ) )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal, "crgMsgQueueStart: could not create thread specific queue key.\n" );
+            return 0;
+        }
+        mQueueKeyValid = 1;
+    }
+    
+    mQueueStop = 0;
+    
+    if ( pthread_create( &mQueueThread, NULL, msgQueueThread, NULL ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgMsgQueueStart: could not start output thread.\n" );
+        return 0;
+    }
+    
+    mQueueActive = 1;
+    
+    return 1;
+#endif
+}
+
+void
+crgMsgQueueStop( void )
+{
+#ifdef dCrgEnableMsgQueue
+    if ( !mQueueActive )
+        return;
+    
+    /* --- new messages are printed directly, the output thread drains the rest --- */
+    mQueueActive = 0;
+    dCrgMemBarrier();
+    mQueueStop = 1;
+    
+    pthread_join( mQueueThread, NULL );
+    
+    /* --- catch messages which were queued while the output thread terminated --- */
+    msgQueueDrain();
+#endif
+}
+
+#ifdef dCrgEnableMsgQueue
+static void
+msgEmit( int level, char* text )
+{
+    if ( mMsgCallback )
+    {
+        mMsgCallback( level, text );
+        return;
+    }
+    
+    fprintf( stderr, "%7s: %s", crgMsgGetLevelName( level ), text );
+}
+
+static int
+msgQueuePush( int level, const char* format, va_list ap )
+{
+    CrgMsgQueueStruct*      queue = ( CrgMsgQueueStruct* ) pthread_getspecific( mQueueKey );
+    CrgMsgQueueEntryStruct* entry;
+    unsigned long           head;
+    
+    /* --- first message of this thread? register a new queue --- */
+    if ( !queue )
+    {
+        if ( !( queue = ( CrgMsgQueueStruct* ) crgCalloc( 1, sizeof( CrgMsgQueueStruct ) ) ) )
+            return 0;
+        
+        if ( pthread_setspecific( mQueueKey, queue ) )
+        {
+            crgFree( queue );
+            return 0;
+        }
+        
+        pthread_mutex_lock( &mQueueListMutex );
+        queue->next = mQueueList;
+        mQueueList  = queue;
+        pthread_mutex_unlock( &mQueueListMutex );
+    }
+    
+    head = queue->head;
+    
+    /* --- queue full? drop the message, the output thread reports the loss --- */
+    if ( head - queue->tail >= dCrgMsgQueueSize )
+    {
+        queue->noDropped++;
+        return 1;
+    }
+    
+    entry        = &( queue->entry[head % dCrgMsgQueueSize] );
+    entry->level = level;
+    
+    if ( vsnprintf( entry->text, dCrgMsgQueueTextLen, format, ap ) <= 0 )
+        return 1;
+    
+    /* --- publish the entry before the new head index --- */
+    dCrgMemBarrier();
+    queue->head = head + 1;
+    
+    return 1;
+}
+
+static int
+msgQueueDrain( void )
+{
+    CrgMsgQueueStruct** link;
+    CrgMsgQueueStruct*  queue;
+    unsigned long       head;
+    unsigned long       tail;
+    unsigned long       noDropped;
+    int                 noMsgs = 0;
+    
+    pthread_mutex_lock( &mQueueListMutex );
+    
+    link = &mQueueList;
+    
+    while ( ( queue = *link ) != NULL )
+    {
+        head = queue->head;
+        tail = queue->tail;
+        
+        /* --- read the entries only after the head index --- */
+        dCrgMemBarrier();
+        
+        for ( ; tail != head; tail++, noMsgs++ )
+            msgEmit( queue->entry[tail % dCrgMsgQueueSize].level, queue->entry[tail % dCrgMsgQueueSize].text );
+        
+        /* --- release the entries to the owning thread --- */
+        dCrgMemBarrier();
+        queue->tail = tail;
+        
+        noDropped = queue->noDropped;
+        
+        if ( noDropped != queue->noDroppedReported )
+        {
+            char buffer[128];
+            
+            sprintf( buffer, "crgMsgPrint: message queue full, dropped %lu message(s).\n", noDropped - queue->noDroppedReported );
+            msgEmit( dCrgMsgLevelWarn, buffer );
+            queue->noDroppedReported = noDropped;
+        }
+        
+        /* --- release queues of terminated threads --- */
+        if ( queue->closed && queue->head == tail )
+        {
+            *link = queue->next;
+            crgFree( queue );
+            continue;
+        }
+        
+        link = &( queue->next );
+    }
+    
+    pthread_mutex_unlock( &mQueueListMutex );
+    
+    return noMsgs;
+}
+
+static void*
+msgQueueThread( void* arg )
+{
+    struct timespec pause;
+    
+    pause.tv_sec  = 0;
+    pause.tv_nsec = 1000000L;   /* 1ms */
+    
+    while ( !mQueueStop )
+    {
+        if ( !msgQueueDrain() )
+            nanosleep( &pause, NULL );
+    }
+    
+    msgQueueDrain();
+    
+    return NULL;
+}
+
+static void
+msgQueueClose( void* queue )
+{
+    ( ( CrgMsgQueueStruct* ) queue )->closed = 1;
+}
+#endif
@@ -0,0 +1,401 @@
+/* ===================================================
+ *  classify the roughness of a road according to
+ *  ISO 8608 from the PSD of its elevation
+ * ---------------------------------------------------
+ *
+ * ASAM OpenCRG C API
+ *
+ * OpenCRG version:           1.2.0
+ *
+ * package:               baselib
+ * file name:             crgRoughness.c
+ * author:                ASAM e.V.
+ *
+ *
+ * C by ASAM e.V., 2020
+ * Any use is limited to the scope described in the license terms.
+ * The license terms can be viewed at www.asam.net/license
+ *
+ * More Information on ASAM OpenCRG can be found here:
+ * https://www.asam.net/standards/detail/opencrg/
+ *
+ */
+/* ====== INCLUSIONS ====== */
+#include "crgBaseLibPrivate.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ====== DEFINITIONS ====== */
+#define dCrgRoughWindowLength   100.0     /* default length of the Welch windows                [m] */
+#define dCrgRoughMinWindow      16        /* min. number of samples per window                  [-] */
+#define dCrgRoughMaxWindow      1048576   /* max. number of samples per window                  [-] */
+#define dCrgRoughSpatFreqMin    0.011     /* lowest spatial frequency (ISO 8608)         [cycles/m] */
+#define dCrgRoughSpatFreqMax    2.83      /* highest spatial frequency (ISO 8608)        [cycles/m] */
+#define dCrgRoughSpatFreqRef    0.1       /* reference spatial frequency n0 (ISO 8608)   [cycles/m] */
+#define dCrgRoughGdLimitA       32.0e-6   /* upper limit of Gd(n0) for class A                [m^3] */
+#define dCrgRoughNoClasses      8         /* classes A to H                                     [-] */
+#define dCrgRoughPi             3.14159265358979323846
+
+/* ====== TYPE DEFINITIONS ====== */
+/**
+* buffers of the spectral analysis; all of them are sized by the window, so
+* the memory does not depend on the length of the road
+*/
+typedef struct
+{
+    size_t  size;       /* number of samples per window                               [-] */
+    double  du;         /* distance of the samples                                    [m] */
+    double* z;          /* samples of the current window                              [m] */
+    double* re;         /* FFT buffer, real part                                      [-] */
+    double* im;         /* FFT buffer, imaginary part                                 [-] */
+    double* cosTab;     /* twiddle factors, real part                                 [-] */
+    double* sinTab;     /* twiddle factors, imaginary part                            [-] */
+    double* hann;       /* window function                                            [-] */
+    double* psd;        /* accumulated one-sided PSD                                [m^3] */
+} CrgRoughBufferStruct;
+
+/* ====== LOCAL METHODS ====== */
+/**
+* allocate the buffers and pre-compute window function and twiddle factors
+* @param buf    pointer to the buffers
+* @param size   number of samples per window, a power of 2
+* @param du     distance of the samples
+* @return 1 if successful, otherwise 0
+*/
+static int roughBufferAlloc( CrgRoughBufferStruct* buf, size_t size, double du );
+
+/**
+* release the buffers
+* @param buf    pointer to the buffers
+*/
+static void roughBufferFree( CrgRoughBufferStruct* buf );
+
+/**
+* in-place radix-2 FFT of the data in the FFT buffers
+* @param buf    pointer to the buffers
+*/
+static void roughFft( CrgRoughBufferStruct* buf );
+
+/**
+* remove the linear trend of the current window, apply the window function,
+* transform it and accumulate its periodogram
+* @param buf    pointer to the buffers
+*/
+static void roughAddWindow( CrgRoughBufferStruct* buf );
+
+/* ====== IMPLEMENTATION ====== */
+int
+crgDataSetCalcRoughness( int dataSetId, double v, double windowLength, CrgRoughnessStruct* roughness )
+{
+    CrgDataStruct*       crgData = crgDataSetAccess( dataSetId );
+    CrgRoughBufferStruct buf;
+    size_t               noSamples;
+    size_t               size;
+    size_t               step;
+    size_t               next;
+    size_t               i;
+    size_t               k;
+    double               du;
+    double               u;
+    double               dn;
+    double               n;
+    double               nLow;
+    double               nHigh;
+    double               bandPower;
+    double               bandShape;
+    double               bandEnd;
+    size_t               bandBins;
+    double               sumLogGd  = 0.0;
+    double               sumX      = 0.0;
+    double               sumY      = 0.0;
+    double               sumXX     = 0.0;
+    double               sumXY     = 0.0;
+    double               x;
+    double               y;
+    double               z;
+    int                  noBands   = 0;
+    int                  noWindows = 0;
+
+    memset( roughness, 0, sizeof( CrgRoughnessStruct ) );
+
+    if ( !crgData )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetCalcRoughness: invalid data set id <%d>.\n", dataSetId );
+        return 0;
+    }
+
+    if ( v < crgData->channelV.info.first || v > crgData->channelV.info.last )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetCalcRoughness: v = %.3f is outside of the road.\n", v );
+        return 0;
+    }
+
+    if ( windowLength <= 0.0 )
+        windowLength = dCrgRoughWindowLength;
+
+    /* --- the road is sampled at its grid nodes; the window is the shortest power of 2 covering its length --- */
+    du        = crgData->channelU.info.inc;
+    noSamples = crgData->channelU.info.size;
+
+    for ( size = dCrgRoughMinWindow; size < dCrgRoughMaxWindow && size * du < windowLength; size *= 2 )
+        ;
+
+    while ( size > noSamples && size > dCrgRoughMinWindow )
+        size /= 2;
+
+    if ( size > noSamples )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetCalcRoughness: road too short for a spectral analysis.\n" );
+        return 0;
+    }
+
+    if ( !roughBufferAlloc( &buf, size, du ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgDataSetCalcRoughness: could not allocate memory for %lu samples.\n", ( unsigned long ) size );
+        return 0;
+    }
+
+    /* --- Welch's method: windows overlapping by one half; only the new half of each window is evaluated --- */
+    step = size / 2;
+    next = 0;
+
+    for ( i = 0; i < noSamples; i++ )
+    {
+        u = crgData->channelU.info.first + i * du;
+
+        if ( u > crgData->channelU.info.last )
+            u = crgData->channelU.info.last;
+
+        if ( !crgDataEvaluv2z( crgData, NULL, u, v, &z ) || z != z )
+        {
+            /* --- windows containing NaNs are skipped --- */
+            next = 0;
+            continue;
+        }
+
+        buf.z[next++] = z;
+
+        if ( next < size )
+            continue;
+
+        roughAddWindow( &buf );
+        noWindows++;
+
+        memmove( buf.z, buf.z + step, step * sizeof( double ) );
+        next = step;
+    }
+
+    if ( !noWindows )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetCalcRoughness: no valid window at v = %.3f.\n", v );
+        roughBufferFree( &buf );
+        return 0;
+    }
+
+    /* --- fit the level in octave bands; the band power is robust against spectra made up of single lines --- */
+    dn    = 1.0 / ( size * du );
+    nLow  = ( 4.0 * dn > dCrgRoughSpatFreqMin ) ? 4.0 * dn : dCrgRoughSpatFreqMin;
+    nHigh = ( 0.25 / du < dCrgRoughSpatFreqMax ) ? 0.25 / du : dCrgRoughSpatFreqMax;
+
+    for ( ; nLow < nHigh; nLow *= 2.0 )
+    {
+        bandEnd   = ( 2.0 * nLow < nHigh ) ? 2.0 * nLow : nHigh;
+        bandPower = 0.0;
+        bandShape = 0.0;
+        bandBins  = 0;
+
+        for ( k = ( size_t ) ceil( nLow / dn ); k < size / 2 && k * dn < bandEnd; k++ )
+        {
+            n          = k * dn;
+            bandPower += buf.psd[k] / noWindows;
+            bandShape += dCrgRoughSpatFreqRef * dCrgRoughSpatFreqRef / ( n * n );
+            bandBins++;
+        }
+
+        if ( !bandBins || bandPower <= 0.0 )
+            continue;
+
+        /* --- Gd(n0) for waviness 2, and the mean level of the band at its geometric center --- */
+        sumLogGd += log( bandPower / bandShape );
+
+        x = log( sqrt( nLow * bandEnd ) / dCrgRoughSpatFreqRef );
+        y = log( bandPower / bandBins );
+
+        sumX  += x;
+        sumY  += y;
+        sumXX += x * x;
+        sumXY += x * y;
+        noBands++;
+
+        if ( roughness->nMin == 0.0 )
+            roughness->nMin = nLow;
+
+        roughness->nMax = bandEnd;
+    }
+
+    roughBufferFree( &buf );
+
+    if ( !noBands )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgDataSetCalcRoughness: no spatial frequencies in the range of ISO 8608.\n" );
+        return 0;
+    }
+
+    roughness->gdN0      = exp( sumLogGd / noBands );
+    roughness->noWindows = noWindows;
+
+    if ( noBands > 1 && noBands * sumXX - sumX * sumX > 0.0 )
+        roughness->waviness = -( noBands * sumXY - sumX * sumY ) / ( noBands * sumXX - sumX * sumX );
+
+    /* --- class limits are 32e-6 m^3 for A, times 4 for each further class --- */
+    for ( roughness->isoClass = 0, z = dCrgRoughGdLimitA;
+          roughness->isoClass < dCrgRoughNoClasses - 1 && roughness->gdN0 >= z;
+          roughness->isoClass++, z *= 4.0 )
+        ;
+
+    dCrgMsgInfo( ( dCrgMsgLevelInfo, "crgDataSetCalcRoughness: v = %.3f: Gd(n0) = %.3e m^3, w = %.2f, class %c (%d windows of %lu samples)\n",
+                   v, roughness->gdN0, roughness->waviness, 'A' + roughness->isoClass, noWindows, ( unsigned long ) size ) );
+
+    return 1;
+}
+
+static int
+roughBufferAlloc( CrgRoughBufferStruct* buf, size_t size, double du )
+{
+    size_t i;
+
+    memset( buf, 0, sizeof( CrgRoughBufferStruct ) );
+
+    buf->size   = size;
+    buf->du     = du;
+    buf->z      = ( double* ) crgCalloc( size, sizeof( double ) );
+    buf->re     = ( double* ) crgCalloc( size, sizeof( double ) );
+    buf->im     = ( double* ) crgCalloc( size, sizeof( double ) );
+    buf->cosTab = ( double* ) crgCalloc( size / 2, sizeof( double ) );
+    buf->sinTab = ( double* ) crgCalloc( size / 2, sizeof( double ) );
+    buf->hann   = ( double* ) crgCalloc( size, sizeof( double ) );
+    buf->psd    = ( double* ) crgCalloc( size / 2 + 1, sizeof( double ) );
+
+    if ( !buf->z || !buf->re || !buf->im || !buf->cosTab || !buf->sinTab || !buf->hann || !buf->psd )
+    {
+        roughBufferFree( buf );
+        return 0;
+    }
+
+    for ( i = 0; i < size / 2; i++ )
+    {
+        buf->cosTab[i] = cos( 2.0 * dCrgRoughPi * i / size );
+        buf->sinTab[i] = -sin( 2.0 * dCrgRoughPi * i / size );
+    }
+
+    for ( i = 0; i < size; i++ )
+        buf->hann[i] = 0.5 - 0.5 * cos( 2.0 * dCrgRoughPi * i / size );
+
+    return 1;
+}
+
+static void
+roughBufferFree( CrgRoughBufferStruct* buf )
+{
+    crgFree( buf->z );
+    crgFree( buf->re );
+    crgFree( buf->im );
+    crgFree( buf->cosTab );
+    crgFree( buf->sinTab );
+    crgFree( buf->hann );
+    crgFree( buf->psd );
+
+    memset( buf, 0, sizeof( CrgRoughBufferStruct ) );
+}
+
+static void
+roughFft( CrgRoughBufferStruct* buf )
+{
+    size_t size = buf->size;
+    size_t half;
+    size_t stride;
+    size_t i;
+    size_t j;
+    size_t k;
+    double tRe;
+    double tIm;
+
+    /* --- bit reversal permutation --- */
+    for ( i = 1, j = 0; i < size; i++ )
+    {
+        for ( k = size >> 1; j & k; k >>= 1 )
+            j ^= k;
+
+        j |= k;
+
+        if ( i < j )
+        {
+            tRe = buf->re[i]; buf->re[i] = buf->re[j]; buf->re[j] = tRe;
+            tIm = buf->im[i]; buf->im[i] = buf->im[j]; buf->im[j] = tIm;
+        }
+    }
+
+    /* --- butterflies --- */
+    for ( half = 1, stride = size / 2; half < size; half *= 2, stride /= 2 )
+    {
+        for ( i = 0; i < size; i += 2 * half )
+        {
+            for ( k = 0; k < half; k++ )
+            {
+                double wRe = buf->cosTab[k * stride];
+                double wIm = buf->sinTab[k * stride];
+                size_t a   = i + k;
+                size_t b   = a + half;
+
+                tRe = buf->re[b] * wRe - buf->im[b] * wIm;
+                tIm = buf->re[b] * wIm + buf->im[b] * wRe;
+
+                buf->re[b] = buf->re[a] - tRe;
+                buf->im[b] = buf->im[a] - tIm;
+                buf->re[a] += tRe;
+                buf->im[a] += tIm;
+            }
+        }
+    }
+}
+
+static void
+roughAddWindow( CrgRoughBufferStruct* buf )
+{
+    size_t size  = buf->size;
+    double sumZ  = 0.0;
+    double sumIZ = 0.0;
+    double sumW2 = 0.0;
+    double mean;
+    double slope;
+    double center = 0.5 * ( size - 1 );
+    double scale;
+    size_t i;
+
+    /* --- least squares line through the window; grades and long waves are not part of the roughness --- */
+    for ( i = 0; i < size; i++ )
+    {
+        sumZ  += buf->z[i];
+        sumIZ += ( i - center ) * buf->z[i];
+    }
+
+    mean  = sumZ / size;
+    slope = sumIZ / ( size * ( ( double ) size * size - 1.0 ) / 12.0 );
+
+    for ( i = 0; i < size; i++ )
+    {
+        buf->re[i] = ( buf->z[i] - mean - slope * ( i - center ) ) * buf->hann[i];
+        buf->im[i] = 0.0;
+        sumW2     += buf->hann[i] * buf->hann[i];
+    }
+
+    roughFft( buf );
+
+    /* --- one-sided PSD per spatial frequency [m^3]; the power of the window function is compensated --- */
+    scale = 2.0 * buf->du / sumW2;
+
+    for ( i = 1; i < size / 2; i++ )
+        buf->psd[i] += scale * ( buf->re[i] * buf->re[i] + buf->im[i] * buf->im[i] );
+}
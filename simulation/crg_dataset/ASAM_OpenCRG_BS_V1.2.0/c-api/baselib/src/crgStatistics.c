@@ -38,10 +38,6 @@
 /* ====== IMPLEMENTATION ====== */
 void crgCalcStatistics( CrgDataStruct *crgData )
 {
-    double zMeanF = 0.0;
-    double zMeanL = 0.0;
-    double zMin   = 0.0;
-    double zMax   = 0.0;
     double dx0;
     double dy0;
     double dx1;
@@ -51,10 +47,7 @@ void crgCalcStatistics( CrgDataStruct *crgData )
     double val;
     double curv = 0.0;
     size_t i;
-    size_t j;
     size_t maxIndex;
-    size_t nPtsF = 0;
-    size_t nPtsL = 0;
     
     if ( !crgData )
         return;
@@ -63,79 +56,11 @@ void crgCalcStatistics( CrgDataStruct *crgData )
     crgMsgPrint( dCrgMsgLevelNotice, "crgCalcStatistics: statistical information about data set:\n" );
     crgMsgPrint( dCrgMsgLevelNotice, "    road elevation:\n" );
     
-    /* --- mean elevation at start and end of road --- */
-    for ( i = 0; i < crgData->channelV.info.size; i++ )
-    {
-        if ( crgData->channelZ[i].data )
-        {
-            if ( !crgIsNanf( &( crgData->channelZ[i].data[0] ) ) )
-            {
-                zMeanF += crgData->channelZ[i].data[0];
-                nPtsF++;
-                
-                if ( crgData->channelZ[i].info.size == 0 )
-                {
-                    zMeanL = zMeanF;
-                    nPtsL++;
-                }
-            }
-            
-            if ( crgData->channelZ[i].info.size > 0 )
-            {
-                if ( !crgIsNanf( &( crgData->channelZ[i].data[crgData->channelZ[i].info.size-1] ) ) )
-                {
-                    zMeanL += crgData->channelZ[i].data[crgData->channelZ[i].info.size-1];
-                    nPtsL++;
-                }
-            }
-        }
-        else
-            crgMsgPrint( dCrgMsgLevelWarn, "        v-channel with index %ld has no data!\n", i );
-    }
-    
-    if ( nPtsF )
-        zMeanF /= 1.0 * nPtsF;
-    
-    if ( nPtsL )
-        zMeanL /= 1.0 * nPtsL;
-    
-    /* --- add the mean value which was used for normalizing the data --- */
-    zMeanF += crgData->channelZ[0].info.mean;
-    zMeanL += crgData->channelZ[0].info.mean;
-    
-    crgData->util.zMeanBeg = zMeanF;
-    crgData->util.zMeanEnd = zMeanL;
-
-    crgMsgPrint( dCrgMsgLevelNotice, "        mean elevation at start [m]: %10.4f\n", zMeanF );
-    crgMsgPrint( dCrgMsgLevelNotice, "        mean elevation at end   [m]: %10.4f\n", zMeanL );
-    
-    /* --- minimum and maximum elevation --- */
-    zMin = zMeanF;
-    zMax = zMin;
-    
-    for ( i = 0; i < crgData->channelV.info.size; i++ )
-    {
-        for ( j = 0; j < crgData->channelZ[i].info.size; j++ )
-        {
-            if ( !crgIsNanf( &( crgData->channelZ[i].data[j] ) ) )
-            {
-                if ( crgData->channelZ[i].data[j] < zMin )
-                    zMin = crgData->channelZ[i].data[j];
-                if ( crgData->channelZ[i].data[j] > zMax )
-                    zMax = crgData->channelZ[i].data[j];
-            }
-        }
-    }
-    
-    /* --- add the mean value which was used for normalizing the data --- */
-    zMin += crgData->channelZ[0].info.mean;
-    zMax += crgData->channelZ[0].info.mean;
-    
-    crgMsgPrint( dCrgMsgLevelNotice, "        min. road elevation     [m]: %10.4f\n", zMin );
-    crgMsgPrint( dCrgMsgLevelNotice, "        max. road elevation     [m]: %10.4f\n", zMax );
-    
-    crgData->util.zMin = zMin;
-    crgData->util.zMax = zMax;
+    /* --- elevation statistics have been collected while normalizing the z data --- */
+    crgMsgPrint( dCrgMsgLevelNotice, "        mean elevation at start [m]: %10.4f\n", crgData->util.zMeanBeg );
+    crgMsgPrint( dCrgMsgLevelNotice, "        mean elevation at end   [m]: %10.4f\n", crgData->util.zMeanEnd );
+    crgMsgPrint( dCrgMsgLevelNotice, "        min. road elevation     [m]: %10.4f\n", crgData->util.zMin );
+    crgMsgPrint( dCrgMsgLevelNotice, "        max. road elevation     [m]: %10.4f\n", crgData->util.zMax );
     
     /* --- reference line information --- */
     crgMsgPrint( dCrgMsgLevelNotice, "    reference line information:\n" );
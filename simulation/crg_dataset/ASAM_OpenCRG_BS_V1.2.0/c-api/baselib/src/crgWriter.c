@@ -0,0 +1,595 @@
+/* ===================================================
+ *  streaming writer for binary CRG files, e.g. for
+ *  road profiles generated record by record
+ * ---------------------------------------------------
+ *
+ * ASAM OpenCRG C API
+ *
+ * OpenCRG version:           1.2.0
+ *
+ * package:               baselib
+ * file name:             crgWriter.c
+ * author:                ASAM e.V.
+ *
+ *
+ * C by ASAM e.V., 2020
+ * Any use is limited to the scope described in the license terms.
+ * The license terms can be viewed at www.asam.net/license
+ *
+ * More Information on ASAM OpenCRG can be found here:
+ * https://www.asam.net/standards/detail/opencrg/
+ *
+ */
+/* ====== INCLUSIONS ====== */
+#include "crgBaseLibPrivate.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* ====== DEFINITIONS ====== */
+#define dCrgWriterBufferSize   65536    /* size of the output buffer of a writer        [byte] */
+#define dCrgWriterMaxLineLen      72    /* max. length of a line in the header of a file [-]   */
+#define dCrgWriterPadBytes        80    /* data section is padded to a multiple of this [byte] */
+
+/* ====== TYPE DEFINITIONS ====== */
+/**
+* a CRG file which is being written
+*/
+typedef struct
+{
+    int            id;               /* identifier of the writer                          [-] */
+    FILE*          fPtr;             /* the file which is being written                   [-] */
+    char*          filename;         /* name of the file                                  [-] */
+    char*          fileBuffer;       /* output buffer of the file                         [-] */
+    unsigned char* recordBuffer;     /* encoded record                                    [-] */
+    char*          comments;         /* comment lines of the $CT block                    [-] */
+    size_t         commentSize;      /* length of the comment lines                       [-] */
+    int            format;           /* data format [dCrgWriterFormatKRBI, ...KRBZ]       [-] */
+    size_t         valueSize;        /* size of an encoded value                       [byte] */
+    size_t         noSections;       /* number of long sections per record                [-] */
+    size_t         noRecords;        /* number of records written so far                  [-] */
+    double         uInc;             /* increment of the reference line                   [m] */
+    double         vRight;           /* v position of the rightmost long section          [m] */
+    double         vInc;             /* increment between the long sections               [m] */
+    long           uEndPos;          /* file position of the value of reference_line_end_u [-] */
+    unsigned char* blockBuffer;      /* compressed format: records of the current block   [-] */
+    unsigned char* encBuffer;        /* compressed format: encoded block                  [-] */
+    size_t         blockRecords;     /* compressed format: number of records per block    [-] */
+    size_t*        blockEnd;         /* compressed format: end of each block written      [-] */
+    size_t         noBlocks;         /* compressed format: number of blocks written       [-] */
+    size_t         dataSize;         /* compressed format: size of the blocks written  [byte] */
+    int            headerDone;       /* header has been written                           [-] */
+    int            failed;           /* a write operation failed                          [-] */
+} CrgWriterStruct;
+
+/* ====== LOCAL METHODS ====== */
+/**
+* get a writer by its identifier
+* @param writerId   identifier of the writer
+* @return pointer to the writer or NULL if it doesn't exist
+*/
+static CrgWriterStruct* writerAccess( int writerId );
+
+/**
+* release a writer and its entry in the list of writers; the file is
+* closed but not completed
+* @param writer     pointer to the writer
+*/
+static void writerRelease( CrgWriterStruct* writer );
+
+/**
+* write the header of the file, the end of the reference line is written
+* as placeholder which is replaced when the file is closed
+* @param writer     pointer to the writer
+* @return 1 if successful, otherwise 0
+*/
+static int writeHeader( CrgWriterStruct* writer );
+
+/**
+* compress the records of the current block and write them
+* @param writer     pointer to the writer
+* @return 1 if successful, otherwise 0
+*/
+static int writeBlock( CrgWriterStruct* writer );
+
+/**
+* encode a value in big endian byte order as required by the binary formats;
+* NaNs are encoded as quiet NaNs which are identified by the loader
+* @param writer     pointer to the writer
+* @param value      the value to be encoded
+* @param tgt        target location of the encoded value
+*/
+static void encodeValue( CrgWriterStruct* writer, double value, unsigned char* tgt );
+
+/**
+* encode a quiet NaN in big endian byte order
+* @param writer     pointer to the writer
+* @param tgt        target location of the encoded value
+*/
+static void encodeNan( CrgWriterStruct* writer, unsigned char* tgt );
+
+/**
+* check whether machine is little endian
+* @return 1 if machine is little endian, otherwise 0
+*/
+static int isLittleEndian( void );
+
+/* ====== LOCAL VARIABLES ====== */
+static CrgWriterStruct** sWriterList = NULL;
+static int               sNoWriters  = 0;
+
+/* ====== IMPLEMENTATION ====== */
+int
+crgWriterOpen( const char* filename, int format, double uInc, double vRight, double vInc, int noSections )
+{
+    CrgWriterStruct* writer;
+    int              tgtId = -1;
+    int              i;
+
+    if ( !filename || ( format != dCrgWriterFormatKRBI && format != dCrgWriterFormatKDBI && format != dCrgWriterFormatKRBZ ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgWriterOpen: invalid file name or data format.\n" );
+        return 0;
+    }
+
+    if ( noSections < 2 || uInc < 1.0e-6 || vInc < 1.0e-6 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgWriterOpen: at least 2 long sections and increments of at least 1.e-6m are required.\n" );
+        return 0;
+    }
+
+    /* --- any unused slot available or do we need to extend the list of writers? --- */
+    for ( i = 0; i < sNoWriters && tgtId < 0; i++ )
+    {
+        if ( !sWriterList[i] )
+            tgtId = i;
+    }
+
+    if ( tgtId < 0 )
+    {
+        CrgWriterStruct** newList = ( CrgWriterStruct** ) crgRealloc( sWriterList, ( sNoWriters + 1 ) * sizeof( CrgWriterStruct* ) );
+
+        if ( !newList )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal, "crgWriterOpen: could not allocate writer.\n" );
+            return 0;
+        }
+
+        sWriterList = newList;
+        sWriterList[sNoWriters] = NULL;
+        tgtId = sNoWriters++;
+    }
+
+    if ( !( writer = ( CrgWriterStruct* ) crgCalloc( 1, sizeof( CrgWriterStruct ) ) ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgWriterOpen: could not allocate writer.\n" );
+        return 0;
+    }
+
+    sWriterList[tgtId] = writer;
+
+    writer->id         = tgtId + 1;
+    writer->format     = format;
+    writer->valueSize  = ( format == dCrgWriterFormatKDBI ) ? 8 : 4;
+    writer->noSections = ( size_t ) noSections;
+    writer->uInc       = uInc;
+    writer->vRight     = vRight;
+    writer->vInc       = vInc;
+
+    writer->filename     = ( char* ) crgCalloc( strlen( filename ) + 1, sizeof( char ) );
+    writer->fileBuffer   = ( char* ) crgCalloc( dCrgWriterBufferSize, sizeof( char ) );
+    writer->recordBuffer = ( unsigned char* ) crgCalloc( writer->noSections, writer->valueSize );
+
+    /* --- compressed records are collected block by block --- */
+    if ( format == dCrgWriterFormatKRBZ )
+    {
+        writer->blockRecords = dCrgCompressBlockSize / ( writer->noSections * writer->valueSize );
+        writer->blockRecords = ( writer->blockRecords < 16 ) ? 16 : writer->blockRecords;
+
+        writer->blockBuffer = ( unsigned char* ) crgCalloc( writer->blockRecords * writer->noSections, writer->valueSize );
+        writer->encBuffer   = ( unsigned char* ) crgCalloc( dCrgCompressBlockBound( writer->blockRecords, writer->noSections ), 1 );
+    }
+
+    if ( !writer->filename || !writer->fileBuffer || !writer->recordBuffer
+      || ( format == dCrgWriterFormatKRBZ && ( !writer->blockBuffer || !writer->encBuffer ) ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgWriterOpen: could not allocate writer.\n" );
+        writerRelease( writer );
+        return 0;
+    }
+
+    strcpy( writer->filename, filename );
+
+    if ( !( writer->fPtr = fopen( filename, "wb" ) ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgWriterOpen: could not open <%s> for writing.\n", filename );
+        writerRelease( writer );
+        return 0;
+    }
+
+    setvbuf( writer->fPtr, writer->fileBuffer, _IOFBF, dCrgWriterBufferSize );
+
+    crgMsgPrint( dCrgMsgLevelInfo, "crgWriterOpen: writing <%s> with %d long sections, id = %d\n", filename, noSections, writer->id );
+
+    return writer->id;
+}
+
+int
+crgWriterAddComment( int writerId, const char* text )
+{
+    CrgWriterStruct* writer = writerAccess( writerId );
+    const char*      linePtr;
+    const char*      endPtr;
+    char*            newComments;
+    size_t           lineLen;
+
+    if ( !writer || !text )
+        return 0;
+
+    if ( writer->headerDone )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgWriterAddComment: comments must be added before the first record.\n" );
+        return 0;
+    }
+
+    /* --- store the comment line by line; a leading '$' would start a new block --- */
+    for ( linePtr = text; *linePtr; linePtr = *endPtr ? endPtr + 1 : endPtr )
+    {
+        if ( !( endPtr = strchr( linePtr, '\n' ) ) )
+            endPtr = linePtr + strlen( linePtr );
+
+        lineLen = ( size_t ) ( endPtr - linePtr );
+
+        if ( lineLen && linePtr[lineLen-1] == '\r' )
+            lineLen--;
+
+        if ( *linePtr == '$' )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "crgWriterAddComment: comment lines must not start with '$'.\n" );
+            return 0;
+        }
+
+        if ( lineLen > dCrgWriterMaxLineLen )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "crgWriterAddComment: comment line truncated to %d characters.\n", dCrgWriterMaxLineLen );
+            lineLen = dCrgWriterMaxLineLen;
+        }
+
+        if ( !( newComments = ( char* ) crgRealloc( writer->comments, writer->commentSize + lineLen + 2 ) ) )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal, "crgWriterAddComment: could not allocate comment.\n" );
+            return 0;
+        }
+
+        writer->comments = newComments;
+
+        memcpy( writer->comments + writer->commentSize, linePtr, lineLen );
+        writer->commentSize += lineLen;
+        writer->comments[writer->commentSize++] = '\n';
+        writer->comments[writer->commentSize]   = '\0';
+    }
+
+    return 1;
+}
+
+int
+crgWriterAppendRecord( int writerId, const double* z )
+{
+    CrgWriterStruct* writer = writerAccess( writerId );
+    unsigned char*   tgtPtr;
+    size_t           i;
+
+    if ( !writer || !z || writer->failed )
+        return 0;
+
+    if ( !writer->headerDone && !writeHeader( writer ) )
+        return 0;
+
+    /* --- compressed records are written once a block is complete --- */
+    if ( writer->format == dCrgWriterFormatKRBZ )
+    {
+        tgtPtr = writer->blockBuffer + ( writer->noRecords % writer->blockRecords ) * writer->noSections * writer->valueSize;
+
+        for ( i = 0; i < writer->noSections; i++, tgtPtr += writer->valueSize )
+            encodeValue( writer, z[i], tgtPtr );
+
+        writer->noRecords++;
+
+        return ( writer->noRecords % writer->blockRecords ) ? 1 : writeBlock( writer );
+    }
+
+    for ( i = 0, tgtPtr = writer->recordBuffer; i < writer->noSections; i++, tgtPtr += writer->valueSize )
+        encodeValue( writer, z[i], tgtPtr );
+
+    if ( fwrite( writer->recordBuffer, writer->valueSize, writer->noSections, writer->fPtr ) != writer->noSections )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgWriterAppendRecord: write error in <%s>.\n", writer->filename );
+        writer->failed = 1;
+        return 0;
+    }
+
+    writer->noRecords++;
+
+    return 1;
+}
+
+int
+crgWriterClose( int writerId )
+{
+    CrgWriterStruct* writer = writerAccess( writerId );
+    unsigned char    padValue[8];
+    size_t           noPadValues;
+    unsigned char*   index;
+    size_t           size;
+    int              result;
+
+    if ( !writer )
+        return 0;
+
+    if ( writer->noRecords < 2 && !writer->failed )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgWriterClose: <%s> needs at least 2 records.\n", writer->filename );
+        writer->failed = 1;
+    }
+
+    /* --- the compressed data section ends with the last block, the index and the trailer --- */
+    if ( !writer->failed && writer->format == dCrgWriterFormatKRBZ )
+    {
+        if ( writer->noRecords % writer->blockRecords )
+            writeBlock( writer );
+
+        if ( !writer->failed && !( index = ( unsigned char* ) crgCalloc( 4 * writer->noBlocks + dCrgCompressTrailerSize, 1 ) ) )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal, "crgWriterClose: could not allocate block index.\n" );
+            writer->failed = 1;
+        }
+
+        if ( !writer->failed )
+        {
+            size = crgCompressEncodeIndex( writer->blockEnd, writer->noBlocks, writer->noRecords, writer->blockRecords, index );
+
+            writer->failed = fwrite( index, 1, size, writer->fPtr ) != size;
+
+            crgFree( index );
+        }
+    }
+    else if ( !writer->failed )
+    {
+        /* --- pad the data with NaNs to a multiple of 80 bytes --- */
+        encodeNan( writer, padValue );
+
+        noPadValues = ( dCrgWriterPadBytes / writer->valueSize
+                      - ( writer->noRecords * writer->noSections ) % ( dCrgWriterPadBytes / writer->valueSize ) )
+                      % ( dCrgWriterPadBytes / writer->valueSize );
+
+        for ( ; noPadValues && !writer->failed; noPadValues-- )
+            writer->failed = fwrite( padValue, writer->valueSize, 1, writer->fPtr ) != 1;
+    }
+
+    /* --- the end of the reference line is known now --- */
+    if ( !writer->failed )
+        writer->failed = fseek( writer->fPtr, writer->uEndPos, SEEK_SET ) != 0
+                      || fprintf( writer->fPtr, "%24.16e", ( writer->noRecords - 1 ) * writer->uInc ) != 24;
+
+    if ( fclose( writer->fPtr ) != 0 )
+        writer->failed = 1;
+
+    writer->fPtr = NULL;
+    result       = !writer->failed;
+
+    /* --- an incomplete file must not be taken for a valid one --- */
+    if ( result )
+        crgMsgPrint( dCrgMsgLevelNotice, "crgWriterClose: wrote %lu records to <%s>\n", ( unsigned long ) writer->noRecords, writer->filename );
+    else
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "crgWriterClose: could not complete <%s>, removing it.\n", writer->filename );
+        remove( writer->filename );
+    }
+
+    writerRelease( writer );
+
+    return result;
+}
+
+void
+crgWriterCloseAll( void )
+{
+    int i;
+
+    for ( i = 0; i < sNoWriters; i++ )
+    {
+        if ( sWriterList[i] )
+            crgWriterClose( sWriterList[i]->id );
+    }
+
+    crgFree( sWriterList );
+
+    sWriterList = NULL;
+    sNoWriters  = 0;
+}
+
+static CrgWriterStruct*
+writerAccess( int writerId )
+{
+    if ( writerId < 1 || writerId > sNoWriters || !sWriterList[writerId-1] )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "writerAccess: invalid writer id %d.\n", writerId );
+        return NULL;
+    }
+
+    return sWriterList[writerId-1];
+}
+
+static void
+writerRelease( CrgWriterStruct* writer )
+{
+    if ( writer->fPtr )
+        fclose( writer->fPtr );
+
+    if ( writer->filename )
+        crgFree( writer->filename );
+
+    if ( writer->fileBuffer )
+        crgFree( writer->fileBuffer );
+
+    if ( writer->recordBuffer )
+        crgFree( writer->recordBuffer );
+
+    if ( writer->comments )
+        crgFree( writer->comments );
+
+    if ( writer->blockBuffer )
+        crgFree( writer->blockBuffer );
+
+    if ( writer->encBuffer )
+        crgFree( writer->encBuffer );
+
+    if ( writer->blockEnd )
+        crgFree( writer->blockEnd );
+
+    sWriterList[writer->id-1] = NULL;
+
+    crgFree( writer );
+}
+
+static int
+writeHeader( CrgWriterStruct* writer )
+{
+    FILE*   fPtr = writer->fPtr;
+    char    timeStr[32];
+    time_t  now  = time( NULL );
+    size_t  i;
+    int     ok;
+
+    writer->headerDone = 1;
+
+    if ( !strftime( timeStr, sizeof( timeStr ), "%Y-%m-%d %H:%M:%S", localtime( &now ) ) )
+        strcpy( timeStr, "unknown time" );
+
+    /* --- comment text --- */
+    ok = fprintf( fPtr, "$CT\n%s$\n", writer->comments ? writer->comments : "CRG generated by crgWriter\n" ) > 0;
+
+    /* --- road data; the end of the reference line is a placeholder of the same width --- */
+    ok = ok && fprintf( fPtr, "$ROAD_CRG\n" ) > 0;
+    ok = ok && fprintf( fPtr, "reference_line_start_u    = %24.16e\n", 0.0 ) > 0;
+    ok = ok && fprintf( fPtr, "reference_line_end_u      = " ) > 0;
+
+    writer->uEndPos = ftell( fPtr );
+
+    ok = ok && fprintf( fPtr, "%24.16e\n", 0.0 ) > 0;
+    ok = ok && fprintf( fPtr, "reference_line_increment  = %24.16e\n", writer->uInc ) > 0;
+    ok = ok && fprintf( fPtr, "long_section_v_right      = %24.16e\n", writer->vRight ) > 0;
+    ok = ok && fprintf( fPtr, "long_section_v_left       = %24.16e\n", writer->vRight + ( writer->noSections - 1 ) * writer->vInc ) > 0;
+    ok = ok && fprintf( fPtr, "long_section_v_increment  = %24.16e\n", writer->vInc ) > 0;
+    ok = ok && fprintf( fPtr, "$\n" ) > 0;
+
+    /* --- channel definitions --- */
+    ok = ok && fprintf( fPtr, "* written by crgWriter at %s\n", timeStr ) > 0;
+    ok = ok && fprintf( fPtr, "$KD_DEFINITION\n#:%s\n", ( writer->format == dCrgWriterFormatKDBI ) ? "KDBI" 
+                                                      : ( writer->format == dCrgWriterFormatKRBZ ) ? "KRBZ" : "KRBI" ) > 0;
+    ok = ok && fprintf( fPtr, "U:reference line u,m,%.3f,%.9g\n", 0.0, writer->uInc ) > 0;
+
+    for ( i = 0; ok && i < writer->noSections; i++ )
+        ok = fprintf( fPtr, "D:long section %lu,m\n", ( unsigned long ) ( i + 1 ) ) > 0;
+
+    ok = ok && fprintf( fPtr, "$\n" ) > 0;
+
+    /* --- separator, followed by the data --- */
+    for ( i = 0; ok && i < dCrgWriterMaxLineLen; i++ )
+        ok = fputc( '$', fPtr ) != EOF;
+
+    ok = ok && fputc( '\n', fPtr ) != EOF;
+
+    if ( !ok || writer->uEndPos < 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "writeHeader: write error in <%s>.\n", writer->filename );
+        writer->failed = 1;
+        return 0;
+    }
+
+    return 1;
+}
+
+static int
+writeBlock( CrgWriterStruct* writer )
+{
+    size_t  noRecords = writer->noRecords - writer->noBlocks * writer->blockRecords;
+    size_t* blockEnd;
+    size_t  size;
+
+    if ( !( blockEnd = ( size_t* ) crgRealloc( writer->blockEnd, ( writer->noBlocks + 1 ) * sizeof( size_t ) ) ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "writeBlock: could not allocate block index.\n" );
+        writer->failed = 1;
+        return 0;
+    }
+
+    writer->blockEnd = blockEnd;
+
+    size = crgCompressEncodeBlock( writer->blockBuffer, noRecords, writer->noSections, writer->encBuffer );
+
+    /* --- the index holds 32 bit offsets --- */
+    if ( !size || writer->dataSize + size > 0xffffffffUL || fwrite( writer->encBuffer, 1, size, writer->fPtr ) != size )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "writeBlock: write error in <%s>.\n", writer->filename );
+        writer->failed = 1;
+        return 0;
+    }
+
+    writer->dataSize += size;
+    writer->blockEnd[writer->noBlocks++] = writer->dataSize;
+
+    return 1;
+}
+
+static void
+encodeValue( CrgWriterStruct* writer, double value, unsigned char* tgt )
+{
+    static int littleEndian = -1;
+    unsigned char src[8];
+    float         fValue;
+    size_t        j;
+
+    if ( littleEndian < 0 )
+        littleEndian = isLittleEndian();
+
+    /* --- quiet NaN, independent of the bit pattern of the given NaN --- */
+    if ( value != value )
+    {
+        encodeNan( writer, tgt );
+        return;
+    }
+
+    if ( writer->valueSize == 8 )
+        memcpy( src, &value, 8 );
+    else
+    {
+        fValue = ( float ) value;
+        memcpy( src, &fValue, 4 );
+    }
+
+    if ( littleEndian )
+        for ( j = 0; j < writer->valueSize; j++ )
+            tgt[j] = src[writer->valueSize-1-j];
+    else
+        memcpy( tgt, src, writer->valueSize );
+}
+
+static void
+encodeNan( CrgWriterStruct* writer, unsigned char* tgt )
+{
+    memset( tgt, 0, writer->valueSize );
+
+    tgt[0] = 0x7f;
+    tgt[1] = ( writer->valueSize == 8 ) ? 0xf8 : 0xc0;
+}
+
+static int
+isLittleEndian( void )
+{
+    int i = 0;
+
+    (( char* )( &i))[0] = 1;
+
+    return ( i == 1 );
+}
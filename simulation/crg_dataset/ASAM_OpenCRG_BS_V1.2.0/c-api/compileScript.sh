@@ -53,6 +53,34 @@ $COMP  -o test/bin/crgPerfTest -I baselib/inc test/PerfTest/src/main.c baselib/s
 #$COMP -m32 -O2 -Wall -fomit-frame-pointer -fno-strict-aliasing -fPIC -o test/bin/crgPerfTest -I baselib/inc test/PerfTest/src/main.c baselib/src/*.c -lm 
 echo done
 
+echo -n compiling crgBench...
+$COMP -o test/bin/crgBench -I baselib/inc test/Bench/src/main.c baselib/src/*.c -lm 
+echo done
+
+echo -n compiling crgScaling...
+$COMP -o test/bin/crgScaling -I baselib/inc test/Scaling/src/main.c baselib/src/*.c -lm -lpthread 
+echo done
+
+echo -n compiling crgCppBench...
+gcc -O3 -c -I baselib/inc baselib/src/*.c && g++ -O3 -std=c++17 -o test/bin/crgCppBench -I baselib/inc test/CppWrap/src/main.cpp crg*.o -lm && rm -f crg*.o
+echo done
+
+echo -n compiling crgRtBench...
+$COMP -o test/bin/crgRtBench -I baselib/inc test/RealTime/src/main.c baselib/src/*.c -lm 
+echo done
+
+echo -n compiling crgReloadBench...
+$COMP -o test/bin/crgReloadBench -I baselib/inc test/Reload/src/main.c baselib/src/*.c -lm 
+echo done
+
+echo -n compiling crgWriterTest...
+$COMP -o test/bin/crgWriterTest -I baselib/inc test/Writer/src/main.c baselib/src/*.c -lm 
+echo done
+
+echo -n compiling crgPathTest...
+$COMP -o test/bin/crgPathTest -I baselib/inc test/Path/src/main.c baselib/src/*.c -lm 
+echo done
+
 echo -n compiling crgDump...
 $COMP -o test/bin/crgDump -I baselib/inc test/Dump/src/main.c baselib/src/*.c -lm 
 echo done
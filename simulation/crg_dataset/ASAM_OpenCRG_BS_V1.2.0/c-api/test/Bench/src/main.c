@@ -0,0 +1,646 @@
+/* ===================================================
+ *  main program for CRG benchmark suite measuring
+ *  load and evaluation times of a set of CRG files
+ * ---------------------------------------------------
+ *
+ * ASAM OpenCRG C API
+ *
+ * OpenCRG version:           1.2.0
+ *
+ * package:               test/Bench
+ * file name:             main.c
+ * author:                ASAM e.V.
+ *
+ *
+ * C by ASAM e.V., 2020
+ * Any use is limited to the scope described in the license terms.
+ * The license terms can be viewed at www.asam.net/license
+ *
+ * More Information on ASAM OpenCRG can be found here:
+ * https://www.asam.net/standards/detail/opencrg/
+ *
+ */
+
+/* ====== INCLUSIONS ====== */
+#ifdef __linux__
+#define _GNU_SOURCE     /* sched_setaffinity() */
+#include <sched.h>
+#endif
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "crgBaseLibPrivate.h"
+
+/* ====== DEFINITIONS ====== */
+#define dBenchLoad      0
+#define dBenchUv2z      1
+#define dBenchXy2z      2
+#define dBenchXy2uv     3
+#define dBenchUv2xy     4
+#define dBenchUv2pk     5
+#define dBenchPatch     6
+#define dBenchBatch     7
+#define dBenchGrid      8
+#define dBenchPath      9
+#define dBenchCpCreate 10
+#define dBenchCpLife   11
+#define dBenchNoTypes  12
+
+#define dFormatCSV      0
+#define dFormatJSON     1
+
+/* ====== TYPE DEFINITIONS ====== */
+typedef struct
+{
+    int     noPts;      /* number of trajectory points per pass   [-] */
+    double* u;          /* trajectory u co-ordinates              [m] */
+    double* v;          /* trajectory v co-ordinates              [m] */
+    double* x;          /* trajectory x co-ordinates              [m] */
+    double* y;          /* trajectory y co-ordinates              [m] */
+    double* phi;        /* trajectory heading                   [rad] */
+    int     noBatchU;   /* grid size of batch test in u direction [-] */
+    int     noBatchV;   /* grid size of batch test in v direction [-] */
+    float*  grid;       /* results of the grid test               [m] */
+    double  pathA[2];   /* u co-ordinates of the path test        [m] */
+    double  pathB[2];   /* v co-ordinates of the path test        [m] */
+    double  pathTime;   /* time of the speed schedule             [s] */
+    double  pathSpeed;  /* speed of the path test               [m/s] */
+    double  pathOffset[2]; /* lateral offsets of the wheel tracks [m] */
+    double* pathZ;      /* results of the path test               [m] */
+    int     pathCpId;   /* contact point of the right wheel track [-] */
+    double  uMin;
+    double  uMax;
+    double  vMin;
+    double  vMax;
+    int     dataSetId;  /* data set of the contact points         [-] */
+} TestPointsStruct;
+
+/* ====== LOCAL VARIABLES ====== */
+static const char* sBenchName[dBenchNoTypes] = { "load", "uv2z", "xy2z", "xy2uv", "uv2xy", "uv2pk", "patch", "batch", "grid", "path", "cpcreate", "cplife" };
+
+static int    sNoReps      = 20;      /* timed repetitions per benchmark                      */
+static int    sNoWarmUp    = 2;       /* untimed repetitions per benchmark                    */
+static int    sNoLoadReps  = 5;       /* timed repetitions of the load benchmark              */
+static int    sNoPts       = 10000;   /* trajectory points per repetition                     */
+static int    sPatchSize   = 10;      /* tesselation points per patch side                    */
+static double sPatchWidth  = 0.1;     /* [m] width and length of the patch under a wheel      */
+static double sWheelDist   = 1.45;    /* [m] distance from left to right wheel                */
+static int    sFormat      = dFormatCSV;
+static int    sFirstRecord = 1;
+static double sChecksum    = 0.0;     /* keeps results alive; printed at info level           */
+
+/* ====== LOCAL METHODS ====== */
+static void   usage( void );
+static int    pinToCpu( int cpu );
+static int    cmpDouble( const void* a, const void* b );
+static double percentile( double* sorted, int n, double p );
+static void   report( FILE* fPtr, const char* filename, int type, int noQueries, double* nsPerQuery, int noReps );
+static int    createTestPoints( int cpId, int dataSetId, TestPointsStruct* pts );
+static void   releaseTestPoints( TestPointsStruct* pts );
+static int    runPass( int type, int cpId, TestPointsStruct* pts );
+static int    checkGrid( int cpId, TestPointsStruct* pts );
+static int    benchFile( FILE* fPtr, const char* filename );
+
+static void
+usage( void )
+{
+    crgMsgPrint( dCrgMsgLevelNotice, "usage: crgBench [options] <filename> [<filename> ...]\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       options: -h         show this info\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -r <n>     number of timed repetitions (default: 20)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -w <n>     number of warm-up repetitions (default: 2)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -l <n>     number of timed file loads (default: 5)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -n <n>     number of trajectory points per repetition (default: 10000)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -c <cpu>   pin the benchmark to the given CPU (Linux only)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -f <fmt>   output format: csv (default) or json\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -o <file>  write results to file instead of stdout\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       <filename> CRG file(s) to be benchmarked\n" );
+    exit( -1 );
+}
+
+int main( int argc, char** argv )
+{
+    char*  outFile  = NULL;
+    FILE*  fPtr     = stdout;
+    int    cpu      = -1;
+    int    noFiles  = 0;
+    int    noFailed = 0;
+    int    i;
+
+    /* --- decode the command line --- */
+    if ( argc < 2 )
+        usage();
+
+    for ( i = 1; i < argc; i++ )
+    {
+        if ( !strcmp( argv[i], "-h" ) )
+            usage();
+
+        if ( argv[i][0] != '-' )
+            break;
+
+        if ( i + 1 >= argc )
+            usage();
+
+        if ( !strcmp( argv[i], "-r" ) )
+            sNoReps = atoi( argv[++i] );
+        else if ( !strcmp( argv[i], "-w" ) )
+            sNoWarmUp = atoi( argv[++i] );
+        else if ( !strcmp( argv[i], "-l" ) )
+            sNoLoadReps = atoi( argv[++i] );
+        else if ( !strcmp( argv[i], "-n" ) )
+            sNoPts = atoi( argv[++i] );
+        else if ( !strcmp( argv[i], "-c" ) )
+            cpu = atoi( argv[++i] );
+        else if ( !strcmp( argv[i], "-o" ) )
+            outFile = argv[++i];
+        else if ( !strcmp( argv[i], "-f" ) )
+        {
+            i++;
+
+            if ( !strcmp( argv[i], "json" ) )
+                sFormat = dFormatJSON;
+            else if ( !strcmp( argv[i], "csv" ) )
+                sFormat = dFormatCSV;
+            else
+                usage();
+        }
+        else
+            usage();
+    }
+
+    if ( i >= argc || sNoReps < 1 || sNoWarmUp < 0 || sNoLoadReps < 1 || sNoPts < 4 )
+        usage();
+
+    /* --- benchmarks shall not be disturbed by messages --- */
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+
+    if ( cpu >= 0 && !pinToCpu( cpu ) )
+        crgMsgPrint( dCrgMsgLevelWarn, "main: could not pin benchmark to CPU %d.\n", cpu );
+
+    if ( outFile && ( fPtr = fopen( outFile, "w" ) ) == NULL )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "main: could not open output file <%s>.\n", outFile );
+        return -1;
+    }
+
+    if ( sFormat == dFormatCSV )
+        fprintf( fPtr, "file,benchmark,queries,reps,min_ns,p50_ns,p90_ns,p99_ns,max_ns,mean_ns\n" );
+    else
+        fprintf( fPtr, "[\n" );
+
+    for ( ; i < argc; i++ )
+    {
+        noFiles++;
+
+        if ( !benchFile( fPtr, argv[i] ) )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "main: skipping file <%s>.\n", argv[i] );
+            noFailed++;
+        }
+    }
+
+    if ( sFormat == dFormatJSON )
+        fprintf( fPtr, "\n]\n" );
+
+    if ( outFile )
+        fclose( fPtr );
+
+    crgMsgPrint( dCrgMsgLevelInfo, "main: checksum = %.6f\n", sChecksum );
+    crgMsgPrint( dCrgMsgLevelNotice, "main: benchmarked %d of %d files\n", noFiles - noFailed, noFiles );
+
+    return noFailed ? -1 : 0;
+}
+
+static int
+pinToCpu( int cpu )
+{
+#ifdef __linux__
+    cpu_set_t cpuSet;
+
+    CPU_ZERO( &cpuSet );
+    CPU_SET( cpu, &cpuSet );
+
+    return !sched_setaffinity( 0, sizeof( cpuSet ), &cpuSet );
+#else
+    return 0;
+#endif
+}
+
+static int
+cmpDouble( const void* a, const void* b )
+{
+    double da = *( const double* ) a;
+    double db = *( const double* ) b;
+
+    return ( da > db ) - ( da < db );
+}
+
+static double
+percentile( double* sorted, int n, double p )
+{
+    /* --- nearest-rank method --- */
+    int rank = ( int ) ceil( 0.01 * p * n );
+
+    if ( rank < 1 )
+        rank = 1;
+
+    return sorted[rank - 1];
+}
+
+static void
+report( FILE* fPtr, const char* filename, int type, int noQueries, double* nsPerQuery, int noReps )
+{
+    double mean = 0.0;
+    int    i;
+
+    for ( i = 0; i < noReps; i++ )
+        mean += nsPerQuery[i];
+
+    mean /= noReps;
+
+    qsort( nsPerQuery, noReps, sizeof( double ), cmpDouble );
+
+    if ( sFormat == dFormatCSV )
+    {
+        fprintf( fPtr, "%s,%s,%d,%d,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n", filename, sBenchName[type], noQueries, noReps,
+                 nsPerQuery[0], percentile( nsPerQuery, noReps, 50.0 ), percentile( nsPerQuery, noReps, 90.0 ),
+                 percentile( nsPerQuery, noReps, 99.0 ), nsPerQuery[noReps - 1], mean );
+    }
+    else
+    {
+        fprintf( fPtr, "%s  {\"file\": \"%s\", \"benchmark\": \"%s\", \"queries\": %d, \"reps\": %d, "
+                 "\"min_ns\": %.1f, \"p50_ns\": %.1f, \"p90_ns\": %.1f, \"p99_ns\": %.1f, \"max_ns\": %.1f, \"mean_ns\": %.1f}",
+                 sFirstRecord ? "" : ",\n", filename, sBenchName[type], noQueries, noReps,
+                 nsPerQuery[0], percentile( nsPerQuery, noReps, 50.0 ), percentile( nsPerQuery, noReps, 90.0 ),
+                 percentile( nsPerQuery, noReps, 99.0 ), nsPerQuery[noReps - 1], mean );
+    }
+
+    sFirstRecord = 0;
+    fflush( fPtr );
+}
+
+static int
+createTestPoints( int cpId, int dataSetId, TestPointsStruct* pts )
+{
+    double uStep;
+    double v;
+    double curv;
+    int    i;
+
+    memset( pts, 0, sizeof( TestPointsStruct ) );
+
+    pts->dataSetId = dataSetId;
+
+    crgDataSetGetURange( dataSetId, &pts->uMin, &pts->uMax );
+    crgDataSetGetVRange( dataSetId, &pts->vMin, &pts->vMax );
+
+    pts->noPts    = sNoPts;
+    pts->u        = ( double* ) calloc( pts->noPts, sizeof( double ) );
+    pts->v        = ( double* ) calloc( pts->noPts, sizeof( double ) );
+    pts->x        = ( double* ) calloc( pts->noPts, sizeof( double ) );
+    pts->y        = ( double* ) calloc( pts->noPts, sizeof( double ) );
+    pts->phi      = ( double* ) calloc( pts->noPts, sizeof( double ) );
+    pts->noBatchV = ( int ) sqrt( ( double ) pts->noPts );
+    pts->noBatchU = pts->noPts / pts->noBatchV;
+    pts->grid     = ( float* ) calloc( pts->noBatchU * pts->noBatchV, sizeof( float ) );
+    pts->pathZ    = ( double* ) calloc( pts->noPts, sizeof( double ) );
+
+    if ( !pts->u || !pts->v || !pts->x || !pts->y || !pts->phi || !pts->grid || !pts->pathZ )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "createTestPoints: could not allocate memory.\n" );
+        releaseTestPoints( pts );
+        return 0;
+    }
+
+    /* --- trajectory of the four wheels of a car driving along the reference line --- */
+    uStep = 4.0 * ( pts->uMax - pts->uMin ) / pts->noPts;
+    v     = 0.5 * sWheelDist;
+
+    if ( v > 0.5 * ( pts->vMax - pts->vMin ) )
+        v = 0.25 * ( pts->vMax - pts->vMin );
+
+    for ( i = 0; i < pts->noPts; i++ )
+    {
+        pts->u[i] = pts->uMin + uStep * ( i / 4 );
+        pts->v[i] = 0.5 * ( pts->vMin + pts->vMax ) + ( ( i % 2 ) ? -v : v );
+
+        if ( !crgEvaluv2xy( cpId, pts->u[i], pts->v[i], &pts->x[i], &pts->y[i] ) )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal, "createTestPoints: could not convert u/v = %.3f / %.3f.\n", pts->u[i], pts->v[i] );
+            releaseTestPoints( pts );
+            return 0;
+        }
+
+        crgEvaluv2pk( cpId, pts->u[i], pts->v[i], &pts->phi[i], &curv );
+    }
+
+    /* --- left and right wheel driving along the reference line, noPts / 2 samples at 1 kHz --- */
+    pts->pathA[0]      = pts->uMin;
+    pts->pathA[1]      = pts->uMax;
+    pts->pathB[0]      = 0.5 * ( pts->vMin + pts->vMax );
+    pts->pathB[1]      = pts->pathB[0];
+    pts->pathSpeed     = 1000.0 * ( pts->uMax - pts->uMin ) / ( pts->noPts / 2 );
+    pts->pathOffset[0] = v;
+    pts->pathOffset[1] = -v;
+
+    return 1;
+}
+
+static void
+releaseTestPoints( TestPointsStruct* pts )
+{
+    free( pts->u );
+    free( pts->v );
+    free( pts->x );
+    free( pts->y );
+    free( pts->phi );
+    free( pts->grid );
+    free( pts->pathZ );
+    memset( pts, 0, sizeof( TestPointsStruct ) );
+}
+
+/**
+* run one pass of a benchmark over all test points
+* @return number of queries issued
+*/
+static int
+runPass( int type, int cpId, TestPointsStruct* pts )
+{
+    double a;
+    double b;
+    int    noQueries = 0;
+    int    i;
+    int    j;
+    int    k;
+
+    switch ( type )
+    {
+        case dBenchUv2z:
+            for ( i = 0; i < pts->noPts; i++ )
+            {
+                crgEvaluv2z( cpId, pts->u[i], pts->v[i], &a );
+                sChecksum += a;
+            }
+            noQueries = pts->noPts;
+            break;
+
+        case dBenchXy2z:
+            for ( i = 0; i < pts->noPts; i++ )
+            {
+                crgEvalxy2z( cpId, pts->x[i], pts->y[i], &a );
+                sChecksum += a;
+            }
+            noQueries = pts->noPts;
+            break;
+
+        case dBenchXy2uv:
+            for ( i = 0; i < pts->noPts; i++ )
+            {
+                crgEvalxy2uv( cpId, pts->x[i], pts->y[i], &a, &b );
+                sChecksum += a + b;
+            }
+            noQueries = pts->noPts;
+            break;
+
+        case dBenchUv2xy:
+            for ( i = 0; i < pts->noPts; i++ )
+            {
+                crgEvaluv2xy( cpId, pts->u[i], pts->v[i], &a, &b );
+                sChecksum += a + b;
+            }
+            noQueries = pts->noPts;
+            break;
+
+        case dBenchUv2pk:
+            for ( i = 0; i < pts->noPts; i++ )
+            {
+                crgEvaluv2pk( cpId, pts->u[i], pts->v[i], &a, &b );
+                sChecksum += a + b;
+            }
+            noQueries = pts->noPts;
+            break;
+
+        case dBenchPatch:
+            /* --- a patch of n by n points under each wheel, only every n-th trajectory point --- */
+            for ( i = 0; i < pts->noPts; i += sPatchSize )
+            {
+                double cosPhi = cos( pts->phi[i] );
+                double sinPhi = sin( pts->phi[i] );
+
+                for ( j = 0; j < sPatchSize; j++ )
+                {
+                    double wx = sPatchWidth * ( ( double ) j / ( sPatchSize - 1 ) - 0.5 );
+
+                    for ( k = 0; k < sPatchSize; k++ )
+                    {
+                        double wy = sPatchWidth * ( ( double ) k / ( sPatchSize - 1 ) - 0.5 );
+
+                        crgEvalxy2z( cpId, pts->x[i] + wx * cosPhi - wy * sinPhi, pts->y[i] + wy * cosPhi + wx * sinPhi, &a );
+                        sChecksum += a;
+                        noQueries++;
+                    }
+                }
+            }
+            break;
+
+        case dBenchBatch:
+            /* --- regular u/v grid covering the whole data set, evaluated point by point --- */
+            for ( i = 0; i < pts->noBatchU; i++ )
+            {
+                double u = pts->uMin + ( pts->uMax - pts->uMin ) * i / ( pts->noBatchU - 1 );
+
+                for ( j = 0; j < pts->noBatchV; j++ )
+                {
+                    crgEvaluv2z( cpId, u, pts->vMin + ( pts->vMax - pts->vMin ) * j / ( pts->noBatchV - 1 ), &a );
+                    sChecksum += a;
+                    noQueries++;
+                }
+            }
+            break;
+
+        case dBenchGrid:
+            /* --- the same grid as above, evaluated in one call --- */
+            crgEvalGridUV( pts->dataSetId, pts->uMin, ( pts->uMax - pts->uMin ) / ( pts->noBatchU - 1 ), pts->noBatchU,
+                           pts->vMin, ( pts->vMax - pts->vMin ) / ( pts->noBatchV - 1 ), pts->noBatchV, pts->grid );
+            sChecksum += pts->grid[0] + pts->grid[pts->noBatchU * pts->noBatchV - 1];
+            noQueries = pts->noBatchU * pts->noBatchV;
+            break;
+
+        case dBenchPath:
+            /* --- time domain excitation of two wheel tracks in one call --- */
+            {
+                CrgPathStruct path;
+                int           cpIds[2];
+
+                path.type       = dCrgPathTypeUV;
+                path.noPts      = 2;
+                path.a          = pts->pathA;
+                path.b          = pts->pathB;
+                path.noSpeeds   = 1;
+                path.speedTime  = &pts->pathTime;
+                path.speed      = &pts->pathSpeed;
+                path.sampleRate = 1000.0;
+                cpIds[0]        = cpId;
+                cpIds[1]        = pts->pathCpId;
+
+                crgEvalPathSample( &path, 2, cpIds, pts->pathOffset, pts->noPts / 2, pts->pathZ, &i );
+                sChecksum += pts->pathZ[0] + pts->pathZ[pts->noPts - 1];
+                noQueries = 2 * i;
+            }
+            break;
+
+        case dBenchCpCreate:
+            /* --- creation and deletion of a contact point --- */
+            for ( i = 0; i < pts->noPts; i++ )
+            {
+                j = crgContactPointCreate( pts->dataSetId );
+                crgContactPointDelete( j );
+                sChecksum += j;
+            }
+            noQueries = pts->noPts;
+            break;
+
+        case dBenchCpLife:
+            /* --- short-lived contact point as in Monte-Carlo runs: create, one x/y query, delete --- */
+            for ( i = 0; i < pts->noPts; i++ )
+            {
+                j = crgContactPointCreate( pts->dataSetId );
+                crgEvalxy2z( j, pts->x[i], pts->y[i], &a );
+                crgContactPointDelete( j );
+                sChecksum += a;
+            }
+            noQueries = pts->noPts;
+            break;
+    }
+
+    return noQueries;
+}
+
+/**
+* compare the results of the grid test with point by point evaluations
+* @return 1 if all values are identical, otherwise 0
+*/
+static int
+checkGrid( int cpId, TestPointsStruct* pts )
+{
+    double du = ( pts->uMax - pts->uMin ) / ( pts->noBatchU - 1 );
+    double dv = ( pts->vMax - pts->vMin ) / ( pts->noBatchV - 1 );
+    double z;
+    float  zRef;
+    float  zGrid;
+    int    noDiffs = 0;
+    int    i;
+    int    j;
+
+    if ( !crgEvalGridUV( pts->dataSetId, pts->uMin, du, pts->noBatchU, pts->vMin, dv, pts->noBatchV, pts->grid ) )
+        return 0;
+
+    for ( j = 0; j < pts->noBatchV; j++ )
+    {
+        for ( i = 0; i < pts->noBatchU; i++ )
+        {
+            zGrid = pts->grid[j * pts->noBatchU + i];
+
+            if ( crgEvaluv2z( cpId, pts->uMin + i * du, pts->vMin + j * dv, &z ) )
+                zRef = ( float ) z;
+            else
+                crgSetNanf( &zRef );
+
+            /* --- NaNs must match as well --- */
+            if ( ( zGrid != zGrid ) != ( zRef != zRef ) || ( zGrid == zGrid && zGrid != zRef ) )
+                noDiffs++;
+        }
+    }
+
+    if ( noDiffs )
+        crgMsgPrint( dCrgMsgLevelWarn, "checkGrid: %d of %d grid values differ from point by point evaluation.\n",
+                     noDiffs, pts->noBatchU * pts->noBatchV );
+
+    return !noDiffs;
+}
+
+static int
+benchFile( FILE* fPtr, const char* filename )
+{
+    TestPointsStruct pts;
+    double* nsPerQuery;
+    double  startTime;
+    int     dataSetId = 0;
+    int     cpId;
+    int     noQueries = 0;
+    int     type;
+    int     i;
+
+    nsPerQuery = ( double* ) calloc( ( sNoReps > sNoLoadReps ) ? sNoReps : sNoLoadReps, sizeof( double ) );
+
+    if ( !nsPerQuery )
+        return 0;
+
+    /* --- load benchmark; the last data set is kept for the evaluation benchmarks --- */
+    for ( i = 0; i < sNoLoadReps; i++ )
+    {
+        if ( dataSetId > 0 )
+            crgDataSetRelease( dataSetId );
+
+        startTime = crgPortGetTime();
+        dataSetId = crgLoaderReadFile( filename );
+        nsPerQuery[i] = crgPortGetTime() - startTime;
+
+        if ( dataSetId <= 0 )
+        {
+            free( nsPerQuery );
+            return 0;
+        }
+    }
+
+    report( fPtr, filename, dBenchLoad, 1, nsPerQuery, sNoLoadReps );
+
+    if ( !crgCheck( dataSetId ) )
+        crgMsgPrint( dCrgMsgLevelWarn, "benchFile: could not validate <%s>, results may be meaningless.\n", filename );
+
+    crgDataSetModifiersApply( dataSetId );
+
+    if ( ( cpId = crgContactPointCreate( dataSetId ) ) < 0 || !createTestPoints( cpId, dataSetId, &pts ) )
+    {
+        crgDataSetRelease( dataSetId );
+        free( nsPerQuery );
+        return 0;
+    }
+
+    /* --- the wheel tracks of the path test are evaluated by contact points of their own --- */
+    if ( ( pts.pathCpId = crgContactPointCreate( dataSetId ) ) < 0 )
+    {
+        releaseTestPoints( &pts );
+        crgDataSetRelease( dataSetId );
+        free( nsPerQuery );
+        return 0;
+    }
+
+    /* --- evaluation benchmarks --- */
+    for ( type = dBenchUv2z; type < dBenchNoTypes; type++ )
+    {
+        for ( i = 0; i < sNoWarmUp; i++ )
+            runPass( type, cpId, &pts );
+
+        for ( i = 0; i < sNoReps; i++ )
+        {
+            startTime     = crgPortGetTime();
+            noQueries     = runPass( type, cpId, &pts );
+            nsPerQuery[i] = ( crgPortGetTime() - startTime ) / noQueries;
+        }
+
+        report( fPtr, filename, type, noQueries, nsPerQuery, sNoReps );
+    }
+
+    if ( !checkGrid( cpId, &pts ) )
+        crgMsgPrint( dCrgMsgLevelWarn, "benchFile: grid evaluation of <%s> is inconsistent.\n", filename );
+
+    crgContactPointDelete( pts.pathCpId );
+    releaseTestPoints( &pts );
+    crgContactPointDelete( cpId );
+    crgDataSetRelease( dataSetId );
+    free( nsPerQuery );
+
+    return 1;
+}
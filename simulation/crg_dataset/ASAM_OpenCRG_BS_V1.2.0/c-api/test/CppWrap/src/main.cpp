@@ -0,0 +1,336 @@
+/* ===================================================
+ *  benchmark and check of the C++ interface: z
+ *  evaluation by the C API versus the compile-time
+ *  specialized evaluator of crgBaseLib.hpp
+ * ---------------------------------------------------
+ *
+ * ASAM OpenCRG C API
+ *
+ * OpenCRG version:           1.2.0
+ *
+ * package:               test/CppWrap
+ * file name:             main.cpp
+ * author:                ASAM e.V.
+ *
+ *
+ * C by ASAM e.V., 2020
+ * Any use is limited to the scope described in the license terms.
+ * The license terms can be viewed at www.asam.net/license
+ *
+ * More Information on ASAM OpenCRG can be found here:
+ * https://www.asam.net/standards/detail/opencrg/
+ *
+ */
+
+/* ====== INCLUSIONS ====== */
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "crgBaseLib.hpp"
+
+/* ====== DEFINITIONS ====== */
+#define dCheckNoPts       20000     /* positions per check of an evaluator                      */
+#define dCheckBorder        1.3     /* fraction of u/v range added at each side for the checks  */
+#define dCheckTolerance  1.0e-9     /* max. deviation from crgEvaluv2z()                    [m] */
+
+/* ====== LOCAL VARIABLES ====== */
+static int    sNoReps   = 20;       /* timed repetitions per method              */
+static int    sNoPts    = 100000;   /* evaluation points per repetition          */
+static double sBorder   = 0.1;      /* fraction of u/v range added at each side  */
+static double sChecksum = 0.0;      /* keeps results alive; printed at info level */
+static bool   sCheckOnly = false;   /* only check the evaluators, no timing      */
+
+/* ====== LOCAL METHODS ====== */
+static void usage()
+{
+    crgMsgPrint( dCrgMsgLevelNotice, "usage: crgCppBench [options] <filename> [<filename> ...]\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       options: -h         show this info\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -r <n>     number of timed repetitions (default: 20)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -n <n>     number of evaluation points per repetition (default: 100000)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -b <frac>  fraction of the u/v range outside the data at each side (default: 0.1)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -c         only check the evaluator against crgEvaluv2z(), no timing\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       <filename> CRG file(s) to be benchmarked\n" );
+    exit( -1 );
+}
+
+/**
+* generate reproducible random positions, partly outside the data
+* @param border     fraction of the u/v range added at each side
+*/
+static void randomPositions( const crg::Road& road, double border, std::vector< double >& u, std::vector< double >& v )
+{
+    std::pair< double, double > uRange = road.uRange();
+    std::pair< double, double > vRange = road.vRange();
+    double du = ( uRange.second - uRange.first ) * border;
+    double dv = ( vRange.second - vRange.first ) * border;
+
+    std::srand( 4711 );
+
+    for ( std::size_t j = 0; j < u.size(); j++ )
+    {
+        u[j] = uRange.first - du + ( uRange.second - uRange.first + 2.0 * du ) * std::rand() / RAND_MAX;
+        v[j] = vRange.first - dv + ( vRange.second - vRange.first + 2.0 * dv ) * std::rand() / RAND_MAX;
+    }
+}
+
+/**
+* compare an evaluator with crgEvaluv2z() at all positions
+* @return number of positions with a different result or return value
+*/
+template < int BorderU, int BorderV, bool HasBank, bool Smooth >
+static int checkEvaluator( const crg::ContactPoint& cp, const std::vector< double >& u, const std::vector< double >& v )
+{
+    crg::Evaluator< BorderU, BorderV, HasBank, Smooth > eval( cp );
+    int noDiff = 0;
+
+    for ( std::size_t i = 0; i < u.size(); i++ )
+    {
+        double zRef = 0.0;
+        double z    = 0.0;
+        bool   okRef = crgEvaluv2z( cp.id(), u[i], v[i], &zRef ) != 0;
+        bool   ok    = eval.uv2z( u[i], v[i], z );
+
+        /* --- data which gives NaN in the C implementation must do so in the evaluator as well --- */
+        bool same = ( std::isnan( z ) && std::isnan( zRef ) ) || std::fabs( z - zRef ) <= dCheckTolerance;
+
+        if ( ok != okRef || ( ok && !same ) )
+            noDiff++;
+    }
+    return noDiff;
+}
+
+/**
+* check the evaluators of all combinations of border modes, starting with the given ones
+* @return number of evaluators which differ from crgEvaluv2z()
+*/
+template < int BorderU, int BorderV, bool HasBank >
+static int checkBorderModes( const char* filename, crg::ContactPoint& cp, const std::vector< double >& u, const std::vector< double >& v,
+                             bool smooth, bool cellCoefs )
+{
+    int noDiff;
+    int noFailed = 0;
+
+    cp.setOption( dCrgCpOptionBorderModeU, BorderU );
+    cp.setOption( dCrgCpOptionBorderModeV, BorderV );
+
+    if ( smooth )
+        noDiff = checkEvaluator< BorderU, BorderV, HasBank, true >( cp, u, v );
+    else
+        noDiff = checkEvaluator< BorderU, BorderV, HasBank, false >( cp, u, v );
+
+    if ( noDiff )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "crgCppBench: %s: border modes u/v = %d/%d%s%s: %d of %d positions differ from crgEvaluv2z()\n",
+                     filename, BorderU, BorderV, smooth ? ", smoothing" : "", cellCoefs ? ", cell coefficients" : "",
+                     noDiff, ( int ) u.size() );
+        noFailed++;
+    }
+
+    if constexpr ( BorderV < dCrgBorderModeReflect )
+        return noFailed + checkBorderModes< BorderU, BorderV + 1, HasBank >( filename, cp, u, v, smooth, cellCoefs );
+    else if constexpr ( BorderU < dCrgBorderModeReflect )
+        return noFailed + checkBorderModes< BorderU + 1, dCrgBorderModeNone, HasBank >( filename, cp, u, v, smooth, cellCoefs );
+    else
+        return noFailed;
+}
+
+/**
+* check the evaluators of all border modes, with and without smoothing zones and cell coefficients
+* @return number of evaluators which differ from crgEvaluv2z()
+*/
+template < bool HasBank >
+static int checkFile( const char* filename, const crg::Road& road, crg::ContactPoint& cp )
+{
+    std::vector< double > u( dCheckNoPts );
+    std::vector< double > v( dCheckNoPts );
+    std::pair< double, double > uRange = road.uRange();
+    int noFailed = 0;
+
+    randomPositions( road, dCheckBorder, u, v );
+
+    cp.setOption( dCrgCpOptionBorderOffsetU, 0.01 );
+    cp.setOption( dCrgCpOptionBorderOffsetV, 0.02 );
+
+    for ( int cellCoefs = 0; cellCoefs < 2; cellCoefs++ )
+    {
+        crgDataSetCellCoefsEnable( road.id(), cellCoefs );
+
+        for ( int smooth = 0; smooth < 2; smooth++ )
+        {
+            if ( smooth )
+            {
+                cp.setOption( dCrgCpOptionSmoothUBegin, 0.2 * ( uRange.second - uRange.first ) );
+                cp.setOption( dCrgCpOptionSmoothUEnd,   0.2 * ( uRange.second - uRange.first ) );
+            }
+
+            noFailed += checkBorderModes< dCrgBorderModeNone, dCrgBorderModeNone, HasBank >( filename, cp, u, v, smooth, cellCoefs );
+
+            crgContactPointOptionRemove( cp.id(), dCrgCpOptionSmoothUBegin );
+            crgContactPointOptionRemove( cp.id(), dCrgCpOptionSmoothUEnd );
+        }
+    }
+
+    crgDataSetCellCoefsEnable( road.id(), 0 );
+    crgContactPointOptionRemove( cp.id(), dCrgCpOptionBorderOffsetU );
+    crgContactPointOptionRemove( cp.id(), dCrgCpOptionBorderOffsetV );
+
+    return noFailed;
+}
+
+/**
+* time a method over all repetitions
+* @return minimum time per query [ns]
+*/
+template < typename Method >
+static double timeMethod( Method method )
+{
+    double best = 1.0e30;
+
+    for ( int rep = 0; rep < sNoReps; rep++ )
+    {
+        double t0 = crgPortGetTime();
+        method();
+        double dt = ( crgPortGetTime() - t0 ) / sNoPts;
+
+        if ( dt < best )
+            best = dt;
+    }
+    return best;
+}
+
+static double maxDeviation( const std::vector< double >& a, const std::vector< double >& b )
+{
+    double dev = 0.0;
+
+    for ( std::size_t i = 0; i < a.size(); i++ )
+        dev = std::max( dev, std::fabs( a[i] - b[i] ) );
+
+    return dev;
+}
+
+template < int BorderU, int BorderV, bool HasBank >
+static void benchFile( const char* filename, const crg::Road& road, crg::ContactPoint& cp,
+                       const std::vector< double >& u, const std::vector< double >& v )
+{
+    std::vector< double > zRef( u.size() );
+    std::vector< double > z( u.size() );
+    crg::Evaluator< BorderU, BorderV, HasBank, false > eval( cp );
+    int    cpId = cp.id();
+    double nsC;
+    double nsBatch;
+    double nsEval;
+
+    nsC = timeMethod( [&]() {
+        for ( std::size_t i = 0; i < u.size(); i++ )
+            crgEvaluv2z( cpId, u[i], v[i], &zRef[i] );
+    } );
+
+    nsBatch = timeMethod( [&]() { cp.uv2z( u, v, z ); } );
+    double devBatch = maxDeviation( zRef, z );
+
+    nsEval = timeMethod( [&]() { eval.uv2z( u, v, z ); } );
+    double devEval = maxDeviation( zRef, z );
+
+    for ( std::size_t i = 0; i < z.size(); i++ )
+        sChecksum += z[i];
+
+    std::printf( "%s,crgEvaluv2z,%d,%.2f,1.00,0\n", filename, sNoPts, nsC );
+    std::printf( "%s,ContactPoint::uv2z,%d,%.2f,%.2f,%g\n", filename, sNoPts, nsBatch, nsC / nsBatch, devBatch );
+    std::printf( "%s,Evaluator::uv2z,%d,%.2f,%.2f,%g\n", filename, sNoPts, nsEval, nsC / nsEval, devEval );
+
+    ( void ) road;
+}
+
+int main( int argc, char** argv )
+{
+    int i;
+    int noFailed = 0;
+
+    if ( argc < 2 )
+        usage();
+
+    for ( i = 1; i < argc; i++ )
+    {
+        if ( !std::strcmp( argv[i], "-h" ) )
+            usage();
+
+        if ( argv[i][0] != '-' )
+            break;
+
+        if ( !std::strcmp( argv[i], "-c" ) )
+        {
+            sCheckOnly = true;
+            continue;
+        }
+
+        if ( i + 1 >= argc )
+            usage();
+
+        if ( !std::strcmp( argv[i], "-r" ) )
+            sNoReps = std::atoi( argv[++i] );
+        else if ( !std::strcmp( argv[i], "-n" ) )
+            sNoPts = std::atoi( argv[++i] );
+        else if ( !std::strcmp( argv[i], "-b" ) )
+            sBorder = std::atof( argv[++i] );
+        else
+            usage();
+    }
+
+    if ( i >= argc || sNoReps < 1 || sNoPts < 1 )
+        usage();
+
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+
+    if ( !sCheckOnly )
+        std::printf( "file,method,queries,ns_per_query,speedup,max_deviation\n" );
+
+    for ( ; i < argc; i++ )
+    {
+        try
+        {
+            crg::Road         road( argv[i] );
+            crg::ContactPoint cp( road );
+            std::vector< double > u( sNoPts );
+            std::vector< double > v( sNoPts );
+            int noDiff;
+
+            /* --- the evaluators of all option combinations must reproduce crgEvaluv2z() --- */
+            if ( road.data()->util.hasBank )
+                noDiff = checkFile< true >( argv[i], road, cp );
+            else
+                noDiff = checkFile< false >( argv[i], road, cp );
+
+            if ( noDiff )
+                noFailed++;
+
+            if ( sCheckOnly )
+                continue;
+
+            /* --- keep last value at the borders, no smoothing --- */
+            cp.setOption( dCrgCpOptionBorderModeU, dCrgBorderModeExKeep );
+            cp.setOption( dCrgCpOptionBorderModeV, dCrgBorderModeExKeep );
+            crgContactPointOptionRemove( cp.id(), dCrgCpOptionSmoothUBegin );
+            crgContactPointOptionRemove( cp.id(), dCrgCpOptionSmoothUEnd );
+
+            randomPositions( road, sBorder, u, v );
+
+            if ( road.data()->util.hasBank )
+                benchFile< dCrgBorderModeExKeep, dCrgBorderModeExKeep, true >( argv[i], road, cp, u, v );
+            else
+                benchFile< dCrgBorderModeExKeep, dCrgBorderModeExKeep, false >( argv[i], road, cp, u, v );
+        }
+        catch ( const std::exception& e )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "crgCppBench: %s\n", e.what() );
+            noFailed++;
+        }
+    }
+
+    crgMsgPrint( dCrgMsgLevelInfo, "crgCppBench: checksum %g\n", sChecksum );
+
+    crgMemRelease();
+
+    return noFailed ? -1 : 0;
+}
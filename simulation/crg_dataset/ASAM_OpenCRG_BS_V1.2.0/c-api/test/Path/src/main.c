@@ -0,0 +1,293 @@
+/* ===================================================
+ *  main program for testing the sampling of the road
+ *  excitation along a path (crgEvalPathSample): two
+ *  wheel tracks with contact points of their own are
+ *  sampled along a straight u/v path and along an x/y
+ *  path; the positions of the samples are computed
+ *  independently and the z values are compared to
+ *  point by point evaluations
+ * ---------------------------------------------------
+ *
+ * ASAM OpenCRG C API
+ *
+ * OpenCRG version:           1.2.0
+ *
+ * package:               test/Path
+ * file name:             main.c
+ * author:                ASAM e.V.
+ *
+ *
+ * C by ASAM e.V., 2020
+ * Any use is limited to the scope described in the license terms.
+ * The license terms can be viewed at www.asam.net/license
+ *
+ * More Information on ASAM OpenCRG can be found here:
+ * https://www.asam.net/standards/detail/opencrg/
+ *
+ */
+
+/* ====== INCLUSIONS ====== */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "crgBaseLib.h"
+
+/* ====== DEFINITIONS ====== */
+#define dNoTracks       2       /* number of wheel tracks                               [-] */
+#define dNoXYPts        50      /* number of points of the x/y path                     [-] */
+#define dTolerance      1.0e-6  /* max. deviation of z values, relative above 1 m       [m] */
+
+/* ====== LOCAL VARIABLES ====== */
+static double sSampleRate = 200.0;     /* sample rate                          [Hz] */
+static double sSpeed0     = 5.0;       /* speed at the start                  [m/s] */
+static double sSpeed1     = 20.0;      /* speed after the ramp                [m/s] */
+static double sRampTime   = 2.0;       /* duration of the speed ramp            [s] */
+static double sOffset[dNoTracks];      /* lateral offsets of the wheel tracks   [m] */
+static int    sTrackCp[dNoTracks];     /* contact points of the wheel tracks    [-] */
+static int    sRefCp[dNoTracks];       /* contact points of the references      [-] */
+
+/* ====== LOCAL METHODS ====== */
+static void   usage( void );
+static double distance( double time );
+static int    checkPath( const char* name, const CrgPathStruct* path );
+
+static void
+usage( void )
+{
+    crgMsgPrint( dCrgMsgLevelNotice, "usage: crgPathTest [options] <CRG file>\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       options: -h         show this info\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -r <rate>  sample rate [Hz] (default: 200)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -s <speed> speed after the ramp [m/s] (default: 20)\n" );
+    exit( -1 );
+}
+
+int main( int argc, char** argv )
+{
+    const char*   filename = NULL;
+    CrgPathStruct path;
+    double        speedTime[2];
+    double        speed[2];
+    double        a[dNoXYPts];
+    double        b[dNoXYPts];
+    double        uMin;
+    double        uMax;
+    double        vMin;
+    double        vMax;
+    int           dataSetId;
+    int           noFailed = 0;
+    int           i;
+    int           j;
+
+    /* --- decode the command line --- */
+    for ( i = 1; i < argc; i++ )
+    {
+        if ( argv[i][0] != '-' && !filename )
+            filename = argv[i];
+        else if ( argv[i][0] != '-' || argv[i][1] == 'h' || i + 1 >= argc )
+            usage();
+        else if ( !strcmp( argv[i], "-r" ) )
+            sSampleRate = atof( argv[++i] );
+        else if ( !strcmp( argv[i], "-s" ) )
+            sSpeed1 = atof( argv[++i] );
+        else
+            usage();
+    }
+
+    if ( !filename || !( sSampleRate > 0.0 ) || !( sSpeed1 > 0.0 ) )
+        usage();
+
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+
+    if ( ( dataSetId = crgLoaderReadFile( filename ) ) <= 0 )
+        return -1;
+
+    crgDataSetGetURange( dataSetId, &uMin, &uMax );
+    crgDataSetGetVRange( dataSetId, &vMin, &vMax );
+
+    /* --- both tracks leave the road; the left one is set to zero there, the right one keeps the border values --- */
+    sOffset[0] =  0.45 * ( vMax - vMin );
+    sOffset[1] = -0.5  * ( vMax - vMin );
+
+    for ( j = 0; j < dNoTracks; j++ )
+    {
+        sTrackCp[j] = crgContactPointCreate( dataSetId );
+        sRefCp[j]   = crgContactPointCreate( dataSetId );
+    }
+
+    crgContactPointOptionSetInt( sTrackCp[0], dCrgCpOptionBorderModeV, dCrgBorderModeExZero );
+    crgContactPointOptionSetInt( sRefCp[0],   dCrgCpOptionBorderModeV, dCrgBorderModeExZero );
+
+    /* --- speed ramp followed by a constant speed --- */
+    speedTime[0] = 0.0;
+    speedTime[1] = sRampTime;
+    speed[0]     = sSpeed0;
+    speed[1]     = sSpeed1;
+
+    path.noSpeeds   = 2;
+    path.speedTime  = speedTime;
+    path.speed      = speed;
+    path.sampleRate = sSampleRate;
+
+    /* --- straight line in u/v, slightly inclined to the reference line --- */
+    a[0] = uMin + 0.05 * ( uMax - uMin );
+    b[0] = vMin + 0.4  * ( vMax - vMin );
+    a[1] = uMax - 0.05 * ( uMax - uMin );
+    b[1] = vMin + 0.6  * ( vMax - vMin );
+
+    path.type  = dCrgPathTypeUV;
+    path.noPts = 2;
+    path.a     = a;
+    path.b     = b;
+
+    noFailed += checkPath( "uv_straight", &path );
+
+    /* --- x/y path weaving around the reference line --- */
+    for ( i = 0; i < dNoXYPts; i++ )
+    {
+        double u = uMin + ( 0.05 + 0.9 * i / ( dNoXYPts - 1 ) ) * ( uMax - uMin );
+        double v = 0.5 * ( vMin + vMax ) + 0.1 * ( vMax - vMin ) * sin( 0.5 * i );
+
+        if ( !crgEvaluv2xy( sRefCp[1], u, v, a + i, b + i ) )
+            return -1;
+    }
+
+    path.type  = dCrgPathTypeXY;
+    path.noPts = dNoXYPts;
+
+    noFailed += checkPath( "xy_weaving", &path );
+
+    for ( j = 0; j < dNoTracks; j++ )
+    {
+        crgContactPointDelete( sTrackCp[j] );
+        crgContactPointDelete( sRefCp[j] );
+    }
+
+    crgDataSetRelease( dataSetId );
+    crgMemRelease();
+
+    return noFailed ? -1 : 0;
+}
+
+static double
+distance( double time )
+{
+    if ( time <= sRampTime )
+        return sSpeed0 * time + 0.5 * ( sSpeed1 - sSpeed0 ) / sRampTime * time * time;
+
+    return 0.5 * ( sSpeed0 + sSpeed1 ) * sRampTime + sSpeed1 * ( time - sRampTime );
+}
+
+/**
+* sample a path and compare the result with the expected positions and z values
+* @param name  name of the path for the report
+* @param path  pointer to the path description
+* @return 0 if the samples match, otherwise 1
+*/
+static int
+checkPath( const char* name, const CrgPathStruct* path )
+{
+    double* z;
+    double  length = 0.0;
+    double  segLen;
+    double  s;
+    double  sSeg;
+    double  dirA;
+    double  dirB;
+    double  posA;
+    double  posB;
+    double  u;
+    double  v;
+    double  zRef;
+    double  zPath;
+    double  dev = 0.0;
+    int     noExpected;
+    int     noSamples;
+    int     noCounted;
+    int     noNaN = 0;
+    int     noZero = 0;
+    int     ok;
+    int     i;
+    int     j;
+    int     k;
+
+    for ( i = 0; i < path->noPts - 1; i++ )
+        length += sqrt( ( path->a[i+1] - path->a[i] ) * ( path->a[i+1] - path->a[i] )
+                      + ( path->b[i+1] - path->b[i] ) * ( path->b[i+1] - path->b[i] ) );
+
+    /* --- all samples up to the end of the path are taken --- */
+    for ( noExpected = 0; distance( noExpected / path->sampleRate ) <= length + 1.0e-9; noExpected++ )
+        ;
+
+    if ( !crgEvalPathGetNoSamples( path, &noCounted ) )
+        return 1;
+
+    /* --- one more sample than needed shows that sampling stops at the end --- */
+    z = ( double* ) calloc( ( size_t ) dNoTracks * ( noExpected + 1 ), sizeof( double ) );
+
+    if ( !z || !crgEvalPathSample( path, dNoTracks, sTrackCp, sOffset, noExpected + 1, z, &noSamples ) )
+    {
+        free( z );
+        return 1;
+    }
+
+    for ( k = 0; k < noSamples; k++ )
+    {
+        s = distance( k / path->sampleRate );
+
+        /* --- segment holding the position, searched from the start --- */
+        sSeg = 0.0;
+
+        for ( i = 0; ; i++ )
+        {
+            segLen = sqrt( ( path->a[i+1] - path->a[i] ) * ( path->a[i+1] - path->a[i] )
+                         + ( path->b[i+1] - path->b[i] ) * ( path->b[i+1] - path->b[i] ) );
+
+            if ( i == path->noPts - 2 || s <= sSeg + segLen )
+                break;
+
+            sSeg += segLen;
+        }
+
+        dirA = ( path->a[i+1] - path->a[i] ) / segLen;
+        dirB = ( path->b[i+1] - path->b[i] ) / segLen;
+        posA = path->a[i] + ( s - sSeg ) * dirA;
+        posB = path->b[i] + ( s - sSeg ) * dirB;
+
+        for ( j = 0; j < dNoTracks; j++ )
+        {
+            u = posA - dirB * sOffset[j];
+            v = posB + dirA * sOffset[j];
+
+            if ( path->type == dCrgPathTypeXY )
+                ok = crgEvalxy2uv( sRefCp[j], u, v, &u, &v ) && crgEvaluv2z( sRefCp[j], u, v, &zRef );
+            else
+                ok = crgEvaluv2z( sRefCp[j], u, v, &zRef );
+
+            zPath = z[j * ( noExpected + 1 ) + k];
+
+            /* --- positions which cannot be evaluated must be NaN in both --- */
+            if ( !ok || zRef != zRef )
+            {
+                if ( zPath == zPath )
+                    dev = 1.0e30;
+
+                noNaN++;
+            }
+            else if ( zPath != zPath )
+                dev = 1.0e30;
+            else if ( fabs( zPath - zRef ) > dev * ( fabs( zRef ) > 1.0 ? fabs( zRef ) : 1.0 ) )
+                dev = fabs( zPath - zRef ) / ( fabs( zRef ) > 1.0 ? fabs( zRef ) : 1.0 );
+
+            if ( zPath == 0.0 )
+                noZero++;
+        }
+    }
+
+    free( z );
+
+    printf( "%-12s length = %10.3f m, samples = %d (expected %d, counted %d), nan = %d, zero = %d, max_dev_z = %g\n",
+            name, length, noSamples, noExpected, noCounted, noNaN, noZero, dev );
+
+    return ( noSamples == noExpected && noCounted == noExpected && dev <= dTolerance ) ? 0 : 1;
+}
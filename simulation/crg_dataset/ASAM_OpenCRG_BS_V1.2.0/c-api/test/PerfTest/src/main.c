@@ -251,7 +251,7 @@ int main( int argc, char** argv )
 
     crgMsgPrint( dCrgMsgLevelNotice, "main: generated %d test points. Now running actual test....\n", idxTestPt );
 
-    crgContactPointActivatePerfStat( cpId );
+    crgPerfStatReset();
     
     /* --- all right, I have the test points, now let's go through all of them and measure the time required --- */
     gettimeofday(&tme, 0);
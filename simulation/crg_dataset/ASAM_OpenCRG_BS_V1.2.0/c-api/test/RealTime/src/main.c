@@ -0,0 +1,334 @@
+/* ===================================================
+ *  main program for measuring the latency distribution
+ *  of x/y queries along long trajectories, with and
+ *  without real-time mode of the contact point
+ * ---------------------------------------------------
+ *
+ * ASAM OpenCRG C API
+ *
+ * OpenCRG version:           1.2.0
+ *
+ * package:               test/RealTime
+ * file name:             main.c
+ * author:                ASAM e.V.
+ *
+ *
+ * C by ASAM e.V., 2020
+ * Any use is limited to the scope described in the license terms.
+ * The license terms can be viewed at www.asam.net/license
+ *
+ * More Information on ASAM OpenCRG can be found here:
+ * https://www.asam.net/standards/detail/opencrg/
+ *
+ */
+
+/* ====== INCLUSIONS ====== */
+#ifdef __linux__
+#define _GNU_SOURCE     /* sched_setaffinity() */
+#include <sched.h>
+#endif
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "crgBaseLibPrivate.h"
+
+/* ====== DEFINITIONS ====== */
+#define dModeStandard   0
+#define dModeRealTime   1
+#define dNoModes        2
+
+/* ====== TYPE DEFINITIONS ====== */
+typedef struct
+{
+    int     noPts;      /* number of trajectory points              [-] */
+    double* x;          /* trajectory x co-ordinates                [m] */
+    double* y;          /* trajectory y co-ordinates                [m] */
+    double* z;          /* resulting elevation of standard mode     [m] */
+    double* ns;         /* latency of each query                   [ns] */
+} TrajectoryStruct;
+
+/* ====== LOCAL VARIABLES ====== */
+static const char* sModeName[dNoModes] = { "standard", "realtime" };
+
+static int    sNoPts     = 100000;  /* trajectory points per lap                            */
+static int    sNoLaps    = 5;       /* laps along the reference line                         */
+static int    sSteps     = 32;      /* step limit of real-time mode                          */
+static int    sJumpDist  = 1000;    /* trajectory points between jumps, 0 = no jumps         */
+static double sChecksum  = 0.0;     /* keeps results alive; printed at info level            */
+
+/* ====== LOCAL METHODS ====== */
+static void   usage( void );
+static int    pinToCpu( int cpu );
+static int    cmpDouble( const void* a, const void* b );
+static double percentile( double* sorted, int n, double p );
+static int    createTrajectory( int dataSetId, TrajectoryStruct* traj );
+static void   releaseTrajectory( TrajectoryStruct* traj );
+static int    runMode( int mode, const char* filename, int dataSetId, TrajectoryStruct* traj );
+static int    benchFile( const char* filename );
+
+static void
+usage( void )
+{
+    crgMsgPrint( dCrgMsgLevelNotice, "usage: crgRtBench [options] <filename> [<filename> ...]\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       options: -h         show this info\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -n <n>     number of trajectory points per lap (default: 100000)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -l <n>     number of laps along the reference line (default: 5)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -s <n>     step limit of real-time mode (default: 32)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -j <n>     trajectory points between jumps to random positions, 0 = none (default: 1000)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -c <cpu>   pin the benchmark to the given CPU (Linux only)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       <filename> CRG file(s) to be benchmarked\n" );
+    exit( -1 );
+}
+
+int main( int argc, char** argv )
+{
+    int cpu      = -1;
+    int noFiles  = 0;
+    int noFailed = 0;
+    int i;
+
+    /* --- decode the command line --- */
+    if ( argc < 2 )
+        usage();
+
+    for ( i = 1; i < argc; i++ )
+    {
+        if ( !strcmp( argv[i], "-h" ) )
+            usage();
+
+        if ( argv[i][0] != '-' )
+            break;
+
+        if ( i + 1 >= argc )
+            usage();
+
+        if ( !strcmp( argv[i], "-n" ) )
+            sNoPts = atoi( argv[++i] );
+        else if ( !strcmp( argv[i], "-l" ) )
+            sNoLaps = atoi( argv[++i] );
+        else if ( !strcmp( argv[i], "-s" ) )
+            sSteps = atoi( argv[++i] );
+        else if ( !strcmp( argv[i], "-j" ) )
+            sJumpDist = atoi( argv[++i] );
+        else if ( !strcmp( argv[i], "-c" ) )
+            cpu = atoi( argv[++i] );
+        else
+            usage();
+    }
+
+    if ( i >= argc || sNoPts < 2 || sNoLaps < 1 || sSteps < 1 || sJumpDist < 0 )
+        usage();
+
+    /* --- benchmarks shall not be disturbed by messages --- */
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+
+    if ( cpu >= 0 && !pinToCpu( cpu ) )
+        crgMsgPrint( dCrgMsgLevelWarn, "main: could not pin benchmark to CPU %d.\n", cpu );
+
+    printf( "file,mode,queries,p50_ns,p99_ns,p999_ns,max_ns,degraded,max_dev_z\n" );
+
+    for ( ; i < argc; i++ )
+    {
+        noFiles++;
+
+        if ( !benchFile( argv[i] ) )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "main: skipping file <%s>.\n", argv[i] );
+            noFailed++;
+        }
+    }
+
+    crgMsgPrint( dCrgMsgLevelInfo, "main: checksum = %.6f\n", sChecksum );
+    crgMsgPrint( dCrgMsgLevelNotice, "main: benchmarked %d of %d files\n", noFiles - noFailed, noFiles );
+
+    return noFailed ? -1 : 0;
+}
+
+static int
+pinToCpu( int cpu )
+{
+#ifdef __linux__
+    cpu_set_t cpuSet;
+
+    CPU_ZERO( &cpuSet );
+    CPU_SET( cpu, &cpuSet );
+
+    return !sched_setaffinity( 0, sizeof( cpuSet ), &cpuSet );
+#else
+    return 0;
+#endif
+}
+
+static int
+cmpDouble( const void* a, const void* b )
+{
+    double da = *( const double* ) a;
+    double db = *( const double* ) b;
+
+    return ( da > db ) - ( da < db );
+}
+
+static double
+percentile( double* sorted, int n, double p )
+{
+    /* --- nearest-rank method --- */
+    int rank = ( int ) ceil( 0.01 * p * n );
+
+    if ( rank < 1 )
+        rank = 1;
+
+    return sorted[rank - 1];
+}
+
+static int
+createTrajectory( int dataSetId, TrajectoryStruct* traj )
+{
+    double uMin;
+    double uMax;
+    double vMin;
+    double vMax;
+    double u;
+    double v;
+    int    cpId;
+    int    i;
+
+    memset( traj, 0, sizeof( TrajectoryStruct ) );
+
+    if ( ( cpId = crgContactPointCreate( dataSetId ) ) < 0 )
+        return 0;
+
+    crgDataSetGetURange( dataSetId, &uMin, &uMax );
+    crgDataSetGetVRange( dataSetId, &vMin, &vMax );
+
+    traj->noPts = sNoPts * sNoLaps;
+    traj->x     = ( double* ) calloc( traj->noPts, sizeof( double ) );
+    traj->y     = ( double* ) calloc( traj->noPts, sizeof( double ) );
+    traj->z     = ( double* ) calloc( traj->noPts, sizeof( double ) );
+    traj->ns    = ( double* ) calloc( traj->noPts, sizeof( double ) );
+
+    if ( !traj->x || !traj->y || !traj->z || !traj->ns )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "createTrajectory: could not allocate memory.\n" );
+        releaseTrajectory( traj );
+        crgContactPointDelete( cpId );
+        return 0;
+    }
+
+    /* --- laps along the reference line, weaving across the road, with occasional --- */
+    /* --- jumps to random positions which defeat the history (e.g. a reset)        --- */
+    srand( 4711 );
+
+    for ( i = 0; i < traj->noPts; i++ )
+    {
+        if ( sJumpDist && i % sJumpDist == sJumpDist - 1 )
+        {
+            u = uMin + ( uMax - uMin ) * rand() / RAND_MAX;
+            v = vMin + ( vMax - vMin ) * rand() / RAND_MAX;
+        }
+        else
+        {
+            u = uMin + ( uMax - uMin ) * ( i % sNoPts ) / ( sNoPts - 1 );
+            v = 0.5 * ( vMin + vMax ) + 0.4 * ( vMax - vMin ) * sin( i / 300.0 );
+        }
+
+        crgEvaluv2xy( cpId, u, v, &traj->x[i], &traj->y[i] );
+    }
+
+    crgContactPointDelete( cpId );
+
+    return 1;
+}
+
+static void
+releaseTrajectory( TrajectoryStruct* traj )
+{
+    free( traj->x );
+    free( traj->y );
+    free( traj->z );
+    free( traj->ns );
+
+    memset( traj, 0, sizeof( TrajectoryStruct ) );
+}
+
+static int
+runMode( int mode, const char* filename, int dataSetId, TrajectoryStruct* traj )
+{
+    unsigned long noDegraded = 0;
+    double devMax = 0.0;
+    double t0;
+    double z;
+    int    cpId;
+    int    i;
+
+    if ( ( cpId = crgContactPointCreate( dataSetId ) ) < 0 )
+        return 0;
+
+    if ( mode == dModeRealTime )
+        crgContactPointOptionSetInt( cpId, dCrgCpOptionRealTimeSteps, sSteps );
+
+    /* --- time every single query; tail latency is what matters here --- */
+    for ( i = 0; i < traj->noPts; i++ )
+    {
+        t0 = crgPortGetTime();
+
+        if ( !crgEvalxy2z( cpId, traj->x[i], traj->y[i], &z ) )
+            z = 0.0;
+
+        traj->ns[i] = crgPortGetTime() - t0;
+
+        if ( mode == dModeStandard )
+            traj->z[i] = z;
+        else if ( fabs( z - traj->z[i] ) > devMax )
+            devMax = fabs( z - traj->z[i] );
+
+        if ( z == z )
+            sChecksum += z;
+    }
+
+    if ( mode == dModeRealTime )
+        crgContactPointGetRealTimeStatus( cpId, NULL, &noDegraded );
+
+    crgContactPointDelete( cpId );
+
+    qsort( traj->ns, traj->noPts, sizeof( double ), cmpDouble );
+
+    printf( "%s,%s,%d,%.1f,%.1f,%.1f,%.1f,%lu,%g\n", filename, sModeName[mode], traj->noPts,
+            percentile( traj->ns, traj->noPts, 50.0 ), percentile( traj->ns, traj->noPts, 99.0 ),
+            percentile( traj->ns, traj->noPts, 99.9 ), traj->ns[traj->noPts - 1], noDegraded, devMax );
+    fflush( stdout );
+
+    return 1;
+}
+
+static int
+benchFile( const char* filename )
+{
+    TrajectoryStruct traj;
+    int dataSetId;
+    int mode;
+    int ok = 1;
+
+    if ( ( dataSetId = crgLoaderReadFile( filename ) ) <= 0 )
+        return 0;
+
+    if ( !crgCheck( dataSetId ) )
+        crgMsgPrint( dCrgMsgLevelWarn, "benchFile: could not validate crg data in <%s>.\n", filename );
+
+    crgDataSetModifiersApply( dataSetId );
+
+    if ( !createTrajectory( dataSetId, &traj ) )
+    {
+        crgDataSetRelease( dataSetId );
+        return 0;
+    }
+
+    /* --- standard mode first: its results are the reference for the deviation --- */
+    for ( mode = dModeStandard; mode < dNoModes && ok; mode++ )
+        ok = runMode( mode, filename, dataSetId, &traj );
+
+    releaseTrajectory( &traj );
+    crgDataSetRelease( dataSetId );
+
+    return ok;
+}
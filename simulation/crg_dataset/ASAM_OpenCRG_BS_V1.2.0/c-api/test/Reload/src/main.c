@@ -0,0 +1,373 @@
+/* ===================================================
+ *  main program for measuring the time for reloading
+ *  a CRG file after modifications of its header or of
+ *  single records, compared to reading the file again
+ * ---------------------------------------------------
+ *
+ * ASAM OpenCRG C API
+ *
+ * OpenCRG version:           1.2.0
+ *
+ * package:               test/Reload
+ * file name:             main.c
+ * author:                ASAM e.V.
+ *
+ *
+ * C by ASAM e.V., 2020
+ * Any use is limited to the scope described in the license terms.
+ * The license terms can be viewed at www.asam.net/license
+ *
+ * More Information on ASAM OpenCRG can be found here:
+ * https://www.asam.net/standards/detail/opencrg/
+ *
+ */
+
+/* ====== INCLUSIONS ====== */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "crgBaseLibPrivate.h"
+
+/* ====== DEFINITIONS ====== */
+#define dNoGridU    200     /* evaluation points in u direction for verification */
+#define dNoGridV     20     /* evaluation points in v direction for verification */
+
+/* ====== TYPE DEFINITIONS ====== */
+typedef struct
+{
+    char*  data;        /* contents of the file                                 [-] */
+    size_t size;        /* size of the file                                  [byte] */
+    size_t dataStart;   /* offset of the data section                        [byte] */
+    size_t hdrPos;      /* position of the character modified in the header  [byte] */
+    size_t recPos;      /* position of the character modified in the data    [byte] */
+} FileStruct;
+
+/* ====== LOCAL VARIABLES ====== */
+static int         sNoReps   = 10;                    /* timed repetitions per case     */
+static const char* sWorkFile = "crgReloadBench.tmp";  /* modified copy of the CRG file  */
+
+/* ====== LOCAL METHODS ====== */
+static void   usage( void );
+static int    readFile( const char* filename, FileStruct* file );
+static int    writeWorkFile( FileStruct* file );
+static double timeReload( int dataSetId );
+static double maxDeviation( int dataSetId );
+static int    benchFile( const char* filename );
+
+static void
+usage( void )
+{
+    crgMsgPrint( dCrgMsgLevelNotice, "usage: crgReloadBench [options] <filename> [<filename> ...]\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       options: -h         show this info\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -r <n>     number of timed repetitions per case (default: 10)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -w <file>  name of the modified copy of the CRG file (default: crgReloadBench.tmp)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       <filename> CRG file(s) to be benchmarked\n" );
+    exit( -1 );
+}
+
+int main( int argc, char** argv )
+{
+    int noFiles  = 0;
+    int noFailed = 0;
+    int i;
+
+    /* --- decode the command line --- */
+    if ( argc < 2 )
+        usage();
+
+    for ( i = 1; i < argc; i++ )
+    {
+        if ( !strcmp( argv[i], "-h" ) )
+            usage();
+
+        if ( argv[i][0] != '-' )
+            break;
+
+        if ( i + 1 >= argc )
+            usage();
+
+        if ( !strcmp( argv[i], "-r" ) )
+            sNoReps = atoi( argv[++i] );
+        else if ( !strcmp( argv[i], "-w" ) )
+            sWorkFile = argv[++i];
+        else
+            usage();
+    }
+
+    if ( i >= argc || sNoReps < 1 )
+        usage();
+
+    /* --- benchmarks shall not be disturbed by messages --- */
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+
+    printf( "file,read_ms,first_reload_ms,unchanged_ms,header_ms,record_ms,max_dev_z\n" );
+
+    for ( ; i < argc; i++ )
+    {
+        noFiles++;
+
+        if ( !benchFile( argv[i] ) )
+        {
+            crgMsgPrint( dCrgMsgLevelWarn, "main: skipping file <%s>.\n", argv[i] );
+            noFailed++;
+        }
+    }
+
+    remove( sWorkFile );
+    crgMemRelease();
+
+    crgMsgPrint( dCrgMsgLevelNotice, "main: benchmarked %d of %d files\n", noFiles - noFailed, noFiles );
+
+    return noFailed ? -1 : 0;
+}
+
+static int
+readFile( const char* filename, FileStruct* file )
+{
+    FILE*  fPtr;
+    char*  ptr;
+    size_t i;
+    long   size;
+    int    isBinary;
+
+    memset( file, 0, sizeof( FileStruct ) );
+
+    if ( !( fPtr = fopen( filename, "rb" ) ) )
+        return 0;
+
+    fseek( fPtr, 0, SEEK_END );
+    size = ftell( fPtr );
+    fseek( fPtr, 0, SEEK_SET );
+
+    if ( size <= 0 || !( file->data = ( char* ) calloc( size + 1, 1 ) ) )
+    {
+        fclose( fPtr );
+        return 0;
+    }
+
+    file->size = fread( file->data, 1, size, fPtr );
+    fclose( fPtr );
+
+    /* --- the data section follows the first line starting with $$$$ --- */
+    if ( !( ptr = strstr( file->data, "\n$$$$" ) ) || !( ptr = strchr( ptr + 1, '\n' ) ) )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "readFile: no data section found in <%s>.\n", filename );
+        return 0;
+    }
+
+    file->dataStart = ptr + 1 - file->data;
+
+    /* --- a comment line of the header --- */
+    if ( !( ptr = strstr( file->data, "\n*" ) ) || ( size_t ) ( ptr - file->data ) >= file->dataStart )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "readFile: no comment found in header of <%s>.\n", filename );
+        return 0;
+    }
+
+    file->hdrPos = ptr + 2 - file->data;
+
+    /* --- a digit in the middle of ASCII data, the least significant byte of a big endian --- */
+    /* --- binary value otherwise; the modification toggles the lowest bit                  --- */
+    isBinary = strstr( file->data, "#:KRBI" ) || strstr( file->data, "#:KRBD" );
+
+    for ( i = file->dataStart + ( file->size - file->dataStart ) / 2; i < file->size; i++ )
+    {
+        if ( isBinary )
+        {
+            if ( ( i - file->dataStart ) % 4 == 3 )
+                break;
+        }
+        else if ( file->data[i] >= '0' && file->data[i] <= '9' )
+            break;
+    }
+
+    if ( i >= file->size )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "readFile: no data to be modified in <%s>.\n", filename );
+        return 0;
+    }
+
+    file->recPos = i;
+
+    return 1;
+}
+
+static int
+writeWorkFile( FileStruct* file )
+{
+    FILE*  fPtr;
+    size_t noBytes;
+
+    if ( !( fPtr = fopen( sWorkFile, "wb" ) ) )
+    {
+        crgMsgPrint( dCrgMsgLevelWarn, "writeWorkFile: could not write <%s>.\n", sWorkFile );
+        return 0;
+    }
+
+    noBytes = fwrite( file->data, 1, file->size, fPtr );
+    fclose( fPtr );
+
+    return noBytes == file->size;
+}
+
+static double
+timeReload( int dataSetId )
+{
+    double t0 = crgPortGetTime();
+
+    if ( !crgDataSetReload( dataSetId ) )
+        return -1.0;
+
+    return 1.0e-6 * ( crgPortGetTime() - t0 );
+}
+
+static double
+maxDeviation( int dataSetId )
+{
+    double uMin;
+    double uMax;
+    double vMin;
+    double vMax;
+    double u;
+    double v;
+    double z;
+    double zRef;
+    double dev = 0.0;
+    int    refId;
+    int    cpId;
+    int    refCpId;
+    int    i;
+    int    j;
+
+    /* --- the reference is the modified file read from scratch --- */
+    if ( ( refId = crgLoaderReadFile( sWorkFile ) ) <= 0 )
+        return -1.0;
+
+    crgDataSetModifiersApply( refId );
+
+    cpId    = crgContactPointCreate( dataSetId );
+    refCpId = crgContactPointCreate( refId );
+
+    crgDataSetGetURange( refId, &uMin, &uMax );
+    crgDataSetGetVRange( refId, &vMin, &vMax );
+
+    for ( i = 0; i < dNoGridU && dev >= 0.0; i++ )
+    {
+        for ( j = 0; j < dNoGridV; j++ )
+        {
+            u = uMin + ( uMax - uMin ) * i / ( dNoGridU - 1 );
+            v = vMin + ( vMax - vMin ) * j / ( dNoGridV - 1 );
+
+            if ( !crgEvaluv2z( cpId, u, v, &z ) || !crgEvaluv2z( refCpId, u, v, &zRef ) )
+            {
+                dev = -1.0;
+                break;
+            }
+
+            /* --- NaNs must match as well --- */
+            if ( ( z != z ) != ( zRef != zRef ) )
+                dev = 1.0e30;
+            else if ( z == z && fabs( z - zRef ) > dev )
+                dev = fabs( z - zRef );
+        }
+    }
+
+    crgContactPointDelete( cpId );
+    crgContactPointDelete( refCpId );
+    crgDataSetRelease( refId );
+
+    return dev;
+}
+
+static int
+benchFile( const char* filename )
+{
+    FileStruct file;
+    double tRead     = 1.0e30;
+    double tFirst;
+    double tUnchanged = 1.0e30;
+    double tHeader    = 1.0e30;
+    double tRecord    = 1.0e30;
+    double dt;
+    double t0;
+    double dev;
+    int    dataSetId;
+    int    cpId;
+    int    rep;
+
+    if ( !readFile( filename, &file ) )
+    {
+        free( file.data );
+        return 0;
+    }
+
+    if ( !writeWorkFile( &file ) )
+    {
+        free( file.data );
+        return 0;
+    }
+
+    /* --- reading the file from scratch --- */
+    for ( rep = 0; rep < sNoReps; rep++ )
+    {
+        t0 = crgPortGetTime();
+
+        if ( ( dataSetId = crgLoaderReadFile( sWorkFile ) ) <= 0 )
+        {
+            free( file.data );
+            return 0;
+        }
+
+        dt = 1.0e-6 * ( crgPortGetTime() - t0 );
+        tRead = ( dt < tRead ) ? dt : tRead;
+
+        crgDataSetRelease( dataSetId );
+    }
+
+    /* --- the data set under test is used like an application would: modified and with a contact point --- */
+    dataSetId = crgLoaderReadFile( sWorkFile );
+    crgDataSetModifiersApply( dataSetId );
+    cpId = crgContactPointCreate( dataSetId );
+
+    /* --- the first reload decodes all data and keeps it for the following reloads --- */
+    file.data[file.recPos] ^= 1;
+    writeWorkFile( &file );
+    tFirst = timeReload( dataSetId );
+
+    for ( rep = 0; rep < sNoReps; rep++ )
+    {
+        dt = timeReload( dataSetId );
+        tUnchanged = ( dt < tUnchanged ) ? dt : tUnchanged;
+    }
+
+    for ( rep = 0; rep < sNoReps; rep++ )
+    {
+        file.data[file.hdrPos] ^= 1;
+        writeWorkFile( &file );
+
+        dt = timeReload( dataSetId );
+        tHeader = ( dt < tHeader ) ? dt : tHeader;
+    }
+
+    for ( rep = 0; rep < sNoReps; rep++ )
+    {
+        file.data[file.recPos] ^= 1;
+        writeWorkFile( &file );
+
+        dt = timeReload( dataSetId );
+        tRecord = ( dt < tRecord ) ? dt : tRecord;
+    }
+
+    /* --- the reloaded data set must match the file read from scratch --- */
+    dev = maxDeviation( dataSetId );
+
+    printf( "%s,%.3f,%.3f,%.3f,%.3f,%.3f,%g\n", filename, tRead, tFirst, tUnchanged, tHeader, tRecord, dev );
+    fflush( stdout );
+
+    crgContactPointDelete( cpId );
+    crgDataSetRelease( dataSetId );
+    free( file.data );
+
+    return tFirst >= 0.0 && dev == 0.0;
+}
@@ -0,0 +1,385 @@
+/* ===================================================
+ *  main program for CRG test program measuring the
+ *  scaling of the evaluation across threads, each
+ *  thread simulating a car with its own contact points
+ * ---------------------------------------------------
+ *
+ * ASAM OpenCRG C API
+ *
+ * OpenCRG version:           1.2.0
+ *
+ * package:               test/Scaling
+ * file name:             main.c
+ * author:                ASAM e.V.
+ *
+ *
+ * C by ASAM e.V., 2020
+ * Any use is limited to the scope described in the license terms.
+ * The license terms can be viewed at www.asam.net/license
+ *
+ * More Information on ASAM OpenCRG can be found here:
+ * https://www.asam.net/standards/detail/opencrg/
+ *
+ */
+
+/* ====== INCLUSIONS ====== */
+#ifdef __linux__
+#define _GNU_SOURCE     /* pthread_setaffinity_np() */
+#endif
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+#include "crgBaseLibPrivate.h"
+
+/* ====== TYPE DEFINITIONS ====== */
+typedef struct
+{
+    int     index;          /* thread index                                [-] */
+    int*    cpIds;          /* contact points of this thread               [-] */
+    double  startTime;      /* time at which the replay started           [ns] */
+    double  endTime;        /* time at which the replay finished          [ns] */
+    double  checksum;       /* sum of all results, keeps the queries alive [m] */
+    long    noQueries;      /* number of queries issued                    [-] */
+    long    noErrors;       /* number of failed queries                    [-] */
+} ThreadDataStruct;
+
+/* ====== LOCAL VARIABLES ====== */
+static double* sTestX    = NULL;    /* x positions of the trajectory           */
+static double* sTestY    = NULL;    /* y positions of the trajectory           */
+static int*    sTestCp   = NULL;    /* wheel (i.e. contact point) of the point */
+static size_t  sNoTestPts = 0;      /* number of trajectory points             */
+static int     sNoReps    = 3;      /* replays of the trajectory per thread    */
+static int     sNoCpPerThread = 4;  /* contact points per thread               */
+static int     sPinThreads = 0;     /* pin thread i to CPU i?                  */
+
+static pthread_mutex_t sStartMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  sStartCond  = PTHREAD_COND_INITIALIZER;
+static int             sStartFlag  = 0;
+
+/* ====== LOCAL METHODS ====== */
+static void  usage( void );
+static int   createTrajectory( int dataSetId, int cpId );
+static void* runThread( void* arg );
+static int   runTest( int dataSetId, int noThreads, double* qps, double* minThreadQps, double* maxThreadQps );
+
+static void
+usage( void )
+{
+    crgMsgPrint( dCrgMsgLevelNotice, "usage: crgScaling [options] <filename>\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       options: -h         show this info\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -t <n>     maximum number of threads (default: number of CPUs)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -cp <n>    number of contact points per thread (default: 4)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -r <n>     number of trajectory replays per thread (default: 3)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -p         pin thread i to CPU i (Linux only)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       <filename> use indicated file as input file\n" );
+    exit( -1 );
+}
+
+int main( int argc, char** argv )
+{
+    char*  filename = NULL;
+    int    dataSetId;
+    int    cpId;
+    int    maxThreads;
+    int    noThreads;
+    int    i;
+    double qps;
+    double qps1 = 0.0;
+    double minThreadQps;
+    double maxThreadQps;
+
+    maxThreads = ( int ) sysconf( _SC_NPROCESSORS_ONLN );
+
+    /* --- decode the command line --- */
+    for ( i = 1; i < argc; i++ )
+    {
+        if ( !strcmp( argv[i], "-h" ) )
+            usage();
+        else if ( !strcmp( argv[i], "-p" ) )
+            sPinThreads = 1;
+        else if ( !strcmp( argv[i], "-t" ) && i + 1 < argc )
+            maxThreads = atoi( argv[++i] );
+        else if ( !strcmp( argv[i], "-cp" ) && i + 1 < argc )
+            sNoCpPerThread = atoi( argv[++i] );
+        else if ( !strcmp( argv[i], "-r" ) && i + 1 < argc )
+            sNoReps = atoi( argv[++i] );
+        else if ( i == argc - 1 ) /* last argument is the filename */
+            filename = argv[i];
+        else
+            usage();
+    }
+
+    if ( !filename || maxThreads < 1 || sNoCpPerThread < 1 || sNoReps < 1 )
+        usage();
+
+    /* --- now load the file --- */
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+
+    if ( ( dataSetId = crgLoaderReadFile( filename ) ) <= 0 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "main: error reading data.\n" );
+        usage();
+    }
+
+    if ( !crgCheck( dataSetId ) )
+    {
+        crgMsgPrint ( dCrgMsgLevelFatal, "main: could not validate crg data. \n" );
+        return -1;
+    }
+
+    crgDataSetModifiersApply( dataSetId );
+
+    /* --- trajectory is computed with a temporary contact point --- */
+    if ( ( cpId = crgContactPointCreate( dataSetId ) ) < 0 || !createTrajectory( dataSetId, cpId ) )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "main: could not create trajectory.\n" );
+        return -1;
+    }
+
+    crgContactPointDelete( cpId );
+
+    fprintf( stdout, "threads,cpPerThread,queries,wall_s,queries_per_s,speedup,efficiency,min_thread_qps,max_thread_qps\n" );
+
+    for ( noThreads = 1; noThreads <= maxThreads; noThreads++ )
+    {
+        if ( !runTest( dataSetId, noThreads, &qps, &minThreadQps, &maxThreadQps ) )
+            return -1;
+
+        if ( noThreads == 1 )
+            qps1 = qps;
+
+        fprintf( stdout, "%d,%d,%ld,%.4f,%.0f,%.3f,%.3f,%.0f,%.0f\n", noThreads, sNoCpPerThread,
+                 ( long ) ( sNoTestPts * sNoReps * noThreads ), ( sNoTestPts * sNoReps * noThreads ) / qps,
+                 qps, qps / qps1, qps / qps1 / noThreads, minThreadQps, maxThreadQps );
+        fflush( stdout );
+    }
+
+    crgDataSetRelease( dataSetId );
+
+    free( sTestX );
+    free( sTestY );
+    free( sTestCp );
+
+    return 0;
+}
+
+/**
+* compute the trajectory of a car with four wheels and a patch of n by n
+* points under each wheel running along the data set (see test/PerfTest)
+*/
+static int
+createTrajectory( int dataSetId, int cpId )
+{
+    double wheelPatchWidth  = 0.1;   /* [m] width of the patch under a wheel                */
+    double wheelPatchLength = 0.1;   /* [m] length of the patch under a wheel               */
+    int    noPtsPatchWidth  =  10;   /* [-] number of tesselation points along patch width  */
+    int    noPtsPatchLength =  10;   /* [-] number of tesselation points along patch length */
+    int    noWheels         =   4;   /* [-] number of wheels                                */
+
+    double wheelBase = 2.50;     /* [m] distance from front to rear axle  */
+    double wheelDist = 1.45;     /* [m] distance from left to right wheel */
+    double stepSizeU = 0.01;     /* [m] per time step                     */
+
+    double uMin;
+    double uMax;
+    double u;
+    double x;
+    double y;
+    double phi;
+    double curv;
+    size_t idx = 0;
+    int    i;
+    int    j;
+    int    k;
+
+    crgDataSetGetURange( dataSetId, &uMin, &uMax );
+
+    sNoTestPts = ( size_t ) ( ( ( uMax - uMin ) * noPtsPatchWidth * noPtsPatchLength * noWheels / stepSizeU ) + 0.5 );
+
+    sTestX  = ( double* ) calloc( sNoTestPts, sizeof( double ) );
+    sTestY  = ( double* ) calloc( sNoTestPts, sizeof( double ) );
+    sTestCp = ( int* )    calloc( sNoTestPts, sizeof( int ) );
+
+    if ( !sTestX || !sTestY || !sTestCp )
+        return 0;
+
+    for ( u = uMin; u < uMax && idx + noWheels * noPtsPatchWidth * noPtsPatchLength <= sNoTestPts; u += stepSizeU )
+    {
+        if ( !crgEvaluv2xy( cpId, u, 0.0, &x, &y ) )
+            continue;
+
+        crgEvaluv2pk( cpId, u, 0.0, &phi, &curv );
+
+        for ( i = 0; i < noWheels; i++ )
+        {
+            double dx = ( i < 2 ) ? 0.0 : wheelBase;
+            double dy = ( i % 2 ) ? -0.5 * wheelDist : 0.5 * wheelDist;
+
+            for ( j = 0; j < noPtsPatchLength; j++ )
+            {
+                double wx = dx - 0.5 * wheelPatchLength + ( wheelPatchLength / ( noPtsPatchLength - 1 ) ) * j;
+
+                for ( k = 0; k < noPtsPatchWidth; k++ )
+                {
+                    double wy = dy - 0.5 * wheelPatchWidth + ( wheelPatchWidth / ( noPtsPatchWidth - 1 ) ) * k;
+
+                    sTestX[idx]  = x + wx * cos( phi ) - wy * sin( phi );
+                    sTestY[idx]  = y + wy * cos( phi ) + wx * sin( phi );
+                    sTestCp[idx] = i;
+                    idx++;
+                }
+            }
+        }
+    }
+
+    sNoTestPts = idx;
+
+    crgMsgPrint( dCrgMsgLevelNotice, "createTrajectory: generated %ld test points.\n", ( long ) sNoTestPts );
+
+    return sNoTestPts > 0;
+}
+
+static void*
+runThread( void* arg )
+{
+    ThreadDataStruct* data = ( ThreadDataStruct* ) arg;
+    size_t idx;
+    double z;
+    int    rep;
+
+#ifdef __linux__
+    if ( sPinThreads )
+    {
+        cpu_set_t cpuSet;
+
+        CPU_ZERO( &cpuSet );
+        CPU_SET( data->index, &cpuSet );
+
+        if ( pthread_setaffinity_np( pthread_self(), sizeof( cpuSet ), &cpuSet ) )
+            crgMsgPrint( dCrgMsgLevelWarn, "runThread: could not pin thread %d.\n", data->index );
+    }
+#endif
+
+    /* --- wait until all threads are ready --- */
+    pthread_mutex_lock( &sStartMutex );
+
+    while ( !sStartFlag )
+        pthread_cond_wait( &sStartCond, &sStartMutex );
+
+    pthread_mutex_unlock( &sStartMutex );
+
+    data->startTime = crgPortGetTime();
+
+    for ( rep = 0; rep < sNoReps; rep++ )
+    {
+        for ( idx = 0; idx < sNoTestPts; idx++ )
+        {
+            if ( crgEvalxy2z( data->cpIds[sTestCp[idx] % sNoCpPerThread], sTestX[idx], sTestY[idx], &z ) )
+                data->checksum += z;
+            else
+                data->noErrors++;
+        }
+    }
+
+    data->endTime   = crgPortGetTime();
+    data->noQueries = ( long ) ( sNoTestPts * sNoReps );
+
+    return NULL;
+}
+
+static int
+runTest( int dataSetId, int noThreads, double* qps, double* minThreadQps, double* maxThreadQps )
+{
+    ThreadDataStruct* data;
+    pthread_t* threads;
+    double startTime = 0.0;
+    double endTime   = 0.0;
+    int    i;
+    int    j;
+
+    data    = ( ThreadDataStruct* ) calloc( noThreads, sizeof( ThreadDataStruct ) );
+    threads = ( pthread_t* ) calloc( noThreads, sizeof( pthread_t ) );
+
+    if ( !data || !threads )
+        return 0;
+
+    /* --- the contact point registry is not thread-safe, so create all contact points up front --- */
+    for ( i = 0; i < noThreads; i++ )
+    {
+        data[i].index = i;
+        data[i].cpIds = ( int* ) calloc( sNoCpPerThread, sizeof( int ) );
+
+        if ( !data[i].cpIds )
+            return 0;
+
+        for ( j = 0; j < sNoCpPerThread; j++ )
+        {
+            if ( ( data[i].cpIds[j] = crgContactPointCreate( dataSetId ) ) < 0 )
+            {
+                crgMsgPrint( dCrgMsgLevelFatal, "runTest: could not create contact point.\n" );
+                return 0;
+            }
+        }
+    }
+
+    sStartFlag = 0;
+
+    for ( i = 0; i < noThreads; i++ )
+    {
+        if ( pthread_create( &threads[i], NULL, runThread, &data[i] ) )
+        {
+            crgMsgPrint( dCrgMsgLevelFatal, "runTest: could not create thread %d.\n", i );
+            return 0;
+        }
+    }
+
+    /* --- release all threads at once --- */
+    pthread_mutex_lock( &sStartMutex );
+    sStartFlag = 1;
+    pthread_cond_broadcast( &sStartCond );
+    pthread_mutex_unlock( &sStartMutex );
+
+    for ( i = 0; i < noThreads; i++ )
+        pthread_join( threads[i], NULL );
+
+    *minThreadQps = 0.0;
+    *maxThreadQps = 0.0;
+
+    for ( i = 0; i < noThreads; i++ )
+    {
+        double threadQps = 1.0e9 * data[i].noQueries / ( data[i].endTime - data[i].startTime );
+
+        if ( !i || data[i].startTime < startTime )
+            startTime = data[i].startTime;
+
+        if ( !i || data[i].endTime > endTime )
+            endTime = data[i].endTime;
+
+        if ( !i || threadQps < *minThreadQps )
+            *minThreadQps = threadQps;
+
+        if ( !i || threadQps > *maxThreadQps )
+            *maxThreadQps = threadQps;
+
+        if ( data[i].noErrors )
+            crgMsgPrint( dCrgMsgLevelWarn, "runTest: thread %d: %ld failed queries.\n", i, data[i].noErrors );
+
+        for ( j = 0; j < sNoCpPerThread; j++ )
+            crgContactPointDelete( data[i].cpIds[j] );
+
+        free( data[i].cpIds );
+    }
+
+    *qps = 1.0e9 * ( double ) sNoTestPts * sNoReps * noThreads / ( endTime - startTime );
+
+    free( data );
+    free( threads );
+
+    return 1;
+}
@@ -0,0 +1,360 @@
+/* ===================================================
+ *  main program for testing the streaming CRG writer:
+ *  a synthetic road profile according to ISO 8608 is
+ *  written record by record, read back by the loader
+ *  and compared to the generated values; the road
+ *  class is determined again from the file
+ * ---------------------------------------------------
+ *
+ * ASAM OpenCRG C API
+ *
+ * OpenCRG version:           1.2.0
+ *
+ * package:               test/Writer
+ * file name:             main.c
+ * author:                ASAM e.V.
+ *
+ *
+ * C by ASAM e.V., 2020
+ * Any use is limited to the scope described in the license terms.
+ * The license terms can be viewed at www.asam.net/license
+ *
+ * More Information on ASAM OpenCRG can be found here:
+ * https://www.asam.net/standards/detail/opencrg/
+ *
+ */
+
+/* ====== INCLUSIONS ====== */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "crgBaseLibPrivate.h"
+
+/* ====== DEFINITIONS ====== */
+#define dNoWaves        100     /* number of harmonics per profile                      [-] */
+#define dSpatFreqMin    0.011   /* lowest spatial frequency (ISO 8608)            [cycles/m] */
+#define dSpatFreqMax    2.83    /* highest spatial frequency (ISO 8608)           [cycles/m] */
+#define dSpatFreqRef    0.1     /* reference spatial frequency n0 (ISO 8608)      [cycles/m] */
+#define dMaxSections    4096    /* max. number of long sections                         [-] */
+#define dPi             3.14159265358979323846
+
+/* ====== TYPE DEFINITIONS ====== */
+/**
+* a profile given by the sum of harmonics; the harmonics are rotated by
+* one increment per record so that no trigonometric functions are evaluated
+*/
+typedef struct
+{
+    double re[dNoWaves];        /* current phasors, real part                           [m] */
+    double im[dNoWaves];        /* current phasors, imaginary part                      [m] */
+    double cosInc[dNoWaves];    /* rotation per increment, real part                    [-] */
+    double sinInc[dNoWaves];    /* rotation per increment, imaginary part               [-] */
+} ProfileStruct;
+
+/* ====== LOCAL VARIABLES ====== */
+static double        sLength    = 5000.0;              /* length of the road               [m] */
+static double        sUInc      = 0.05;                /* increment in u direction         [m] */
+static double        sWidth     = 4.0;                 /* width of the road                [m] */
+static double        sVInc      = 0.1;                 /* increment in v direction         [m] */
+static char          sClass     = 'C';                 /* road class according to ISO 8608 [-] */
+static int           sFormat    = dCrgWriterFormatKRBI;
+static unsigned long sSeed      = 1;                   /* seed of the random phases        [-] */
+static const char*   sFilename  = "crgWriterTest.crg";
+static const char*   sRefFile   = "crgWriterTestKRBI.crg";   /* same road in KRBI, for comparing the read time */
+static int           sKeepFile  = 0;
+static unsigned long sRandState;
+
+/* ====== LOCAL METHODS ====== */
+static void   usage( void );
+static double randomPhase( void );
+static void   initProfile( ProfileStruct* profile, double gdRef );
+static double nextValue( ProfileStruct* profile );
+static void   initRoad( ProfileStruct* heave, ProfileStruct* roll );
+static void   nextRecord( ProfileStruct* heave, ProfileStruct* roll, double* z, int noSections );
+static int    writeRoad( const char* filename, int format, long noRecords, int noSections, double* z );
+
+static void
+usage( void )
+{
+    crgMsgPrint( dCrgMsgLevelNotice, "usage: crgWriterTest [options]\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "       options: -h         show this info\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -l <len>   length of the road [m] (default: 5000)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -u <inc>   increment in u direction [m] (default: 0.05)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -w <width> width of the road [m] (default: 4)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -v <inc>   increment in v direction [m] (default: 0.1)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -c <class> road class A..H according to ISO 8608 (default: C)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -s <seed>  seed of the random phases (default: 1)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -d         write double precision (KDBI) instead of single precision (KRBI)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -z         write compressed single precision (KRBZ) instead of KRBI\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -o <file>  name of the file to be written (default: crgWriterTest.crg)\n" );
+    crgMsgPrint( dCrgMsgLevelNotice, "                -k         keep the file\n" );
+    exit( -1 );
+}
+
+int main( int argc, char** argv )
+{
+    ProfileStruct heave;
+    ProfileStruct roll;
+    double*       z;
+    double        zRef;
+    double        zEval;
+    double        dev = 0.0;
+    double        t0;
+    double        tWrite;
+    double        tRead;
+    double        tReadRef;
+    double        uMin;
+    double        uMax;
+    double        vMin;
+    double        vMax;
+    long          noRecords;
+    long          i;
+    int           noSections;
+    int           dataSetId;
+    int           refId;
+    int           cpId;
+    int           j;
+    CrgRoughnessStruct roughLeft;
+    CrgRoughnessStruct roughRight;
+    FILE*         fPtr;
+    long          fileSize = 0;
+
+    /* --- decode the command line --- */
+    for ( i = 1; i < argc; i++ )
+    {
+        if ( !strcmp( argv[i], "-d" ) )
+            sFormat = dCrgWriterFormatKDBI;
+        else if ( !strcmp( argv[i], "-z" ) )
+            sFormat = dCrgWriterFormatKRBZ;
+        else if ( !strcmp( argv[i], "-k" ) )
+            sKeepFile = 1;
+        else if ( argv[i][0] != '-' || argv[i][1] == 'h' || i + 1 >= argc )
+            usage();
+        else if ( !strcmp( argv[i], "-l" ) )
+            sLength = atof( argv[++i] );
+        else if ( !strcmp( argv[i], "-u" ) )
+            sUInc = atof( argv[++i] );
+        else if ( !strcmp( argv[i], "-w" ) )
+            sWidth = atof( argv[++i] );
+        else if ( !strcmp( argv[i], "-v" ) )
+            sVInc = atof( argv[++i] );
+        else if ( !strcmp( argv[i], "-c" ) )
+            sClass = argv[++i][0];
+        else if ( !strcmp( argv[i], "-s" ) )
+            sSeed = strtoul( argv[++i], NULL, 10 );
+        else if ( !strcmp( argv[i], "-o" ) )
+            sFilename = argv[++i];
+        else
+            usage();
+    }
+
+    if ( sClass >= 'a' && sClass <= 'h' )
+        sClass += 'A' - 'a';
+
+    if ( sClass < 'A' || sClass > 'H' || sUInc <= 0.0 || sVInc <= 0.0 || sLength < sUInc || sWidth < sVInc )
+        usage();
+
+    noRecords  = ( long ) ( sLength / sUInc + 0.5 ) + 1;
+    noSections = ( int ) ( sWidth / sVInc + 0.5 ) + 1;
+
+    if ( noSections > dMaxSections )
+        usage();
+
+    z = ( double* ) calloc( noSections, sizeof( double ) );
+
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+
+    /* --- generate and write the road record by record --- */
+    t0 = crgPortGetTime();
+
+    if ( !writeRoad( sFilename, sFormat, noRecords, noSections, z ) )
+        return -1;
+
+    tWrite = 1.0e-6 * ( crgPortGetTime() - t0 );
+
+    if ( ( fPtr = fopen( sFilename, "rb" ) ) )
+    {
+        fseek( fPtr, 0, SEEK_END );
+        fileSize = ftell( fPtr );
+        fclose( fPtr );
+    }
+
+    /* --- read the file and compare the values at the grid nodes with the generated ones --- */
+    t0 = crgPortGetTime();
+
+    if ( ( dataSetId = crgLoaderReadFile( sFilename ) ) <= 0 )
+        return -1;
+
+    tRead = 1.0e-6 * ( crgPortGetTime() - t0 );
+
+    /* --- the read time of other formats is compared to the one of the same road in KRBI --- */
+    tReadRef = tRead;
+
+    if ( sFormat != dCrgWriterFormatKRBI )
+    {
+        if ( !writeRoad( sRefFile, dCrgWriterFormatKRBI, noRecords, noSections, z ) )
+            return -1;
+
+        t0 = crgPortGetTime();
+
+        if ( ( refId = crgLoaderReadFile( sRefFile ) ) <= 0 )
+            return -1;
+
+        tReadRef = 1.0e-6 * ( crgPortGetTime() - t0 );
+
+        crgDataSetRelease( refId );
+        remove( sRefFile );
+    }
+
+    crgDataSetGetURange( dataSetId, &uMin, &uMax );
+    crgDataSetGetVRange( dataSetId, &vMin, &vMax );
+
+    if ( fabs( uMin ) > 1.0e-9 || fabs( uMax - ( noRecords - 1 ) * sUInc ) > 1.0e-6
+      || fabs( vMax - vMin - ( noSections - 1 ) * sVInc ) > 1.0e-6 )
+    {
+        crgMsgPrint( dCrgMsgLevelFatal, "main: wrong range u = [%.6f, %.6f], v = [%.6f, %.6f]\n", uMin, uMax, vMin, vMax );
+        return -1;
+    }
+
+    cpId = crgContactPointCreate( dataSetId );
+
+    initRoad( &heave, &roll );
+
+    for ( i = 0; i < noRecords; i++ )
+    {
+        nextRecord( &heave, &roll, z, noSections );
+
+        for ( j = 0; j < noSections; j++ )
+        {
+            /* --- the loader keeps z values in single precision --- */
+            zRef = ( float ) z[j];
+
+            if ( !crgEvaluv2z( cpId, i * sUInc, vMin + j * sVInc, &zEval ) || zEval != zEval )
+                dev = 1.0e30;
+            else if ( fabs( zEval - zRef ) > dev )
+                dev = fabs( zEval - zRef );
+        }
+    }
+
+    /* --- the tracks at the borders have the PSD of the class --- */
+    if ( !crgDataSetCalcRoughness( dataSetId, vMin, 0.0, &roughLeft ) || !crgDataSetCalcRoughness( dataSetId, vMax, 0.0, &roughRight ) )
+        return -1;
+
+    printf( "file,class,records,sections,file_mb,write_ms,write_mb_s,read_ms,read_mvalues_s,read_ms_krbi,read_ratio_krbi,max_dev_z,gd_left,gd_right,class_left,class_right\n" );
+    printf( "%s,%c,%ld,%d,%.3f,%.3f,%.1f,%.3f,%.1f,%.3f,%.2f,%g,%.3e,%.3e,%c,%c\n", sFilename, sClass, noRecords, noSections,
+            1.0e-6 * fileSize, tWrite, 1.0e-3 * fileSize / tWrite, tRead, 1.0e-3 * noRecords * noSections / tRead,
+            tReadRef, tRead / tReadRef, dev,
+            roughLeft.gdN0, roughRight.gdN0, 'A' + roughLeft.isoClass, 'A' + roughRight.isoClass );
+
+    crgContactPointDelete( cpId );
+    crgDataSetRelease( dataSetId );
+    crgMemRelease();
+    free( z );
+
+    if ( !sKeepFile )
+        remove( sFilename );
+
+    return ( dev < 1.0e-6 && 'A' + roughLeft.isoClass == sClass && 'A' + roughRight.isoClass == sClass ) ? 0 : -1;
+}
+
+static double
+randomPhase( void )
+{
+    /* --- a generator of its own makes the profiles reproducible on all platforms --- */
+    sRandState = ( sRandState * 1103515245UL + 12345UL ) & 0xffffffffUL;
+
+    return 2.0 * dPi * ( sRandState >> 8 ) / 16777216.0;
+}
+
+static void
+initProfile( ProfileStruct* profile, double gdRef )
+{
+    double dn = ( dSpatFreqMax - dSpatFreqMin ) / dNoWaves;
+    double n;
+    double amp;
+    double phase;
+    int    k;
+
+    for ( k = 0; k < dNoWaves; k++ )
+    {
+        /* --- displacement PSD Gd(n) = Gd(n0) * ( n / n0 )^-2 --- */
+        n     = dSpatFreqMin + ( k + 0.5 ) * dn;
+        amp   = sqrt( 2.0 * gdRef * pow( n / dSpatFreqRef, -2.0 ) * dn );
+        phase = randomPhase();
+
+        profile->re[k]     = amp * cos( phase );
+        profile->im[k]     = amp * sin( phase );
+        profile->cosInc[k] = cos( 2.0 * dPi * n * sUInc );
+        profile->sinInc[k] = sin( 2.0 * dPi * n * sUInc );
+    }
+}
+
+static double
+nextValue( ProfileStruct* profile )
+{
+    double value = 0.0;
+    double re;
+    int    k;
+
+    for ( k = 0; k < dNoWaves; k++ )
+    {
+        value += profile->re[k];
+
+        re              = profile->re[k] * profile->cosInc[k] - profile->im[k] * profile->sinInc[k];
+        profile->im[k]  = profile->re[k] * profile->sinInc[k] + profile->im[k] * profile->cosInc[k];
+        profile->re[k]  = re;
+    }
+
+    return value;
+}
+
+static void
+initRoad( ProfileStruct* heave, ProfileStruct* roll )
+{
+    /* --- Gd(n0) of the class is the geometric mean of its range: 16e-6 m^3 for A, times 4 per class --- */
+    double gdRef = 16.0e-6 * pow( 4.0, sClass - 'A' );
+
+    sRandState = sSeed;
+
+    initProfile( heave, gdRef );
+    initProfile( roll,  gdRef );
+}
+
+static void
+nextRecord( ProfileStruct* heave, ProfileStruct* roll, double* z, int noSections )
+{
+    double zHeave = nextValue( heave );
+    double zRoll  = nextValue( roll );
+    int    j;
+
+    /* --- two uncorrelated tracks of the given class at the borders, linear in between --- */
+    for ( j = 0; j < noSections; j++ )
+        z[j] = sqrt( 0.5 ) * ( zHeave + zRoll * ( 2.0 * j / ( noSections - 1 ) - 1.0 ) );
+}
+
+static int
+writeRoad( const char* filename, int format, long noRecords, int noSections, double* z )
+{
+    ProfileStruct heave;
+    ProfileStruct roll;
+    long          i;
+    int           writerId;
+
+    if ( !( writerId = crgWriterOpen( filename, format, sUInc, -0.5 * ( noSections - 1 ) * sVInc, sVInc, noSections ) ) )
+        return 0;
+
+    crgWriterAddComment( writerId, "synthetic road profile according to ISO 8608\nwritten by crgWriterTest" );
+
+    initRoad( &heave, &roll );
+
+    for ( i = 0; i < noRecords; i++ )
+    {
+        nextRecord( &heave, &roll, z, noSections );
+
+        if ( !crgWriterAppendRecord( writerId, z ) )
+            break;
+    }
+
+    return crgWriterClose( writerId );
+}
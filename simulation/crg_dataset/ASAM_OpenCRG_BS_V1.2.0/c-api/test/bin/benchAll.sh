@@ -0,0 +1,16 @@
+#!/bin/sh
+#
+# run the benchmark suite on all sample data sets
+# usage: benchAll.sh [<result file>] [additional crgBench options]
+#
+
+DATA_DIR='../../..'
+RESULT=${1:-benchResult.csv}
+
+if [ $# -gt 0 ] ; then
+    shift
+fi
+
+./crgBench "$@" -o $RESULT $DATA_DIR/crg-bin/*.crg $DATA_DIR/crg-txt/*.crg
+
+echo "results written to $RESULT"
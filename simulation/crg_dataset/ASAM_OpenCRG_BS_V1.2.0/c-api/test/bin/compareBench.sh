@@ -0,0 +1,41 @@
+#!/bin/sh
+#
+# compare two result files of crgBench (CSV format) and flag regressions
+# usage: compareBench.sh <reference file> <current file> [<threshold in %>]
+# a benchmark is flagged if its median time per query (p50) exceeds the
+# reference by more than the threshold (default: 10%); the exit code is
+# the number of regressions (0 = no regression)
+#
+
+if [ $# -lt 2 ] ; then
+    echo "usage: compareBench.sh <reference file> <current file> [<threshold in %>]"
+    exit 255
+fi
+
+THRESHOLD=${3:-10}
+
+awk -F, -v threshold=$THRESHOLD '
+    FNR == 1 { next }
+    NR == FNR { ref[$1 "," $2] = $6; next }
+    {
+        key = $1 "," $2
+        if ( !( key in ref ) ) {
+            printf( "NEW:        %-60s %-6s p50 = %10.1f ns\n", $1, $2, $6 )
+            next
+        }
+        change = ( ref[key] > 0 ) ? 100.0 * ( $6 - ref[key] ) / ref[key] : 0.0
+        if ( change > threshold ) {
+            status = "REGRESSION:"
+            noRegressions++
+        }
+        else if ( change < -threshold )
+            status = "IMPROVED:  "
+        else
+            status = "OK:        "
+        printf( "%s %-60s %-6s p50 = %10.1f ns (reference: %10.1f ns, %+6.1f%%)\n", status, $1, $2, $6, ref[key], change )
+    }
+    END {
+        printf( "%d regression(s) beyond %s%%\n", noRegressions, threshold )
+        exit ( noRegressions > 254 ) ? 254 : noRegressions
+    }
+' "$1" "$2"
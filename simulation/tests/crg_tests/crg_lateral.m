@@ -63,7 +63,14 @@ end
 
 %% ----------------- Lateral Variation Plotting -----------------
 function crg_lateral_variation(crg_file)
-    data = crg_read(crg_file);
+    % Native evaluation via crg_mex if compiled (see build_crg_mex)
+    use_mex = exist('crg_mex', 'file') == 3;
+    if use_mex
+        h = crg_mex('open', crg_file);
+        data.head = crg_mex('info', h);
+    else
+        data = crg_read(crg_file);
+    end
     [~, crg_fname, crg_ext] = fileparts(crg_file);
     crg_title = [crg_fname, crg_ext];
 
@@ -80,12 +87,16 @@ function crg_lateral_variation(crg_file)
         error('Invalid longitudinal bounds in CRG header.');
     end
 
-    Z_map = zeros(length(v_values), length(s_values));
+    if use_mex
+        Z_map = crg_mex('uvgrid', h, s_values, v_values);
+    else
+        Z_map = zeros(length(v_values), length(s_values));
 
-    for i = 1:length(v_values)
-        uv = [s_values; v_values(i)*ones(size(s_values))]';
-        z = crg_eval_uv2z(data, uv);
-        Z_map(i, :) = z;
+        for i = 1:length(v_values)
+            uv = [s_values; v_values(i)*ones(size(s_values))]';
+            z = crg_eval_uv2z(data, uv);
+            Z_map(i, :) = z;
+        end
     end
 
     plot_lateral_profiles(s_values, v_values, Z_map, crg_title);
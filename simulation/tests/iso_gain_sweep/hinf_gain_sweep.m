@@ -55,31 +55,45 @@ for i = 1:numel(road_classes)
     Q_base = base{1};
     gamma_base = base{2};
 
-    all_results = struct();
+    scale_gain = @(scale) {Q_base, gamma_base * scale};  % Scale only gamma
 
     fprintf('\n===== ISO Class %s =====\n', iso_class);
 
     for k = 1:numel(scales)
         scale = scales(k);
-        gamma_scaled = gamma_base * scale;
-        gains = {Q_base, gamma_scaled};  % Scale only gamma
+        scaled_gain = scale_gain(scale);
+        fprintf('gamma scale: %.1f, R_hinf = %.4f\n', scale, scaled_gain{2});
+    end
 
-        label = sprintf('%s - %s - gamma x%.1f', controller, iso_class, scale);
-        key = matlab.lang.makeValidName(label);
+    gain_sets = arrayfun(scale_gain, scales, 'UniformOutput', false);
+    out_dir = results_dir(iso_class);
+
+    % All gain scales are simulated at once on the same road
+    try
+        [t, Y] = run_batch_control(controller, A, B, T_plot, u, x0, gain_sets, 'OutputDir', out_dir);
+        results = arrayfun(@(k) struct('t', t, 'y', Y(:, :, k), 'failed', all(isnan(reshape(Y(:, :, k), [], 1)))), ...
+            1:numel(scales), 'UniformOutput', false);
+    catch err
+        % Otherwise the gain scales are simulated independently on the sweep runner
+        warning(err.identifier, 'Batched simulation failed, simulating gain scales separately: %s', err.message);
+        scenarios = sweep_grid(struct('scale', scales));
+        results = run_sweep(scenarios, @(sc) simulate_scale(controller_func, A, B, T_plot, u, x0, scale_gain(sc.scale)), ...
+            'OutputDir', out_dir);
+    end
 
-        try
-            fprintf('gamma scale: %.1f, R_hinf = %.4f\n', scale, gamma_scaled);
+    all_results = struct();
+    for k = 1:numel(scales)
+        label = sprintf('%s - %s - gamma x%.1f', controller, iso_class, scales(k));
+        key = matlab.lang.makeValidName(label);
 
-            [all_results.(key).t, all_results.(key).y] = controller_func(A, B, T_plot, u, x0, gains);
-            all_results.(key).label = label;
-            all_results.(key).speed = simulation_speed;
-        catch err
-            warning(err.identifier, 'Simulation failed: %s', err.message);
-            all_results.(key).t = [];
-            all_results.(key).y = [];
+        all_results.(key).t = results{k}.t;
+        all_results.(key).y = results{k}.y;
+        if results{k}.failed
             all_results.(key).label = [label, ' (error)'];
-            all_results.(key).speed = simulation_speed;
+        else
+            all_results.(key).label = label;
         end
+        all_results.(key).speed = simulation_speed;
     end
 
     %% ----------------- Plot Results -----------------
@@ -88,3 +102,16 @@ for i = 1:numel(road_classes)
     plot_results(T_plot * simulation_speed, u, title_str, road_title, all_results, plot_flag);
     fprintf('------------------------------\n');
 end
+
+%% ----------------- Local Functions -----------------
+function result = simulate_scale(controller_func, A, B, T, u, x0, gains)
+    try
+        [result.t, result.y] = controller_func(A, B, T, u, x0, gains);
+        result.failed = false;
+    catch err
+        warning(err.identifier, 'Simulation failed: %s', err.message);
+        result.t = [];
+        result.y = [];
+        result.failed = true;
+    end
+end
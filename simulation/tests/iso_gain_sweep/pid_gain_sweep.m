@@ -53,31 +53,46 @@ for i = 1:numel(road_classes)
 
     base_gain = gain_map.(controller).(iso_class);  % [Kp, Ki, Kd]
 
-    all_results = struct();
+    scale_gain = @(scale) cellfun(@(x) x * scale, base_gain, 'UniformOutput', false);
 
     fprintf('\n===== ISO Class %s =====\n', iso_class);
 
     for k = 1:numel(scales)
         scale = scales(k);
-        scaled_gain = cellfun(@(x) x * scale, base_gain, 'UniformOutput', false);
+        scaled_gain = scale_gain(scale);
+        fprintf('Scale: %.1f, Kp = %.3f, Ki = %.3f, Kd = %.3f\n', ...
+            scale, scaled_gain{1}, scaled_gain{2}, scaled_gain{3});
+    end
 
-        label = sprintf('%s - ISO Profile %s - Gains x%.1f', controller, iso_class, scale);
-        key = matlab.lang.makeValidName(label);
+    gain_sets = arrayfun(scale_gain, scales, 'UniformOutput', false);
+    out_dir = results_dir(iso_class);
+
+    % All gain scales are simulated at once on the same road
+    try
+        [t, Y] = run_batch_control(controller, A, B, T_plot, u, x0, gain_sets, 'OutputDir', out_dir);
+        results = arrayfun(@(k) struct('t', t, 'y', Y(:, :, k), 'failed', all(isnan(reshape(Y(:, :, k), [], 1)))), ...
+            1:numel(scales), 'UniformOutput', false);
+    catch err
+        % Otherwise the gain scales are simulated independently on the sweep runner
+        warning(err.identifier, 'Batched simulation failed, simulating gain scales separately: %s', err.message);
+        scenarios = sweep_grid(struct('scale', scales));
+        results = run_sweep(scenarios, @(sc) simulate_scale(controller_func, A, B, T_plot, u, x0, scale_gain(sc.scale)), ...
+            'OutputDir', out_dir);
+    end
 
-        try
-            fprintf('Scale: %.1f, Kp = %.3f, Ki = %.3f, Kd = %.3f\n', ...
-                scale, scaled_gain{1}, scaled_gain{2}, scaled_gain{3});
+    all_results = struct();
+    for k = 1:numel(scales)
+        label = sprintf('%s - ISO Profile %s - Gains x%.1f', controller, iso_class, scales(k));
+        key = matlab.lang.makeValidName(label);
 
-            [all_results.(key).t, all_results.(key).y] = controller_func(A, B, T_plot, u, x0, scaled_gain);
-            all_results.(key).label = label;
-            all_results.(key).speed = simulation_speed;
-        catch err
-            warning(err.identifier, 'Simulation failed: %s', err.message);
-            all_results.(key).t = [];
-            all_results.(key).y = [];
+        all_results.(key).t = results{k}.t;
+        all_results.(key).y = results{k}.y;
+        if results{k}.failed
             all_results.(key).label = [label, ' (error)'];
-            all_results.(key).speed = simulation_speed;
+        else
+            all_results.(key).label = label;
         end
+        all_results.(key).speed = simulation_speed;
     end
 
     %% ----------------- Plot Results -----------------
@@ -86,3 +101,16 @@ for i = 1:numel(road_classes)
     plot_results(T_plot * simulation_speed, u, title_str, road_title, all_results, plot_flag);
     fprintf('------------------------------\n');
 end
+
+%% ----------------- Local Functions -----------------
+function result = simulate_scale(controller_func, A, B, T, u, x0, gains)
+    try
+        [result.t, result.y] = controller_func(A, B, T, u, x0, gains);
+        result.failed = false;
+    catch err
+        warning(err.identifier, 'Simulation failed: %s', err.message);
+        result.t = [];
+        result.y = [];
+        result.failed = true;
+    end
+end
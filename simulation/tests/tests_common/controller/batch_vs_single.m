@@ -0,0 +1,77 @@
+clc;
+clear;
+close all;
+
+%% ----------------- Setup Simulation -----------------
+% Compares the batched gain sweep simulation (run_batch_control) with one
+% run_<controller>_control call per gain set, on an ISO road with the gain
+% scales of the sweep scripts. Both use the same discretization, so they
+% agree up to rounding. Fails if a controller deviates by more than the
+% tolerance, and reports the time of the batch against the single runs.
+if endsWith(pwd, 'simulation')
+    base_path = pwd;
+else
+    base_path = fullfile(pwd, 'simulation');
+end
+
+sub_dirs = {'algo', 'controller', 'init', 'utils'};
+for i = 1:numel(sub_dirs)
+    addpath(fullfile(base_path, sub_dirs{i}));
+end
+
+run(fullfile(base_path, 'init', 'parameters.m'));
+
+%% ----------------- Road and Model -----------------
+iso_class = 'C';
+scales = [0.1, 0.5, 1.0, 2.0, 5.0];
+
+T_plot = 0:resolution:simulation_time;
+u = generate_road_profile(road_len, resolution, T_plot, class_psd_values(strcmp(iso_classes, iso_class)));
+u = u(1:numel(T_plot));
+[A, B] = get_state_space(m_s, m_u, k_s, k_t, b_s);
+
+%% ----------------- Comparison -----------------
+controllers = {'PID', 'SMC', 'LQR', 'Hinf'};
+
+% Largest accepted deviation relative to the largest state value of the
+% single runs; the batch only sums the same products in another order
+tolerance = 1e-9;
+
+failed = {};
+fprintf('\n%-8s %5s %11s %10s %8s %14s %14s\n', 'Control', 'Sets', 'single [s]', 'batch [s]', 'Speedup', 'max |diff|', 'Limit');
+
+for j = 1:numel(controllers)
+    ctrl = controllers{j};
+    gains = gains_lookup().ISO.(ctrl).(iso_class);
+    if any(strcmp(ctrl, {'PID', 'SMC'}))
+        gain_sets = arrayfun(@(scale) cellfun(@(g) g * scale, gains, 'UniformOutput', false), scales, 'UniformOutput', false);
+    else
+        gain_sets = arrayfun(@(scale) {gains{1}, gains{2} * scale}, scales, 'UniformOutput', false);
+    end
+
+    tic;
+    for g = numel(gain_sets):-1:1
+        [~, Y_single(:, :, g)] = feval(['run_', lower(ctrl), '_control'], A, B, T_plot, u, x0, gain_sets{g});
+    end
+    t_single = toc;
+
+    tic;
+    [~, Y_batch] = run_batch_control(ctrl, A, B, T_plot, u, x0, gain_sets);
+    t_batch = toc;
+
+    % Gain sets which fail must fail in both
+    max_diff = max(abs(Y_batch(:) - Y_single(:)));
+    same_nan = isequal(isnan(Y_batch), isnan(Y_single));
+    limit = tolerance * max(abs(Y_single(:)));
+    fprintf('%-8s %5d %11.3f %10.3f %8.1f %14.4g %14.4g\n', ctrl, numel(gain_sets), t_single, t_batch, t_single / max(t_batch, eps), max_diff, limit);
+
+    if ~same_nan || ~(max_diff <= limit)
+        failed{end+1} = sprintf('%s: max |diff| %.4g > %.4g or failed gain sets differ', ctrl, max_diff, limit); %#ok<SAGROW>
+    end
+    clear Y_single;
+end
+
+if ~isempty(failed)
+    error('batch_vs_single:tolerance', 'Batched simulation deviates from single runs:\n  %s', strjoin(failed, '\n  '));
+end
+fprintf('\nAll controllers within tolerance.\n');
@@ -0,0 +1,118 @@
+clc;
+clear;
+close all;
+
+%% ----------------- Setup Simulation -----------------
+% Compares the fixed-step controller simulations (simulate_discrete) with
+% a tightly toleranced ode15s integration of the same control laws from
+% algo/, on an ISO road at the sample step used by the sweep scripts.
+% Fails if a controller deviates by more than its tolerance.
+if endsWith(pwd, 'simulation')
+    base_path = pwd;
+else
+    base_path = fullfile(pwd, 'simulation');
+end
+
+sub_dirs = {'algo', 'controller', 'init', 'utils'};
+for i = 1:numel(sub_dirs)
+    addpath(fullfile(base_path, sub_dirs{i}));
+end
+
+run(fullfile(base_path, 'init', 'parameters.m'));
+
+%% ----------------- Road and Model -----------------
+compare_time = 20;  % Simulated time per run (s), ode15s is slow
+iso_class = 'C';
+scales = [1, 5];
+
+T_plot = 0:resolution:compare_time;
+u = generate_road_profile(road_len, resolution, T_plot, class_psd_values(strcmp(iso_classes, iso_class)));
+u = u(1:numel(T_plot));
+[A, B] = get_state_space(m_s, m_u, k_s, k_t, b_s);
+
+%% ----------------- Comparison -----------------
+controllers = {'Passive', 'PID', 'SMC', 'LQR', 'Hinf'};
+
+% Largest accepted RMS deviation of the quarter car states [%]. Passive, LQR
+% and H-infinity are discretized exactly; PID and SMC hold their feedback
+% over 1 ms, which costs about 0.07 % (PID) and 0.12 % (SMC).
+tolerance = struct('Passive', 0.05, 'PID', 0.5, 'SMC', 1, 'LQR', 0.05, 'Hinf', 0.05);
+
+failed = {};
+fprintf('\n%-8s %6s %12s %12s %14s %10s\n', 'Control', 'Scale', 'ode15s [s]', 'discrete [s]', 'RMS error [%]', 'Limit [%]');
+
+for j = 1:numel(controllers)
+    ctrl = controllers{j};
+    for scale = scales
+        if strcmp(ctrl, 'Passive')
+            if scale ~= 1
+                continue;
+            end
+            gains = {};
+        else
+            gains = gains_lookup().ISO.(ctrl).(iso_class);
+            if any(strcmp(ctrl, {'PID', 'SMC'}))
+                gains = cellfun(@(g) g * scale, gains, 'UniformOutput', false);
+            else
+                gains = {gains{1}, gains{2} * scale};
+            end
+        end
+
+        tic;
+        if strcmp(ctrl, 'Passive')
+            [~, y] = run_passive_control(A, B, T_plot, u, x0);
+        else
+            [~, y] = feval(['run_', lower(ctrl), '_control'], A, B, T_plot, u, x0, gains);
+        end
+        t_discrete = toc;
+
+        % The states are tiny (road input acts as a force), so the absolute
+        % tolerance of the reference follows their magnitude
+        abs_tol = max(1e-8 * max(abs(y), [], 1), 1e-20);
+
+        tic;
+        [~, y_ode] = run_ode_reference(ctrl, A, B, T_plot, u, x0, gains, abs_tol);
+        t_ode = toc;
+
+        % Error of the quarter car states relative to their RMS value
+        err = 100 * max(rms(y(:, 1:4) - y_ode(:, 1:4)) ./ max(rms(y_ode(:, 1:4)), eps));
+        fprintf('%-8s %6.1f %12.3f %12.3f %14.4f %10.2f\n', ctrl, scale, t_ode, t_discrete, err, tolerance.(ctrl));
+
+        if ~(err <= tolerance.(ctrl))
+            failed{end+1} = sprintf('%s (scale %g): %.4f %% > %.2f %%', ctrl, scale, err, tolerance.(ctrl)); %#ok<SAGROW>
+        end
+    end
+end
+
+if ~isempty(failed)
+    error('discrete_vs_ode:tolerance', 'Discrete simulation deviates from ode15s:\n  %s', strjoin(failed, '\n  '));
+end
+fprintf('\nAll controllers within tolerance.\n');
+
+%% ----------------- ode15s Reference -----------------
+% Continuous feedback with the same models and control laws as the controllers
+function [t, y] = run_ode_reference(ctrl, A, B, T, u, x0, gains, abs_tol)
+    road = @(t) interp1(T, u, t, 'linear', 'extrap');
+    switch ctrl
+        case 'Passive'
+            u_filtered = movmean(u, 10);
+            dynamics = @(t, x) A * x + B * interp1(T, u_filtered, t, 'linear', 'extrap');
+        case 'LQR'
+            K = lqr(A, B, gains{1}, gains{2});
+            dynamics = @(t, x) (A - B * K) * x + B * road(t);
+        case 'Hinf'
+            P = care(A, B, gains{1}, gains{2});
+            K = gains{2} \ (B' * P);
+            dynamics = @(t, x) (A - B * K) * x + B * road(t);
+        case 'SMC'
+            C_smc = [1 0 0 0];
+            dynamics = @(t, x) A * x + B * (smc_control(C_smc * x, gains{1}, gains{2}) + road(t));
+        case 'PID'
+            [A, B] = pid_augment(A, B);
+            dynamics = @(t, x) A * x + B * (pid_control(x(end-1), x(end), gains{:}) + road(t));
+            x0 = [x0; 0; 0];
+    end
+
+    options = odeset('RelTol', 1e-8, 'AbsTol', abs_tol);
+    [t, y] = ode15s(dynamics, T, x0, options);
+end
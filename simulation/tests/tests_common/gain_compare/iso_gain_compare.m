@@ -76,132 +76,147 @@ for i = 1:numel(iso_classes)
 
         fprintf('\n----- Controller: %s -----\n', ctrl);
 
-        % Loop through each speed for the current ISO profile and controller
-        for s_idx = 1:numel(speeds_mps)
-            current_speed_mps = speeds_mps(s_idx);
-            current_speed_kmh = speeds_kmh(s_idx);
-            fprintf('\n--- Speed: %.1f km/h (%.2f m/s) ---\n', current_speed_kmh, current_speed_mps);
-
-            simulation_time = road_len / current_speed_mps;
-            T_current_speed = 0:resolution:simulation_time;
-
-            % Resample the base road profile (u_plot_base) for the current speed's time vector.
-            % The interpolation is based on distance.
-            % X_known: distance corresponding to u_plot_base (T_plot_base * speeds_mps(1))
-            % Y_known: u_plot_base elevation values
-            % X_query: distance for current speed's time vector (T_current_speed * current_speed_mps)
-            u_speed = interp1(T_plot_base * speeds_mps(1), u_plot_base, T_current_speed * current_speed_mps, 'linear', 0);
-
-            % Initialize structure to store results for this speed comparison
-            comparison_results_for_this_speed = struct();
-
-            % --- Simulation with FIXED Gains ---
-            fixed_gains = gain_map.(ctrl).(iso_class); % This should be cell array for PID/SMC, struct for LQR/Hinf
-
-            try
-                % Run simulation with fixed gains
-                [t_fixed, y_fixed] = controller_func(A, B, T_current_speed, u_speed, x0, fixed_gains);
-
-                % Store fixed gain results
-                comparison_results_for_this_speed.FixedGain.t = t_fixed;
-                comparison_results_for_this_speed.FixedGain.y = y_fixed;
-                comparison_results_for_this_speed.FixedGain.label = sprintf('%s - Fixed Gain', ctrl);
-                comparison_results_for_this_speed.FixedGain.speed = current_speed_mps;
-
-                % Calculate RMS sprung mass displacement for fixed gains
-                rms_sprung_disp = rms(y_fixed(:,1)); % Assuming y(:,1) is sprung mass displacement
-                fprintf('    RMS Sprung Mass Disp (Fixed Gain): %.10f m\n', rms_sprung_disp);
-
-                % --- Simulation with INTERPOLATED Gains ---
-                % Initialize as empty, type will depend on controller
-                interpolated_gains_for_controller = [];
-
-                try
-                    % Call gain_interpolate. It returns a numeric array for PID/SMC, struct for LQR/Hinf.
-                    raw_interpolated_gains = gain_interpolate(ctrl, rms_sprung_disp, current_speed_mps);
-
-                    % Handle NaN values returned by gain_interpolate, and assign fallback as numeric array
-                    if isnumeric(raw_interpolated_gains) && any(isnan(raw_interpolated_gains))
-                        warning('iso_speed_sweep:NaN_Gains', 'gain_interpolate returned NaN for %s at rms_sprung_disp = %.4f. Using default/fallback gains.', ctrl, rms_sprung_disp);
-                        if strcmp(ctrl, 'PID')
-                            raw_interpolated_gains = [1000, 10, 200]; % Fallback as numeric array
-                        elseif strcmp(ctrl, 'SMC')
-                            raw_interpolated_gains = [5000, 0.001]; % Fallback as numeric array (Ks, epsilon)
-                        else
-                            % For LQR/Hinf, if they return NaN (unlikely for a struct output)
-                            % This case is less likely, but if it happens, fall back to fixed_gains which should be a struct
-                            raw_interpolated_gains = fixed_gains; % Assume fixed_gains is compatible (struct)
-                        end
-                    end
-
-                    % Now, convert raw_interpolated_gains into the final format expected by controller_func
-                    if strcmp(ctrl, 'PID')
-                        if numel(raw_interpolated_gains) == 3 && isnumeric(raw_interpolated_gains)
-                            % Convert numeric array [Kp, Ki, Kd] to cell array {Kp, Ki, Kd}
-                            interpolated_gains_for_controller = num2cell(raw_interpolated_gains);
-                        else
-                            error('iso_speed_sweep:InvalidPIDGains', 'PID gains from gain_interpolate have unexpected format for cell array conversion.');
-                        end
-                    elseif strcmp(ctrl, 'SMC')
-                        if numel(raw_interpolated_gains) == 2 && isnumeric(raw_interpolated_gains)
-                            % Convert numeric array [Ks, epsilon] to cell array {Ks, epsilon}
-                            interpolated_gains_for_controller = num2cell(raw_interpolated_gains);
-                        else
-                            error('iso_speed_sweep:InvalidSMCGains', 'SMC gains from gain_interpolate have unexpected format for cell array conversion.');
-                        end
-                    elseif isstruct(raw_interpolated_gains)
-                        % LQR/Hinf controllers expect a struct, but run_lqr_control might expect a cell array.
-                        % Assuming run_lqr_control expects gains as a cell array {Q_matrix, R_scalar}
-                        if isfield(raw_interpolated_gains, 'Q') && isfield(raw_interpolated_gains, 'R')
-                            % Convert the struct fields into a cell array
-                            interpolated_gains_for_controller = {raw_interpolated_gains.Q, raw_interpolated_gains.R};
-                        else
-                            error('iso_speed_sweep:InvalidLQRHinfGains', 'LQR/Hinf gains struct from gain_interpolate is missing Q or R fields.');
-                        end
-                    else
-                        error('iso_speed_sweep:UnknownControllerConversion', 'Controller "%s" not handled for gain conversion. Expected struct or numeric array for conversion to cell.', ctrl);
-                    end
-
-                    % Now, call controller_func with the correctly formatted gains
-                    [t_interp, y_interp] = controller_func(A, B, T_current_speed, u_speed, x0, interpolated_gains_for_controller);
-
-                    % Store interpolated gain results
-                    comparison_results_for_this_speed.InterpolatedGain.t = t_interp;
-                    comparison_results_for_this_speed.InterpolatedGain.y = y_interp;
-                    comparison_results_for_this_speed.InterpolatedGain.label = sprintf('%s - Interpolated Gain', ctrl);
-                    comparison_results_for_this_speed.InterpolatedGain.speed = current_speed_mps;
-                    fprintf('    RMS Sprung Mass Disp (Interp. Gain): %.10f m\n', rms(y_interp(:,1)));
-
-                catch inter_err
-                    % If any error occurs during interpolation process or simulation
-                    warning(inter_err.identifier, 'Interpolated gain processing/simulation failed for %s at %.1f km/h: %s', ...
-                                ctrl, current_speed_kmh, inter_err.message);
-                    % Populate with NaNs to ensure plotting functions don't crash due to missing data
-                    comparison_results_for_this_speed.InterpolatedGain.t = T_current_speed;
-                    num_states = size(A, 1); % Assuming A defines the number of states
-                    comparison_results_for_this_speed.InterpolatedGain.y = NaN(numel(T_current_speed), num_states);
-                    comparison_results_for_this_speed.InterpolatedGain.label = sprintf('%s - Interp. Gain (Error)', ctrl);
-                    comparison_results_for_this_speed.InterpolatedGain.speed = current_speed_mps;
-                end
-
-                % --- Plotting for current speed, comparing fixed vs. interpolated gains ---
-                title_str = sprintf('Gain Compare - %s - %s - %.1f kmph', ctrl, iso_class, current_speed_kmh);
-                display_metrics_table(title_str, comparison_results_for_this_speed);
+        % Speeds are compared independently on the sweep runner
+        scenarios = sweep_grid(struct('speed_kmh', speeds_kmh));
+        sim_func = @(sc) compare_speed(sc.speed_kmh, ctrl, controller_func, A, B, resolution, road_len, T_plot_base * speeds_mps(1), u_plot_base, x0, gain_map.(ctrl).(iso_class));
+        results = run_sweep(scenarios, sim_func, 'OutputDir', results_dir(iso_class, ctrl));
 
-                % The road profile for plotting is the base u_plot_base, not the speed-specific u_speed
-                plot_results(T_plot_base * speeds_mps(1), u_plot_base, ...
-                                 title_str, iso_class, comparison_results_for_this_speed, plot_flag, iso_class, ctrl);
+        for s_idx = 1:numel(scenarios)
+            comparison_results_for_this_speed = results{s_idx};
 
-            catch fixed_err
-                % Catch block for errors during fixed gain simulation
-                warning(fixed_err.identifier, 'Fixed gain simulation failed for %s at %.1f km/h: %s', ...
-                                ctrl, current_speed_kmh, fixed_err.message);
+            % Speeds whose fixed gain simulation failed have no results
+            if isempty(fieldnames(comparison_results_for_this_speed))
+                continue;
             end
+
+            % --- Plotting for each speed, comparing fixed vs. interpolated gains ---
+            title_str = sprintf('Gain Compare - %s - %s - %.1f kmph', ctrl, iso_class, speeds_kmh(s_idx));
+            display_metrics_table(title_str, comparison_results_for_this_speed);
+
+            % The road profile for plotting is the base u_plot_base, not the speed-specific u_speed
+            plot_results(T_plot_base * speeds_mps(1), u_plot_base, ...
+                             title_str, iso_class, comparison_results_for_this_speed, plot_flag, iso_class, ctrl);
         end
         fprintf('------------------------------\n');
     end
 end
 
+%% ----------------- Compare Fixed and Interpolated Gains -----------------
+function comparison_results_for_this_speed = compare_speed(speed_kmh, ctrl, controller_func, A, B, resolution, road_len, s_base, u_plot_base, x0, fixed_gains)
+    % Simulates one speed with the fixed gains and with the gains interpolated
+    % from its RMS displacement. The result is empty if the fixed gain
+    % simulation fails.
+    current_speed_mps = speed_kmh / 3.6;
+    current_speed_kmh = speed_kmh;
+    fprintf('\n--- Speed: %.1f km/h (%.2f m/s) ---\n', current_speed_kmh, current_speed_mps);
+
+    simulation_time = road_len / current_speed_mps;
+    T_current_speed = 0:resolution:simulation_time;
+
+    % Resample the base road profile (u_plot_base) for the current speed's time vector.
+    % The interpolation is based on distance.
+    % X_known: distance corresponding to u_plot_base (s_base)
+    % Y_known: u_plot_base elevation values
+    % X_query: distance for current speed's time vector (T_current_speed * current_speed_mps)
+    u_speed = interp1(s_base, u_plot_base, T_current_speed * current_speed_mps, 'linear', 0);
+
+    % Initialize structure to store results for this speed comparison
+    comparison_results_for_this_speed = struct();
+
+    % --- Simulation with FIXED Gains ---
+    try
+        % Run simulation with fixed gains
+        [t_fixed, y_fixed] = controller_func(A, B, T_current_speed, u_speed, x0, fixed_gains);
+
+        % Store fixed gain results
+        comparison_results_for_this_speed.FixedGain.t = t_fixed;
+        comparison_results_for_this_speed.FixedGain.y = y_fixed;
+        comparison_results_for_this_speed.FixedGain.label = sprintf('%s - Fixed Gain', ctrl);
+        comparison_results_for_this_speed.FixedGain.speed = current_speed_mps;
+
+        % Calculate RMS sprung mass displacement for fixed gains
+        rms_sprung_disp = rms(y_fixed(:,1)); % Assuming y(:,1) is sprung mass displacement
+        fprintf('    RMS Sprung Mass Disp (Fixed Gain): %.10f m\n', rms_sprung_disp);
+
+        % --- Simulation with INTERPOLATED Gains ---
+        % Initialize as empty, type will depend on controller
+        interpolated_gains_for_controller = [];
+
+        try
+            % Call gain_interpolate. It returns a numeric array for PID/SMC, struct for LQR/Hinf.
+            raw_interpolated_gains = gain_interpolate(ctrl, rms_sprung_disp, current_speed_mps);
+
+            % Handle NaN values returned by gain_interpolate, and assign fallback as numeric array
+            if isnumeric(raw_interpolated_gains) && any(isnan(raw_interpolated_gains))
+                warning('iso_speed_sweep:NaN_Gains', 'gain_interpolate returned NaN for %s at rms_sprung_disp = %.4f. Using default/fallback gains.', ctrl, rms_sprung_disp);
+                if strcmp(ctrl, 'PID')
+                    raw_interpolated_gains = [1000, 10, 200]; % Fallback as numeric array
+                elseif strcmp(ctrl, 'SMC')
+                    raw_interpolated_gains = [5000, 0.001]; % Fallback as numeric array (Ks, epsilon)
+                else
+                    % For LQR/Hinf, if they return NaN (unlikely for a struct output)
+                    % This case is less likely, but if it happens, fall back to fixed_gains which should be a struct
+                    raw_interpolated_gains = fixed_gains; % Assume fixed_gains is compatible (struct)
+                end
+            end
+
+            % Now, convert raw_interpolated_gains into the final format expected by controller_func
+            if strcmp(ctrl, 'PID')
+                if numel(raw_interpolated_gains) == 3 && isnumeric(raw_interpolated_gains)
+                    % Convert numeric array [Kp, Ki, Kd] to cell array {Kp, Ki, Kd}
+                    interpolated_gains_for_controller = num2cell(raw_interpolated_gains);
+                else
+                    error('iso_speed_sweep:InvalidPIDGains', 'PID gains from gain_interpolate have unexpected format for cell array conversion.');
+                end
+            elseif strcmp(ctrl, 'SMC')
+                if numel(raw_interpolated_gains) == 2 && isnumeric(raw_interpolated_gains)
+                    % Convert numeric array [Ks, epsilon] to cell array {Ks, epsilon}
+                    interpolated_gains_for_controller = num2cell(raw_interpolated_gains);
+                else
+                    error('iso_speed_sweep:InvalidSMCGains', 'SMC gains from gain_interpolate have unexpected format for cell array conversion.');
+                end
+            elseif isstruct(raw_interpolated_gains)
+                % LQR/Hinf controllers expect a struct, but run_lqr_control might expect a cell array.
+                % Assuming run_lqr_control expects gains as a cell array {Q_matrix, R_scalar}
+                if isfield(raw_interpolated_gains, 'Q') && isfield(raw_interpolated_gains, 'R')
+                    % Convert the struct fields into a cell array
+                    interpolated_gains_for_controller = {raw_interpolated_gains.Q, raw_interpolated_gains.R};
+                else
+                    error('iso_speed_sweep:InvalidLQRHinfGains', 'LQR/Hinf gains struct from gain_interpolate is missing Q or R fields.');
+                end
+            else
+                error('iso_speed_sweep:UnknownControllerConversion', 'Controller "%s" not handled for gain conversion. Expected struct or numeric array for conversion to cell.', ctrl);
+            end
+
+            % Now, call controller_func with the correctly formatted gains
+            [t_interp, y_interp] = controller_func(A, B, T_current_speed, u_speed, x0, interpolated_gains_for_controller);
+
+            % Store interpolated gain results
+            comparison_results_for_this_speed.InterpolatedGain.t = t_interp;
+            comparison_results_for_this_speed.InterpolatedGain.y = y_interp;
+            comparison_results_for_this_speed.InterpolatedGain.label = sprintf('%s - Interpolated Gain', ctrl);
+            comparison_results_for_this_speed.InterpolatedGain.speed = current_speed_mps;
+            fprintf('    RMS Sprung Mass Disp (Interp. Gain): %.10f m\n', rms(y_interp(:,1)));
+
+        catch inter_err
+            % If any error occurs during interpolation process or simulation
+            warning(inter_err.identifier, 'Interpolated gain processing/simulation failed for %s at %.1f km/h: %s', ...
+                        ctrl, current_speed_kmh, inter_err.message);
+            % Populate with NaNs to ensure plotting functions don't crash due to missing data
+            comparison_results_for_this_speed.InterpolatedGain.t = T_current_speed;
+            num_states = size(A, 1); % Assuming A defines the number of states
+            comparison_results_for_this_speed.InterpolatedGain.y = NaN(numel(T_current_speed), num_states);
+            comparison_results_for_this_speed.InterpolatedGain.label = sprintf('%s - Interp. Gain (Error)', ctrl);
+            comparison_results_for_this_speed.InterpolatedGain.speed = current_speed_mps;
+        end
+    catch fixed_err
+        % Catch block for errors during fixed gain simulation
+        warning(fixed_err.identifier, 'Fixed gain simulation failed for %s at %.1f km/h: %s', ...
+                        ctrl, current_speed_kmh, fixed_err.message);
+        comparison_results_for_this_speed = struct();
+    end
+end
+
 %% ----------------- Get Base Path -----------------
 function base_path = get_base_path()
     current_script_dir = fileparts(mfilename('fullpath'));
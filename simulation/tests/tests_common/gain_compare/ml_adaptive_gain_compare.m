@@ -78,6 +78,9 @@ fprintf('\nProcessing CRG File: %s%s\n', crg_fname, crg_ext);
 max_sim_time_for_plot = road_len / min(speeds_mps);
 [actual_crg_length, ~, road_profile_base] = process_crg_file(crg_file, 0:resolution:max_sim_time_for_plot, min(speeds_mps));
 
+% Distance of each sample of the base road profile
+s_base = (0:length(road_profile_base)-1) * (min(speeds_mps) * resolution);
+
 fprintf('Actual CRG Data Length: %.4f m\n', actual_crg_length);
 if abs(actual_crg_length - road_len) > 1e-3
     warning('ml_adaptive_gain_compare:RoadLengthMismatch', 'Configured road_len (%.2f m) does not match actual CRG data length (%.2f m). Simulation will extrapolate/truncate.', road_len, actual_crg_length);
@@ -95,178 +98,189 @@ for ctrl_idx = 1:numel(controllers)
 
     fprintf('\n----- Controller: %s -----\n', ctrl);
 
-    % Loop through each speed for the current controller
-    for s_idx = 1:numel(speeds_mps)
-        current_speed_mps = speeds_mps(s_idx);
-        current_speed_kmh = speeds_kmh(s_idx);
-        fprintf('\n--- Speed: %.1f km/h (%.2f m/s) ---\n', current_speed_kmh, current_speed_mps);
+    % Speeds are compared independently on the sweep runner
+    scenarios = sweep_grid(struct('speed_kmh', speeds_kmh));
+    sim_func = @(sc) compare_speed(sc.speed_kmh, ctrl, controller_func, A, B, resolution, road_len, s_base, road_profile_base, x0, gain_map.CRG.(ctrl).(crg_name), roadClassifierModel);
+    results = run_sweep(scenarios, sim_func, 'OutputDir', results_dir(crg_name, ctrl));
 
-        % Calculate simulation time and time vector for current speed
-        simulation_time = road_len / current_speed_mps;
-        T_current_speed = 0:resolution:simulation_time;
+    for s_idx = 1:numel(scenarios)
+        %% --- Plotting and Metrics for each speed ---
+        title_str = sprintf('Gain Compare - %s - %s - %.1f kmph (ML Adaptive)', ctrl, crg_name, speeds_kmh(s_idx));
+        display_metrics_table(title_str, results{s_idx}.comparison);
 
-        % Interpolate road profile for the current speed
-        road_profile_current_speed = interp1((0:length(road_profile_base)-1) * (min(speeds_mps) * resolution), ...
-                                              road_profile_base, ...
-                                              T_current_speed * current_speed_mps, 'linear', 'extrap');
+        plot_results(results{s_idx}.s, results{s_idx}.road_profile, ...
+                             title_str, crg_name, results{s_idx}.comparison, plot_flag, ctrl);
+    end
+    fprintf('------------------------------\n');
+end
 
-        comparison_results_for_this_speed = struct();
+%% ----------------- Compare Fixed and ML Adaptive Gains -----------------
+function result = compare_speed(speed_kmh, ctrl, controller_func, A, B, resolution, road_len, s_base, road_profile_base, x0, fixed_gains, roadClassifierModel)
+    % Simulates one speed with the fixed gains ('CRG' section of gain_map) and
+    % with the adaptive gains derived from the fixed gain response. The road
+    % profile of the speed is returned for plotting.
+    current_speed_mps = speed_kmh / 3.6;
+    current_speed_kmh = speed_kmh;
+    fprintf('\n--- Speed: %.1f km/h (%.2f m/s) ---\n', current_speed_kmh, current_speed_mps);
+
+    % Calculate simulation time and time vector for current speed
+    simulation_time = road_len / current_speed_mps;
+    T_current_speed = 0:resolution:simulation_time;
+
+    % Interpolate road profile for the current speed
+    road_profile_current_speed = interp1(s_base, road_profile_base, ...
+                                          T_current_speed * current_speed_mps, 'linear', 'extrap');
+
+    comparison_results_for_this_speed = struct();
+
+    %% --- Baseline Simulation: Fixed Gains ---
+    try
+        [t_fixed, y_fixed] = controller_func(A, B, T_current_speed, road_profile_current_speed, x0, fixed_gains);
+        comparison_results_for_this_speed.FixedGain.t = t_fixed;
+        comparison_results_for_this_speed.FixedGain.y = y_fixed;
+        comparison_results_for_this_speed.FixedGain.label = sprintf('%s - Fixed Gain', ctrl);
+        comparison_results_for_this_speed.FixedGain.speed = current_speed_mps;
+        fprintf('    RMS Sprung Mass Disp (Fixed Gain): %.10f m\n', rms(y_fixed(:,1)));
+    catch fixed_err
+        warning(fixed_err.identifier, 'Fixed gain simulation failed for %s at %.1f km/h: %s', ...
+                            ctrl, current_speed_kmh, fixed_err.message);
+        comparison_results_for_this_speed.FixedGain.t = T_current_speed;
+        num_states = size(A, 1);
+        comparison_results_for_this_speed.FixedGain.y = NaN(numel(T_current_speed), num_states);
+        comparison_results_for_this_speed.FixedGain.label = sprintf('%s - Fixed Gain (Error)', ctrl);
+        comparison_results_for_this_speed.FixedGain.speed = current_speed_mps;
+    end
 
-        %% --- Baseline Simulation: Fixed Gains ---
-        % Use gains from the 'CRG' section of gain_map for fixed-gain simulation
-        fixed_gains = gain_map.CRG.(ctrl).(crg_name);
-        try
-            [t_fixed, y_fixed] = controller_func(A, B, T_current_speed, road_profile_current_speed, x0, fixed_gains);
-            comparison_results_for_this_speed.FixedGain.t = t_fixed;
-            comparison_results_for_this_speed.FixedGain.y = y_fixed;
-            comparison_results_for_this_speed.FixedGain.label = sprintf('%s - Fixed Gain', ctrl);
-            comparison_results_for_this_speed.FixedGain.speed = current_speed_mps;
-            fprintf('    RMS Sprung Mass Disp (Fixed Gain): %.10f m\n', rms(y_fixed(:,1)));
-        catch fixed_err
-            warning(fixed_err.identifier, 'Fixed gain simulation failed for %s at %.1f km/h: %s', ...
-                                ctrl, current_speed_kmh, fixed_err.message);
-            comparison_results_for_this_speed.FixedGain.t = T_current_speed;
-            num_states = size(A, 1);
-            comparison_results_for_this_speed.FixedGain.y = NaN(numel(T_current_speed), num_states);
-            comparison_results_for_this_speed.FixedGain.label = sprintf('%s - Fixed Gain (Error)', ctrl);
-            comparison_results_for_this_speed.FixedGain.speed = current_speed_mps;
-        end
+    %% --- ML Adaptive Gain Simulation ---
+    predicted_road_type = 'Unknown';
+    try
+        % Calculate sprung mass acceleration from fixed-gain simulation results
+        raw_sprung_accel = diff(y_fixed(:,2)) / resolution;
+
+        % Ensure acceleration vector has same length as displacement vector
+        target_length = length(y_fixed(:,2));
+        sim_sprung_accel = zeros(target_length, 1);
+        sim_sprung_accel(1:target_length-1) = raw_sprung_accel;
+        sim_sprung_accel(target_length) = raw_sprung_accel(end); % Copy last value to match length
+
+        if ~isempty(sim_sprung_accel) && length(sim_sprung_accel) > 1
+            % Extract features from simulated sprung mass acceleration
+            features_vector = extract_road_features(sim_sprung_accel, resolution);
+
+            % Predict road type using the loaded ML model or heuristic
+            if ~isempty(roadClassifierModel)
+                expected_model_features = size(roadClassifierModel.X, 2);
+                if size(features_vector, 2) ~= expected_model_features
+                    warning('ml_adaptive_gain_compare:FeatureMismatch', ...
+                            'Feature vector size (%d) does not match ML model expected features (%d). Attempting to pad/truncate.', ...
+                            size(features_vector, 2), expected_model_features);
+                    % Pad with zeros or truncate to match expected features
+                    temp_features = zeros(1, expected_model_features);
+                    num_copy = min(size(features_vector, 2), expected_model_features);
+                    temp_features(1, 1:num_copy) = features_vector(1, 1:num_copy);
+                    features_vector = temp_features;
+                end
 
-        %% --- ML Adaptive Gain Simulation ---
-        predicted_road_type = 'Unknown';
-        try
-            % Calculate sprung mass acceleration from fixed-gain simulation results
-            raw_sprung_accel = diff(y_fixed(:,2)) / resolution;
-
-            % Ensure acceleration vector has same length as displacement vector
-            target_length = length(y_fixed(:,2));
-            sim_sprung_accel = zeros(target_length, 1);
-            sim_sprung_accel(1:target_length-1) = raw_sprung_accel;
-            sim_sprung_accel(target_length) = raw_sprung_accel(end); % Copy last value to match length
-
-            if ~isempty(sim_sprung_accel) && length(sim_sprung_accel) > 1
-                % Extract features from simulated sprung mass acceleration
-                features_vector = extract_road_features(sim_sprung_accel, resolution);
-
-                % Predict road type using the loaded ML model or heuristic
-                if ~isempty(roadClassifierModel)
-                    expected_model_features = size(roadClassifierModel.X, 2);
-                    if size(features_vector, 2) ~= expected_model_features
-                        warning('ml_adaptive_gain_compare:FeatureMismatch', ...
-                                'Feature vector size (%d) does not match ML model expected features (%d). Attempting to pad/truncate.', ...
-                                size(features_vector, 2), expected_model_features);
-                        % Pad with zeros or truncate to match expected features
-                        temp_features = zeros(1, expected_model_features);
-                        num_copy = min(size(features_vector, 2), expected_model_features);
-                        temp_features(1, 1:num_copy) = features_vector(1, 1:num_copy);
-                        features_vector = temp_features;
-                    end
-
-                    predicted_road_type = char(predict(roadClassifierModel, features_vector));
+                predicted_road_type = char(predict(roadClassifierModel, features_vector));
+            else
+                % Heuristic for display if ML model is not available
+                current_rms_disp_fixed_gain = rms(y_fixed(:,1));
+                if current_rms_disp_fixed_gain < 0.00002251
+                    predicted_road_type = 'Asphalt Road';
+                elseif current_rms_disp_fixed_gain < 0.00005
+                    predicted_road_type = 'Cobblestone Road';
                 else
-                    % Heuristic for display if ML model is not available
-                    current_rms_disp_fixed_gain = rms(y_fixed(:,1));
-                    if current_rms_disp_fixed_gain < 0.00002251
-                        predicted_road_type = 'Asphalt Road';
-                    elseif current_rms_disp_fixed_gain < 0.00005
-                        predicted_road_type = 'Cobblestone Road';
-                    else
-                        predicted_road_type = 'Dirt Road';
-                    end
-                    fprintf('    (Using heuristic for road classification due to missing ML model.)\n');
+                    predicted_road_type = 'Dirt Road';
                 end
-                fprintf('    Simulated Road Type Classified as: %s\n', predicted_road_type);
-            else
-                warning('ml_adaptive_gain_compare:NoSimulatedSensorData', 'Insufficient simulated sensor data for feature extraction. Cannot classify road type.');
-                predicted_road_type = 'Unknown';
+                fprintf('    (Using heuristic for road classification due to missing ML model.)\n');
             end
+            fprintf('    Simulated Road Type Classified as: %s\n', predicted_road_type);
+        else
+            warning('ml_adaptive_gain_compare:NoSimulatedSensorData', 'Insufficient simulated sensor data for feature extraction. Cannot classify road type.');
+            predicted_road_type = 'Unknown';
+        end
 
-            % Use gain_interpolate based on RMS displacement and current speed
-            % The rms(y_fixed(:,1)) is the RMS of the sprung mass displacement from the fixed-gain simulation.
-            % This RMS value, along with speed, drives the gain interpolation.
-            displacement_input = rms(y_fixed(:,1));
-
-            % Call the gain_interpolate function
-            % It returns a struct (for LQR/Hinf) or a vector (for PID/SMC)
-            interpolated_gain_output = gain_interpolate(ctrl, displacement_input, current_speed_mps);
-
-            % Convert the output of gain_interpolate into a cell array format
-            if isstruct(interpolated_gain_output) % For LQR/Hinf: returns a struct with Q and R
-                if isfield(interpolated_gain_output, 'Q') && isfield(interpolated_gain_output, 'R')
-                    adaptive_gains = {interpolated_gain_output.Q, interpolated_gain_output.R};
-                elseif isfield(interpolated_gain_output, 'gamma')
-                    adaptive_gains = {interpolated_gain_output.gamma};
+        % Use gain_interpolate based on RMS displacement and current speed
+        % The rms(y_fixed(:,1)) is the RMS of the sprung mass displacement from the fixed-gain simulation.
+        % This RMS value, along with speed, drives the gain interpolation.
+        displacement_input = rms(y_fixed(:,1));
+
+        % Call the gain_interpolate function
+        % It returns a struct (for LQR/Hinf) or a vector (for PID/SMC)
+        interpolated_gain_output = gain_interpolate(ctrl, displacement_input, current_speed_mps);
+
+        % Convert the output of gain_interpolate into a cell array format
+        if isstruct(interpolated_gain_output) % For LQR/Hinf: returns a struct with Q and R
+            if isfield(interpolated_gain_output, 'Q') && isfield(interpolated_gain_output, 'R')
+                adaptive_gains = {interpolated_gain_output.Q, interpolated_gain_output.R};
+            elseif isfield(interpolated_gain_output, 'gamma')
+                adaptive_gains = {interpolated_gain_output.gamma};
+            else
+                error('ml_adaptive_gain_compare:InvalidStructGains', 'Struct gains format not recognized.');
+            end
+        else % For PID/SMC: returns a numeric vector, which needs to be unpacked
+             % into individual cell elements for fixed-signature controllers.
+            if strcmp(ctrl, 'PID')
+                % PID gains are {Kp, Ki, Kd}
+                if numel(interpolated_gain_output) == 3
+                    adaptive_gains = {interpolated_gain_output(1), interpolated_gain_output(2), interpolated_gain_output(3)};
                 else
-                    error('ml_adaptive_gain_compare:InvalidStructGains', 'Struct gains format not recognized.');
+                    error('ml_adaptive_gain_compare:InvalidPIDGains', 'PID gain vector from interpolation has unexpected number of elements.');
                 end
-            else % For PID/SMC: returns a numeric vector, which needs to be unpacked
-                 % into individual cell elements for fixed-signature controllers.
-                if strcmp(ctrl, 'PID')
-                    % PID gains are {Kp, Ki, Kd}
-                    if numel(interpolated_gain_output) == 3
-                        adaptive_gains = {interpolated_gain_output(1), interpolated_gain_output(2), interpolated_gain_output(3)};
-                    else
-                        error('ml_adaptive_gain_compare:InvalidPIDGains', 'PID gain vector from interpolation has unexpected number of elements.');
-                    end
-                elseif strcmp(ctrl, 'SMC')
-                    % SMC gains are {k, epsilon}
-                    if numel(interpolated_gain_output) == 2
-                        adaptive_gains = {interpolated_gain_output(1), interpolated_gain_output(2)};
-                    else
-                        error('ml_adaptive_gain_compare:InvalidSMCGains', 'SMC gain vector from interpolation has unexpected number of elements.');
-                    end
+            elseif strcmp(ctrl, 'SMC')
+                % SMC gains are {k, epsilon}
+                if numel(interpolated_gain_output) == 2
+                    adaptive_gains = {interpolated_gain_output(1), interpolated_gain_output(2)};
                 else
-                    % Fallback for other potential non-LQR/Hinf controllers
-                    % If they also return a vector, but expect it as a single cell:
-                    adaptive_gains = {interpolated_gain_output};
-                    warning('ml_adaptive_gain_compare:UnknownControllerFormat', 'Controller %s expects a single cell array for its gain vector. Verify this is correct.', ctrl);
+                    error('ml_adaptive_gain_compare:InvalidSMCGains', 'SMC gain vector from interpolation has unexpected number of elements.');
                 end
+            else
+                % Fallback for other potential non-LQR/Hinf controllers
+                % If they also return a vector, but expect it as a single cell:
+                adaptive_gains = {interpolated_gain_output};
+                warning('ml_adaptive_gain_compare:UnknownControllerFormat', 'Controller %s expects a single cell array for its gain vector. Verify this is correct.', ctrl);
             end
+        end
 
-            % Check for NaN/Inf in adaptive_gains
-            if any(cellfun(@(x) any(isnan(x(:))), adaptive_gains)) || any(cellfun(@(x) any(isinf(x(:))), adaptive_gains))
-                error('ml_adaptive_gain_compare:InvalidAdaptiveGains', 'Interpolated adaptive gains contain NaN or Inf values. This will likely cause simulation failure.');
-            end
+        % Check for NaN/Inf in adaptive_gains
+        if any(cellfun(@(x) any(isnan(x(:))), adaptive_gains)) || any(cellfun(@(x) any(isinf(x(:))), adaptive_gains))
+            error('ml_adaptive_gain_compare:InvalidAdaptiveGains', 'Interpolated adaptive gains contain NaN or Inf values. This will likely cause simulation failure.');
+        end
 
-            fprintf('    ML Adaptive Gain (for %s) using 2D interpolated gains.\n', ctrl);
-
-            % Run simulation with the newly interpolated adaptive gains
-            try
-                [t_ml_adaptive, y_ml_adaptive] = controller_func(A, B, T_current_speed, road_profile_current_speed, x0, adaptive_gains);
-            catch sim_err
-                warning('ml_adaptive_gain_compare:MLAdaptiveSimFailed', ...
-                        'ML Adaptive simulation failed for %s at %.1f km/h: %s', ...
-                        ctrl, current_speed_kmh, sim_err.message);
-                % Rethrow the error to stop execution
-                rethrow(sim_err);
-            end
+        fprintf('    ML Adaptive Gain (for %s) using 2D interpolated gains.\n', ctrl);
 
-            comparison_results_for_this_speed.MLAdaptiveGain.t = t_ml_adaptive;
-            comparison_results_for_this_speed.MLAdaptiveGain.y = y_ml_adaptive;
-            comparison_results_for_this_speed.MLAdaptiveGain.label = sprintf('%s - ML Adaptive Gain', ctrl);
-            comparison_results_for_this_speed.MLAdaptiveGain.speed = current_speed_mps;
-            fprintf('    RMS Sprung Mass Disp (ML Adaptive Gain): %.10f m\n', rms(y_ml_adaptive(:,1)));
-
-        catch ml_adaptive_top_err
-            % This catch block will only be reached if the inner try-catch for controller_func
-            % did not rethrow, or if an error occurred *before* the controller_func call.
-            warning(ml_adaptive_top_err.identifier, 'ML Adaptive gain processing/simulation failed for %s at %.1f km/h (Outer Catch): %s', ...
-                                 ctrl, current_speed_kmh, ml_adaptive_top_err.message);
-            comparison_results_for_this_speed.MLAdaptiveGain.t = T_current_speed;
-            num_states = size(A, 1);
-            comparison_results_for_this_speed.MLAdaptiveGain.y = NaN(numel(T_current_speed), num_states);
-            comparison_results_for_this_speed.MLAdaptiveGain.label = sprintf('%s - ML Adaptive Gain (Error)', ctrl);
-            comparison_results_for_this_speed.MLAdaptiveGain.speed = current_speed_mps;
+        % Run simulation with the newly interpolated adaptive gains
+        try
+            [t_ml_adaptive, y_ml_adaptive] = controller_func(A, B, T_current_speed, road_profile_current_speed, x0, adaptive_gains);
+        catch sim_err
+            warning('ml_adaptive_gain_compare:MLAdaptiveSimFailed', ...
+                    'ML Adaptive simulation failed for %s at %.1f km/h: %s', ...
+                    ctrl, current_speed_kmh, sim_err.message);
+            % Rethrow the error to stop execution
+            rethrow(sim_err);
         end
 
-        %% --- Plotting and Metrics for current speed ---
-        title_str = sprintf('Gain Compare - %s - %s - %.1f kmph (ML Adaptive)', ctrl, crg_name, current_speed_kmh);
-        display_metrics_table(title_str, comparison_results_for_this_speed);
-
-        plot_results(T_current_speed * current_speed_mps, road_profile_current_speed, ...
-                             title_str, crg_name, comparison_results_for_this_speed, plot_flag, ctrl);
+        comparison_results_for_this_speed.MLAdaptiveGain.t = t_ml_adaptive;
+        comparison_results_for_this_speed.MLAdaptiveGain.y = y_ml_adaptive;
+        comparison_results_for_this_speed.MLAdaptiveGain.label = sprintf('%s - ML Adaptive Gain', ctrl);
+        comparison_results_for_this_speed.MLAdaptiveGain.speed = current_speed_mps;
+        fprintf('    RMS Sprung Mass Disp (ML Adaptive Gain): %.10f m\n', rms(y_ml_adaptive(:,1)));
+
+    catch ml_adaptive_top_err
+        % This catch block will only be reached if the inner try-catch for controller_func
+        % did not rethrow, or if an error occurred *before* the controller_func call.
+        warning(ml_adaptive_top_err.identifier, 'ML Adaptive gain processing/simulation failed for %s at %.1f km/h (Outer Catch): %s', ...
+                             ctrl, current_speed_kmh, ml_adaptive_top_err.message);
+        comparison_results_for_this_speed.MLAdaptiveGain.t = T_current_speed;
+        num_states = size(A, 1);
+        comparison_results_for_this_speed.MLAdaptiveGain.y = NaN(numel(T_current_speed), num_states);
+        comparison_results_for_this_speed.MLAdaptiveGain.label = sprintf('%s - ML Adaptive Gain (Error)', ctrl);
+        comparison_results_for_this_speed.MLAdaptiveGain.speed = current_speed_mps;
     end
-    fprintf('------------------------------\n');
+
+    result.comparison = comparison_results_for_this_speed;
+    result.s = T_current_speed * current_speed_mps;
+    result.road_profile = road_profile_current_speed;
 end
 
 %% ----------------- Get Base Path -----------------
@@ -98,7 +98,7 @@ for i = 1:numel(crg_profiles)
         end
 
         % Simulate controller for different gain scales
-        all_results = simulate_controller(simulation_speed, scales, gains, controller_func, A, B, T_plot, road_profile, x0, controller, crg_name);
+        all_results = simulate_controller(simulation_speed, scales, gains, controller_func, A, B, T_plot, road_profile, x0, controller, crg_name, results_dir(crg_name, controller));
 
         %% ----------------- Display Performance Metrics -----------------
         road_title = crg_name;
@@ -124,44 +124,67 @@ function base_path = get_base_path()
     end
 end
 
-function all_results = simulate_controller(simulation_speed, scales, baseGains, controller_func, A, B, T, u, x0, controller, crg_name)
-    all_results = struct();
-    for scale = scales
-        switch controller
-            case 'LQR'
-                % For LQR: scale only R
-                scaledGains = {baseGains{1}, baseGains{2} * scale};
-
-            case 'Hinf'
-                % For H-Infinity: scale only gamma
-                scaledGains = {baseGains{1}, baseGains{2} * scale};
-
-            otherwise
-                % For PID, SMC : scale all gain matrices
-                scaledGains = cellfun(@(g) g * scale, baseGains, 'UniformOutput', false);
-        end
+function all_results = simulate_controller(simulation_speed, scales, baseGains, controller_func, A, B, T, u, x0, controller, crg_name, out_dir)
+    scaledGains = arrayfun(@(scale) scale_gains(baseGains, scale, controller), scales, 'UniformOutput', false);
+    scenarios = sweep_grid(struct('scale', scales));
+
+    % All gain scales are simulated at once on the same road
+    try
+        [t, Y] = run_batch_control(controller, A, B, T, u, x0, scaledGains, 'OutputDir', out_dir);
+        results = arrayfun(@(i) struct('t', t, 'y', Y(:, :, i)), 1:numel(scales), 'UniformOutput', false);
+    catch err
+        % Otherwise the gain scales are simulated independently on the sweep runner
+        warning(err.identifier, 'Batched simulation failed, simulating gain scales separately: %s', err.message);
+        results = run_sweep(scenarios, @(sc) simulate_scale(sc.scale, controller_func, A, B, T, u, x0, scale_gains(baseGains, sc.scale, controller)), ...
+            'OutputDir', out_dir);
+    end
 
+    all_results = struct();
+    for i = 1:numel(scales)
+        scale = scales(i);
         label = sprintf('%s - %s - x%.1f', controller, crg_name, scale);
         key = sprintf('%s_%s_x%.1f', controller, crg_name, scale);
         key = matlab.lang.makeValidName(key);
 
-        % Run the controller simulation
-        try
-            [t, y] = controller_func(A, B, T, u, x0, scaledGains);
-            all_results.(key).t = t;
-            all_results.(key).y = y;
-            all_results.(key).label = label;
-            all_results.(key).speed = simulation_speed;
-        catch err
-            warning(err.identifier, 'Simulation failed: %s', err.message);
-            all_results.(key).t = T;
-            all_results.(key).y = NaN(numel(T), size(B, 2));
+        all_results.(key).t = results{i}.t;
+        all_results.(key).y = results{i}.y;
+        if isfield(results{i}, 'error')
             all_results.(key).label = [label, ' (error)'];
-            all_results.(key).speed = simulation_speed;
+        else
+            all_results.(key).label = label;
         end
+        all_results.(key).speed = simulation_speed;
 
         % Print scaled gains
-        printScaledGains(scale, scaledGains, crg_name, controller);
+        printScaledGains(scale, scaledGains{i}, crg_name, controller);
+    end
+end
+
+function result = simulate_scale(scale, controller_func, A, B, T, u, x0, scaledGains)
+    % Run the controller simulation
+    try
+        [result.t, result.y] = controller_func(A, B, T, u, x0, scaledGains);
+    catch err
+        warning(err.identifier, 'Simulation failed at scale x%.1f: %s', scale, err.message);
+        result.t = T;
+        result.y = NaN(numel(T), size(B, 2));
+        result.error = err.message;
+    end
+end
+
+function scaledGains = scale_gains(baseGains, scale, controller)
+    switch controller
+        case 'LQR'
+            % For LQR: scale only R
+            scaledGains = {baseGains{1}, baseGains{2} * scale};
+
+        case 'Hinf'
+            % For H-Infinity: scale only gamma
+            scaledGains = {baseGains{1}, baseGains{2} * scale};
+
+        otherwise
+            % For PID, SMC : scale all gain matrices
+            scaledGains = cellfun(@(g) g * scale, baseGains, 'UniformOutput', false);
     end
 end
 
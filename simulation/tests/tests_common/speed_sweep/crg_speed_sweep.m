@@ -75,35 +75,14 @@ for i = 1:numel(crg_profiles)
 
         fprintf('\n----- Controller: %s -----\n', controller);
 
-        all_speed_results = struct();
+        % Speeds are simulated independently on the sweep runner
+        scenarios = sweep_grid(struct('speed_kmh', speeds_kmh));
+        sim_func = @(sc) simulate_speed(sc.speed_kmh, controller_func, A, B, resolution, road_len, crg_file, T_plot * speeds_mps(1), road_profile, x0, gains, controller, crg_name);
+        results = run_sweep(scenarios, sim_func, 'OutputDir', results_dir(crg_name, controller));
 
-        for s_idx = 1:numel(speeds_mps)
-            current_speed = speeds_mps(s_idx);
-            fprintf('\n--- Speed: %.1f km/h (%.2f m/s) ---\n', speeds_kmh(s_idx), current_speed);
-
-            simulation_time = road_len / current_speed;
-            T_speed = 0:resolution:simulation_time;
-
-            % Resample road profile for current speed
-            % Use the 'road_profile' (base profile) and 'T_plot' (base time) for interpolation
-            road_profile_current_speed = interp1(T_plot * speeds_mps(1), road_profile, T_speed * current_speed);
-
-            label = sprintf('%s - %s - %.1f km/h', controller, crg_name, speeds_kmh(s_idx));
-            key = matlab.lang.makeValidName(sprintf('%s_%s_%dkmh', controller, crg_name, speeds_kmh(s_idx)));
-
-            try
-                [t, y] = controller_func(A, B, T_speed, road_profile_current_speed, x0, gains);
-                all_speed_results.(key).t = t;
-                all_speed_results.(key).y = y;
-                all_speed_results.(key).label = label;
-                all_speed_results.(key).speed = current_speed;
-            catch err
-                warning(err.identifier, 'Simulation failed for %s at %.1f km/h: %s', crg_name, speeds_kmh(s_idx), err.message);
-                all_speed_results.(key).t = T_speed;
-                all_speed_results.(key).y = NaN(numel(T_speed), size(B, 2));
-                all_speed_results.(key).label = [label, ' (error)'];
-                all_speed_results.(key).speed = current_speed;
-            end
+        all_speed_results = struct();
+        for s_idx = 1:numel(scenarios)
+            all_speed_results.(results{s_idx}.key) = rmfield(results{s_idx}, 'key');
         end
 
         title_str = sprintf('Speed Sweep - %s - %s', controller, crg_name);
@@ -127,3 +106,44 @@ function base_path = get_base_path()
         base_path = fullfile(pwd, 'simulation');
     end
 end
+
+function result = simulate_speed(speed_kmh, controller_func, A, B, resolution, road_len, crg_file, s_base, road_profile, x0, gains, controller, crg_name)
+    current_speed = speed_kmh / 3.6;
+    fprintf('\n--- Speed: %.1f km/h (%.2f m/s) ---\n', speed_kmh, current_speed);
+
+    simulation_time = road_len / current_speed;
+    T_speed = 0:resolution:simulation_time;
+
+    if exist('crg_mex', 'file') == 3
+        % Sample the road along the centerline at the current speed natively,
+        % within the u range of the file as in process_crg_file
+        h = crg_mex('open', crg_file);
+        head = crg_mex('info', h);
+        u_end = min(head.uend, head.ubeg + road_len);
+        road_profile_current_speed = crg_mex('path', h, [head.ubeg; u_end], [0; 0], 0, current_speed, 1 / resolution);
+
+        % The path may end one sample earlier or later due to rounding, and earlier
+        % if the file is shorter than road_len; the last value is kept as when clamping
+        n = numel(T_speed);
+        road_profile_current_speed(end+1:n) = road_profile_current_speed(end);
+        road_profile_current_speed = road_profile_current_speed(1:n)';
+    else
+        % Resample road profile for current speed
+        % Use the 'road_profile' (base profile) at its positions 's_base' for interpolation
+        road_profile_current_speed = interp1(s_base, road_profile, T_speed * current_speed);
+    end
+
+    label = sprintf('%s - %s - %.1f km/h', controller, crg_name, speed_kmh);
+    result.key = matlab.lang.makeValidName(sprintf('%s_%s_%dkmh', controller, crg_name, speed_kmh));
+
+    try
+        [result.t, result.y] = controller_func(A, B, T_speed, road_profile_current_speed, x0, gains);
+        result.label = label;
+    catch err
+        warning(err.identifier, 'Simulation failed for %s at %.1f km/h: %s', crg_name, speed_kmh, err.message);
+        result.t = T_speed;
+        result.y = NaN(numel(T_speed), size(B, 2));
+        result.label = [label, ' (error)'];
+    end
+    result.speed = current_speed;
+end
@@ -63,34 +63,14 @@ for i = 1:numel(iso_classes)
 
         fprintf('\n----- Controller: %s -----\n', controller);
 
-        all_speed_results = struct();
+        % Speeds are simulated independently on the sweep runner
+        scenarios = sweep_grid(struct('speed_kmh', speeds_kmh));
+        sim_func = @(sc) simulate_speed(sc.speed_kmh, controller_func, A, B, resolution, road_len, T_plot, u_plot, x0, gains, controller, iso_class);
+        results = run_sweep(scenarios, sim_func, 'OutputDir', results_dir(iso_class, controller));
 
-        for s_idx = 1:numel(speeds_mps)
-            simulation_speed = speeds_mps(s_idx);
-            fprintf('\n--- Speed: %.1f km/h (%.2f m/s) ---\n', speeds_kmh(s_idx), simulation_speed);
-
-            simulation_time = road_len / simulation_speed;
-            T_speed = 0:resolution:simulation_time;
-
-            % Resample the road profile for the current speed's time vector.
-            u_speed = interp1(T_plot, u_plot, T_speed, 'linear', 0); % Use linear interpolation, 0 for out-of-bounds
-
-            label = sprintf('%s - %s - %.1f km/h', controller, iso_class, speeds_kmh(s_idx));
-            key = matlab.lang.makeValidName(sprintf('%s_%s_%dkmh', controller, iso_class, speeds_kmh(s_idx)));
-
-            try
-                [t, y] = controller_func(A, B, T_speed, u_speed, x0, gains);
-                all_speed_results.(key).t = t;
-                all_speed_results.(key).y = y;
-                all_speed_results.(key).label = label;
-                all_speed_results.(key).speed = simulation_speed;
-            catch err
-                warning(err.identifier, 'Simulation failed for %s at %.1f km/h: %s', iso_class, speeds_kmh(s_idx), err.message);
-                all_speed_results.(key).t = T_speed;
-                all_speed_results.(key).y = NaN(numel(T_speed), size(B, 2));
-                all_speed_results.(key).label = [label, ' (error)'];
-                all_speed_results.(key).speed = simulation_speed;
-            end
+        all_speed_results = struct();
+        for s_idx = 1:numel(scenarios)
+            all_speed_results.(results{s_idx}.key) = rmfield(results{s_idx}, 'key');
         end
 
         title_str = sprintf('Speed Sweep - %s - %s', controller, iso_class);
@@ -114,3 +94,28 @@ function base_path = get_base_path()
         base_path = fullfile(pwd, 'simulation');
     end
 end
+
+function result = simulate_speed(speed_kmh, controller_func, A, B, resolution, road_len, T_plot, u_plot, x0, gains, controller, iso_class)
+    simulation_speed = speed_kmh / 3.6;
+    fprintf('\n--- Speed: %.1f km/h (%.2f m/s) ---\n', speed_kmh, simulation_speed);
+
+    simulation_time = road_len / simulation_speed;
+    T_speed = 0:resolution:simulation_time;
+
+    % Resample the road profile for the current speed's time vector.
+    u_speed = interp1(T_plot, u_plot, T_speed, 'linear', 0); % Use linear interpolation, 0 for out-of-bounds
+
+    label = sprintf('%s - %s - %.1f km/h', controller, iso_class, speed_kmh);
+    result.key = matlab.lang.makeValidName(sprintf('%s_%s_%dkmh', controller, iso_class, speed_kmh));
+
+    try
+        [result.t, result.y] = controller_func(A, B, T_speed, u_speed, x0, gains);
+        result.label = label;
+    catch err
+        warning(err.identifier, 'Simulation failed for %s at %.1f km/h: %s', iso_class, speed_kmh, err.message);
+        result.t = T_speed;
+        result.y = NaN(numel(T_speed), size(B, 2));
+        result.label = [label, ' (error)'];
+    end
+    result.speed = simulation_speed;
+end
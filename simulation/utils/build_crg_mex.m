@@ -0,0 +1,18 @@
+%% ----------------- Build CRG MEX Gateway -----------------
+function build_crg_mex(varargin)
+    % Compiles utils/mex/crg_mex.c together with the OpenCRG C base library
+    % into utils/, so every script adding utils to the path can use it.
+    % Extra arguments are passed on to mex, e.g. build_crg_mex('-g').
+    utils_path = fileparts(mfilename('fullpath'));
+    crg_api = fullfile(utils_path, '..', 'crg_dataset', 'ASAM_OpenCRG_BS_V1.2.0', 'c-api', 'baselib');
+
+    lib_src = dir(fullfile(crg_api, 'src', '*.c'));
+    lib_src = fullfile(crg_api, 'src', {lib_src.name});
+
+    mex('-outdir', utils_path, ['-I', fullfile(crg_api, 'inc')], ...
+        varargin{:}, fullfile(utils_path, 'mex', 'crg_mex.c'), lib_src{:});
+
+    % Release a previously loaded version
+    clear crg_mex;
+    fprintf('Built %s\n', fullfile(utils_path, ['crg_mex.', mexext]));
+end
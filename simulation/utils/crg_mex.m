@@ -0,0 +1,23 @@
+%% ----------------- CRG MEX Gateway -----------------
+function varargout = crg_mex(varargin) %#ok<STOUT>
+    % Native evaluation of CRG files via the OpenCRG C API.
+    %
+    %   h      = crg_mex('open', crg_file)   load (or reload if modified) a file
+    %   z      = crg_mex('uv2z', h, u, v)    elevation at u/v positions
+    %   z      = crg_mex('xy2z', h, x, y)    elevation at x/y positions
+    %   [u, v] = crg_mex('xy2uv', h, x, y)   x/y to u/v positions
+    %   [x, y] = crg_mex('uv2xy', h, u, v)   u/v to x/y positions
+    %   Z      = crg_mex('uvgrid', h, u, v)  elevation on the grid of the equidistant
+    %                                        vectors u and v, numel(v) x numel(u)
+    %   Z      = crg_mex('path', h, u, v, speed_time, speed, sample_rate, offset)
+    %                                        elevation sampled in time along the u/v
+    %                                        path points at the speed schedule, one
+    %                                        column per lateral offset (default 0)
+    %   info   = crg_mex('info', h)          ubeg, uend, vmin, vmax, uinc, vinc
+    %   crg_mex('close', h)                  release a file
+    %   crg_mex('closeall')                  release all files
+    %
+    % Files stay loaded until closed or until the MEX file is cleared.
+    % This file only holds the help text; compile the gateway with build_crg_mex.
+    error('crg_mex:notBuilt', 'crg_mex is not compiled, run build_crg_mex first.');
+end
@@ -0,0 +1,134 @@
+%% ----------------- CRG Road Profile Cache -----------------
+function varargout = crg_profile_cache(cmd, varargin)
+    % Persistent cache of road profiles evaluated by process_crg_file.
+    %
+    %   key = crg_profile_cache('key', crg_file, T, speed, v_offset, backend)
+    %   [hit, road_length, resolution, road_profile] = crg_profile_cache('load', key)
+    %   crg_profile_cache('store', key, road_length, resolution, road_profile)
+    %   crg_profile_cache('clear')
+    %
+    % The key is a hash of the CRG file contents, the speed, the time vector,
+    % the lateral offset, the evaluator which produced the profile (backend,
+    % e.g. 'crg_mex' or 'crg_read') and the cache version. Each profile is
+    % kept in a binary file in simulation/cache/road_profiles and read back
+    % with fread.
+    switch cmd
+        case 'key'
+            varargout{1} = cache_key(varargin{:});
+        case 'load'
+            [varargout{1:4}] = cache_load(varargin{1});
+        case 'store'
+            cache_store(varargin{:});
+        case 'clear'
+            % Includes temporary files left by interrupted writes
+            files = [dir(fullfile(cache_dir(), '*.bin')); dir(fullfile(cache_dir(), '*.tmp'))];
+            for i = 1:numel(files)
+                delete(fullfile(files(i).folder, files(i).name));
+            end
+        otherwise
+            error('crg_profile_cache:command', 'Unknown command ''%s''.', cmd);
+    end
+end
+
+%% ----------------- Cache Directory -----------------
+function d = cache_dir()
+    d = fullfile(fileparts(mfilename('fullpath')), '..', 'cache', 'road_profiles');
+end
+
+%% ----------------- Cache Key -----------------
+function key = cache_key(crg_file, T, speed, v_offset, backend)
+    % Increase when the sampling in process_crg_file or the file layout changes
+    cache_version = 1;
+
+    md = java.security.MessageDigest.getInstance('SHA-1');
+    md.update(typecast(double(cache_version), 'int8'));
+    md.update(int8(backend));
+    md.update(file_hash(crg_file));
+    md.update(typecast(double([speed, v_offset, numel(T)]), 'int8'));
+    md.update(typecast(double(T(:))', 'int8'));
+    key = lower(reshape(dec2hex(typecast(int8(md.digest()), 'uint8'))', 1, []));
+end
+
+function h = file_hash(crg_file)
+    % Hashes of unchanged files (same size and modification time in ms) are
+    % reused. A file modified within the last seconds may be modified again
+    % within the same ms, so it is hashed every time until its time stamp is old.
+    persistent known;
+    if isempty(known)
+        known = containers.Map();
+    end
+
+    % Java resolves relative names against its own working directory, not pwd
+    info = dir(crg_file);
+    if numel(info) ~= 1 || info.isdir
+        error('crg_profile_cache:file', 'CRG file not found: %s', crg_file);
+    end
+    jfile = java.io.File(fullfile(info.folder, info.name));
+    modified_ms = jfile.lastModified();
+    stamp = sprintf('%s|%d|%d', char(jfile.getCanonicalPath()), jfile.length(), modified_ms);
+    is_settled = java.lang.System.currentTimeMillis() - modified_ms > 2000;
+
+    if is_settled && isKey(known, stamp)
+        h = known(stamp);
+        return;
+    end
+
+    fid = fopen(crg_file, 'r');
+    bytes = fread(fid, inf, '*int8');
+    fclose(fid);
+
+    md = java.security.MessageDigest.getInstance('SHA-1');
+    h = int8(md.digest(bytes));
+    if is_settled
+        known(stamp) = h;
+    end
+end
+
+%% ----------------- Load / Store -----------------
+function [hit, road_length, resolution, road_profile] = cache_load(key)
+    % File layout: road_length, resolution, numel(road_profile), road_profile (double)
+    hit = false;
+    road_length = [];
+    resolution = [];
+    road_profile = [];
+
+    file = fullfile(cache_dir(), [key, '.bin']);
+    if ~exist(file, 'file')
+        return;
+    end
+
+    fid = fopen(file, 'r');
+    if fid < 0
+        return;
+    end
+    data = fread(fid, inf, 'double');
+    fclose(fid);
+    if numel(data) < 3 || numel(data) ~= 3 + data(3)
+        warning('crg_profile_cache:corrupt', 'Ignoring corrupt cache file %s', file);
+        return;
+    end
+
+    road_length = data(1);
+    resolution = data(2);
+    road_profile = data(4:end);
+    hit = true;
+end
+
+function cache_store(key, road_length, resolution, road_profile)
+    d = cache_dir();
+    if ~exist(d, 'dir')
+        mkdir(d);
+    end
+
+    % Written to a temporary file first, so readers never see partial profiles
+    file = fullfile(d, [key, '.bin']);
+    tmp_file = [file, '.', num2str(feature('getpid')), '.tmp'];
+    fid = fopen(tmp_file, 'w');
+    if fid < 0
+        warning('crg_profile_cache:write', 'Could not write cache file %s', tmp_file);
+        return;
+    end
+    fwrite(fid, [road_length; resolution; numel(road_profile); road_profile(:)], 'double');
+    fclose(fid);
+    movefile(tmp_file, file, 'f');
+end
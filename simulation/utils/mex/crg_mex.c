@@ -0,0 +1,506 @@
+/* ----------------- CRG MEX Gateway -----------------
+ *
+ * native evaluation of CRG files via the OpenCRG C API (crgBaseLib.h);
+ * a file is loaded once and kept in a persistent handle until it is closed
+ * or the MEX file is cleared (clear crg_mex, clear all)
+ *
+ *   h      = crg_mex('open', crg_file)   load (or reload if modified) a file
+ *   z      = crg_mex('uv2z', h, u, v)    elevation at u/v positions
+ *   z      = crg_mex('xy2z', h, x, y)    elevation at x/y positions
+ *   [u, v] = crg_mex('xy2uv', h, x, y)   x/y to u/v positions
+ *   [x, y] = crg_mex('uv2xy', h, u, v)   u/v to x/y positions
+ *   Z      = crg_mex('uvgrid', h, u, v)  elevation on the grid of the equidistant
+ *                                        vectors u and v, numel(v) x numel(u)
+ *   Z      = crg_mex('path', h, u, v, speed_time, speed, sample_rate, offset)
+ *                                        elevation sampled in time along the u/v
+ *                                        path points at the speed schedule, one
+ *                                        column per lateral offset (default 0)
+ *   info   = crg_mex('info', h)          ubeg, uend, vmin, vmax, uinc, vinc
+ *   crg_mex('close', h)                  release a file
+ *   crg_mex('closeall')                  release all files
+ *
+ * positions are double arrays of equal size (or scalars), read in place;
+ * results have the size of the positions, NaN where evaluation fails.
+ * Build with build_crg_mex.m.
+ */
+#if !defined(_WIN32) && !defined(_XOPEN_SOURCE)
+#define _XOPEN_SOURCE 700       /* realpath()                                 */
+#endif
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mex.h"
+#include "crgBaseLib.h"
+
+#define dMaxHandles   64        /* max. number of files open at the same time */
+#define dMaxPathLen 4096        /* max. length of the name of a file          */
+
+/* file names are compared as the file system does */
+#ifdef _WIN32
+#define dPathCmp _stricmp
+#else
+#define dPathCmp strcmp
+#endif
+
+/* evaluates one position: z (out2 unused) or a pair of co-ordinates */
+typedef int ( *CrgMexEvalFunc )( int cpId, double a, double b, double* out1, double* out2 );
+
+typedef struct
+{
+    int  dataSetId;             /* data set of the file, 0 if the slot is free */
+    int  cpId;                  /* contact point used for all evaluations      */
+    char filename[dMaxPathLen]; /* absolute, canonical name of the file        */
+} CrgMexHandleStruct;
+
+static CrgMexHandleStruct sHandle[dMaxHandles];
+static int                sInitialized = 0;
+
+/* ----------------- Messages and Cleanup ----------------- */
+static int
+msgCallback( int level, char* message )
+{
+    mexPrintf( "crg_mex: %s", message );
+
+    ( void ) level;
+    return 1;
+}
+
+static void
+closeAll( void )
+{
+    int i;
+
+    for ( i = 0; i < dMaxHandles; i++ )
+    {
+        if ( sHandle[i].dataSetId > 0 )
+            crgDataSetRelease( sHandle[i].dataSetId );
+
+        sHandle[i].dataSetId = 0;
+    }
+
+    crgMemRelease();
+}
+
+static void
+init( void )
+{
+    if ( sInitialized )
+        return;
+
+    crgMsgSetCallback( msgCallback );
+    crgMsgSetLevel( dCrgMsgLevelWarn );
+
+    /* --- the data sets are released when the MEX file is cleared --- */
+    mexAtExit( closeAll );
+
+    memset( sHandle, 0, sizeof( sHandle ) );
+    sInitialized = 1;
+}
+
+/* ----------------- Handles ----------------- */
+static CrgMexHandleStruct*
+getHandle( const mxArray* arg )
+{
+    int id;
+    int i;
+
+    if ( !mxIsNumeric( arg ) || mxGetNumberOfElements( arg ) != 1 )
+        mexErrMsgIdAndTxt( "crg_mex:handle", "Handle must be a scalar returned by crg_mex('open', ...)." );
+
+    id = ( int ) mxGetScalar( arg );
+
+    for ( i = 0; i < dMaxHandles; i++ )
+    {
+        if ( id > 0 && sHandle[i].dataSetId == id )
+            return &sHandle[i];
+    }
+
+    mexErrMsgIdAndTxt( "crg_mex:handle", "Invalid or closed handle %d.", id );
+    return NULL;
+}
+
+static int
+canonicalPath( const char* filename, char* path )
+{
+#ifdef _WIN32
+    return _fullpath( path, filename, dMaxPathLen ) != NULL;
+#else
+    /* --- resolves ".", ".." and symbolic links; the file must exist --- */
+    char* resolved = realpath( filename, NULL );
+    int   ok       = resolved && strlen( resolved ) < dMaxPathLen;
+
+    if ( ok )
+        strcpy( path, resolved );
+
+    free( resolved );
+    return ok;
+#endif
+}
+
+static int
+openFile( const char* filename )
+{
+    CrgMexHandleStruct* slot = NULL;
+    char                path[dMaxPathLen];
+    int                 i;
+
+    /* --- the same file opened by another name (relative, "..", links) gets the same handle --- */
+    if ( !canonicalPath( filename, path ) )
+        mexErrMsgIdAndTxt( "crg_mex:open", "Could not find CRG file %s.", filename );
+
+    /* --- a file which is open already is only re-read if it has been modified --- */
+    for ( i = 0; i < dMaxHandles; i++ )
+    {
+        if ( sHandle[i].dataSetId > 0 && !dPathCmp( sHandle[i].filename, path ) )
+        {
+            if ( !crgDataSetReload( sHandle[i].dataSetId ) )
+                mexWarnMsgIdAndTxt( "crg_mex:reload", "Could not reload %s, keeping previous data.", filename );
+
+            return sHandle[i].dataSetId;
+        }
+
+        if ( !slot && sHandle[i].dataSetId <= 0 )
+            slot = &sHandle[i];
+    }
+
+    if ( !slot )
+        mexErrMsgIdAndTxt( "crg_mex:open", "Too many open files (max. %d), close some first.", dMaxHandles );
+
+    if ( ( slot->dataSetId = crgLoaderReadFile( path ) ) <= 0 )
+    {
+        slot->dataSetId = 0;
+        mexErrMsgIdAndTxt( "crg_mex:open", "Could not read CRG file %s.", filename );
+    }
+
+    if ( !crgCheck( slot->dataSetId ) )
+    {
+        crgDataSetRelease( slot->dataSetId );
+        slot->dataSetId = 0;
+        mexErrMsgIdAndTxt( "crg_mex:open", "Could not validate CRG file %s.", filename );
+    }
+
+    crgDataSetModifiersApply( slot->dataSetId );
+
+    if ( ( slot->cpId = crgContactPointCreate( slot->dataSetId ) ) < 0 )
+    {
+        crgDataSetRelease( slot->dataSetId );
+        slot->dataSetId = 0;
+        mexErrMsgIdAndTxt( "crg_mex:open", "Could not create contact point for %s.", filename );
+    }
+
+    strcpy( slot->filename, path );
+
+    return slot->dataSetId;
+}
+
+/* ----------------- Evaluation ----------------- */
+static int
+evalUv2z( int cpId, double a, double b, double* out1, double* out2 )
+{
+    ( void ) out2;
+    return crgEvaluv2z( cpId, a, b, out1 );
+}
+
+static int
+evalXy2z( int cpId, double a, double b, double* out1, double* out2 )
+{
+    ( void ) out2;
+    return crgEvalxy2z( cpId, a, b, out1 );
+}
+
+static int
+evalXy2uv( int cpId, double a, double b, double* out1, double* out2 )
+{
+    return crgEvalxy2uv( cpId, a, b, out1, out2 );
+}
+
+static int
+evalUv2xy( int cpId, double a, double b, double* out1, double* out2 )
+{
+    return crgEvaluv2xy( cpId, a, b, out1, out2 );
+}
+
+/* get the evaluator of a point command, NULL for other commands */
+static CrgMexEvalFunc
+getEvalFunc( const char* cmd )
+{
+    if ( !strcmp( cmd, "uv2z" ) )
+        return evalUv2z;
+
+    if ( !strcmp( cmd, "xy2z" ) )
+        return evalXy2z;
+
+    if ( !strcmp( cmd, "xy2uv" ) )
+        return evalXy2uv;
+
+    if ( !strcmp( cmd, "uv2xy" ) )
+        return evalUv2xy;
+
+    return NULL;
+}
+
+static const double*
+getPositions( const mxArray* arg, const char* name )
+{
+    if ( !mxIsDouble( arg ) || mxIsComplex( arg ) || mxIsSparse( arg ) )
+        mexErrMsgIdAndTxt( "crg_mex:input", "%s must be a real double array.", name );
+
+    return mxGetPr( arg );
+}
+
+static void
+evalPoints( CrgMexEvalFunc func, CrgMexHandleStruct* handle, int nlhs, mxArray* plhs[], const mxArray* a, const mxArray* b )
+{
+    const double* aPtr = getPositions( a, "First co-ordinate" );
+    const double* bPtr = getPositions( b, "Second co-ordinate" );
+    size_t        na   = mxGetNumberOfElements( a );
+    size_t        nb   = mxGetNumberOfElements( b );
+    const mxArray* shape = ( na >= nb ) ? a : b;
+    size_t        n    = ( na >= nb ) ? na : nb;
+    size_t        ia   = ( na == 1 ) ? 0 : 1;
+    size_t        ib   = ( nb == 1 ) ? 0 : 1;
+    double*       out1;
+    double*       out2 = NULL;
+    size_t        k;
+
+    if ( na != nb && na != 1 && nb != 1 )
+        mexErrMsgIdAndTxt( "crg_mex:input", "Co-ordinates must have the same number of elements or be scalar." );
+
+    /* --- results are written directly into the output arrays --- */
+    plhs[0] = mxCreateNumericArray( mxGetNumberOfDimensions( shape ), mxGetDimensions( shape ), mxDOUBLE_CLASS, mxREAL );
+    out1    = mxGetPr( plhs[0] );
+
+    /* --- the second co-ordinate is computed in any case, but only returned if requested --- */
+    if ( func == evalXy2uv || func == evalUv2xy )
+    {
+        if ( nlhs > 1 )
+        {
+            plhs[1] = mxCreateNumericArray( mxGetNumberOfDimensions( shape ), mxGetDimensions( shape ), mxDOUBLE_CLASS, mxREAL );
+            out2    = mxGetPr( plhs[1] );
+        }
+        else
+            out2 = ( double* ) mxMalloc( ( n ? n : 1 ) * sizeof( double ) );
+    }
+
+    for ( k = 0; k < n; k++ )
+    {
+        if ( !func( handle->cpId, aPtr[k*ia], bPtr[k*ib], out1 + k, out2 ? out2 + k : NULL ) )
+        {
+            out1[k] = mxGetNaN();
+
+            if ( out2 )
+                out2[k] = mxGetNaN();
+        }
+    }
+
+    if ( out2 && nlhs < 2 )
+        mxFree( out2 );
+}
+
+static double
+getIncrement( const mxArray* arg, const char* name )
+{
+    const double* pos = getPositions( arg, name );
+    size_t        n   = mxGetNumberOfElements( arg );
+    double        inc;
+    size_t        k;
+
+    if ( n < 2 )
+        return 1.0;
+
+    inc = ( pos[n-1] - pos[0] ) / ( n - 1 );
+
+    for ( k = 1; k < n; k++ )
+    {
+        if ( fabs( pos[k] - pos[0] - k * inc ) > 1.0e-9 * ( 1.0 + fabs( pos[k] ) ) )
+            mexErrMsgIdAndTxt( "crg_mex:input", "%s must be equidistant for 'uvgrid'.", name );
+    }
+
+    return inc;
+}
+
+static void
+evalGrid( CrgMexHandleStruct* handle, mxArray* plhs[], const mxArray* u, const mxArray* v )
+{
+    double  du = getIncrement( u, "u" );
+    double  dv = getIncrement( v, "v" );
+    size_t  nu = mxGetNumberOfElements( u );
+    size_t  nv = mxGetNumberOfElements( v );
+    double* out;
+    float*  grid;
+    size_t  i;
+    size_t  j;
+
+    plhs[0] = mxCreateDoubleMatrix( nv, nu, mxREAL );
+
+    if ( !nu || !nv )
+        return;
+
+    out  = mxGetPr( plhs[0] );
+    grid = ( float* ) mxMalloc( nu * nv * sizeof( float ) );
+
+    if ( !crgEvalGridUV( handle->dataSetId, mxGetPr( u )[0], du, ( int ) nu, mxGetPr( v )[0], dv, ( int ) nv, grid ) )
+    {
+        mxFree( grid );
+        mexErrMsgIdAndTxt( "crg_mex:eval", "Grid evaluation failed." );
+    }
+
+    /* --- rows of the grid are v positions, MATLAB stores columns --- */
+    for ( j = 0; j < nv; j++ )
+        for ( i = 0; i < nu; i++ )
+            out[j + i * nv] = ( grid[j * nu + i] != grid[j * nu + i] ) ? mxGetNaN() : grid[j * nu + i];
+
+    mxFree( grid );
+}
+
+static void
+evalPath( CrgMexHandleStruct* handle, mxArray* plhs[], int nArgs, const mxArray* arg[] )
+{
+    CrgPathStruct path;
+    const double* offset;
+    double        zeroOffset = 0.0;
+    double*       out;
+    int*          cpId;
+    int           noTracks   = 1;
+    int           noSamples;
+    int           noSampled;
+    int           j;
+    int           ok;
+
+    if ( mxGetNumberOfElements( arg[0] ) != mxGetNumberOfElements( arg[1] )
+      || mxGetNumberOfElements( arg[2] ) != mxGetNumberOfElements( arg[3] ) || mxGetNumberOfElements( arg[4] ) != 1 )
+        mexErrMsgIdAndTxt( "crg_mex:input", "Path points and speed schedule must have matching sizes, sample rate must be scalar." );
+
+    path.type       = dCrgPathTypeUV;
+    path.noPts      = ( int ) mxGetNumberOfElements( arg[0] );
+    path.a          = getPositions( arg[0], "u" );
+    path.b          = getPositions( arg[1], "v" );
+    path.noSpeeds   = ( int ) mxGetNumberOfElements( arg[2] );
+    path.speedTime  = getPositions( arg[2], "Speed time" );
+    path.speed      = getPositions( arg[3], "Speed" );
+    path.sampleRate = mxGetScalar( arg[4] );
+
+    offset = &zeroOffset;
+
+    if ( nArgs > 5 )
+    {
+        offset   = getPositions( arg[5], "Offset" );
+        noTracks = ( int ) mxGetNumberOfElements( arg[5] );
+    }
+
+    if ( noTracks < 1 || !crgEvalPathGetNoSamples( &path, &noSamples ) )
+        mexErrMsgIdAndTxt( "crg_mex:eval", "Invalid path, offsets or speed schedule." );
+
+    /* --- each track needs its own contact point; the first one is that of the handle --- */
+    cpId    = ( int* ) mxMalloc( noTracks * sizeof( int ) );
+    cpId[0] = handle->cpId;
+
+    for ( j = 1; j < noTracks; j++ )
+    {
+        if ( ( cpId[j] = crgContactPointCreate( handle->dataSetId ) ) < 0 )
+        {
+            while ( --j > 0 )
+                crgContactPointDelete( cpId[j] );
+
+            mxFree( cpId );
+            mexErrMsgIdAndTxt( "crg_mex:eval", "Could not create contact points for %d tracks.", noTracks );
+        }
+    }
+
+    /* --- tracks are written directly into the columns of the output --- */
+    plhs[0] = mxCreateDoubleMatrix( noSamples, noTracks, mxREAL );
+    out     = mxGetPr( plhs[0] );
+
+    ok = crgEvalPathSample( &path, noTracks, cpId, offset, noSamples, out, &noSampled );
+
+    for ( j = 1; j < noTracks; j++ )
+        crgContactPointDelete( cpId[j] );
+
+    mxFree( cpId );
+
+    if ( !ok )
+        mexErrMsgIdAndTxt( "crg_mex:eval", "Path evaluation failed." );
+}
+
+static void
+getInfo( CrgMexHandleStruct* handle, mxArray* plhs[] )
+{
+    const char* fields[] = { "ubeg", "uend", "vmin", "vmax", "uinc", "vinc" };
+    double      value[6];
+    int         i;
+
+    crgDataSetGetURange( handle->dataSetId, &value[0], &value[1] );
+    crgDataSetGetVRange( handle->dataSetId, &value[2], &value[3] );
+    crgDataSetGetIncrements( handle->dataSetId, &value[4], &value[5] );
+
+    plhs[0] = mxCreateStructMatrix( 1, 1, 6, fields );
+
+    for ( i = 0; i < 6; i++ )
+        mxSetField( plhs[0], 0, fields[i], mxCreateDoubleScalar( value[i] ) );
+}
+
+/* ----------------- Gateway ----------------- */
+void
+mexFunction( int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[] )
+{
+    char                cmd[16];
+    char                filename[dMaxPathLen];
+    CrgMexHandleStruct* handle;
+    CrgMexEvalFunc      func;
+
+    init();
+
+    if ( nrhs < 1 || !mxIsChar( prhs[0] ) || mxGetString( prhs[0], cmd, sizeof( cmd ) ) )
+        mexErrMsgIdAndTxt( "crg_mex:command", "First argument must be a command, see help crg_mex." );
+
+    if ( !strcmp( cmd, "open" ) )
+    {
+        if ( nrhs != 2 || !mxIsChar( prhs[1] ) || mxGetString( prhs[1], filename, sizeof( filename ) ) )
+            mexErrMsgIdAndTxt( "crg_mex:open", "Usage: h = crg_mex('open', crg_file)." );
+
+        plhs[0] = mxCreateDoubleScalar( openFile( filename ) );
+        return;
+    }
+
+    if ( !strcmp( cmd, "closeall" ) )
+    {
+        closeAll();
+        return;
+    }
+
+    if ( nrhs < 2 )
+        mexErrMsgIdAndTxt( "crg_mex:command", "Command '%s' requires a handle.", cmd );
+
+    handle = getHandle( prhs[1] );
+
+    if ( !strcmp( cmd, "close" ) )
+    {
+        crgDataSetRelease( handle->dataSetId );
+        handle->dataSetId = 0;
+    }
+    else if ( !strcmp( cmd, "info" ) )
+        getInfo( handle, plhs );
+    else if ( ( func = getEvalFunc( cmd ) ) != NULL )
+    {
+        if ( nrhs != 4 )
+            mexErrMsgIdAndTxt( "crg_mex:command", "Usage: crg_mex('%s', h, a, b).", cmd );
+
+        evalPoints( func, handle, nlhs, plhs, prhs[2], prhs[3] );
+    }
+    else if ( !strcmp( cmd, "uvgrid" ) )
+    {
+        if ( nrhs != 4 )
+            mexErrMsgIdAndTxt( "crg_mex:command", "Usage: Z = crg_mex('uvgrid', h, u, v)." );
+
+        evalGrid( handle, plhs, prhs[2], prhs[3] );
+    }
+    else if ( !strcmp( cmd, "path" ) )
+    {
+        if ( nrhs != 7 && nrhs != 8 )
+            mexErrMsgIdAndTxt( "crg_mex:command", "Usage: Z = crg_mex('path', h, u, v, speed_time, speed, sample_rate, offset)." );
+
+        evalPath( handle, plhs, nrhs - 2, prhs + 2 );
+    }
+    else
+        mexErrMsgIdAndTxt( "crg_mex:command", "Unknown command '%s'.", cmd );
+}
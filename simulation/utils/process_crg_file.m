@@ -1,18 +1,46 @@
 %% ----------------- CRG File Processor -----------------
-function [road_length, resolution, road_profile] = process_crg_file(crg_file, T, speed)
-    data = crg_read(crg_file);
-    data = crg_check(data);  % Check for validity
+function [road_length, resolution, road_profile] = process_crg_file(crg_file, T, speed, v_offset)
+    if nargin < 4
+        v_offset = 0;  % Evaluate along centerline
+    end
+
+    % Native evaluation via crg_mex if compiled (see build_crg_mex)
+    use_mex = exist('crg_mex', 'file') == 3;
+    backends = {'crg_read', 'crg_mex'};
+
+    % Profiles evaluated before by the same backend are read from the cache (see crg_profile_cache)
+    cache_key = crg_profile_cache('key', crg_file, T, speed, v_offset, backends{use_mex + 1});
+    [hit, road_length, resolution, road_profile] = crg_profile_cache('load', cache_key);
+    if hit
+        fprintf('CRG Length: %.2f m, Resolution: %.4f m (cached)\n', road_length, resolution);
+        return;
+    end
+
+    if use_mex
+        h = crg_mex('open', crg_file);  % Loaded once, reused on later calls
+        head = crg_mex('info', h);
+    else
+        data = crg_read(crg_file);
+        data = crg_check(data);  % Check for validity
+        head = data.head;
+    end
 
     % Convert time vector to position (s)
     s = speed * T;
-    s = min(max(s, data.head.ubeg), data.head.uend);  % Clamp to valid domain
-    v = zeros(size(s));  % Evaluate along centerline
+    s = min(max(s, head.ubeg), head.uend);  % Clamp to valid domain
+    v = v_offset * ones(size(s));
 
-    z = crg_eval_uv2z(data, [s(:), v(:)]);  % Evaluate road height profile
+    if use_mex
+        z = crg_mex('uv2z', h, s(:), v(:));  % Evaluate road height profile
+    else
+        z = crg_eval_uv2z(data, [s(:), v(:)]);  % Evaluate road height profile
+    end
 
     road_profile = z(:);  % Column vector
     resolution = mean(diff(s));
-    road_length = data.head.uend - data.head.ubeg;
+    road_length = head.uend - head.ubeg;
+
+    crg_profile_cache('store', cache_key, road_length, resolution, road_profile);
 
     % CRG Information
     fprintf('CRG Length: %.2f m, Resolution: %.4f m\n', road_length, resolution);
@@ -0,0 +1,25 @@
+%% ----------------- Results Directory -----------------
+function out_dir = results_dir(varargin)
+    % Directory for the simulation results of the calling script, laid out
+    % like its figures (see save_figure):
+    %
+    %   simulation/figures/results/<path below tests>/<script>/<varargin{:}>
+    %
+    % The directory is created by the caller (e.g. run_sweep 'OutputDir').
+    stack = dbstack('-completenames');
+    if numel(stack) < 2
+        error('results_dir:caller', 'results_dir must be called from a script or function.');
+    end
+
+    [caller_dir, script_name] = fileparts(stack(2).file);
+    path_components = strsplit(caller_dir, filesep);
+    tests_idx = find(strcmp(path_components, 'tests'), 1);
+    if isempty(tests_idx)
+        segments = {};
+    else
+        segments = path_components(tests_idx + 1:end);
+    end
+
+    out_dir = fullfile(fileparts(mfilename('fullpath')), '..', 'figures', 'results', ...
+        segments{:}, script_name, varargin{:});
+end
@@ -0,0 +1,73 @@
+%% ----------------- Sweep Runner -----------------
+function results = run_sweep(scenarios, sim_func, varargin)
+    % Runs sim_func(scenario) for every element of the scenario array (see
+    % sweep_grid) and returns the results in scenario order.
+    %
+    %   results = run_sweep(scenarios, sim_func, 'OutputDir', dir, 'UseParallel', true)
+    %
+    % With a parallel pool each simulation is an independent parfeval task,
+    % so idle workers pick up the next pending scenario as soon as they are
+    % done. Results are written to OutputDir (one MAT file per scenario) as
+    % they finish, the throughput of the sweep to sweep.mat (see results_dir
+    % for the directory of a script). sim_func should catch its own
+    % simulation errors.
+    p = inputParser;
+    addParameter(p, 'OutputDir', '');
+    addParameter(p, 'UseParallel', can_use_parallel());
+    parse(p, varargin{:});
+    out_dir = p.Results.OutputDir;
+
+    if ~isempty(out_dir) && ~exist(out_dir, 'dir')
+        mkdir(out_dir);
+    end
+
+    n = numel(scenarios);
+    results = cell(n, 1);
+    t_start = tic;
+
+    if p.Results.UseParallel && n > 1
+        pool = gcp();
+        no_workers = pool.NumWorkers;
+
+        futures = parallel.FevalFuture.empty;
+        for i = n:-1:1
+            futures(i) = parfeval(pool, sim_func, 1, scenarios(i));
+        end
+        cleanup = onCleanup(@() cancel(futures));  % Interrupted sweeps stop the workers
+
+        for done = 1:n
+            [i, result] = fetchNext(futures);
+            results{i} = result;
+            store_result(out_dir, i, scenarios(i), result);
+        end
+        clear cleanup;
+    else
+        no_workers = 1;
+        for i = 1:n
+            results{i} = sim_func(scenarios(i));
+            store_result(out_dir, i, scenarios(i), results{i});
+        end
+    end
+
+    elapsed = toc(t_start);
+    fprintf('Sweep: %d simulations in %.2f s (%.1f simulations/s, %d workers)\n', ...
+        n, elapsed, n / max(elapsed, eps), no_workers);
+
+    % Throughput of the sweep next to its results
+    if ~isempty(out_dir)
+        sweep = struct('no_simulations', n, 'elapsed', elapsed, ...
+            'simulations_per_s', n / max(elapsed, eps), 'no_workers', no_workers);
+        save(fullfile(out_dir, 'sweep.mat'), 'sweep');
+    end
+end
+
+function ok = can_use_parallel()
+    ok = license('test', 'Distrib_Computing_Toolbox') && ~isempty(ver('parallel'));
+end
+
+function store_result(out_dir, i, scenario, result)
+    if isempty(out_dir)
+        return;
+    end
+    save(fullfile(out_dir, sprintf('scenario_%05d.mat', i)), 'scenario', 'result');
+end
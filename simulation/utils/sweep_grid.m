@@ -0,0 +1,26 @@
+%% ----------------- Sweep Scenario Grid -----------------
+function scenarios = sweep_grid(axes)
+    % Expands a struct of sweep axes into a struct array of all combinations.
+    % Each field of axes holds the values of one axis (numeric vector or cell
+    % array); the first axis varies fastest.
+    %
+    %   scenarios = sweep_grid(struct('controller', {{'PID', 'LQR'}}, 'scale', [0.5 1 2]))
+    names = fieldnames(axes);
+    values = cellfun(@(f) axis_values(axes.(f)), names, 'UniformOutput', false);
+    counts = cellfun(@numel, values)';
+
+    scenarios = repmat(cell2struct(cell(numel(names), 1), names, 1), prod(counts), 1);
+    idx = cell(1, numel(names));
+    for i = 1:prod(counts)
+        [idx{:}] = ind2sub([counts, 1], i);
+        for j = 1:numel(names)
+            scenarios(i).(names{j}) = values{j}{idx{j}};
+        end
+    end
+end
+
+function v = axis_values(v)
+    if ~iscell(v)
+        v = num2cell(v);
+    end
+end